@@ -35,6 +35,18 @@ public final class SnapCommandLineDriver {
         }
     }
 
+    public enum CPUModel {
+        case schematic, fast, lockstep
+
+        func makeCPU() -> CPU {
+            switch self {
+            case .schematic: return SchematicLevelCPUModel()
+            case .fast: return FastCPUModel()
+            case .lockstep: return LockstepCPUModel()
+            }
+        }
+    }
+
     public var status: Int32 = 1
     public var stdout: TextOutputStream = String()
     public var stderr: TextOutputStream = String()
@@ -49,6 +61,15 @@ public final class SnapCommandLineDriver {
     public var shouldListTests = false
     public var verb: Verb = .compile
     public var platform: Platform = .turtle16
+    public var cpuModel: CPUModel = .schematic
+    public var backendJobs = 1
+    public var testJobs = 1
+    public var shouldTimePasses = false
+    public private(set) var timePassesJSONFileName: URL?
+    private var phaseReport: CompilerPhaseReport?
+    public var registerAllocator: RegisterAllocatorDriver.Algorithm = .linearScan
+    public var shouldReportRegisterAllocation = false
+    private var registerAllocationReport: RegisterAllocatorDriver.Report?
     public var shouldIncludeRuntime = true
     public var chooseSpecificTest: String?
     public var shouldBeQuiet = false
@@ -82,6 +103,12 @@ public final class SnapCommandLineDriver {
 
     func tryRun() throws {
         try parseArguments()
+        if shouldTimePasses || timePassesJSONFileName != nil {
+            phaseReport = CompilerPhaseReport()
+        }
+        if shouldReportRegisterAllocation {
+            registerAllocationReport = RegisterAllocatorDriver.Report()
+        }
 
         if shouldListTests {
             let fileName = inputFileName!.relativePath
@@ -96,6 +123,7 @@ public final class SnapCommandLineDriver {
             for testName in testNames {
                 stdout.write(testName + "\n")
             }
+            try writePhaseReport()
             status = 0
             return
         }
@@ -110,6 +138,9 @@ public final class SnapCommandLineDriver {
         case .compile:
             try doVerbCompile()
         }
+
+        try writePhaseReport()
+        writeRegisterAllocationReport()
     }
 
     private func reportInfoMessage(_ message: String) {
@@ -118,6 +149,17 @@ public final class SnapCommandLineDriver {
         }
     }
 
+    private func reportInfoMessage(_ message: String, to output: OutputBuffer?) {
+        if let output {
+            if !shouldBeQuiet {
+                output.write(message)
+            }
+        }
+        else {
+            reportInfoMessage(message)
+        }
+    }
+
     private func printNumberOfInstructionWordsUsed(_ program: TurtleProgram) {
         let numberOfInstructions = program.instructions.count
         if numberOfInstructions > 32767 {
@@ -136,22 +178,143 @@ public final class SnapCommandLineDriver {
         guard let text = maybeText else {
             throw SnapCommandLineDriverError("failed to read input file as UTF-8 text: \(fileName)")
         }
-        let testNames = try collectNamesOfTests(text, fileName)
         if let chooseSpecificTest {
+            let testNames = try collectNamesOfTests(text, fileName)
+            guard testNames.contains(chooseSpecificTest) else {
+                throw SnapCommandLineDriverError(
+                    "\(fileName): no test named `\(chooseSpecificTest)'"
+                )
+            }
             try runSpecificTest(chooseSpecificTest, text, fileName)
         }
         else {
-            for testName in testNames {
-                try runSpecificTest(testName, text, fileName)
-            }
+            try runAllTests(text)
         }
         status = 0
     }
 
+    /// Compile the program once with every test included and then run it once
+    /// per test, each time on a fresh machine with the test selector set to
+    /// the index of that test.
+    private func runAllTests(_ text: String) throws {
+        let program = try compile(program: text, isTestDispatchEnabled: true)
+        printNumberOfInstructionWordsUsed(program)
+        let directory: URL = inputFileName!.deletingPathExtension().deletingLastPathComponent()
+        let baseName: String = inputFileName!.deletingPathExtension().lastPathComponent + " -- tests"
+        irOutputFileName = URL(fileURLWithPath: baseName + ".ir", relativeTo: directory)
+        asmOutputFileName = URL(fileURLWithPath: baseName + ".asm", relativeTo: directory)
+        if shouldOutputIR {
+            try writeToFile(ir: program.tackProgram)
+        }
+        if shouldOutputAssembly {
+            try writeAssemblyToFile(assembly: program.assembly)
+        }
+
+        guard let selector = program.symbolsOfTopLevelScope.maybeResolve(identifier: kTestSelectorName),
+              let selectorAddress = selector.storage.offset
+        else {
+            throw SnapCommandLineDriverError(
+                "internal compiler error: failed to find the address of `\(kTestSelectorName)'"
+            )
+        }
+
+        // With more than one job, each test writes to its own buffer and the
+        // buffers are printed in test order once all tests have finished.
+        let isBuffered = testJobs > 1
+        let runs = try Array(program.testNames.enumerated()).concurrentMap(jobs: testJobs) {
+            element -> TestRun in
+            let (index, testName) = element
+            let output: OutputBuffer? = isBuffered ? OutputBuffer() : nil
+            reportInfoMessage("Running test \"\(testName)\"...\n", to: output)
+            let startTime = DispatchTime.now().uptimeNanoseconds
+            let result = Result {
+                try runProgram(
+                    program,
+                    poke: (address: selectorAddress, value: UInt16(index)),
+                    output: output
+                )
+            }
+            let elapsedTime = TimeInterval(DispatchTime.now().uptimeNanoseconds - startTime) / 1.0e9
+            reportInfoMessage("\n\n", to: output)
+            return TestRun(
+                name: testName,
+                output: output,
+                result: result,
+                elapsedTime: elapsedTime
+            )
+        }
+        // Every test has run by now, so print all of the output and the
+        // summary before reporting the first test which failed.
+        for run in runs {
+            if let output = run.output {
+                stdout.write(output.text)
+            }
+        }
+        printTestSummary(runs)
+        for run in runs {
+            _ = try run.result.get()
+        }
+    }
+
+    /// The outcome of running a single test
+    struct TestRun {
+        let name: String
+        let output: OutputBuffer?
+
+        /// The number of cycles, or instructions on the Tack VM, run by the
+        /// test if it ran to completion
+        let result: Result<UInt, Error>
+
+        /// Wall-clock time spent running the test, in seconds
+        let elapsedTime: TimeInterval
+    }
+
+    /// Collects the output of a test so that tests may run concurrently and
+    /// still print their output in order
+    final class OutputBuffer: TextOutputStream, Logger {
+        private(set) var text = ""
+
+        func write(_ string: String) {
+            text += string
+        }
+
+        func append(_ format: String, _ args: CVarArg...) {
+            text += String(format: format, arguments: args)
+        }
+    }
+
+    /// List the tests in order of decreasing wall-clock time so that slow
+    /// tests stand out
+    private func printTestSummary(_ runs: [TestRun]) {
+        let unit =
+            switch platform {
+            case .turtle16: "cycles"
+            case .tack: "instructions"
+            }
+        reportInfoMessage("Test summary:\n")
+        for run in runs.sorted(by: { $0.elapsedTime > $1.elapsedTime }) {
+            let outcome =
+                switch run.result {
+                case let .success(count): String(format: "%12lu %@", count, unit)
+                case .failure: "error".padding(toLength: 13 + unit.count, withPad: " ", startingAt: 0)
+                }
+            reportInfoMessage(
+                String(
+                    format: "  %10.6f s  %@  %@\n",
+                    run.elapsedTime,
+                    outcome,
+                    run.name
+                )
+            )
+        }
+    }
+
     private func collectNamesOfTests(_ text: String, _ fileName: String) throws -> [String] {
         let testNames: [String]
+        var compiler = SnapToTurtle16Compiler()
+        compiler.phaseReport = phaseReport
         do {
-            testNames = try SnapToTurtle16Compiler().collectTestNames(
+            testNames = try compiler.collectTestNames(
                 program: text,
                 url: URL(string: fileName),
                 options: SnapToTurtle16Compiler.Options(
@@ -246,18 +409,30 @@ public final class SnapCommandLineDriver {
 
     func compile(
         program text: String,
-        shouldRunSpecificTest testName: String? = nil
+        shouldRunSpecificTest testName: String? = nil,
+        isTestDispatchEnabled: Bool = false
     ) throws -> TurtleProgram {
         let program: TurtleProgram
+        var compiler = SnapToTurtle16Compiler()
+        compiler.phaseReport = phaseReport
+        compiler.registerAllocationReport = registerAllocationReport
         do {
-            program = try SnapToTurtle16Compiler().compile(
+            program = try compiler.compile(
                 program: text,
                 url: inputFileName,
                 options: SnapToTurtle16Compiler.Options(
                     isBoundsCheckEnabled: true,
                     isUsingStandardLibrary: false,
                     runtimeSupport: shouldIncludeRuntime ? platform.runtimeSupport : nil,
-                    shouldRunSpecificTest: testName
+                    shouldRunSpecificTest: testName,
+                    isTestDispatchEnabled: isTestDispatchEnabled,
+                    backendJobs: backendJobs,
+                    isInstructionSchedulingEnabled: shouldEnableOptimizations,
+                    isTackOptimizationEnabled: shouldEnableOptimizations,
+                    isPeepholeOptimizationEnabled: shouldEnableOptimizations,
+                    isInliningEnabled: shouldEnableOptimizations,
+                    isLeafFrameEliminationEnabled: shouldEnableOptimizations,
+                    registerAllocator: registerAllocator
                 )
             )
         }
@@ -268,41 +443,119 @@ public final class SnapCommandLineDriver {
         return program
     }
 
-    private func runProgram(_ program: TurtleProgram) throws {
+    /// Print the time spent in each phase of each compile, and write the same
+    /// as JSON if requested
+    private func writePhaseReport() throws {
+        guard let phaseReport else { return }
+        if shouldTimePasses {
+            stdout.write("Compiler phases:\n")
+            stdout.write(phaseReport.listing)
+        }
+        if let timePassesJSONFileName {
+            try phaseReport.jsonRepresentation().write(to: timePassesJSONFileName)
+        }
+    }
+
+    /// Print the spill loads and stores inserted in each subroutine, next to
+    /// those which linear scan would have inserted. Where linear scan could
+    /// not allocate registers, its figures are shown as unavailable.
+    private func writeRegisterAllocationReport() {
+        guard let registerAllocationReport else { return }
+        let entries = registerAllocationReport.entries
+        func total(_ count: KeyPath<RegisterAllocatorDriver.Report.Entry, Int>) -> Int {
+            entries.reduce(0) { $0 + $1[keyPath: count] }
+        }
+        func totalIfAvailable(
+            _ count: KeyPath<RegisterAllocatorDriver.Report.Entry, Int?>
+        ) -> Int? {
+            entries.reduce(Int?(0)) { sum, entry in
+                guard let sum, let count = entry[keyPath: count] else { return nil }
+                return sum + count
+            }
+        }
+        func column(_ count: Int?, _ width: Int) -> String {
+            let text = count.map { String($0) } ?? "n/a"
+            return String(repeating: " ", count: max(0, width - text.count)) + text
+        }
+        stdout.write(
+            String(
+                format: "Register allocation took %g seconds over %d subroutines\n",
+                registerAllocationReport.totalElapsedTime,
+                entries.count
+            )
+        )
+        stdout.write("     loads   stores   linear scan loads   stores\n")
+        let spilling = entries.filter {
+            $0.linearScanSpillLoadCount == nil
+                || $0.spillLoadCount + $0.spillStoreCount
+                    + ($0.linearScanSpillLoadCount ?? 0)
+                    + ($0.linearScanSpillStoreCount ?? 0) > 0
+        }
+        for entry in spilling {
+            stdout.write(
+                String(
+                    format: "  %8d %8d %@ %@  %@\n",
+                    entry.spillLoadCount,
+                    entry.spillStoreCount,
+                    column(entry.linearScanSpillLoadCount, 19),
+                    column(entry.linearScanSpillStoreCount, 8),
+                    entry.identifier ?? "<top level>"
+                )
+            )
+        }
+        stdout.write(
+            String(
+                format: "  %8d %8d %@ %@  total\n",
+                total(\.spillLoadCount),
+                total(\.spillStoreCount),
+                column(totalIfAvailable(\.linearScanSpillLoadCount), 19),
+                column(totalIfAvailable(\.linearScanSpillStoreCount), 8)
+            )
+        )
+    }
+
+    /// A word to store in memory before the program starts
+    typealias Poke = (address: Int, value: UInt16)
+
+    /// Run the program to completion. Output is written to stdout, or to the
+    /// given buffer if there is one.
+    /// - Returns: The number of cycles run, or the number of instructions run
+    ///   on the Tack VM
+    @discardableResult
+    private func runProgram(
+        _ program: TurtleProgram,
+        poke: Poke? = nil,
+        output: OutputBuffer? = nil
+    ) throws -> UInt {
+        let write = { (string: String) in
+            if let output {
+                output.write(string)
+            }
+            else {
+                self.stdout.write(string)
+            }
+        }
         switch platform {
         case .turtle16:
-            try runOnTurtle16(program)
+            let logger: Logger = if let output { output } else { PrintLogger() }
+            return try runOnTurtle16(program, poke: poke, write: write, logger: logger)
         case .tack:
-            try runOnTack(program)
-        }
-    }
-
-    private func runOnTurtle16(_ program: TurtleProgram) throws {
-        var serialOutput: [UInt8] = []
-        let onSerialOutput = { (value: UInt16) in
-            let oldStr = String(bytes: serialOutput, encoding: .utf8)
-            serialOutput.append(UInt8(value & 0x00ff))
-            let newStr = String(bytes: serialOutput, encoding: .utf8)
-            let delta: String =
-                if let n = oldStr?.count {
-                    if let newDelta = newStr?.dropFirst(n) {
-                        String(newDelta)
-                    }
-                    else {
-                        oldStr!
-                    }
-                }
-                else {
-                    ""
-                }
-            if delta.count > 0 {
-                self.stdout.write(String(delta))
-            }
+            return try runOnTack(program, poke: poke, write: write)
         }
-        let computer = TurtleComputer(SchematicLevelCPUModel())
+    }
+
+    private func runOnTurtle16(
+        _ program: TurtleProgram,
+        poke: Poke?,
+        write: @escaping (String) -> Void,
+        logger: Logger
+    ) throws -> UInt {
+        let serialOutput = SerialOutputDecoder(onText: write)
+        defer { serialOutput.flush() }
+        let computer = TurtleComputer(cpuModel.makeCPU())
         computer.cpu.store = { (value: UInt16, addr: MemoryAddress) in
             if addr == self.kMemoryMappedSerialOutputPort {
-                onSerialOutput(value)
+                serialOutput.write(UInt8(value & 0x00ff))
             }
             else {
                 computer.ram[addr.value] = value
@@ -313,19 +566,36 @@ public final class SnapCommandLineDriver {
         }
         computer.instructions = program.instructions
         computer.reset()
+        if let poke {
+            computer.ram[poke.address] = poke.value
+        }
 
         let debugger = SnapDebugConsole(computer: computer)
-        debugger.logger = PrintLogger()
+        debugger.logger = logger
         debugger.symbols = program.symbolsOfTopLevelScope
         debugger.interpreter.runOne(instruction: .run)
+
+        if let lockstep = computer.cpu as? LockstepCPUModel,
+           let divergence = lockstep.firstDivergence {
+            throw SnapCommandLineDriverError(divergence.description)
+        }
+        return computer.timeStamp
     }
 
-    private func runOnTack(_ program: TurtleProgram) throws {
+    private func runOnTack(
+        _ program: TurtleProgram,
+        poke: Poke?,
+        write: @escaping (String) -> Void
+    ) throws -> UInt {
         let vm = TackVirtualMachine(program.tackProgram)
-        vm.onSerialOutput = { value in
-            self.stdout.write(String(Character(UnicodeScalar(value))))
+        if let poke {
+            vm.store(w: poke.value, address: UInt(poke.address))
         }
+        let serialOutput = SerialOutputDecoder(onText: write)
+        defer { serialOutput.flush() }
+        vm.onSerialOutput = { serialOutput.write($0) }
         try vm.run()
+        return vm.instructionCount
     }
 
     func writeToFile(ir: TackProgram) throws {
@@ -406,6 +676,9 @@ public final class SnapCommandLineDriver {
             case .unoptimized:
                 shouldEnableOptimizations = false
 
+            case .optimized:
+                shouldEnableOptimizations = true
+
             case let .platform(platformName):
                 switch platformName.lowercased() {
                 case "turtle16":
@@ -416,8 +689,51 @@ public final class SnapCommandLineDriver {
                     throw SnapCommandLineDriverError("unknown platform '\(platformName)'. Valid platforms: turtle16, tack")
                 }
 
+            case let .cpu(cpuName):
+                switch cpuName.lowercased() {
+                case "schematic":
+                    cpuModel = .schematic
+                case "fast":
+                    cpuModel = .fast
+                case "lockstep":
+                    cpuModel = .lockstep
+                default:
+                    throw SnapCommandLineDriverError("unknown CPU model '\(cpuName)'. Valid CPU models: schematic, fast, lockstep")
+                }
+
             case .noRuntime:
                 shouldIncludeRuntime = false
+
+            case let .backendJobs(jobCount):
+                guard let value = Int(jobCount), value > 0 else {
+                    throw SnapCommandLineDriverError("invalid number of backend jobs '\(jobCount)'. Expected a positive integer")
+                }
+                backendJobs = value
+
+            case let .jobs(jobCount):
+                guard let value = Int(jobCount), value > 0 else {
+                    throw SnapCommandLineDriverError("invalid number of jobs '\(jobCount)'. Expected a positive integer")
+                }
+                testJobs = value
+
+            case .timePasses:
+                shouldTimePasses = true
+
+            case let .timePassesJSON(fileName):
+                timePassesJSONFileName = URL(fileURLWithPath: fileName)
+
+            case let .registerAllocator(allocatorName):
+                switch allocatorName.lowercased() {
+                case "linear-scan":
+                    registerAllocator = .linearScan
+                case "graph-coloring":
+                    registerAllocator = .graphColoring
+                default:
+                    throw SnapCommandLineDriverError("unknown register allocator '\(allocatorName)'. Valid register allocators: linear-scan, graph-coloring")
+                }
+
+            case .registerAllocationReport:
+                shouldReportRegisterAllocation = true
             }
         }
 
@@ -452,7 +768,14 @@ public final class SnapCommandLineDriver {
         \ttest       Compile the program for testing and run immediately in a VM.
         \t-t <test>  The test suite only runs the specified test
         \t--platform <platform>  Target platform (turtle16, tack). Default: turtle16
+        \t--cpu <model>          Turtle16 CPU model (schematic, fast, lockstep). Default: schematic
         \t--no-runtime           Compile without including runtime support
+        \t--backend-jobs <n>     Compile up to n subroutines at once in the backend. Default: 1
+        \t--jobs <n>             Run up to n tests at once. Default: 1
+        \t--time-passes          Print the time, AST node counts, and peak memory of each compiler phase
+        \t--time-passes-json <file>  Write the same compiler phase report to file as JSON
+        \t--regalloc <allocator>  Register allocator (linear-scan, graph-coloring). Default: linear-scan
+        \t--regalloc-report       Print the spill loads and stores of each subroutine, compared to linear scan
         \t-h         Display available options
         \t-o <file>  Specify the output filename
         \t-S         Output assembly code
@@ -460,6 +783,7 @@ public final class SnapCommandLineDriver {
         \t-ast-dump  Print the abstract syntax tree to stdout
         \t-q         Quiet. Do not print progress to stdout
         \t-O0        Disable optimizations
+        \t-O1        Enable optimizations (default)
 
         """
     }
@@ -38,6 +38,23 @@ class SnapBenchmarkDriver: NSObject {
     var stderr: TextOutputStream = String()
     let arguments: [String]
     var benchmarkFilePath: String?
+    var baselineRate: Double?
+    var isUsingGALHazardControl = false
+    var isUsingFastCPUModel = false
+    var isUsingTackVirtualMachine = false
+    var isUsingTackInterpreter = false
+    var isReportingRegisterAllocation = false
+    var isInstructionSchedulingEnabled = true
+    var isTackOptimizationEnabled = true
+    var isPeepholeOptimizationEnabled = true
+    var isReportingInstructionScheduling = false
+    var isReportingPeepholeOptimization = false
+    var isInliningEnabled = true
+    var isLeafFrameEliminationEnabled = true
+    var isReportingInlining = false
+    var registerAllocator: RegisterAllocatorDriver.Algorithm = .linearScan
+    var snapshotInterval: UInt?
+    var statementTracerDepth: Int?
 
     required init(arguments: [String]) {
         self.arguments = arguments
@@ -80,7 +97,20 @@ class SnapBenchmarkDriver: NSObject {
 
     func tryRun() throws {
         try parseArguments()
-        try runProgramRuntimeBenchmark()
+        if let statementTracerDepth {
+            try runStatementTracerBenchmark(depth: statementTracerDepth)
+            status = 0
+            return
+        }
+        if isUsingTackInterpreter, !isUsingTackVirtualMachine {
+            throw SnapBenchmarkDriverError(format: "'--interpreted' requires '--tack-vm'")
+        }
+        if isUsingTackVirtualMachine {
+            try runTackVirtualMachineBenchmark()
+        }
+        else {
+            try runProgramRuntimeBenchmark()
+        }
         status = 0
     }
 
@@ -92,7 +122,85 @@ class SnapBenchmarkDriver: NSObject {
         while argIndex < arguments.count {
             let arg = arguments[argIndex]
 
-            if arg.hasPrefix("--") {
+            if arg == "--baseline" {
+                argIndex += 1
+                guard argIndex < arguments.count,
+                      let value = Double(arguments[argIndex]),
+                      value > 0
+                else {
+                    throw SnapBenchmarkDriverError(
+                        format: "expected a positive number per second after '--baseline'"
+                    )
+                }
+                baselineRate = value
+                argIndex += 1
+            } else if arg == "--gal-hazard-control" {
+                isUsingGALHazardControl = true
+                argIndex += 1
+            } else if arg == "--fast-cpu" {
+                isUsingFastCPUModel = true
+                argIndex += 1
+            } else if arg == "--tack-vm" {
+                isUsingTackVirtualMachine = true
+                argIndex += 1
+            } else if arg == "--interpreted" {
+                isUsingTackInterpreter = true
+                argIndex += 1
+            } else if arg == "--regalloc-report" {
+                isReportingRegisterAllocation = true
+                argIndex += 1
+            } else if arg == "--no-schedule" {
+                isInstructionSchedulingEnabled = false
+                argIndex += 1
+            } else if arg == "--no-optimize" {
+                isTackOptimizationEnabled = false
+                argIndex += 1
+            } else if arg == "--schedule-report" {
+                isReportingInstructionScheduling = true
+                argIndex += 1
+            } else if arg == "--no-peephole" {
+                isPeepholeOptimizationEnabled = false
+                argIndex += 1
+            } else if arg == "--peephole-report" {
+                isReportingPeepholeOptimization = true
+                argIndex += 1
+            } else if arg == "--no-inline" {
+                isInliningEnabled = false
+                argIndex += 1
+            } else if arg == "--no-leaf-frames" {
+                isLeafFrameEliminationEnabled = false
+                argIndex += 1
+            } else if arg == "--inline-report" {
+                isReportingInlining = true
+                argIndex += 1
+            } else if arg == "--graph-coloring" {
+                registerAllocator = .graphColoring
+                argIndex += 1
+            } else if arg == "--snapshots" {
+                argIndex += 1
+                guard argIndex < arguments.count,
+                      let value = UInt(arguments[argIndex]),
+                      value > 0
+                else {
+                    throw SnapBenchmarkDriverError(
+                        format: "expected a positive number of cycles after '--snapshots'"
+                    )
+                }
+                snapshotInterval = value
+                argIndex += 1
+            } else if arg == "--statement-tracer" {
+                argIndex += 1
+                guard argIndex < arguments.count,
+                      let value = Int(arguments[argIndex]),
+                      value > 0
+                else {
+                    throw SnapBenchmarkDriverError(
+                        format: "expected a positive number of conditionals after '--statement-tracer'"
+                    )
+                }
+                statementTracerDepth = value
+                argIndex += 1
+            } else if arg.hasPrefix("--") {
                 throw SnapBenchmarkDriverError(
                     format: "unknown option '\(arg)'"
                 )
@@ -111,15 +219,69 @@ class SnapBenchmarkDriver: NSObject {
             )
         }
 
+        // The statement tracer benchmark generates its own input.
+        if statementTracerDepth != nil, benchmarkFilePath == nil {
+            return
+        }
+
         // Require benchmark file path
         guard let filePath = benchmarkFilePath else {
             throw SnapBenchmarkDriverError(
                 format: """
-                    usage: SnapBenchmark <benchmark_file.snap>
+                    usage: SnapBenchmark [--baseline <rate>] [--gal-hazard-control] [--fast-cpu] [--tack-vm [--interpreted]] [--regalloc-report] [--no-schedule] [--no-optimize] [--schedule-report] [--no-peephole] [--peephole-report] [--no-inline] [--no-leaf-frames] [--inline-report] [--graph-coloring] [--snapshots <n>] <benchmark_file.snap>
+                           SnapBenchmark --statement-tracer <n>
+
+                    Options:
+                      --baseline <n>          Report the speedup relative to a previously
+                                              measured rate of n cycles per second, or n
+                                              instructions per second with --tack-vm
+                      --gal-hazard-control    Simulate the hazard control unit at the level
+                                              of the programmed ATF22V10 fuse maps
+                      --fast-cpu              Simulate with FastCPUModel instead of the
+                                              schematic-level CPU model
+                      --tack-vm               Run the Tack intermediate representation of
+                                              the program on the Tack virtual machine and
+                                              report instructions per second
+                      --interpreted           With --tack-vm, run the Tack VM interpreter
+                                              instead of compiled execution
+                      --regalloc-report       Report the time spent in register allocation
+                                              for the slowest subroutines, and the spill
+                                              loads and stores compared to linear scan
+                      --no-schedule           Compile without instruction scheduling, to
+                                              compare the cycle count against a scheduled
+                                              build of the same program
+                      --no-optimize           Compile without optimizing the Tack
+                                              intermediate representation
+                      --schedule-report       Report the estimated stall cycles removed by
+                                              instruction scheduling, by subroutine
+                      --no-peephole           Compile without peephole optimization, to
+                                              compare the cycle count and program size
+                                              against an optimized build
+                      --peephole-report       Report the number of rewrites made by each
+                                              peephole pattern and the instruction words
+                                              they saved
+                      --no-inline             Compile without inlining calls to small
+                                              subroutines
+                      --no-leaf-frames        Compile without removing the stack frame
+                                              from subroutines which make no calls
+                      --inline-report         Report the calls which were inlined and the
+                                              subroutines whose frames were removed
+                      --graph-coloring        Allocate registers by coloring an
+                                              interference graph instead of by linear scan
+                      --snapshots <n>         Take a snapshot of the computer every n cycles
+                                              and compare the size and latency of paged
+                                              snapshots against archived snapshots
+                      --statement-tracer <n>  Analyze the return statements of a function
+                                              with a chain of n conditionals, comparing
+                                              the enumeration of every path against the
+                                              linear-time reachability analysis
 
                     Examples:
                       SnapBenchmark Examples/benchmarks/fibonacci.snap
                       SnapBenchmark Examples/benchmarks/micro.snap
+                      SnapBenchmark --baseline 250000 Examples/benchmarks/micro.snap
+                      SnapBenchmark --tack-vm Examples/benchmarks/macro.snap
+                      SnapBenchmark --tack-vm Examples/benchmarks/recursion.snap
                     """
             )
         }
@@ -131,17 +293,62 @@ class SnapBenchmarkDriver: NSObject {
     func runProgramRuntimeBenchmark() throws {
 
         let logger = isVerboseLogging ? ConsoleLogger(output: stdout) : nil
-        let compiler = SnapToTurtle16Compiler()
+        var compiler = SnapToTurtle16Compiler()
+        let registerAllocationReport = RegisterAllocatorDriver.Report()
+        if isReportingRegisterAllocation {
+            compiler.registerAllocationReport = registerAllocationReport
+        }
+        let instructionSchedulingReport = InstructionScheduler.Report()
+        if isReportingInstructionScheduling {
+            compiler.instructionSchedulingReport = instructionSchedulingReport
+        }
+        let peepholeReport = PeepholeOptimizer.Report()
+        if isReportingPeepholeOptimization {
+            compiler.peepholeReport = peepholeReport
+        }
+        let inliningReport = TackInliner.Report()
+        let leafFrameReport = LeafFrameEliminator.Report()
+        if isReportingInlining {
+            compiler.inliningReport = inliningReport
+            compiler.leafFrameReport = leafFrameReport
+        }
         let programText = try getProgramText()
-        let options = SnapToTurtle16Compiler.Options(runtimeSupport: "runtime_Turtle16")
-        let program = try compiler.compile(program: programText, options: options)
+        let program = try compiler.compile(program: programText, options: turtle16Options())
+        if isReportingRegisterAllocation {
+            writeRegisterAllocationReport(registerAllocationReport)
+        }
+        if isReportingInstructionScheduling {
+            writeInstructionSchedulingReport(instructionSchedulingReport)
+        }
+        if isReportingPeepholeOptimization {
+            writePeepholeReport(peepholeReport, instructionWordCount: program.instructions.count)
+        }
+        if isReportingInlining {
+            writeInliningReport(inliningReport, leafFrameReport: leafFrameReport)
+        }
 
         if isVerboseLogging {
             logger?.append(AssemblerListingMaker().makeListing(program.assembly))
             logger?.append(program.tackProgram.listing)
         }
 
-        let computer = TurtleComputer(SchematicLevelCPUModel())
+        let cpu: CPU
+        if isUsingFastCPUModel {
+            if isUsingGALHazardControl {
+                throw SnapBenchmarkDriverError(
+                    format: "'--gal-hazard-control' cannot be combined with '--fast-cpu'"
+                )
+            }
+            cpu = FastCPUModel()
+        }
+        else {
+            let schematicLevelCPU = SchematicLevelCPUModel()
+            if isUsingGALHazardControl {
+                schematicLevelCPU.stageID.hazardControlUnit = HazardControlGAL()
+            }
+            cpu = schematicLevelCPU
+        }
+        let computer = TurtleComputer(cpu)
         computer.cpu.store = { (value: UInt16, addr: MemoryAddress) in
             if let logger {
                 logger.append("store ram[\(addr.value)] <- \(value)")
@@ -164,6 +371,11 @@ class SnapBenchmarkDriver: NSObject {
             debugger.logger = logger
         }
 
+        if let snapshotInterval {
+            runSnapshotBenchmark(computer, interval: snapshotInterval)
+            return
+        }
+
         let fileName = benchmarkFilePath?.split(separator: "/").last.map(String.init) ?? "program"
         stdout.write("Running \(fileName) program now...\n")
         let elapsedTime = try measure {
@@ -176,6 +388,382 @@ class SnapBenchmarkDriver: NSObject {
                 elapsedTime
             )
         )
+
+        let cyclesPerSecond = Double(computer.timeStamp) / max(elapsedTime, .leastNonzeroMagnitude)
+        stdout.write(
+            String(
+                format: "Simulator throughput was %@ cycles per second\n",
+                formatDecimal(value: UInt(cyclesPerSecond))
+            )
+        )
+        let predecodeCache = (cpu as? FastCPUModel)?.predecodeCache
+            ?? (cpu as? SchematicLevelCPUModel)?.predecodeCache
+        if let predecodeCache {
+            stdout.write(
+                String(
+                    format: "Predecode cache had %@ hits and %@ misses\n",
+                    formatDecimal(value: predecodeCache.hits),
+                    formatDecimal(value: predecodeCache.misses)
+                )
+            )
+        }
+        if let baselineRate {
+            stdout.write(
+                String(
+                    format: "Speedup relative to the baseline of %@ cycles per second is %.2fx\n",
+                    formatDecimal(value: UInt(baselineRate)),
+                    cyclesPerSecond / baselineRate
+                )
+            )
+        }
+    }
+
+    func runTackVirtualMachineBenchmark() throws {
+        if isUsingFastCPUModel || isUsingGALHazardControl {
+            throw SnapBenchmarkDriverError(
+                format: "'--tack-vm' cannot be combined with options for the CPU simulator"
+            )
+        }
+
+        let compiler = SnapToTurtle16Compiler()
+        let programText = try getProgramText()
+        let options = SnapToTurtle16Compiler.Options(
+            runtimeSupport: "runtime_TackVM",
+            isTackOptimizationEnabled: isTackOptimizationEnabled,
+            isInliningEnabled: isInliningEnabled
+        )
+        let program = try compiler.compile(program: programText, options: options)
+        let vm = TackVirtualMachine(program.tackProgram)
+        vm.isCompiledExecutionEnabled = !isUsingTackInterpreter
+
+        let fileName = benchmarkFilePath?.split(separator: "/").last.map(String.init) ?? "program"
+        stdout.write("Running \(fileName) program on the Tack VM now...\n")
+        let elapsedTime = try measure {
+            // The program may stop at a breakpoint, such as on a panic.
+            try vm.run()
+        }
+        let instructionCount = vm.instructionCount
+        stdout.write(
+            String(
+                format: "Tack VM benchmark completed in %@ instructions. This took %g seconds\n",
+                formatDecimal(value: instructionCount),
+                elapsedTime
+            )
+        )
+
+        let instructionsPerSecond = Double(instructionCount) / max(elapsedTime, .leastNonzeroMagnitude)
+        stdout.write(
+            String(
+                format: "Tack VM throughput was %@ instructions per second\n",
+                formatDecimal(value: UInt(instructionsPerSecond))
+            )
+        )
+        if let baseline = baselineRate {
+            stdout.write(
+                String(
+                    format: "Speedup relative to the baseline of %@ instructions per second is %.2fx\n",
+                    formatDecimal(value: UInt(baseline)),
+                    instructionsPerSecond / baseline
+                )
+            )
+        }
+    }
+
+    // Analyze the return statements of a function body with a chain of
+    // `depth` conditionals, each of which returns on one branch. The number
+    // of paths through the body is exponential in the depth, so enumerating
+    // every path is only attempted for small depths.
+    func runStatementTracerBenchmark(depth: Int) throws {
+        let kMaxEnumeratedDepth = 18
+        var children: [AbstractSyntaxTreeNode] = []
+        for i in 0..<depth {
+            let condition = Identifier("c\(i)")
+            let inner = If(
+                condition: condition,
+                then: Block(children: [Return(LiteralInt(i))]),
+                else: nil
+            )
+            let statement: AbstractSyntaxTreeNode =
+                if i % 2 == 0 {
+                    If(condition: condition, then: Block(children: [inner]), else: Block())
+                }
+                else {
+                    While(condition: condition, body: Block(children: [inner]))
+                }
+            children.append(statement)
+        }
+        children.append(Return(LiteralInt(depth)))
+        let body = Block(children: children)
+        let tracer = StatementTracer()
+
+        stdout.write("Analyzing a function with a chain of \(depth) conditionals...\n")
+        var reachability = StatementTracer.Reachability(fallsThrough: true, returns: false)
+        let reachabilityTime = try measure {
+            reachability = try tracer.reachability(ast: body)
+        }
+        stdout.write(
+            String(
+                format: "Reachability analysis took %g seconds (falls through: %@)\n",
+                reachabilityTime,
+                reachability.fallsThrough ? "yes" : "no"
+            )
+        )
+
+        guard depth <= kMaxEnumeratedDepth else {
+            stdout.write(
+                "Skipped enumerating every path, as there are more than 2^\(kMaxEnumeratedDepth)\n"
+            )
+            return
+        }
+        var traceCount = 0
+        let traceTime = try measure {
+            traceCount = try tracer.trace(ast: body).count
+        }
+        stdout.write(
+            String(
+                format: "Enumerating %@ paths took %g seconds, %.1fx as long\n",
+                formatDecimal(value: UInt(traceCount)),
+                traceTime,
+                traceTime / max(reachabilityTime, .leastNonzeroMagnitude)
+            )
+        )
+    }
+
+    // Run the program to completion, taking a snapshot every `interval` cycles
+    // with both NSKeyedArchiver and ComputerSnapshot. Restoring is measured
+    // by going back to the snapshot taken one interval earlier.
+    func runSnapshotBenchmark(_ computer: TurtleComputer, interval: UInt) {
+        var count = 0
+        var archivedByteCount = 0
+        var archiveTime: TimeInterval = 0
+        var decodeTime: TimeInterval = 0
+        var pagedByteCount = 0
+        var pagedSnapshotTime: TimeInterval = 0
+        var pagedRestoreTime: TimeInterval = 0
+        var previous = computer.makeSnapshot()
+        pagedByteCount += previous.byteCount
+
+        stdout.write(
+            "Running the program with a snapshot every \(formatDecimal(value: interval)) cycles...\n"
+        )
+        while !computer.isHalted {
+            _ = computer.run(cycles: interval)
+            count += 1
+
+            var data = Data()
+            archiveTime += try! measure {
+                data = computer.snapshot()
+            }
+            archivedByteCount += data.count
+            decodeTime += try! measure {
+                _ = try TurtleComputer.decode(from: data)
+            }
+
+            var snapshot = previous
+            pagedSnapshotTime += try! measure {
+                snapshot = computer.makeSnapshot()
+            }
+            pagedByteCount += snapshot.byteCount
+            pagedRestoreTime += try! measure {
+                computer.restore(from: previous)
+            }
+            computer.restore(from: snapshot)
+            previous = snapshot
+        }
+
+        let n = Double(max(count, 1))
+        stdout.write(
+            String(
+                format: """
+                    Took %d snapshots over %@ cycles
+                    NSKeyedArchiver:  %10.6f s per snapshot  %10.6f s per decode  %@ bytes in total
+                    ComputerSnapshot: %10.6f s per snapshot  %10.6f s per restore %@ bytes in total
+
+                    """,
+                count,
+                formatDecimal(value: computer.timeStamp),
+                archiveTime / n,
+                decodeTime / n,
+                formatDecimal(value: UInt(archivedByteCount)),
+                pagedSnapshotTime / n,
+                pagedRestoreTime / n,
+                formatDecimal(value: UInt(pagedByteCount))
+            )
+        )
+    }
+
+    func writeRegisterAllocationReport(_ report: RegisterAllocatorDriver.Report) {
+        stdout.write(
+            String(
+                format: "Register allocation took %g seconds over %d subroutines\n",
+                report.totalElapsedTime,
+                report.entries.count
+            )
+        )
+        let slowest = report.entries.sorted { $0.elapsedTime > $1.elapsedTime }.prefix(10)
+        for entry in slowest {
+            stdout.write(
+                String(
+                    format: "  %10.6f s  %6d nodes  %6d intervals  %2d passes  %@\n",
+                    entry.elapsedTime,
+                    entry.nodeCount,
+                    entry.liveIntervalCount,
+                    entry.allocationCount,
+                    entry.identifier ?? "<top level>"
+                )
+            )
+        }
+        let spillLoads = report.entries.reduce(0) { $0 + $1.spillLoadCount }
+        let spillStores = report.entries.reduce(0) { $0 + $1.spillStoreCount }
+        // Linear scan's figures are unavailable if it failed on any subroutine.
+        let linearScanEntries = report.entries.compactMap { entry in
+            entry.linearScanSpillLoadCount.flatMap { loads in
+                entry.linearScanSpillStoreCount.map { stores in (loads, stores) }
+            }
+        }
+        let linearScan =
+            if linearScanEntries.count == report.entries.count {
+                String(
+                    format: "%d loads, %d stores",
+                    linearScanEntries.reduce(0) { $0 + $1.0 },
+                    linearScanEntries.reduce(0) { $0 + $1.1 }
+                )
+            }
+            else {
+                "unavailable"
+            }
+        stdout.write(
+            String(
+                format: "Spill code: %d loads, %d stores (linear scan: %@)\n",
+                spillLoads,
+                spillStores,
+                linearScan
+            )
+        )
+    }
+
+    func writeInstructionSchedulingReport(_ report: InstructionScheduler.Report) {
+        let jumpsRemoved = report.entries.reduce(0) { $0 + $1.jumpsRemoved }
+        let loopsRotated = report.entries.reduce(0) { $0 + $1.loopsRotated }
+        stdout.write(
+            String(
+                format: "Instruction scheduling took %g seconds over %d subroutines\n",
+                report.totalElapsedTime,
+                report.entries.count
+            )
+        )
+        stdout.write(
+            String(
+                format: "Estimated stall cycles went from %d to %d. Removed %d jumps and rotated %d loops\n",
+                report.totalStallCyclesBefore,
+                report.totalStallCyclesAfter,
+                jumpsRemoved,
+                loopsRotated
+            )
+        )
+        let mostImproved = report.entries
+            .sorted {
+                ($0.stallCyclesBefore - $0.stallCyclesAfter) > ($1.stallCyclesBefore - $1.stallCyclesAfter)
+            }
+            .prefix(10)
+        for entry in mostImproved {
+            stdout.write(
+                String(
+                    format: "  %6d instructions  %5d -> %5d stall cycles  %@\n",
+                    entry.instructionCount,
+                    entry.stallCyclesBefore,
+                    entry.stallCyclesAfter,
+                    entry.identifier ?? "<top level>"
+                )
+            )
+        }
+    }
+
+    func writePeepholeReport(_ report: PeepholeOptimizer.Report, instructionWordCount: Int) {
+        stdout.write(
+            String(
+                format: "Peephole optimization took %g seconds and removed %d of %d instructions. The program is %@ instruction words\n",
+                report.elapsedTime,
+                report.instructionCountBefore - report.instructionCountAfter,
+                report.instructionCountBefore,
+                formatDecimal(value: UInt(instructionWordCount))
+            )
+        )
+        var hitsByName: [String: (hits: Int, instructionsRemoved: Int)] = [:]
+        var names: [String] = []
+        for entry in report.entries {
+            if hitsByName[entry.name] == nil {
+                names.append(entry.name)
+            }
+            let previous = hitsByName[entry.name] ?? (0, 0)
+            hitsByName[entry.name] = (
+                previous.hits + entry.hits,
+                previous.instructionsRemoved + entry.instructionsRemoved
+            )
+        }
+        for name in names {
+            let (hits, instructionsRemoved) = hitsByName[name]!
+            stdout.write(
+                String(
+                    format: "  %6d hits  %6d instructions removed  %@\n",
+                    hits,
+                    instructionsRemoved,
+                    name
+                )
+            )
+        }
+    }
+
+    func writeInliningReport(
+        _ report: TackInliner.Report,
+        leafFrameReport: LeafFrameEliminator.Report
+    ) {
+        let instructionsCopied = report.entries.reduce(0) { $0 + $1.instructionCount }
+        stdout.write(
+            String(
+                format: "Inlined %d calls, copying %d Tack instructions\n",
+                report.entries.count,
+                instructionsCopied
+            )
+        )
+        var callsByCallee: [String: Int] = [:]
+        var callees: [String] = []
+        for entry in report.entries {
+            if callsByCallee[entry.callee] == nil {
+                callees.append(entry.callee)
+            }
+            callsByCallee[entry.callee, default: 0] += 1
+        }
+        for callee in callees {
+            stdout.write(String(format: "  %6d calls  %@\n", callsByCallee[callee]!, callee))
+        }
+        stdout.write(
+            String(
+                format: "Removed the stack frame from %d leaf subroutines\n",
+                leafFrameReport.entries.count
+            )
+        )
+        for entry in leafFrameReport.entries {
+            stdout.write(
+                String(
+                    format: "  %6d registers saved  %@\n",
+                    entry.savedRegisterCount,
+                    entry.identifier
+                )
+            )
+        }
+    }
+
+    func turtle16Options() -> SnapToTurtle16Compiler.Options {
+        SnapToTurtle16Compiler.Options(
+            runtimeSupport: "runtime_Turtle16",
+            isInstructionSchedulingEnabled: isInstructionSchedulingEnabled,
+            isTackOptimizationEnabled: isTackOptimizationEnabled,
+            isPeepholeOptimizationEnabled: isPeepholeOptimizationEnabled,
+            isInliningEnabled: isInliningEnabled,
+            isLeafFrameEliminationEnabled: isLeafFrameEliminationEnabled,
+            registerAllocator: registerAllocator
+        )
     }
 
     func formatDecimal(value: UInt) -> String {
@@ -209,8 +797,11 @@ class SnapBenchmarkDriver: NSObject {
         for _ in 0..<n {
             let compiler = SnapToTurtle16Compiler()
             elapsedTime += try measure {
-                let options = SnapToTurtle16Compiler.Options(runtimeSupport: "runtime_Turtle16")
-                let program = try compiler.compile(program: programText, base: 0, options: options)
+                let program = try compiler.compile(
+                    program: programText,
+                    base: 0,
+                    options: turtle16Options()
+                )
                 instructions = program.instructions
             }
         }
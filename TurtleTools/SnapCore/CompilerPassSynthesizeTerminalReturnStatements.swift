@@ -50,18 +50,16 @@ public class CompilerPassSynthesizeTerminalReturnStatements: CompilerPassWithDec
             .check(expression: node.functionType)
             .unwrapFunctionType()
         guard functionType.returnType != .void else { return }
-        for trace in try trace(node) {
-            if trace.last != .Return {
-                throw CompilerError(
-                    sourceAnchor: node.identifier.sourceAnchor,
-                    message: "missing return in a function expected to return `\(functionType.returnType)'"
-                )
-            }
+        if try reachability(node).fallsThrough {
+            throw CompilerError(
+                sourceAnchor: node.identifier.sourceAnchor,
+                message: "missing return in a function expected to return `\(functionType.returnType)'"
+            )
         }
     }
 
-    private func trace(_ node: FunctionDeclaration) throws -> [StatementTracer.Trace] {
-        try StatementTracer(symbols: symbols!).trace(ast: node.body)
+    private func reachability(_ node: FunctionDeclaration) throws -> StatementTracer.Reachability {
+        try StatementTracer(symbols: symbols!).reachability(ast: node.body)
     }
 
     private func shouldSynthesizeTerminalReturnStatement(_ node: FunctionDeclaration) throws -> Bool
@@ -70,23 +68,7 @@ public class CompilerPassSynthesizeTerminalReturnStatements: CompilerPassWithDec
             .check(expression: node.functionType)
             .unwrapFunctionType()
         guard functionType.returnType == .void else { return false }
-        let tracer = StatementTracer(symbols: symbols!)
-        let traces = try! tracer.trace(ast: node.body)
-        var allTracesEndInReturnStatement = true
-        for trace in traces {
-            if let last = trace.last {
-                switch last {
-                case .Return:
-                    break
-                default:
-                    allTracesEndInReturnStatement = false
-                }
-            }
-            else {
-                allTracesEndInReturnStatement = false
-            }
-        }
-        return !allTracesEndInReturnStatement
+        return try! reachability(node).fallsThrough
     }
 }
 
@@ -14,9 +14,19 @@ public final class CompilerPassTestDeclaration: CompilerPass {
     var currentTest: TestDeclaration?
     var depth = 0
     let shouldRunSpecificTest: String?
-
-    public init(shouldRunSpecificTest: String? = nil) {
+    let isTestDispatchEnabled: Bool
+
+    /// - Parameters:
+    ///   - shouldRunSpecificTest: If set, the test runner runs only this test
+    ///   - isTestDispatchEnabled: If set, and no specific test is chosen, the
+    ///     test runner includes every test and runs the one whose index in
+    ///     `testNames` is stored in the global `__testSelector`.
+    public init(
+        shouldRunSpecificTest: String? = nil,
+        isTestDispatchEnabled: Bool = false
+    ) {
         self.shouldRunSpecificTest = shouldRunSpecificTest
+        self.isTestDispatchEnabled = isTestDispatchEnabled
     }
 
     public override func visit(block node: Block) throws -> AbstractSyntaxTreeNode? {
@@ -55,6 +65,9 @@ public final class CompilerPassTestDeclaration: CompilerPass {
                     Call(callee: Identifier(kTestMainFunctionName), arguments: [])
                 ]
             }
+            else if isTestDispatchEnabled {
+                children += makeTestDispatch(result.symbols)
+            }
             else {
                 let hasMain = result.children.first(where: {
                     if let functionDeclaration = $0 as? FunctionDeclaration,
@@ -83,6 +96,56 @@ public final class CompilerPassTestDeclaration: CompilerPass {
         return result
     }
 
+    /// The test dispatcher contains every test so that the program may be
+    /// compiled once and then run once per test. The selector has no
+    /// initializer, and so the value stored in memory before the program
+    /// starts is the one which the dispatcher sees.
+    private func makeTestDispatch(_ symbols: Env) -> [AbstractSyntaxTreeNode] {
+        let selector = VarDeclaration(
+            identifier: Identifier(kTestSelectorName),
+            explicitType: PrimitiveType(.u16),
+            expression: nil,
+            storage: .staticStorage(offset: nil),
+            isMutable: true
+        )
+        let fnSymbols = Env(parent: symbols)
+        let bodySymbols = Env(parent: fnSymbols)
+        let cases = testDeclarations.enumerated().map { index, testDeclaration in
+            let caseSymbols = Env(parent: bodySymbols)
+            testDeclaration.body.symbols.parent = caseSymbols
+            return If(
+                condition: Binary(
+                    op: .eq,
+                    left: Identifier(kTestSelectorName),
+                    right: LiteralInt(index)
+                ),
+                then: Block(
+                    symbols: caseSymbols,
+                    children: [
+                        testDeclaration.body,
+                        Call(callee: Identifier("__puts"), arguments: [LiteralString("passed\n")])
+                    ]
+                )
+            )
+        }
+        let testRunnerMain = FunctionDeclaration(
+            identifier: Identifier(kTestMainFunctionName),
+            functionType: FunctionType(
+                name: kTestMainFunctionName,
+                returnType: PrimitiveType(.void),
+                arguments: []
+            ),
+            argumentNames: [],
+            body: Block(symbols: bodySymbols, children: cases),
+            symbols: fnSymbols
+        )
+        return [
+            selector,
+            testRunnerMain,
+            Call(callee: Identifier(kTestMainFunctionName), arguments: [])
+        ]
+    }
+
     public override func visit(testDecl node: TestDeclaration) throws -> AbstractSyntaxTreeNode? {
         guard depth <= 1 else {
             throw CompilerError(
@@ -118,9 +181,13 @@ public extension AbstractSyntaxTreeNode {
     /// Erase test declarations and replace with a synthesized test runner.
     func desugarTestDeclarations(
         testNames: inout [String],
-        shouldRunSpecificTest: String?
+        shouldRunSpecificTest: String?,
+        isTestDispatchEnabled: Bool = false
     ) throws -> AbstractSyntaxTreeNode? {
-        let compiler = CompilerPassTestDeclaration(shouldRunSpecificTest: shouldRunSpecificTest)
+        let compiler = CompilerPassTestDeclaration(
+            shouldRunSpecificTest: shouldRunSpecificTest,
+            isTestDispatchEnabled: isTestDispatchEnabled
+        )
         let result = try compiler.run(self)
         testNames = compiler.testNames
         return result
@@ -0,0 +1,192 @@
+//
+//  CompilerPhaseReport.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+
+/// Collects the wall time, AST node counts, and peak memory of each phase of
+/// the compiler, in the order in which the phases run.
+public final class CompilerPhaseReport {
+    public struct Entry: Equatable, Codable {
+        /// The name of the phase, e.g., "parse" or "typeCheck"
+        public let name: String
+
+        /// Wall-clock time spent, in seconds
+        public let elapsedTime: TimeInterval
+
+        /// The number of nodes in the input tree, if the input is a tree
+        public let nodeCountBefore: Int?
+
+        /// The number of nodes in the output tree, if the output is a tree
+        public let nodeCountAfter: Int?
+
+        /// The peak resident memory of the process at the end of the phase,
+        /// in bytes
+        public let peakMemory: Int
+    }
+
+    public private(set) var entries: [Entry] = []
+
+    /// Counting nodes walks the whole tree so remember the count of the last
+    /// output and reuse it when that same tree is the input to the next phase.
+    private weak var lastCountedNode: AbstractSyntaxTreeNode?
+    private var lastCount = 0
+
+    public init() {}
+
+    public var totalElapsedTime: TimeInterval {
+        entries.reduce(0) { $0 + $1.elapsedTime }
+    }
+
+    public var peakMemory: Int {
+        entries.map(\.peakMemory).max() ?? 0
+    }
+
+    /// Run the phase and record an entry for it. The time spent counting nodes
+    /// is not included in the elapsed time of the phase.
+    public func measure<T>(
+        _ name: String,
+        nodeCountBefore: Int? = nil,
+        nodeCountAfter: (T) -> Int? = { _ in nil },
+        _ body: () throws -> T
+    ) rethrows -> T {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        let result = try body()
+        let endTime = DispatchTime.now().uptimeNanoseconds
+        entries.append(
+            Entry(
+                name: name,
+                elapsedTime: TimeInterval(endTime - startTime) / 1.0e9,
+                nodeCountBefore: nodeCountBefore,
+                nodeCountAfter: nodeCountAfter(result),
+                peakMemory: CompilerPhaseReport.currentPeakMemory()
+            )
+        )
+        return result
+    }
+
+    /// Run a phase which transforms an abstract syntax tree
+    public func measure(
+        _ name: String,
+        _ node: AbstractSyntaxTreeNode,
+        _ body: (AbstractSyntaxTreeNode) throws -> AbstractSyntaxTreeNode?
+    ) rethrows -> AbstractSyntaxTreeNode? {
+        try measure(
+            name,
+            nodeCountBefore: nodeCount(node),
+            nodeCountAfter: { $0.map(self.nodeCount) },
+            { try body(node) }
+        )
+    }
+
+    /// Count the nodes in the given tree
+    public func nodeCount(_ node: AbstractSyntaxTreeNode) -> Int {
+        if lastCountedNode === node {
+            return lastCount
+        }
+        let counter = NodeCounter()
+        _ = try? counter.run(node)
+        lastCountedNode = node
+        lastCount = counter.count
+        return counter.count
+    }
+
+    /// A table of the phases, one per line, suitable for printing
+    public var listing: String {
+        let nameWidth = entries.map(\.name.count).max() ?? 0
+        var result = ""
+        for entry in entries {
+            let name = entry.name.padding(toLength: nameWidth, withPad: " ", startingAt: 0)
+            let nodes: String =
+                switch (entry.nodeCountBefore, entry.nodeCountAfter) {
+                case let (before?, after?):
+                    "\(before) -> \(after) nodes"
+                case let (nil, after?):
+                    "\(after) nodes"
+                case let (before?, nil):
+                    "\(before) nodes"
+                case (nil, nil):
+                    ""
+                }
+            result += String(
+                format: "%@  %10.6f s  %5.1f%%  %8.1f MB  %@\n",
+                name,
+                entry.elapsedTime,
+                100.0 * entry.elapsedTime / max(totalElapsedTime, .leastNonzeroMagnitude),
+                Double(entry.peakMemory) / 1_048_576.0,
+                nodes
+            )
+        }
+        result += String(
+            format: "%@  %10.6f s  peak memory %.1f MB\n",
+            "total".padding(toLength: nameWidth, withPad: " ", startingAt: 0),
+            totalElapsedTime,
+            Double(peakMemory) / 1_048_576.0
+        )
+        return result
+    }
+
+    /// The entries encoded as a JSON document
+    public func jsonRepresentation() throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        return try encoder.encode(entries)
+    }
+
+    /// The high-water mark of resident memory for the process, in bytes
+    static func currentPeakMemory() -> Int {
+        var usage = rusage()
+        guard getrusage(RUSAGE_SELF, &usage) == 0 else {
+            return 0
+        }
+        #if os(Linux)
+            return Int(usage.ru_maxrss) * 1024 // Linux reports in kilobytes
+        #else
+            return Int(usage.ru_maxrss)
+        #endif
+    }
+}
+
+/// Counts statement and expression nodes by walking the tree with the default
+/// behavior of CompilerPass, which rebuilds every node without changing it.
+private final class NodeCounter: CompilerPass {
+    var count = 0
+
+    override init(_ symbols: Env? = nil) {
+        super.init(symbols)
+        shouldTypeCheckIdentifiers = false
+    }
+
+    override func visit(_ genericNode: AbstractSyntaxTreeNode?) throws -> AbstractSyntaxTreeNode? {
+        // Expressions are counted when visited as such
+        if let genericNode, !(genericNode is Expression) {
+            count += 1
+        }
+        return try super.visit(genericNode)
+    }
+
+    override func visit(expr: Expression) throws -> Expression? {
+        count += 1
+        return try super.visit(expr: expr)
+    }
+}
+
+public extension AbstractSyntaxTreeNode {
+    /// Run the given compiler phase on this node, recording it in the report
+    /// if there is one
+    func phase(
+        _ name: String,
+        _ report: CompilerPhaseReport?,
+        _ body: (AbstractSyntaxTreeNode) throws -> AbstractSyntaxTreeNode?
+    ) rethrows -> AbstractSyntaxTreeNode? {
+        guard let report else {
+            return try body(self)
+        }
+        return try report.measure(name, self, body)
+    }
+}
@@ -0,0 +1,42 @@
+//
+//  ConcurrentMap.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+extension Array {
+    /// Like map(), except that up to `jobs` elements are transformed at once.
+    /// Each worker takes the next unclaimed element until none remain, so a
+    /// few large elements do not hold up the rest. The results are in the same
+    /// order as the input regardless of the order in which they complete. If
+    /// any transform throws then the error rethrown is that of the earliest
+    /// element in the array to fail.
+    public func concurrentMap<T>(jobs: Int, _ transform: (Element) throws -> T) throws -> [T] {
+        guard jobs > 1, count > 1 else {
+            return try map(transform)
+        }
+
+        var results = [Result<T, Error>?](repeating: nil, count: count)
+        let lock = NSLock()
+        var nextIndex = 0
+        results.withUnsafeMutableBufferPointer { buffer in
+            DispatchQueue.concurrentPerform(iterations: Swift.min(jobs, count)) { _ in
+                while true {
+                    lock.lock()
+                    let index = nextIndex
+                    nextIndex += 1
+                    lock.unlock()
+                    guard index < count else {
+                        return
+                    }
+                    buffer[index] = Result { try transform(self[index]) }
+                }
+            }
+        }
+        return try results.map { try $0!.get() }
+    }
+}
@@ -159,7 +159,12 @@ public final class CoreToTackCompiler: CompilerPassWithDeclScan {
             .mangledName! // TODO: Should a function's mangled name also be stored in the AST in the FunctionDeclaration node itself?
         let stackFrame = symbols.frame!
         assert(symbols.frameLookupMode == .set(stackFrame))
+        // Each subroutine runs in a register frame of its own, so its
+        // registers are numbered from zero to keep that frame small.
+        let savedNextRegisterIndex = nextRegisterIndex
+        nextRegisterIndex = 0
         let subroutineBody = try visit(node.body) ?? Seq()
+        nextRegisterIndex = savedNextRegisterIndex
         let sizeOfLocalVariables = stackFrame.storagePointer
         let subroutine = Subroutine(
             sourceAnchor: node.sourceAnchor,
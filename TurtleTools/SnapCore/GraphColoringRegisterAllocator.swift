@@ -0,0 +1,823 @@
+//
+//  GraphColoringRegisterAllocator.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+import TurtleSimulatorCore
+
+/// Assigns physical registers to the virtual registers of one subroutine by
+/// coloring an interference graph
+///
+/// This is the iterated register coalescing allocator of George and Appel,
+/// which extends the simplify and select phases of Chaitin and Briggs.
+/// Liveness is computed over a control flow graph of basic blocks which are
+/// split at labels and branches, so a value which is live around a loop
+/// interferes with everything in the loop and nothing outside of it.
+///
+/// Moves, `ADDI d, s, 0`, are coalesced when the Briggs or George test shows
+/// that this cannot make the graph uncolorable. The move is left in place
+/// as a move to self. The peephole optimizer removes it if the flags are
+/// not needed.
+///
+/// When no node can be simplified, the node with the least spill cost per
+/// edge is chosen as a candidate for spilling. The cost counts each use and
+/// definition, multiplied by ten for each loop around it. A candidate which
+/// cannot be colored is given a slot in the frame, and each reference loads
+/// from or stores to that slot through a new short-lived virtual register.
+/// Allocation then starts over on the rewritten code.
+///
+/// Explicit references to the allocatable physical registers are treated as
+/// precolored nodes. The other physical registers are left alone.
+public struct GraphColoringRegisterAllocator {
+    public struct Allocation {
+        public let children: [AbstractSyntaxTreeNode]
+
+        /// The number of virtual registers in the final interference graph
+        public let virtualRegisterCount: Int
+
+        /// The number of times the graph was built and colored
+        public let roundCount: Int
+    }
+
+    /// Give up if spilling does not converge after this many rounds
+    private let kMaxRounds = 32
+
+    /// Loops nested deeper than this are weighted as if they were not
+    private let kMaxLoopDepth = 4
+
+    private let numRegisters: Int
+    private let physicalRegisters: Set<String>
+
+    /// - Parameter numRegisters: The number of registers available for
+    ///   allocation, beginning with r0
+    public init(numRegisters: Int = 5 /* a default value appropriate to Turtle16 */) {
+        self.numRegisters = numRegisters
+        physicalRegisters = Set((0..<8).map { "r\($0)" } + ["ra", "sp", "fp"])
+    }
+
+    public func allocate(_ children0: [AbstractSyntaxTreeNode]) throws -> Allocation {
+        var children = children0
+        var spillTemporaries = Set<String>()
+        var roundCount = 0
+        while roundCount < kMaxRounds {
+            roundCount += 1
+            var graph = InterferenceGraph(
+                children: children,
+                numRegisters: numRegisters,
+                physicalRegisters: physicalRegisters,
+                spillTemporaries: spillTemporaries,
+                maxLoopDepth: kMaxLoopDepth
+            )
+            graph.colorNodes()
+            if graph.spilledNodes.isEmpty {
+                return Allocation(
+                    children: rename(children, graph.assignment()),
+                    virtualRegisterCount: graph.virtualRegisterCount,
+                    roundCount: roundCount
+                )
+            }
+            let spilled = graph.spilledNodes.map { graph.names[$0] }
+            children = spill(spilled, children, &spillTemporaries)
+        }
+        throw CompilerError(
+            sourceAnchor: children0.first?.sourceAnchor,
+            message: "Register allocation failed: insufficient physical registers"
+        )
+    }
+
+    private func rename(
+        _ children: [AbstractSyntaxTreeNode],
+        _ assignment: [String: String]
+    ) -> [AbstractSyntaxTreeNode] {
+        children.map { child in
+            var node = child
+            for name in Set(RegisterUtils.getReferencedRegisters(child)) {
+                if let physical = assignment[name] {
+                    node = RegisterUtils.rewrite(node: node, from: name, to: physical)
+                }
+            }
+            return node
+        }
+    }
+
+    /// Give each spilled register a slot in the frame, and load and store it
+    /// around each instruction which refers to it
+    private func spill(
+        _ spilled: [String],
+        _ children0: [AbstractSyntaxTreeNode],
+        _ spillTemporaries: inout Set<String>
+    ) -> [AbstractSyntaxTreeNode] {
+        var children1 = children0
+        if (children1.first as? InstructionNode)?.instruction != kENTER {
+            children1.insert(InstructionNode(instruction: kENTER), at: 0)
+        }
+        let enter = children1[0] as! InstructionNode
+        let oldSizeOnEnter = (enter.parameters.first as? ParameterNumber)?.value ?? 0
+        children1[0] = InstructionNode(
+            sourceAnchor: enter.sourceAnchor,
+            instruction: kENTER,
+            parameter: ParameterNumber(oldSizeOnEnter + spilled.count)
+        )
+        var offsets: [String: Int] = [:]
+        for (slot, name) in spilled.enumerated() {
+            offsets[name] = -(oldSizeOnEnter + slot + 1)
+        }
+
+        var children2: [AbstractSyntaxTreeNode] = []
+        for child in children1 {
+            var node = child
+            var prefix: [AbstractSyntaxTreeNode] = []
+            var postfix: [AbstractSyntaxTreeNode] = []
+            let (defs, uses) = Self.definitionsAndUses(child)
+            for name in spilled where defs.contains(name) || uses.contains(name) {
+                let temporary = "\(name)_\(spillTemporaries.count)"
+                spillTemporaries.insert(temporary)
+                node = RegisterUtils.rewrite(node: node, from: name, to: temporary)
+                if uses.contains(name) {
+                    prefix += spillCode(kLOAD, temporary, offsets[name]!, child.sourceAnchor)
+                }
+                if defs.contains(name) {
+                    postfix += spillCode(kSTORE, temporary, offsets[name]!, child.sourceAnchor)
+                }
+            }
+            children2 += prefix + [node] + postfix
+        }
+        return children2
+    }
+
+    private func spillCode(
+        _ instruction: String,
+        _ register: String,
+        _ offset: Int,
+        _ sourceAnchor: SourceAnchor?
+    ) -> [AbstractSyntaxTreeNode] {
+        let fp = ParameterIdentifier("fp")
+        let ra = ParameterIdentifier("ra")
+        let temporary = ParameterIdentifier(register)
+        guard offset < -16 else {
+            return [
+                InstructionNode(
+                    sourceAnchor: sourceAnchor,
+                    instruction: instruction,
+                    parameters: [temporary, fp, ParameterNumber(offset)]
+                )
+            ]
+        }
+
+        // The offset does not fit in the instruction so compute the address
+        // in `ra', which is saved by ENTER.
+        var address: [AbstractSyntaxTreeNode] = [
+            InstructionNode(
+                sourceAnchor: sourceAnchor,
+                instruction: kLI,
+                parameters: [ra, ParameterNumber(offset >= Int8.min ? offset : offset & 0x00ff)]
+            )
+        ]
+        if offset < Int8.min {
+            address.append(
+                InstructionNode(
+                    sourceAnchor: sourceAnchor,
+                    instruction: kLUI,
+                    parameters: [ra, ParameterNumber((offset >> 8) & 0x00ff)]
+                )
+            )
+        }
+        return address + [
+            InstructionNode(sourceAnchor: sourceAnchor, instruction: kADD, parameters: [ra, ra, fp]),
+            InstructionNode(
+                sourceAnchor: sourceAnchor,
+                instruction: instruction,
+                parameters: [temporary, ra, ParameterNumber(0)]
+            )
+        ]
+    }
+
+    /// The registers written and read by the node
+    ///
+    /// LUI replaces only the upper byte of its destination, so the old value
+    /// is read too. JR and CALLPTR read the register which holds the target.
+    fileprivate static func definitionsAndUses(
+        _ node: AbstractSyntaxTreeNode
+    ) -> (defs: [String], uses: [String]) {
+        guard let instruction = node as? InstructionNode else {
+            return ([], [])
+        }
+        switch instruction.instruction {
+        case kJR, kCALLPTR:
+            return ([], RegisterUtils.getReferencedRegisters(node))
+
+        case kLUI:
+            let destinations = RegisterUtils.getDestinationRegisters(node)
+            return (destinations, destinations)
+
+        default:
+            return (
+                RegisterUtils.getDestinationRegisters(node),
+                RegisterUtils.getSourceRegisters(node)
+            )
+        }
+    }
+}
+
+/// The interference graph of one round of allocation, and the state of the
+/// worklists used to color it
+///
+/// Nodes are numbered with the precolored registers first, so that the
+/// number of a precolored node is also its color.
+private struct InterferenceGraph {
+    enum NodeState {
+        case precolored
+        case initial
+        case simplify
+        case freeze
+        case spill
+        case spilled
+        case coalesced
+        case colored
+        case selected
+    }
+
+    enum MoveState {
+        case worklist
+        case active
+        case coalesced
+        case constrained
+        case frozen
+    }
+
+    let K: Int
+    private(set) var names: [String] = []
+    private var numbers: [String: Int] = [:]
+    private var state: [NodeState] = []
+    private var adjacentPairs = Set<Int>()
+    private var adjacencyList: [[Int]] = []
+    private var degree: [Int] = []
+    private var spillCost: [Double] = []
+    private var alias: [Int] = []
+    private var colors: [Int?] = []
+    private var moves: [(dst: Int, src: Int)] = []
+    private var moveState: [MoveState] = []
+    private var moveList: [[Int]] = []
+    private var simplifyWorklist = OrderedWorklist()
+    private var freezeWorklist = OrderedWorklist()
+    private var spillWorklist = Set<Int>()
+    private var worklistMoves = OrderedWorklist()
+    private var selectStack: [Int] = []
+    private(set) var spilledNodes: [Int] = []
+
+    var virtualRegisterCount: Int {
+        names.count - K
+    }
+
+    init(
+        children: [AbstractSyntaxTreeNode],
+        numRegisters: Int,
+        physicalRegisters: Set<String>,
+        spillTemporaries: Set<String>,
+        maxLoopDepth: Int
+    ) {
+        K = numRegisters
+        for i in 0..<K {
+            addNode("r\(i)", state: .precolored)
+            colors[i] = i
+        }
+
+        // Number the registers and find the registers of each instruction.
+        var defs: [[Int]] = []
+        var uses: [[Int]] = []
+        for child in children {
+            let (d, u) = GraphColoringRegisterAllocator.definitionsAndUses(child)
+            var nodeDefs: [Int] = []
+            var nodeUses: [Int] = []
+            for name in d {
+                if let n = number(name, physicalRegisters) {
+                    nodeDefs.append(n)
+                }
+            }
+            for name in u {
+                if let n = number(name, physicalRegisters) {
+                    nodeUses.append(n)
+                }
+            }
+            defs.append(nodeDefs)
+            uses.append(nodeUses)
+        }
+        for (name, n) in numbers where spillTemporaries.contains(name) {
+            spillCost[n] = .infinity
+        }
+
+        let cfg = ControlFlowGraph(children)
+        let liveOut = cfg.liveOut(defs: defs, uses: uses)
+        build(children, cfg, liveOut, defs, uses, maxLoopDepth)
+    }
+
+    private mutating func addNode(_ name: String, state nodeState: NodeState) {
+        numbers[name] = names.count
+        alias.append(names.count)
+        names.append(name)
+        state.append(nodeState)
+        adjacencyList.append([])
+        degree.append(nodeState == .precolored ? Int.max / 2 : 0)
+        spillCost.append(0)
+        colors.append(nil)
+        moveList.append([])
+    }
+
+    /// The node for the register, or nil if the register is not allocated
+    private mutating func number(_ name: String, _ physicalRegisters: Set<String>) -> Int? {
+        if let n = numbers[name] {
+            return n
+        }
+        guard !physicalRegisters.contains(name) else {
+            return nil
+        }
+        addNode(name, state: .initial)
+        return names.count - 1
+    }
+
+    private func isPrecolored(_ n: Int) -> Bool {
+        n < K
+    }
+
+    private mutating func build(
+        _ children: [AbstractSyntaxTreeNode],
+        _ cfg: ControlFlowGraph,
+        _ liveOut: [Set<Int>],
+        _ defs: [[Int]],
+        _ uses: [[Int]],
+        _ maxLoopDepth: Int
+    ) {
+        for (b, block) in cfg.blocks.enumerated() {
+            let weight = pow(10, Double(min(block.loopDepth, maxLoopDepth)))
+            var live = liveOut[b]
+            for i in block.range.reversed() {
+                for n in defs[i] + uses[i] {
+                    spillCost[n] += weight
+                }
+                if let instruction = children[i] as? InstructionNode,
+                   instruction.instruction == kADDI,
+                   (instruction.parameters.last as? ParameterNumber)?.value == 0,
+                   defs[i].count == 1,
+                   uses[i].count == 1
+                {
+                    live.subtract(uses[i])
+                    let m = moves.count
+                    moves.append((dst: defs[i][0], src: uses[i][0]))
+                    moveState.append(.worklist)
+                    worklistMoves.insert(m)
+                    for n in Set(defs[i] + uses[i]) {
+                        moveList[n].append(m)
+                    }
+                }
+                live.formUnion(defs[i])
+                for d in defs[i] {
+                    for l in live.sorted() {
+                        addEdge(l, d)
+                    }
+                }
+                live.subtract(defs[i])
+                live.formUnion(uses[i])
+            }
+        }
+    }
+
+    private mutating func addEdge(_ u: Int, _ v: Int) {
+        guard u != v, !adjacentPairs.contains(u * names.count + v) else {
+            return
+        }
+        adjacentPairs.insert(u * names.count + v)
+        adjacentPairs.insert(v * names.count + u)
+        if !isPrecolored(u) {
+            adjacencyList[u].append(v)
+            degree[u] += 1
+        }
+        if !isPrecolored(v) {
+            adjacencyList[v].append(u)
+            degree[v] += 1
+        }
+    }
+
+    private func isAdjacent(_ u: Int, _ v: Int) -> Bool {
+        adjacentPairs.contains(u * names.count + v)
+    }
+
+    private func adjacent(_ n: Int) -> [Int] {
+        adjacencyList[n].filter { state[$0] != .selected && state[$0] != .coalesced }
+    }
+
+    private func nodeMoves(_ n: Int) -> [Int] {
+        moveList[n].filter { moveState[$0] == .active || moveState[$0] == .worklist }
+    }
+
+    private func isMoveRelated(_ n: Int) -> Bool {
+        !nodeMoves(n).isEmpty
+    }
+
+    private func getAlias(_ n: Int) -> Int {
+        var n = n
+        while state[n] == .coalesced {
+            n = alias[n]
+        }
+        return n
+    }
+
+    /// Move the node to the given state, and onto the worklist of that state
+    private mutating func setState(_ n: Int, _ nodeState: NodeState) {
+        guard state[n] != nodeState else {
+            return
+        }
+        if state[n] == .spill {
+            spillWorklist.remove(n)
+        }
+        state[n] = nodeState
+        switch nodeState {
+        case .simplify:
+            simplifyWorklist.insert(n)
+        case .freeze:
+            freezeWorklist.insert(n)
+        case .spill:
+            spillWorklist.insert(n)
+        default:
+            break
+        }
+    }
+
+    /// Move the move to the given state, and onto the worklist if it may be
+    /// coalesced
+    private mutating func setMoveState(_ m: Int, _ newState: MoveState) {
+        guard moveState[m] != newState else {
+            return
+        }
+        moveState[m] = newState
+        if newState == .worklist {
+            worklistMoves.insert(m)
+        }
+    }
+
+    mutating func colorNodes() {
+        for n in K..<names.count {
+            let nodeState: NodeState =
+                if degree[n] >= K {
+                    .spill
+                }
+                else if isMoveRelated(n) {
+                    .freeze
+                }
+                else {
+                    .simplify
+                }
+            setState(n, nodeState)
+        }
+        while true {
+            if let n = simplifyWorklist.popFirst(in: state, .simplify) {
+                simplify(n)
+            }
+            else if let m = worklistMoves.popFirst(in: moveState, .worklist) {
+                coalesce(m)
+            }
+            else if let n = freezeWorklist.popFirst(in: state, .freeze) {
+                freeze(n)
+            }
+            else if !spillWorklist.isEmpty {
+                selectSpill()
+            }
+            else {
+                break
+            }
+        }
+        assignColors()
+    }
+
+    private mutating func simplify(_ n: Int) {
+        setState(n, .selected)
+        selectStack.append(n)
+        for m in adjacent(n) {
+            decrementDegree(m)
+        }
+    }
+
+    private mutating func decrementDegree(_ m: Int) {
+        let d = degree[m]
+        degree[m] = d - 1
+        if d == K, !isPrecolored(m) {
+            enableMoves([m] + adjacent(m))
+            if state[m] == .spill {
+                setState(m, isMoveRelated(m) ? .freeze : .simplify)
+            }
+        }
+    }
+
+    private mutating func enableMoves(_ nodes: [Int]) {
+        for n in nodes {
+            for m in nodeMoves(n) where moveState[m] == .active {
+                setMoveState(m, .worklist)
+            }
+        }
+    }
+
+    private mutating func addWorkList(_ u: Int) {
+        if state[u] == .freeze, !isMoveRelated(u), degree[u] < K {
+            setState(u, .simplify)
+        }
+    }
+
+    /// George's test: every significant neighbor of t already interferes
+    /// with the precolored node r
+    private func isOK(_ t: Int, _ r: Int) -> Bool {
+        degree[t] < K || isPrecolored(t) || isAdjacent(t, r)
+    }
+
+    /// Briggs's test: the combined node has fewer than K significant
+    /// neighbors
+    private func isConservative(_ nodes: [Int]) -> Bool {
+        Set(nodes).filter { degree[$0] >= K }.count < K
+    }
+
+    private mutating func coalesce(_ m: Int) {
+        let x = getAlias(moves[m].dst)
+        let y = getAlias(moves[m].src)
+        let (u, v) = isPrecolored(y) ? (y, x) : (x, y)
+        if u == v {
+            setMoveState(m, .coalesced)
+            addWorkList(u)
+        }
+        else if isPrecolored(v) || isAdjacent(u, v) {
+            setMoveState(m, .constrained)
+            addWorkList(u)
+            addWorkList(v)
+        }
+        else if isPrecolored(u)
+            ? adjacent(v).allSatisfy({ isOK($0, u) })
+            : isConservative(adjacent(u) + adjacent(v))
+        {
+            setMoveState(m, .coalesced)
+            combine(u, v)
+            addWorkList(u)
+        }
+        else {
+            setMoveState(m, .active)
+        }
+    }
+
+    private mutating func combine(_ u: Int, _ v: Int) {
+        setState(v, .coalesced)
+        alias[v] = u
+        moveList[u] += moveList[v]
+        spillCost[u] += spillCost[v]
+        enableMoves([v])
+        for t in adjacent(v) {
+            addEdge(t, u)
+            decrementDegree(t)
+        }
+        if degree[u] >= K, state[u] == .freeze {
+            setState(u, .spill)
+        }
+    }
+
+    private mutating func freeze(_ u: Int) {
+        setState(u, .simplify)
+        freezeMoves(u)
+    }
+
+    private mutating func freezeMoves(_ u: Int) {
+        for m in nodeMoves(u) {
+            let x = moves[m].dst
+            let y = moves[m].src
+            let v = getAlias(y) == getAlias(u) ? getAlias(x) : getAlias(y)
+            setMoveState(m, .frozen)
+            if state[v] == .freeze, !isMoveRelated(v), degree[v] < K {
+                setState(v, .simplify)
+            }
+        }
+    }
+
+    /// Pick the node which is cheapest to spill for each edge it would
+    /// remove from the graph, breaking ties by the lowest number
+    private mutating func selectSpill() {
+        var best: Int?
+        for n in spillWorklist {
+            guard let b = best else {
+                best = n
+                continue
+            }
+            let cost = spillCost[n] / Double(degree[n])
+            let bestCost = spillCost[b] / Double(degree[b])
+            if cost < bestCost || (cost == bestCost && n < b) {
+                best = n
+            }
+        }
+        let m = best!
+        setState(m, .simplify)
+        freezeMoves(m)
+    }
+
+    private mutating func assignColors() {
+        while let n = selectStack.popLast() {
+            var okColors = Set(0..<K)
+            for w in adjacencyList[n] {
+                let a = getAlias(w)
+                if state[a] == .colored || state[a] == .precolored, let c = colors[a] {
+                    okColors.remove(c)
+                }
+            }
+            if let c = okColors.min() {
+                setState(n, .colored)
+                colors[n] = c
+            }
+            else {
+                setState(n, .spilled)
+                spilledNodes.append(n)
+            }
+        }
+        for n in K..<names.count where state[n] == .coalesced {
+            colors[n] = colors[getAlias(n)]
+        }
+        spilledNodes.sort()
+    }
+
+    /// The physical register assigned to each virtual register
+    func assignment() -> [String: String] {
+        var result: [String: String] = [:]
+        for n in K..<names.count {
+            if let c = colors[n] {
+                result[names[n]] = "r\(c)"
+            }
+        }
+        return result
+    }
+}
+
+/// A worklist of node or move numbers which always yields the lowest number
+/// first, so that the allocation does not depend on the order of a set
+///
+/// A number stays in the heap when it leaves the state of the worklist, and
+/// is skipped once it comes to the top, so that a change of state is cheap.
+private struct OrderedWorklist {
+    private var heap: [Int] = []
+
+    mutating func insert(_ i: Int) {
+        heap.append(i)
+        var child = heap.count - 1
+        while child > 0 {
+            let parent = (child - 1) / 2
+            guard heap[child] < heap[parent] else {
+                break
+            }
+            heap.swapAt(child, parent)
+            child = parent
+        }
+    }
+
+    /// Remove and return the lowest number which is still in the given state
+    mutating func popFirst<State: Equatable>(in states: [State], _ state: State) -> Int? {
+        while let i = heap.first {
+            removeFirst()
+            if states[i] == state {
+                return i
+            }
+        }
+        return nil
+    }
+
+    private mutating func removeFirst() {
+        let last = heap.removeLast()
+        guard !heap.isEmpty else {
+            return
+        }
+        heap[0] = last
+        var parent = 0
+        while true {
+            let left = 2 * parent + 1
+            let right = left + 1
+            var smallest = parent
+            if left < heap.count, heap[left] < heap[smallest] {
+                smallest = left
+            }
+            if right < heap.count, heap[right] < heap[smallest] {
+                smallest = right
+            }
+            guard smallest != parent else {
+                return
+            }
+            heap.swapAt(parent, smallest)
+            parent = smallest
+        }
+    }
+}
+
+/// The basic blocks of a list of nodes and the edges between them
+private struct ControlFlowGraph {
+    struct Block {
+        let range: Range<Int>
+        var successors: [Int] = []
+
+        /// The number of loops which contain the block
+        var loopDepth = 0
+    }
+
+    private static let conditionalBranches: Set<String> = [
+        kBEQ, kBNE, kBLT, kBGT, kBLTU, kBGTU
+    ]
+
+    private static let terminators: Set<String> = [kJMP, kRET, kHLT, kJR]
+
+    private(set) var blocks: [Block] = []
+
+    init(_ children: [AbstractSyntaxTreeNode]) {
+        // A block begins at each label and after each jump or branch.
+        var leaders: [Int] = children.isEmpty ? [] : [0]
+        for (i, child) in children.enumerated() {
+            if child is LabelDeclaration, i != leaders.last {
+                leaders.append(i)
+            }
+            if let node = child as? InstructionNode,
+               Self.terminators.contains(node.instruction)
+               || Self.conditionalBranches.contains(node.instruction),
+               i + 1 < children.count
+            {
+                leaders.append(i + 1)
+            }
+        }
+        for (j, leader) in leaders.enumerated() {
+            let end = j + 1 < leaders.count ? leaders[j + 1] : children.count
+            blocks.append(Block(range: leader..<end))
+        }
+
+        var blockOfLabel: [String: Int] = [:]
+        for (b, block) in blocks.enumerated() {
+            if let label = children[block.range.first!] as? LabelDeclaration {
+                blockOfLabel[label.identifier] = b
+            }
+        }
+        for b in blocks.indices {
+            let last = children[blocks[b].range.last!] as? InstructionNode
+            let instruction = last?.instruction ?? ""
+            let target = (last?.parameters.first as? ParameterIdentifier)
+                .flatMap { blockOfLabel[$0.value] }
+            let fallthrough = b + 1 < blocks.count ? b + 1 : nil
+            blocks[b].successors =
+                if instruction == kJMP {
+                    [target].compactMap { $0 }
+                }
+                else if Self.conditionalBranches.contains(instruction) {
+                    [target, fallthrough].compactMap { $0 }
+                }
+                else if Self.terminators.contains(instruction) {
+                    []
+                }
+                else {
+                    [fallthrough].compactMap { $0 }
+                }
+        }
+
+        // A branch back to an earlier block closes a loop over every block
+        // in between.
+        for b in blocks.indices {
+            for s in blocks[b].successors where s <= b {
+                for i in s...b {
+                    blocks[i].loopDepth += 1
+                }
+            }
+        }
+    }
+
+    /// The registers live on exit from each block
+    func liveOut(defs: [[Int]], uses: [[Int]]) -> [Set<Int>] {
+        var blockUses: [Set<Int>] = []
+        var blockDefs: [Set<Int>] = []
+        for block in blocks {
+            var u = Set<Int>()
+            var d = Set<Int>()
+            for i in block.range {
+                u.formUnion(uses[i].filter { !d.contains($0) })
+                d.formUnion(defs[i])
+            }
+            blockUses.append(u)
+            blockDefs.append(d)
+        }
+
+        var liveIn = [Set<Int>](repeating: [], count: blocks.count)
+        var liveOut = [Set<Int>](repeating: [], count: blocks.count)
+        var changed = true
+        while changed {
+            changed = false
+            for b in blocks.indices.reversed() {
+                let out = blocks[b].successors.reduce(into: Set<Int>()) {
+                    $0.formUnion(liveIn[$1])
+                }
+                let live = blockUses[b].union(out.subtracting(blockDefs[b]))
+                if out != liveOut[b] || live != liveIn[b] {
+                    liveOut[b] = out
+                    liveIn[b] = live
+                    changed = true
+                }
+            }
+        }
+        return liveOut
+    }
+}
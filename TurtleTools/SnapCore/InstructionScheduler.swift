@@ -0,0 +1,765 @@
+//
+//  InstructionScheduler.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+import TurtleSimulatorCore
+
+/// Reorders instructions to avoid Turtle16 pipeline stalls, and lays out
+/// branches so that the hot path falls through.
+///
+/// This runs after register allocation, on one subroutine at a time. Each run
+/// of straight-line code is list scheduled against PipelineHazardModel. An
+/// instruction moves only where its dependencies through registers, flags,
+/// and memory allow it. A run keeps its original order unless the new order
+/// is estimated to take fewer cycles.
+///
+/// Before scheduling, branches are laid out so that fewer jumps are taken:
+/// a jump to the next instruction is removed, a conditional branch over a
+/// jump is inverted, and a loop whose test is at the top is rotated so that
+/// the test is copied to the bottom and the back edge is one branch.
+public struct InstructionScheduler {
+    /// Collects statistics on instruction scheduling for each subroutine
+    public final class Report {
+        public struct Entry: Equatable {
+            /// The subroutine identifier, or nil for the top level
+            public let identifier: String?
+
+            /// The number of instructions before scheduling
+            public let instructionCount: Int
+
+            /// The estimated number of cycles lost to stalls before scheduling
+            public let stallCyclesBefore: Int
+
+            /// The estimated number of cycles lost to stalls after scheduling
+            public let stallCyclesAfter: Int
+
+            /// The number of jumps removed by laying out branches
+            public let jumpsRemoved: Int
+
+            /// The number of loops rotated to put the test at the bottom
+            public let loopsRotated: Int
+
+            /// Wall-clock time spent, in seconds
+            public let elapsedTime: TimeInterval
+        }
+
+        public private(set) var entries: [Entry] = []
+
+        public init() {}
+
+        public var totalElapsedTime: TimeInterval {
+            entries.reduce(0) { $0 + $1.elapsedTime }
+        }
+
+        public var totalStallCyclesBefore: Int {
+            entries.reduce(0) { $0 + $1.stallCyclesBefore }
+        }
+
+        public var totalStallCyclesAfter: Int {
+            entries.reduce(0) { $0 + $1.stallCyclesAfter }
+        }
+
+        fileprivate func append(_ entry: Entry) {
+            entries.append(entry)
+        }
+    }
+
+    /// The largest number of instructions scheduled together. Longer runs of
+    /// straight-line code are split, to bound the cost of the dependency graph.
+    private let kMaxRegionSize = 256
+
+    /// The largest loop test which is copied to the bottom of the loop
+    private let kMaxRotatedInstructions = 4
+
+    private let model: PipelineHazardModel
+    private let jobs: Int
+    private let report: Report?
+
+    /// - Parameters:
+    ///   - model: The pipeline hazards to avoid
+    ///   - jobs: The number of subroutines which may be scheduled at once.
+    ///     The output does not depend on this.
+    ///   - report: If set, statistics for each subroutine are appended here
+    ///     in the order in which the subroutines appear in the program.
+    public init(
+        model: PipelineHazardModel = .turtle16,
+        jobs: Int = 1,
+        report: Report? = nil
+    ) {
+        self.model = model
+        self.jobs = jobs
+        self.report = report
+    }
+
+    public func compile(topLevel topLevel0: TopLevel) throws -> TopLevel {
+        let (children1, entry1) = schedule(identifier: nil, children: topLevel0.children)
+        report?.append(entry1)
+
+        // Subroutines are independent of one another and so they may be
+        // scheduled concurrently.
+        let subroutines = children1.compactMap { $0 as? Subroutine }
+        let scheduledSubroutines = try subroutines.concurrentMap(jobs: jobs) { subroutine in
+            let (children, entry) = schedule(
+                identifier: subroutine.identifier,
+                children: subroutine.children
+            )
+            return (subroutine.withChildren(children), entry)
+        }
+        for (_, entry) in scheduledSubroutines {
+            report?.append(entry)
+        }
+
+        var nextSubroutine = scheduledSubroutines.makeIterator()
+        let children2 = children1.map { child -> AbstractSyntaxTreeNode in
+            guard child is Subroutine else {
+                return child
+            }
+            return nextSubroutine.next()!.0
+        }
+        return TopLevel(sourceAnchor: topLevel0.sourceAnchor, children: children2)
+    }
+
+    public func compile(
+        children children0: [AbstractSyntaxTreeNode]
+    ) -> [AbstractSyntaxTreeNode] {
+        let (children, entry) = schedule(identifier: nil, children: children0)
+        report?.append(entry)
+        return children
+    }
+
+    /// Estimate the number of cycles lost to stalls when the nodes execute
+    /// in the given order
+    public func estimateStallCycles(_ children: [AbstractSyntaxTreeNode]) -> Int {
+        run(children, isReordering: false).stallCycles
+    }
+
+    private func schedule(
+        identifier: String?,
+        children children0: [AbstractSyntaxTreeNode]
+    ) -> ([AbstractSyntaxTreeNode], Report.Entry) {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        let stallCyclesBefore = estimateStallCycles(children0)
+        let (children1, loopsRotated) = rotateLoops(children0)
+        let (children2, jumpsRemoved) = removeJumps(children1)
+        let (children3, stallCyclesAfter) = run(children2, isReordering: true)
+        let elapsedNanoseconds = DispatchTime.now().uptimeNanoseconds - startTime
+        let entry = Report.Entry(
+            identifier: identifier,
+            instructionCount: children0.filter { $0 is InstructionNode }.count,
+            stallCyclesBefore: stallCyclesBefore,
+            stallCyclesAfter: stallCyclesAfter,
+            jumpsRemoved: jumpsRemoved,
+            loopsRotated: loopsRotated,
+            elapsedTime: TimeInterval(elapsedNanoseconds) / 1e9
+        )
+        return (children3, entry)
+    }
+
+    // MARK: - Instructions
+
+    /// An instruction which may be reordered, with the resources it uses
+    private struct Instruction {
+        let node: InstructionNode
+
+        /// The number of hardware instructions emitted for this node
+        let slots: Int
+
+        /// Registers read through the A and B fields, which may stall
+        let reads: [Int]
+
+        /// Registers on whose previous value the instruction depends
+        let dependencyReads: [Int]
+
+        /// The register written, if any
+        let write: Int?
+
+        let writesBackStoreOperand: Bool
+        let setsFlags: Bool
+        let readsFlags: Bool
+        let memory: MemoryAccess?
+    }
+
+    private struct MemoryAccess {
+        let isStore: Bool
+        let base: Int
+        let offset: Int
+    }
+
+    /// The hazards of an instruction which ends a run of straight-line code
+    private struct Boundary {
+        let reads: [Int]
+        let readsFlags: Bool
+        let writesBackStoreOperand: Int?
+        let setsFlags: Bool
+
+        /// Control passes directly to the next node, unless a branch is taken
+        let fallsThrough: Bool
+    }
+
+    private static let reorderableInstructions: Set<String> = [
+        kLOAD, kSTORE, kLI, kLUI, kLA,
+        kCMP, kADD, kSUB, kAND, kOR, kXOR, kNOT,
+        kCMPI, kADDI, kSUBI, kANDI, kORI, kXORI,
+        kADC, kSBC
+    ]
+
+    private static func registerIndex(_ name: String) -> Int? {
+        switch name {
+        case "r0": 0
+        case "r1": 1
+        case "r2": 2
+        case "r3": 3
+        case "r4": 4
+        case "r5", "ra": 5
+        case "r6", "sp": 6
+        case "r7", "fp": 7
+        default: nil
+        }
+    }
+
+    private static func registerIndex(_ parameter: Parameter?) -> Int? {
+        guard let name = (parameter as? ParameterIdentifier)?.value else {
+            return nil
+        }
+        return registerIndex(name)
+    }
+
+    private func decode(_ node: AbstractSyntaxTreeNode) -> Instruction? {
+        guard let node = node as? InstructionNode,
+              InstructionScheduler.reorderableInstructions.contains(node.instruction),
+              let opcode = model.opcode(mnemonic: node.instruction == kLA ? kLI : node.instruction)
+        else {
+            return nil
+        }
+        let sourceNames = RegisterUtils.getSourceRegisters(node)
+        let destinationNames = RegisterUtils.getDestinationRegisters(node)
+        let reads = sourceNames.compactMap { InstructionScheduler.registerIndex($0) }
+        let writes = destinationNames.compactMap { InstructionScheduler.registerIndex($0) }
+        guard reads.count == sourceNames.count,
+              writes.count == destinationNames.count,
+              writes.count <= 1
+        else {
+            // Leave alone anything which is not in physical registers.
+            return nil
+        }
+        let write = writes.first
+
+        // LUI writes only the upper byte of the destination register.
+        let dependencyReads = node.instruction == kLUI ? reads + writes : reads
+
+        let memory: MemoryAccess?
+        switch node.instruction {
+        case kLOAD, kSTORE:
+            guard let base = InstructionScheduler.registerIndex(node.parameters[1]) else {
+                return nil
+            }
+            let offset = node.parameters.count > 2
+                ? (node.parameters[2] as? ParameterNumber)?.value
+                : 0
+            guard let offset else {
+                return nil
+            }
+            memory = MemoryAccess(isStore: node.instruction == kSTORE, base: base, offset: offset)
+
+        default:
+            memory = nil
+        }
+
+        return Instruction(
+            node: node,
+            slots: node.instruction == kLA ? 2 : 1,
+            reads: reads,
+            dependencyReads: dependencyReads,
+            write: write,
+            writesBackStoreOperand: opcode.writesBackStoreOperand,
+            setsFlags: opcode.setsFlags,
+            readsFlags: opcode.readsFlags,
+            memory: memory
+        )
+    }
+
+    /// The hazards of a hardware instruction which is not reordered, or nil
+    /// for a macro instruction or any other node
+    private func boundary(_ node: AbstractSyntaxTreeNode) -> Boundary? {
+        guard let node = node as? InstructionNode else {
+            return nil
+        }
+        let reads: [Parameter?]
+        let writeBack: Parameter?
+        switch node.instruction {
+        case kJR:
+            reads = [node.parameters.first]
+            writeBack = nil
+
+        case kJALR:
+            reads = [node.parameters.dropFirst().first]
+            writeBack = node.parameters.first
+
+        case kCALLPTR:
+            // CALLPTR is JALR with the link in `ra'
+            return Boundary(
+                reads: [node.parameters.first].compactMap { InstructionScheduler.registerIndex($0) },
+                readsFlags: false,
+                writesBackStoreOperand: 5,
+                setsFlags: false,
+                fallsThrough: false
+            )
+
+        default:
+            reads = []
+            writeBack = nil
+        }
+        guard let opcode = model.opcode(mnemonic: node.instruction) else {
+            return nil
+        }
+        return Boundary(
+            reads: reads.compactMap { InstructionScheduler.registerIndex($0) },
+            readsFlags: opcode.readsFlags,
+            writesBackStoreOperand: opcode.writesBackStoreOperand
+                ? InstructionScheduler.registerIndex(writeBack)
+                : nil,
+            setsFlags: opcode.setsFlags,
+            fallsThrough: !opcode.isJump || opcode.readsFlags
+        )
+    }
+
+    // MARK: - Scheduling
+
+    /// Pass over the nodes, scheduling each run of straight-line code, and
+    /// estimate the number of cycles lost to stalls.
+    private func run(
+        _ children: [AbstractSyntaxTreeNode],
+        isReordering: Bool
+    ) -> ([AbstractSyntaxTreeNode], stallCycles: Int) {
+        var result: [AbstractSyntaxTreeNode] = []
+        result.reserveCapacity(children.count)
+        var timeline = PipelineHazardModel.Timeline(model: model)
+        var stallCycles = 0
+        var region: [Instruction] = []
+
+        func flush(_ next: Boundary?) {
+            guard !region.isEmpty else {
+                return
+            }
+            let order = isReordering ? chooseOrder(region, timeline, next) : Array(region.indices)
+            for index in order {
+                issue(region[index], &timeline)
+                result.append(region[index].node)
+            }
+            region.removeAll(keepingCapacity: true)
+        }
+
+        for child in children {
+            if let instruction = decode(child) {
+                if region.count == kMaxRegionSize {
+                    flush(nil)
+                }
+                region.append(instruction)
+                continue
+            }
+
+            let next = boundary(child)
+            flush(next)
+            result.append(child)
+            if let next {
+                timeline.issue(
+                    reads: next.reads,
+                    readsFlags: next.readsFlags,
+                    writesBackStoreOperand: next.writesBackStoreOperand,
+                    setsFlags: next.setsFlags
+                )
+            }
+            if next?.fallsThrough != true {
+                // Control reaches the next node from elsewhere, or after a
+                // call or a macro instruction. Nothing is known about the
+                // instructions in flight.
+                stallCycles += timeline.totalStallCycles
+                timeline = PipelineHazardModel.Timeline(model: model)
+            }
+        }
+        flush(nil)
+        stallCycles += timeline.totalStallCycles
+        return (result, stallCycles)
+    }
+
+    private func issue(_ instruction: Instruction, _ timeline: inout PipelineHazardModel.Timeline) {
+        timeline.issue(
+            reads: instruction.reads,
+            readsFlags: instruction.readsFlags,
+            writesBackStoreOperand: instruction.writesBackStoreOperand ? instruction.write : nil,
+            setsFlags: instruction.setsFlags,
+            slots: instruction.slots
+        )
+    }
+
+    /// The number of cycles from the start of the region to the issue of the
+    /// boundary instruction which follows it, if the region is issued in the
+    /// given order. Instructions after the boundary may read any register, so
+    /// this is at least the time until every register may be read.
+    private func cost(
+        _ region: [Instruction],
+        _ order: [Int],
+        _ timeline0: PipelineHazardModel.Timeline,
+        _ next: Boundary?
+    ) -> Int {
+        var timeline = timeline0
+        for index in order {
+            issue(region[index], &timeline)
+        }
+        let stall = next.map { timeline.stallCycles(reads: $0.reads, readsFlags: $0.readsFlags) } ?? 0
+        return max(timeline.cycle + stall, timeline.settledCycle)
+    }
+
+    /// List schedule the region, returning the new order as indices into the
+    /// region, or the original order if the new one is no faster
+    private func chooseOrder(
+        _ region: [Instruction],
+        _ timeline0: PipelineHazardModel.Timeline,
+        _ next: Boundary?
+    ) -> [Int] {
+        let original = Array(region.indices)
+        guard region.count > 1 else {
+            return original
+        }
+        let graph = DependencyGraph(region, next, model)
+        var predecessorCount = graph.predecessorCount
+        var ready = region.indices.filter { predecessorCount[$0] == 0 }
+        var timeline = timeline0
+        var order: [Int] = []
+        order.reserveCapacity(region.count)
+        while !ready.isEmpty {
+            // Prefer an instruction which issues without stalling, then the
+            // one on the longest path to the end of the region, then the one
+            // which came first.
+            var best = 0
+            var bestKey = (Int.max, Int.min, Int.max)
+            for (position, index) in ready.enumerated() {
+                let stall = timeline.stallCycles(
+                    reads: region[index].reads,
+                    readsFlags: region[index].readsFlags
+                )
+                let key = (stall, graph.height[index], index)
+                if key.0 < bestKey.0
+                    || (key.0 == bestKey.0 && key.1 > bestKey.1)
+                    || (key.0 == bestKey.0 && key.1 == bestKey.1 && key.2 < bestKey.2) {
+                    best = position
+                    bestKey = key
+                }
+            }
+            let chosen = ready.remove(at: best)
+            order.append(chosen)
+            issue(region[chosen], &timeline)
+            for successor in graph.successors[chosen] {
+                predecessorCount[successor.index] -= 1
+                if predecessorCount[successor.index] == 0 {
+                    ready.append(successor.index)
+                }
+            }
+        }
+        assert(order.count == region.count)
+
+        let isFaster = cost(region, order, timeline0, next) < cost(region, original, timeline0, next)
+        return isFaster ? order : original
+    }
+
+    /// The dependencies between the instructions of a region, which every
+    /// order of the instructions must respect
+    private struct DependencyGraph {
+        struct Edge {
+            let index: Int
+
+            /// The number of cycles the successor would stall if it were
+            /// issued immediately after the predecessor
+            let latency: Int
+        }
+
+        private(set) var successors: [[Edge]]
+        private(set) var predecessorCount: [Int]
+
+        /// The length of the longest path from each instruction to the end
+        /// of the region, in cycles
+        private(set) var height: [Int]
+
+        init(_ region: [Instruction], _ next: Boundary?, _ model: PipelineHazardModel) {
+            successors = Array(repeating: [], count: region.count)
+            predecessorCount = Array(repeating: 0, count: region.count)
+            height = Array(repeating: 0, count: region.count)
+            var exitLatency = Array(repeating: 0, count: region.count)
+
+            var lastWriter = [Int?](repeating: nil, count: 8)
+            var readersSinceWrite = [[Int]](repeating: [], count: 8)
+            var writeCount = [Int](repeating: 0, count: 8)
+            var memoryAccesses: [(index: Int, access: MemoryAccess, version: Int)] = []
+
+            // The flags are written by nearly every ALU instruction, and
+            // ordering every pair of writers would leave little freedom. Only
+            // the writer which a reader observes matters. Writers which are
+            // not observed must come before the one which is.
+            var reachingFlagsWriter: Int?
+            var unobservedFlagsWriters: [Int] = []
+            var flagsReadersSinceWrite: [Int] = []
+
+            func storeOperandLatency(_ writer: Int) -> Int {
+                region[writer].writesBackStoreOperand ? model.storeOperandHazardDistance : 0
+            }
+
+            for (i, instruction) in region.enumerated() {
+                for register in instruction.dependencyReads {
+                    if let writer = lastWriter[register] {
+                        let isHazard = instruction.reads.contains(register)
+                        addEdge(writer, i, isHazard ? storeOperandLatency(writer) : 0)
+                    }
+                }
+                if let register = instruction.write {
+                    if let writer = lastWriter[register] {
+                        addEdge(writer, i, 0)
+                    }
+                    for reader in readersSinceWrite[register] where reader != i {
+                        addEdge(reader, i, 0)
+                    }
+                }
+                for register in instruction.dependencyReads {
+                    readersSinceWrite[register].append(i)
+                }
+                if let register = instruction.write {
+                    lastWriter[register] = i
+                    readersSinceWrite[register] = []
+                }
+
+                if instruction.readsFlags {
+                    if let writer = reachingFlagsWriter {
+                        addEdge(writer, i, model.flagsHazardDistance)
+                        for other in unobservedFlagsWriters where other != writer {
+                            addEdge(other, writer, 0)
+                        }
+                    }
+                    unobservedFlagsWriters = []
+                    flagsReadersSinceWrite.append(i)
+                }
+                if instruction.setsFlags {
+                    for reader in flagsReadersSinceWrite where reader != i {
+                        addEdge(reader, i, 0)
+                    }
+                    flagsReadersSinceWrite = []
+                    reachingFlagsWriter = i
+                    unobservedFlagsWriters.append(i)
+                }
+
+                // Loads have no side effects and may pass one another. Any
+                // other two accesses are independent only if they use the
+                // same value of the same base register with different offsets.
+                if let access = instruction.memory {
+                    let version = writeCount[access.base]
+                    for other in memoryAccesses where access.isStore || other.access.isStore {
+                        let isDisjoint = other.access.base == access.base
+                            && other.version == version
+                            && other.access.offset != access.offset
+                        if !isDisjoint {
+                            addEdge(other.index, i, 0)
+                        }
+                    }
+                    memoryAccesses.append((i, access, version))
+                }
+                if let register = instruction.write {
+                    writeCount[register] += 1
+                }
+            }
+
+            // The flags may be read after the region, so the last writer must
+            // remain the last.
+            if let writer = reachingFlagsWriter {
+                for other in unobservedFlagsWriters where other != writer {
+                    addEdge(other, writer, 0)
+                }
+                if next?.readsFlags == true {
+                    exitLatency[writer] = model.flagsHazardDistance
+                }
+            }
+            // Any register may be read after the region.
+            for writer in lastWriter.compactMap({ $0 }) {
+                exitLatency[writer] = max(exitLatency[writer], storeOperandLatency(writer))
+            }
+
+            // Edges always run forward in the original order, so the heights
+            // can be computed in one backward pass.
+            for i in region.indices.reversed() {
+                var h = exitLatency[i]
+                for edge in successors[i] {
+                    h = max(h, edge.latency + height[edge.index])
+                }
+                height[i] = region[i].slots + h
+            }
+        }
+
+        private mutating func addEdge(_ from: Int, _ to: Int, _ latency: Int) {
+            assert(from < to)
+            successors[from].append(Edge(index: to, latency: latency))
+            predecessorCount[to] += 1
+        }
+    }
+
+    // MARK: - Branch Layout
+
+    private static func inverseBranch(_ instruction: String) -> String? {
+        switch instruction {
+        case kBEQ: kBNE
+        case kBNE: kBEQ
+        default: nil
+        }
+    }
+
+    private static func target(_ node: AbstractSyntaxTreeNode) -> String? {
+        guard let node = node as? InstructionNode, node.parameters.count == 1 else {
+            return nil
+        }
+        return (node.parameters[0] as? ParameterIdentifier)?.value
+    }
+
+    /// The labels declared consecutively from the given index
+    private static func labels(
+        startingAt index: Int,
+        in children: [AbstractSyntaxTreeNode]
+    ) -> Set<String> {
+        var result = Set<String>()
+        var i = index
+        while i < children.count, let label = children[i] as? LabelDeclaration {
+            result.insert(label.identifier)
+            i += 1
+        }
+        return result
+    }
+
+    /// Rotate loops of the form `H: test; BEQ T; body; JMP H; T:`, which take
+    /// the JMP on every iteration, into `H: test; BEQ T; B: body; test; BNE B; T:`
+    private func rotateLoops(
+        _ children: [AbstractSyntaxTreeNode]
+    ) -> ([AbstractSyntaxTreeNode], Int) {
+        var labelIndex: [String: Int] = [:]
+        for (i, child) in children.enumerated() {
+            if let label = child as? LabelDeclaration {
+                labelIndex[label.identifier] = i
+            }
+        }
+
+        var replacements: [Int: [AbstractSyntaxTreeNode]] = [:]
+        var insertedLabels: [Int: String] = [:]
+        for (i, child) in children.enumerated() {
+            guard let jump = child as? InstructionNode,
+                  jump.instruction == kJMP,
+                  let head = InstructionScheduler.target(jump),
+                  let h = labelIndex[head],
+                  h < i
+            else {
+                continue
+            }
+            var j = h + 1
+            while j < i, children[j] is LabelDeclaration {
+                j += 1
+            }
+            var test: [InstructionNode] = []
+            while j < i, decode(children[j]) != nil {
+                test.append(children[j] as! InstructionNode)
+                j += 1
+            }
+            guard (1...kMaxRotatedInstructions).contains(test.count),
+                  j < i,
+                  let branch = children[j] as? InstructionNode,
+                  let inverse = InstructionScheduler.inverseBranch(branch.instruction),
+                  let exit = InstructionScheduler.target(branch),
+                  InstructionScheduler.labels(startingAt: i + 1, in: children).contains(exit)
+            else {
+                continue
+            }
+            let bodyLabel: String
+            if let label = children[j + 1] as? LabelDeclaration {
+                bodyLabel = label.identifier
+            }
+            else {
+                bodyLabel = insertedLabels[j + 1] ?? "\(head)_body"
+                insertedLabels[j + 1] = bodyLabel
+            }
+            let copy: [AbstractSyntaxTreeNode] = test.map {
+                InstructionNode(
+                    sourceAnchor: $0.sourceAnchor,
+                    instruction: $0.instruction,
+                    parameters: $0.parameters
+                )
+            }
+            replacements[i] = copy + [
+                InstructionNode(
+                    sourceAnchor: branch.sourceAnchor,
+                    instruction: inverse,
+                    parameter: ParameterIdentifier(bodyLabel)
+                )
+            ]
+        }
+
+        guard !replacements.isEmpty else {
+            return (children, 0)
+        }
+        var result: [AbstractSyntaxTreeNode] = []
+        result.reserveCapacity(children.count + replacements.count * kMaxRotatedInstructions)
+        for (i, child) in children.enumerated() {
+            if let label = insertedLabels[i] {
+                result.append(LabelDeclaration(sourceAnchor: child.sourceAnchor, identifier: label))
+            }
+            if let replacement = replacements[i] {
+                result += replacement
+            }
+            else {
+                result.append(child)
+            }
+        }
+        return (result, replacements.count)
+    }
+
+    /// Remove jumps to the next instruction, and invert a conditional branch
+    /// over a jump, e.g., `BEQ L1; JMP L2; L1:` becomes `BNE L2; L1:`
+    private func removeJumps(
+        _ children: [AbstractSyntaxTreeNode]
+    ) -> ([AbstractSyntaxTreeNode], Int) {
+        var result: [AbstractSyntaxTreeNode] = []
+        result.reserveCapacity(children.count)
+        var count = 0
+        var i = 0
+        while i < children.count {
+            let child = children[i]
+            if let branch = child as? InstructionNode,
+               let inverse = InstructionScheduler.inverseBranch(branch.instruction),
+               let taken = InstructionScheduler.target(branch),
+               i + 1 < children.count,
+               let jump = children[i + 1] as? InstructionNode,
+               jump.instruction == kJMP,
+               let destination = InstructionScheduler.target(jump),
+               InstructionScheduler.labels(startingAt: i + 2, in: children).contains(taken) {
+                result.append(
+                    InstructionNode(
+                        sourceAnchor: branch.sourceAnchor,
+                        instruction: inverse,
+                        parameter: ParameterIdentifier(destination)
+                    )
+                )
+                count += 1
+                i += 2
+                continue
+            }
+            if let jump = child as? InstructionNode,
+               jump.instruction == kJMP,
+               let destination = InstructionScheduler.target(jump),
+               InstructionScheduler.labels(startingAt: i + 1, in: children).contains(destination) {
+                count += 1
+                i += 1
+                continue
+            }
+            result.append(child)
+            i += 1
+        }
+        return (result, count)
+    }
+}
@@ -0,0 +1,203 @@
+//
+//  LeafFrameEliminator.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+import TurtleSimulatorCore
+
+/// Removes the stack frame from Turtle16 subroutines which make no calls
+///
+/// ENTER saves all seven registers and sets up a frame pointer, and LEAVE
+/// restores them all. A leaf subroutine which never moves the stack pointer
+/// does not need a frame pointer, since sp stays where ENTER would have put
+/// the frame. Each access through fp is rewritten to use sp instead, ENTER is
+/// replaced by stores of only those registers which the subroutine writes,
+/// and each LEAVE by the matching loads.
+///
+/// The caller expects every register to survive the call, so the registers
+/// which are written must still be saved. The saved values go in the space
+/// which ENTER would have used for the save area, below the arguments and
+/// above the locals.
+///
+/// This runs after register allocation, so spilled values are handled too.
+/// A subroutine is left alone if it makes a call, if it writes sp, fp, or
+/// ra, if it uses fp other than as the base of a load, store, or address
+/// computation, or if an offset from sp would not fit in the instruction.
+public struct LeafFrameEliminator {
+    /// Collects the subroutines whose frames were removed
+    public final class Report {
+        public struct Entry: Equatable {
+            public let identifier: String
+
+            /// The number of registers which are still saved and restored
+            public let savedRegisterCount: Int
+        }
+
+        public private(set) var entries: [Entry] = []
+
+        public init() {}
+
+        fileprivate func append(_ entry: Entry) {
+            entries.append(entry)
+        }
+    }
+
+    /// The number of registers saved by ENTER, which is also the distance
+    /// from sp on entry down to fp
+    private let kSizeOfSaveArea = MemoryLayoutStrategyTurtle16().sizeOfSaveArea
+
+    /// The registers which the callee must preserve, and which may be written
+    /// by a leaf subroutine
+    private let kSavedRegisters = ["r0", "r1", "r2", "r3", "r4"]
+
+    /// The range of the immediate value of LOAD, STORE, ADDI, and SUBI
+    private let kImmediateRange = -16...15
+
+    /// Instructions which may appear in the body of a leaf subroutine
+    private static let leafInstructions: Set<String> = [
+        kNOP, kHLT, kLOAD, kSTORE, kLI, kLUI, kLA,
+        kCMP, kADD, kSUB, kAND, kOR, kXOR, kNOT,
+        kCMPI, kADDI, kSUBI, kANDI, kORI, kXORI, kADC, kSBC,
+        kJMP, kBEQ, kBNE, kBLT, kBGT, kBLTU, kBGTU,
+        kLEAVE, kRET
+    ]
+
+    private let report: Report?
+
+    public init(report: Report? = nil) {
+        self.report = report
+    }
+
+    public func compile(topLevel: TopLevel) -> TopLevel {
+        let children = topLevel.children.map { child -> AbstractSyntaxTreeNode in
+            guard let subroutine = child as? Subroutine,
+                  let children = compile(subroutine.children)
+            else {
+                return child
+            }
+            report?.append(
+                Report.Entry(
+                    identifier: subroutine.identifier,
+                    savedRegisterCount: savedRegisters(subroutine.children).count
+                )
+            )
+            return subroutine.withChildren(children)
+        }
+        return TopLevel(sourceAnchor: topLevel.sourceAnchor, children: children)
+    }
+
+    /// Remove the frame from the body of one subroutine, or return nil if
+    /// the subroutine must keep its frame
+    public func compile(_ children: [AbstractSyntaxTreeNode]) -> [AbstractSyntaxTreeNode]? {
+        guard let enter = children.first as? InstructionNode, enter.instruction == kENTER else {
+            return nil
+        }
+        let saved = savedRegisters(children)
+        var result: [AbstractSyntaxTreeNode] = saved.enumerated().map { i, register in
+            InstructionNode(
+                sourceAnchor: enter.sourceAnchor,
+                instruction: kSTORE,
+                parameters: [
+                    ParameterIdentifier(register),
+                    ParameterIdentifier("sp"),
+                    ParameterNumber(-(i + 1))
+                ]
+            )
+        }
+        for child in children.dropFirst() {
+            if child is LabelDeclaration {
+                result.append(child)
+                continue
+            }
+            guard let node = child as? InstructionNode,
+                  Self.leafInstructions.contains(node.instruction)
+            else {
+                return nil
+            }
+            if node.instruction == kLEAVE {
+                result += saved.enumerated().map { i, register in
+                    InstructionNode(
+                        sourceAnchor: node.sourceAnchor,
+                        instruction: kLOAD,
+                        parameters: [
+                            ParameterIdentifier(register),
+                            ParameterIdentifier("sp"),
+                            ParameterNumber(-(i + 1))
+                        ]
+                    )
+                }
+                continue
+            }
+            let destinations = RegisterUtils.getDestinationRegisters(node)
+            guard destinations.allSatisfy({ !["ra", "r5", "sp", "r6", "fp", "r7"].contains($0) }),
+                  let rebased = rebase(node)
+            else {
+                return nil
+            }
+            result.append(rebased)
+        }
+        return result
+    }
+
+    /// The callee-saved registers written in the subroutine
+    private func savedRegisters(_ children: [AbstractSyntaxTreeNode]) -> [String] {
+        let written = Set(children.flatMap { RegisterUtils.getDestinationRegisters($0) })
+        return kSavedRegisters.filter { written.contains($0) }
+    }
+
+    /// Replace fp with sp in the instruction, or return nil if that cannot
+    /// be done
+    private func rebase(_ node: InstructionNode) -> InstructionNode? {
+        func isFramePointer(_ parameter: Parameter) -> Bool {
+            guard let name = (parameter as? ParameterIdentifier)?.value else {
+                return false
+            }
+            return name == "fp" || name == "r7"
+        }
+        guard node.parameters.contains(where: isFramePointer) else {
+            return node
+        }
+        guard node.parameters.count == 3,
+              !isFramePointer(node.parameters[0]),
+              isFramePointer(node.parameters[1]),
+              let k = (node.parameters[2] as? ParameterNumber)?.value
+        else {
+            return nil
+        }
+
+        // fp is sp less the size of the save area
+        let offset: Int
+        switch node.instruction {
+        case kLOAD, kSTORE, kADDI: offset = k - kSizeOfSaveArea
+        case kSUBI: offset = -k - kSizeOfSaveArea
+        default: return nil
+        }
+        let (instruction, imm) =
+            if node.instruction == kLOAD || node.instruction == kSTORE {
+                (node.instruction, offset)
+            }
+            else if kImmediateRange.contains(offset) {
+                (kADDI, offset)
+            }
+            else {
+                (kSUBI, -offset)
+            }
+        guard kImmediateRange.contains(imm) else {
+            return nil
+        }
+        return InstructionNode(
+            sourceAnchor: node.sourceAnchor,
+            instruction: instruction,
+            parameters: [
+                node.parameters[0],
+                ParameterIdentifier("sp"),
+                ParameterNumber(imm)
+            ]
+        )
+    }
+}
@@ -10,17 +10,21 @@
 /// Live Intervals which must be spilled are simply not assigned a register.
 /// Spill code is inserted elsewhere.
 /// Ignores live intervals in the input already assigned a physical register.
+/// Live intervals are visited in the order given, which should be in order of
+/// increasing start point, as produced by RegisterLiveIntervalCalculator.
 /// See <http://web.cs.ucla.edu/~palsberg/course/cs132/linearscan.pdf>
 public struct LinearScanRegisterAllocator {
     private var registerPool: [Bool]
-    private var registers: [Int: Int?] = [:]
-    private var spillSlots: [Int: Int] = [:]
-    private var active: [Int] = []
+    private var registers: [Int?]
+    private var spillSlots: [Int?]
     private var nextSpillSlot = 0
 
+    /// Indices of the live intervals which currently hold a register, in
+    /// order of increasing end point. Intervals with the same end point are
+    /// kept in the order in which they were added.
+    private var active: [Int] = []
+
     private let liveIntervals: [LiveInterval]
-    private let increasingStartPoint: [LiveInterval]
-    private let increasingEndPoint: [LiveInterval]
 
     public static func allocate(
         numRegisters: Int,
@@ -35,17 +39,13 @@ public struct LinearScanRegisterAllocator {
     private init(_ numRegisters: Int, _ liveIntervals: [LiveInterval]) {
         assert(numRegisters >= 0)
         registerPool = [Bool](repeating: true, count: numRegisters)
+        registers = [Int?](repeating: nil, count: liveIntervals.count)
+        spillSlots = [Int?](repeating: nil, count: liveIntervals.count)
         self.liveIntervals = liveIntervals
-        increasingStartPoint = liveIntervals.sorted { leftRange, rightRange in
-            leftRange.range.startIndex < rightRange.range.startIndex
-        }
-        increasingEndPoint = liveIntervals.sorted { leftRange, rightRange in
-            leftRange.range.endIndex < rightRange.range.endIndex
-        }
     }
 
     private mutating func performAllocation() {
-        for i in 0..<increasingStartPoint.count {
+        for i in 0..<liveIntervals.count {
             expireOldIntervals(i)
             guard liveIntervals[i].physicalRegisterName == nil else { continue }
             if active.count == registerPool.count {
@@ -59,13 +59,16 @@ public struct LinearScanRegisterAllocator {
     }
 
     private mutating func expireOldIntervals(_ i: Int) {
+        let startPoint = liveIntervals[i].range.startIndex
+        var numberExpired = 0
         for j in active {
-            guard liveIntervals[j].range.endIndex <= liveIntervals[i].range.startIndex else {
-                return
+            guard liveIntervals[j].range.endIndex <= startPoint else {
+                break
             }
-            removeFromActive(j)
             freePhysicalRegister(j)
+            numberExpired += 1
         }
+        active.removeFirst(numberExpired)
     }
 
     private mutating func spillAtInterval(_ i: Int) {
@@ -73,7 +76,7 @@ public struct LinearScanRegisterAllocator {
            liveIntervals[spill].range.endIndex > liveIntervals[i].range.endIndex {
             registers[i] = registers[spill]
             registers[spill] = nil
-            removeFromActive(spill)
+            active.removeLast()
             addToActive(i)
             spillSlots[spill] = getNextSpillSlot()
         }
@@ -83,15 +86,22 @@ public struct LinearScanRegisterAllocator {
         }
     }
 
-    private mutating func removeFromActive(_ i: Int) {
-        active.removeAll(where: { $0 == i })
-    }
-
+    /// Insert into the active list after every interval which ends at or
+    /// before this one does.
     private mutating func addToActive(_ i: Int) {
-        active.append(i)
-        active.sort { leftIndex, rightIndex in
-            liveIntervals[leftIndex].range.endIndex < liveIntervals[rightIndex].range.endIndex
+        let endPoint = liveIntervals[i].range.endIndex
+        var low = 0
+        var high = active.count
+        while low < high {
+            let mid = (low + high) / 2
+            if liveIntervals[active[mid]].range.endIndex <= endPoint {
+                low = mid + 1
+            }
+            else {
+                high = mid
+            }
         }
+        active.insert(i, at: low)
     }
 
     private mutating func getNextSpillSlot() -> Int {
@@ -111,20 +121,21 @@ public struct LinearScanRegisterAllocator {
     }
 
     private mutating func freePhysicalRegister(_ j: Int) {
-        if let r_ = registers[j], let r = r_ {
+        if let r = registers[j] {
             registerPool[r] = true
         }
     }
 
     private func collateResults() -> [LiveInterval] {
         var result: [LiveInterval] = []
+        result.reserveCapacity(liveIntervals.count)
         for i in 0..<liveIntervals.count {
             let liveInterval = liveIntervals[i]
             let physicalRegisterName: String? =
                 if let name = liveInterval.physicalRegisterName {
                     name
                 }
-                else if let index = (registers[i] ?? nil) {
+                else if let index = registers[i] {
                     "r\(index)"
                 }
                 else {
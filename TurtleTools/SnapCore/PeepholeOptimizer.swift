@@ -0,0 +1,488 @@
+//
+//  PeepholeOptimizer.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+import TurtleSimulatorCore
+
+/// Rewrites short sequences of Turtle16 assembly into cheaper equivalents.
+///
+/// This runs after register allocation and lowering, just before assembly.
+/// The rewrites are described by a table of patterns, each of which matches
+/// a window of consecutive nodes and gives the nodes to put in its place.
+/// For example, this removes a reload of a spilled register which follows
+/// the spill:
+///
+///     Pattern(
+///         "reloadAfterSpill",
+///         match: "STORE $a, fp, $o; LOAD $a, fp, $o",
+///         rewrite: "STORE $a, fp, $o"
+///     )
+///
+/// An operand which begins with `$` is a variable. It matches any register,
+/// label, or number, and each use of the variable must match the same one.
+/// Any other operand matches only itself. A label declaration is written as
+/// the label followed by a colon.
+///
+/// A rewrite may change which instruction is the last to set the flags. When
+/// it does, the pattern applies only where no instruction depends on the
+/// flags before they are set again.
+public struct PeepholeOptimizer {
+    /// Counts the rewrites made by each pattern
+    public final class Report {
+        public struct Entry: Equatable {
+            /// The name of the pattern
+            public let name: String
+
+            /// The number of times the pattern was rewritten
+            public let hits: Int
+
+            /// The number of instructions removed by those rewrites
+            public let instructionsRemoved: Int
+        }
+
+        /// One entry for each pattern, in the order of the table
+        public private(set) var entries: [Entry] = []
+
+        /// The number of instructions before optimization
+        public private(set) var instructionCountBefore = 0
+
+        /// The number of instructions after optimization
+        public private(set) var instructionCountAfter = 0
+
+        /// Wall-clock time spent, in seconds
+        public private(set) var elapsedTime: TimeInterval = 0
+
+        public init() {}
+
+        /// The number of times the named pattern was rewritten
+        public func hits(_ name: String) -> Int {
+            entries.filter { $0.name == name }.reduce(0) { $0 + $1.hits }
+        }
+
+        fileprivate func append(
+            _ entries: [Entry],
+            instructionCountBefore: Int,
+            instructionCountAfter: Int,
+            elapsedTime: TimeInterval
+        ) {
+            self.entries += entries
+            self.instructionCountBefore += instructionCountBefore
+            self.instructionCountAfter += instructionCountAfter
+            self.elapsedTime += elapsedTime
+        }
+    }
+
+    /// The values bound to the variables of a pattern
+    public struct Bindings {
+        fileprivate var values: [String: Parameter] = [:]
+
+        /// The number bound to the variable, or nil if it is not a number
+        public func number(_ name: String) -> Int? {
+            (values[name] as? ParameterNumber)?.value
+        }
+
+        /// The register or label bound to the variable, or nil if it is not
+        /// an identifier
+        public func identifier(_ name: String) -> String? {
+            (values[name] as? ParameterIdentifier)?.value
+        }
+    }
+
+    /// A rewrite of a window of consecutive nodes
+    public struct Pattern: Sendable {
+        public let name: String
+        fileprivate let match: [Template]
+        fileprivate let rewrite: [Template]
+        fileprivate let condition: @Sendable (Bindings) -> Bool
+
+        /// - Parameters:
+        ///   - name: The name under which the pattern is reported
+        ///   - match: The nodes to match, separated by semicolons
+        ///   - rewrite: The nodes which replace them, separated by semicolons
+        ///   - condition: The pattern applies only if this is true of the
+        ///     values bound to its variables
+        public init(
+            _ name: String,
+            match: String,
+            rewrite: String,
+            where condition: @escaping @Sendable (Bindings) -> Bool = { _ in true }
+        ) {
+            self.name = name
+            self.match = Template.parse(match)
+            self.rewrite = Template.parse(rewrite)
+            self.condition = condition
+            assert(!self.match.isEmpty, "pattern \"\(name)\" matches nothing")
+        }
+    }
+
+    /// The patterns for code generated by the Snap compiler
+    public static let turtle16: [Pattern] = [
+        Pattern(
+            "reloadAfterSpill",
+            match: "STORE $a, fp, $o; LOAD $a, fp, $o",
+            rewrite: "STORE $a, fp, $o"
+        ),
+        Pattern(
+            "reloadAfterSpillToAnotherRegister",
+            match: "STORE $a, fp, $o; LOAD $b, fp, $o",
+            rewrite: "STORE $a, fp, $o; ADDI $b, $a, 0"
+        ),
+        Pattern(
+            "moveToSelf",
+            match: "ADDI $a, $a, 0",
+            rewrite: ""
+        ),
+        Pattern(
+            "moveBack",
+            match: "ADDI $a, $b, 0; ADDI $b, $a, 0",
+            rewrite: "ADDI $a, $b, 0"
+        ),
+        Pattern(
+            "jumpToTheNextInstruction",
+            match: "JMP $l; $l:",
+            rewrite: "$l:"
+        ),
+        Pattern(
+            "overwrittenLoadImmediate",
+            match: "LI $a, $x; LI $a, $y",
+            rewrite: "LI $a, $y"
+        ),
+        Pattern(
+            "overwrittenLoadImmediate",
+            match: "LUI $a, $x; LI $a, $y",
+            rewrite: "LI $a, $y"
+        ),
+        Pattern(
+            "upperByteIsAlreadyZero",
+            match: "LI $a, $x; LUI $a, 0",
+            rewrite: "LI $a, $x",
+            where: { bindings in
+                // LI leaves zero in the upper byte only for these
+                bindings.number("x").map { (0...127).contains($0) } ?? false
+            }
+        )
+    ] + [kBEQ, kBNE, kBLT, kBGT, kBLTU, kBGTU].map { branch in
+        Pattern(
+            "branchToTheNextInstruction",
+            match: "\(branch) $l; $l:",
+            rewrite: "$l:"
+        )
+    }
+
+    /// The largest number of instructions examined when looking for the next
+    /// use or definition of the flags
+    private let kMaxFlagsLookahead = 16
+
+    private let patterns: [Pattern]
+    private let model: PipelineHazardModel
+    private let report: Report?
+
+    /// - Parameters:
+    ///   - patterns: The rewrites to make, tried in order at each node
+    ///   - model: Tells which instructions use and set the flags
+    ///   - report: If set, the number of rewrites made by each pattern is
+    ///     recorded here
+    public init(
+        patterns: [Pattern] = PeepholeOptimizer.turtle16,
+        model: PipelineHazardModel = .turtle16,
+        report: Report? = nil
+    ) {
+        self.patterns = patterns
+        self.model = model
+        self.report = report
+    }
+
+    public func compile(topLevel: TopLevel) -> TopLevel {
+        TopLevel(
+            sourceAnchor: topLevel.sourceAnchor,
+            children: compile(children: topLevel.children)
+        )
+    }
+
+    public func compile(
+        children children0: [AbstractSyntaxTreeNode]
+    ) -> [AbstractSyntaxTreeNode] {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        var hits = [Int](repeating: 0, count: patterns.count)
+        var removed = [Int](repeating: 0, count: patterns.count)
+
+        // Each node is appended to the result in turn, and then the patterns
+        // are tried against the end of the result. A rewrite which shrinks
+        // the code may expose another match, and so the patterns are tried
+        // again. One which does not is not retried, which ensures that the
+        // rewriting terminates.
+        var result: [AbstractSyntaxTreeNode] = []
+        result.reserveCapacity(children0.count)
+        for index in children0.indices {
+            let child0 = children0[index]
+            let child1: AbstractSyntaxTreeNode =
+                if let subroutine = child0 as? Subroutine {
+                    subroutine.withChildren(compile(children: subroutine.children))
+                }
+                else {
+                    child0
+                }
+            result.append(child1)
+            let following = children0[(index + 1)...]
+            var isRewriting = true
+            while isRewriting {
+                isRewriting = false
+                for (patternIndex, pattern) in patterns.enumerated() {
+                    guard let replacement = apply(pattern, result, following) else {
+                        continue
+                    }
+                    let window = result.suffix(pattern.match.count)
+                    hits[patternIndex] += 1
+                    removed[patternIndex] += instructionCount(window) - instructionCount(replacement)
+                    result.removeLast(pattern.match.count)
+                    result += replacement
+                    isRewriting = replacement.count < pattern.match.count
+                    break
+                }
+            }
+        }
+
+        let elapsedNanoseconds = DispatchTime.now().uptimeNanoseconds - startTime
+        report?.append(
+            patterns.indices.map {
+                Report.Entry(
+                    name: patterns[$0].name,
+                    hits: hits[$0],
+                    instructionsRemoved: removed[$0]
+                )
+            },
+            instructionCountBefore: instructionCount(children0),
+            instructionCountAfter: instructionCount(result),
+            elapsedTime: TimeInterval(elapsedNanoseconds) / 1e9
+        )
+        return result
+    }
+
+    private func instructionCount<C: Collection>(_ nodes: C) -> Int
+    where C.Element == AbstractSyntaxTreeNode {
+        nodes.reduce(0) { $0 + ($1 is InstructionNode ? 1 : 0) }
+    }
+
+    // MARK: - Matching
+
+    /// The nodes which replace the end of the result, or nil if the pattern
+    /// does not match there
+    private func apply(
+        _ pattern: Pattern,
+        _ result: [AbstractSyntaxTreeNode],
+        _ following: ArraySlice<AbstractSyntaxTreeNode>
+    ) -> [AbstractSyntaxTreeNode]? {
+        guard pattern.match.count <= result.count else {
+            return nil
+        }
+        let window = Array(result.suffix(pattern.match.count))
+        var bindings = Bindings()
+        for (template, node) in zip(pattern.match, window) {
+            guard template.match(node, &bindings) else {
+                return nil
+            }
+        }
+        guard pattern.condition(bindings) else {
+            return nil
+        }
+        let replacement = pattern.rewrite.enumerated().map { index, template in
+            let original = window[min(index, window.count - 1)]
+            let node = template.instantiate(bindings, sourceAnchor: original.sourceAnchor)
+            return index < window.count && node == window[index] ? window[index] : node
+        }
+        guard lastFlagsDefinition(window) == lastFlagsDefinition(replacement)
+            || isFlagsDead(following)
+        else {
+            return nil
+        }
+        return replacement
+    }
+
+    private func lastFlagsDefinition(_ nodes: [AbstractSyntaxTreeNode]) -> AbstractSyntaxTreeNode? {
+        nodes.last { node in
+            guard let node = node as? InstructionNode else {
+                return false
+            }
+            return model.opcode(mnemonic: node.instruction)?.setsFlags ?? false
+        }
+    }
+
+    /// Determine whether the flags are set again before any instruction
+    /// which follows could depend on them
+    private func isFlagsDead(_ following: ArraySlice<AbstractSyntaxTreeNode>) -> Bool {
+        for node in following.prefix(kMaxFlagsLookahead) {
+            if node is LabelDeclaration {
+                continue
+            }
+            guard let node = node as? InstructionNode else {
+                return false
+            }
+            switch node.instruction {
+            case kCALL, kCALLPTR, kRET, kHLT:
+                // The flags are not passed into or out of a subroutine.
+                return true
+
+            case kLA:
+                // LA is LI and LUI, which leave the flags alone.
+                continue
+
+            default:
+                break
+            }
+            guard let opcode = model.opcode(mnemonic: node.instruction), !opcode.readsFlags else {
+                return false
+            }
+            if opcode.setsFlags {
+                return true
+            }
+            if opcode.isJump {
+                // The flags may be used at the target.
+                return false
+            }
+        }
+        return false
+    }
+}
+
+// MARK: - Templates
+
+/// One node of a pattern
+private enum Template: Sendable {
+    case instruction(String, [Operand])
+    case label(Operand)
+
+    enum Operand: Sendable {
+        case variable(String)
+        case identifier(String)
+        case number(Int)
+    }
+
+    static func parse(_ text: String) -> [Template] {
+        text
+            .split(whereSeparator: { $0 == ";" || $0 == "\n" })
+            .map { $0.trimmingCharacters(in: .whitespaces) }
+            .filter { !$0.isEmpty }
+            .map { statement in
+                if statement.hasSuffix(":") {
+                    return .label(Operand(statement.dropLast().trimmingCharacters(in: .whitespaces)))
+                }
+                let mnemonic = statement.prefix { !$0.isWhitespace }
+                let operands = statement
+                    .dropFirst(mnemonic.count)
+                    .split(separator: ",")
+                    .map { Operand($0.trimmingCharacters(in: .whitespaces)) }
+                return .instruction(String(mnemonic), operands)
+            }
+    }
+
+    func match(_ node: AbstractSyntaxTreeNode, _ bindings: inout PeepholeOptimizer.Bindings) -> Bool {
+        switch self {
+        case let .instruction(mnemonic, operands):
+            guard let node = node as? InstructionNode,
+                  node.instruction == mnemonic,
+                  node.parameters.count == operands.count
+            else {
+                return false
+            }
+            return zip(operands, node.parameters).allSatisfy { operand, parameter in
+                operand.match(parameter, &bindings)
+            }
+
+        case let .label(operand):
+            guard let node = node as? LabelDeclaration else {
+                return false
+            }
+            let parameter = ParameterIdentifier(
+                sourceAnchor: node.sourceAnchor,
+                value: node.identifier
+            )
+            return operand.match(parameter, &bindings)
+        }
+    }
+
+    func instantiate(
+        _ bindings: PeepholeOptimizer.Bindings,
+        sourceAnchor: SourceAnchor?
+    ) -> AbstractSyntaxTreeNode {
+        switch self {
+        case let .instruction(mnemonic, operands):
+            InstructionNode(
+                sourceAnchor: sourceAnchor,
+                instruction: mnemonic,
+                parameters: operands.map { $0.instantiate(bindings) }
+            )
+
+        case let .label(operand):
+            LabelDeclaration(
+                sourceAnchor: sourceAnchor,
+                identifier: (operand.instantiate(bindings) as! ParameterIdentifier).value
+            )
+        }
+    }
+}
+
+private extension Template.Operand {
+    init(_ text: String) {
+        if text.hasPrefix("$") {
+            self = .variable(String(text.dropFirst()))
+        }
+        else if let value = Int(text) {
+            self = .number(value)
+        }
+        else {
+            self = .identifier(text)
+        }
+    }
+
+    func match(_ parameter: Parameter, _ bindings: inout PeepholeOptimizer.Bindings) -> Bool {
+        switch self {
+        case let .variable(name):
+            guard let bound = bindings.values[name] else {
+                guard parameter is ParameterIdentifier || parameter is ParameterNumber else {
+                    return false
+                }
+                bindings.values[name] = parameter
+                return true
+            }
+            return isSameOperand(bound, parameter)
+
+        case let .identifier(value):
+            return (parameter as? ParameterIdentifier)?.value == value
+
+        case let .number(value):
+            return (parameter as? ParameterNumber)?.value == value
+        }
+    }
+
+    func instantiate(_ bindings: PeepholeOptimizer.Bindings) -> Parameter {
+        switch self {
+        case let .variable(name):
+            guard let parameter = bindings.values[name] else {
+                fatalError("peephole rewrite uses the unbound variable $\(name)")
+            }
+            return parameter
+
+        case let .identifier(value):
+            return ParameterIdentifier(value)
+
+        case let .number(value):
+            return ParameterNumber(value)
+        }
+    }
+
+    private func isSameOperand(_ a: Parameter, _ b: Parameter) -> Bool {
+        if let a = a as? ParameterIdentifier, let b = b as? ParameterIdentifier {
+            return a.value == b.value
+        }
+        if let a = a as? ParameterNumber, let b = b as? ParameterNumber {
+            return a.value == b.value
+        }
+        return false
+    }
+}
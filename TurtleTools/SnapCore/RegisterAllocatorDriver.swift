@@ -6,63 +6,245 @@
 //  Copyright © 2021 Andrew Fox. All rights reserved.
 //
 
+import Foundation
 import TurtleCore
 import TurtleSimulatorCore
 
 /// Rewrites the program to use physical register names instead of virtual.
 /// Inserts code to load and store values when a register must spill.
 public struct RegisterAllocatorDriver {
+    /// The method used to assign physical registers
+    public enum Algorithm: Equatable {
+        /// Linear scan over live intervals in program order
+        case linearScan
+
+        /// Iterated coalescing graph coloring with liveness computed over the
+        /// control flow graph. See `GraphColoringRegisterAllocator`.
+        case graphColoring
+    }
+
+    /// Collects statistics on register allocation for each subroutine
+    public final class Report {
+        public struct Entry: Equatable {
+            /// The subroutine identifier, or nil for the top level
+            public let identifier: String?
+
+            /// The number of nodes in the subroutine before allocation
+            public let nodeCount: Int
+
+            /// The number of live intervals in the final allocation, or the
+            /// number of virtual registers when coloring a graph
+            public let liveIntervalCount: Int
+
+            /// The number of times the allocator ran on this subroutine
+            public let allocationCount: Int
+
+            /// The number of times live intervals were computed
+            public let livenessCount: Int
+
+            /// The number of loads inserted to reload spilled registers
+            public let spillLoadCount: Int
+
+            /// The number of stores inserted to spill registers
+            public let spillStoreCount: Int
+
+            /// The number of spill loads which linear scan inserts into the
+            /// same subroutine, for comparison, or nil if linear scan could
+            /// not allocate registers for it
+            public let linearScanSpillLoadCount: Int?
+
+            /// The number of spill stores which linear scan inserts into the
+            /// same subroutine, for comparison, or nil if linear scan could
+            /// not allocate registers for it
+            public let linearScanSpillStoreCount: Int?
+
+            /// Wall-clock time spent, in seconds
+            public let elapsedTime: TimeInterval
+        }
+
+        public private(set) var entries: [Entry] = []
+
+        public init() {}
+
+        public var totalElapsedTime: TimeInterval {
+            entries.reduce(0) { $0 + $1.elapsedTime }
+        }
+
+        fileprivate func append(_ entry: Entry) {
+            entries.append(entry)
+        }
+    }
+
+    /// The result of allocating registers in one subroutine
+    private struct Allocation {
+        let children: [AbstractSyntaxTreeNode]
+        let liveIntervalCount: Int
+        let allocationCount: Int
+        let livenessCount: Int
+    }
+
     private let kNumberOfFreelyAllocatableRegisters: Int
+    private let algorithm: Algorithm
+    private let jobs: Int
+    private let report: Report?
 
-    public init(numRegisters: Int = 5 /* a default value appropriate to Turtle16 */ ) {
+    /// - Parameters:
+    ///   - numRegisters: The number of registers available for allocation
+    ///   - algorithm: The method used to assign registers
+    ///   - jobs: The number of subroutines which may be compiled at once.
+    ///     The output does not depend on this.
+    ///   - report: If set, statistics for each subroutine are appended here
+    ///     in the order in which the subroutines appear in the program. When
+    ///     another algorithm is selected, linear scan also runs on each
+    ///     subroutine so that the spill code of the two may be compared.
+    public init(
+        numRegisters: Int = 5 /* a default value appropriate to Turtle16 */,
+        algorithm: Algorithm = .linearScan,
+        jobs: Int = 1,
+        report: Report? = nil
+    ) {
         kNumberOfFreelyAllocatableRegisters = numRegisters
+        self.algorithm = algorithm
+        self.jobs = jobs
+        self.report = report
     }
 
     public func compile(topLevel topLevel0: TopLevel) throws -> TopLevel {
-        let children1 = try compile(children: topLevel0.children)
+        let (children1, entry1) = try compile(identifier: nil, children: topLevel0.children)
+        report?.append(entry1)
         let topLevel1 = TopLevel(sourceAnchor: topLevel0.sourceAnchor, children: children1)
-        let children2 = try iterateSubroutineNodes(topLevel1.children) { subroutine in
-            try Subroutine(
+
+        // Subroutines are independent of one another and so they may be
+        // compiled concurrently.
+        let subroutines = topLevel1.children.compactMap { $0 as? Subroutine }
+        let compiledSubroutines = try subroutines.concurrentMap(jobs: jobs) { subroutine in
+            let (children, entry) = try compile(
+                identifier: subroutine.identifier,
+                children: subroutine.children
+            )
+            let result = Subroutine(
                 sourceAnchor: subroutine.sourceAnchor,
                 identifier: subroutine.identifier,
-                children: compile(children: subroutine.children)
+                children: children
             )
+            return (result, entry)
+        }
+        for (_, entry) in compiledSubroutines {
+            report?.append(entry)
+        }
+
+        var nextSubroutine = compiledSubroutines.makeIterator()
+        let children2 = topLevel1.children.map { child -> AbstractSyntaxTreeNode in
+            guard child is Subroutine else {
+                return child
+            }
+            return nextSubroutine.next()!.0
         }
         let topLevel2 = TopLevel(sourceAnchor: topLevel1.sourceAnchor, children: children2)
         return topLevel2
     }
 
-    private func iterateSubroutineNodes(
-        _ nodes: [AbstractSyntaxTreeNode],
-        _ block: (Subroutine) throws -> Subroutine
+    public func compile(
+        children children0: [AbstractSyntaxTreeNode]
     ) throws -> [AbstractSyntaxTreeNode] {
-        var children: [AbstractSyntaxTreeNode] = []
-        for child in nodes {
-            let result: AbstractSyntaxTreeNode =
-                switch child {
-                case let subroutineNode as Subroutine:
-                    try block(subroutineNode)
-                default:
-                    child
-                }
-
-            children.append(result)
-        }
+        let (children, entry) = try compile(identifier: nil, children: children0)
+        report?.append(entry)
         return children
     }
 
-    public func compile(
+    private func compile(
+        identifier: String?,
         children children0: [AbstractSyntaxTreeNode]
-    ) throws -> [AbstractSyntaxTreeNode] {
+    ) throws -> ([AbstractSyntaxTreeNode], Report.Entry) {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        let allocation = try allocate(algorithm, children0)
+        let elapsedNanoseconds = DispatchTime.now().uptimeNanoseconds - startTime
+
+        // The comparison is only needed if there is a report to read it.
+        // Linear scan may fail where the selected algorithm succeeded, and a
+        // diagnostic must not abort the compile, so the figures are then
+        // left out of the report.
+        let linearScan: Allocation? =
+            if report == nil || algorithm == .linearScan {
+                allocation
+            }
+            else {
+                try? allocate(.linearScan, children0)
+            }
+
+        let entry = Report.Entry(
+            identifier: identifier,
+            nodeCount: children0.count,
+            liveIntervalCount: allocation.liveIntervalCount,
+            allocationCount: allocation.allocationCount,
+            livenessCount: allocation.livenessCount,
+            spillLoadCount: spillCodeCount(kLOAD, children0, allocation.children),
+            spillStoreCount: spillCodeCount(kSTORE, children0, allocation.children),
+            linearScanSpillLoadCount: linearScan.map {
+                spillCodeCount(kLOAD, children0, $0.children)
+            },
+            linearScanSpillStoreCount: linearScan.map {
+                spillCodeCount(kSTORE, children0, $0.children)
+            },
+            elapsedTime: TimeInterval(elapsedNanoseconds) / 1e9
+        )
+        return (allocation.children, entry)
+    }
+
+    private func allocate(
+        _ algorithm: Algorithm,
+        _ children0: [AbstractSyntaxTreeNode]
+    ) throws -> Allocation {
+        switch algorithm {
+        case .linearScan:
+            return try allocateWithLinearScan(children0)
+
+        case .graphColoring:
+            let allocator = GraphColoringRegisterAllocator(
+                numRegisters: kNumberOfFreelyAllocatableRegisters
+            )
+            let allocation = try allocator.allocate(children0)
+            return Allocation(
+                children: allocation.children,
+                liveIntervalCount: allocation.virtualRegisterCount,
+                allocationCount: allocation.roundCount,
+                livenessCount: allocation.roundCount
+            )
+        }
+    }
+
+    /// The number of instructions of the given kind which allocation added
+    private func spillCodeCount(
+        _ instruction: String,
+        _ before: [AbstractSyntaxTreeNode],
+        _ after: [AbstractSyntaxTreeNode]
+    ) -> Int {
+        func count(_ nodes: [AbstractSyntaxTreeNode]) -> Int {
+            nodes.filter { ($0 as? InstructionNode)?.instruction == instruction }.count
+        }
+        return count(after) - count(before)
+    }
+
+    private func allocateWithLinearScan(
+        _ children0: [AbstractSyntaxTreeNode]
+    ) throws -> Allocation {
         var registerPool = Array(0..<kNumberOfFreelyAllocatableRegisters)
         var temporaries: [Int] = []
         var children: [AbstractSyntaxTreeNode] = children0
         var allocations: [LiveInterval]
         var done = false
 
+        // Live intervals depend only on the nodes, so they are recomputed
+        // only when the nodes change, and not when the pool of registers
+        // shrinks to make room for temporaries.
+        var liveIntervals = determineLiveIntervals(children)
+        var livenessCount = 1
+        var allocationCount = 0
+
         repeat {
             let numRegisters = (registerPool.last ?? -1) + 1
-            allocations = allocateRegisters(numRegisters, determineLiveIntervals(children))
+            allocations = allocateRegisters(numRegisters, liveIntervals)
+            allocationCount += 1
             let spilledIntervals = allocations.filter { $0.physicalRegisterName == nil }
             let spillResult = RegisterSpiller.spill(
                 spilledIntervals: spilledIntervals,
@@ -71,8 +253,15 @@ public struct RegisterAllocatorDriver {
             )
             switch spillResult {
             case let .success(r):
-                children = r
-                allocations = allocateRegisters(numRegisters, determineLiveIntervals(children))
+                // If nothing spilled then the nodes are unchanged and so is
+                // the allocation.
+                if !spilledIntervals.isEmpty {
+                    children = r
+                    liveIntervals = determineLiveIntervals(children)
+                    livenessCount += 1
+                    allocations = allocateRegisters(numRegisters, liveIntervals)
+                    allocationCount += 1
+                }
                 done = true
 
             case .failure(.outOfTemporaries):
@@ -86,6 +275,8 @@ public struct RegisterAllocatorDriver {
 
             case .failure(.missingLeadingEnter):
                 children.insert(InstructionNode(instruction: kENTER), at: 0)
+                liveIntervals = determineLiveIntervals(children)
+                livenessCount += 1
 
             case let .failure(e):
                 throw CompilerError(
@@ -95,8 +286,12 @@ public struct RegisterAllocatorDriver {
             }
         } while !done
 
-        children = compile(children: children, liveIntervals: allocations)
-        return children
+        return Allocation(
+            children: compile(children: children, liveIntervals: allocations),
+            liveIntervalCount: allocations.count,
+            allocationCount: allocationCount,
+            livenessCount: livenessCount
+        )
     }
 
     private func determineLiveIntervals(_ nodes: [AbstractSyntaxTreeNode]) -> [LiveInterval] {
@@ -117,8 +312,11 @@ public struct RegisterAllocatorDriver {
         children: [AbstractSyntaxTreeNode],
         liveIntervals: [LiveInterval]
     ) -> [AbstractSyntaxTreeNode] {
+        // Index the live intervals by name so that each lookup need only
+        // consider the few intervals of one virtual register.
+        let liveIntervalsByName = Dictionary(grouping: liveIntervals, by: \.virtualRegisterName)
         let children = iterateInstructionNodes(children) { index, instructionNode in
-            compile(index, instructionNode, liveIntervals)
+            compile(index, instructionNode, liveIntervalsByName)
         }
         return children
     }
@@ -145,7 +343,7 @@ public struct RegisterAllocatorDriver {
     private func compile(
         _ index: Int,
         _ node: InstructionNode,
-        _ liveIntervals: [LiveInterval]
+        _ liveIntervals: [String: [LiveInterval]]
     ) -> InstructionNode {
         // TODO: rewrite in terms of RegisterUtils.rewrite()
         switch node.instruction {
@@ -196,7 +394,7 @@ public struct RegisterAllocatorDriver {
     private func rewriteRegisterIdentifier(
         _ param: Parameter,
         _ index: Int,
-        _ liveIntervals: [LiveInterval]
+        _ liveIntervals: [String: [LiveInterval]]
     ) -> Parameter {
         guard let ident = param as? ParameterIdentifier,
               let rewritten = lookup(ident.value, index, liveIntervals)
@@ -209,12 +407,10 @@ public struct RegisterAllocatorDriver {
     private func lookup(
         _ virtualRegisterName: String,
         _ index: Int,
-        _ liveIntervals: [LiveInterval]
+        _ liveIntervals: [String: [LiveInterval]]
     ) -> String? {
-        liveIntervals
-            .first {
-                ($0.virtualRegisterName == virtualRegisterName) && $0.range.contains(index)
-            }?
+        liveIntervals[virtualRegisterName]?
+            .first { $0.range.contains(index) }?
             .physicalRegisterName
     }
 }
@@ -24,9 +24,17 @@ public final class SnapCommandLineArgumentParser {
         case listTests
         case quiet
         case unoptimized
+        case optimized
         case run
         case platform(String)
+        case cpu(String)
         case noRuntime
+        case backendJobs(String)
+        case jobs(String)
+        case timePasses
+        case timePassesJSON(String)
+        case registerAllocator(String)
+        case registerAllocationReport
     }
 
     private var args: [String]
@@ -104,16 +112,58 @@ public final class SnapCommandLineArgumentParser {
                 try advance()
                 options.append(.unoptimized)
             }
+            else if option == "-O1" {
+                try advance()
+                options.append(.optimized)
+            }
             else if option == "--platform" {
                 try advance()
                 let platformName = try peek()
                 try advance()
                 options.append(.platform(platformName))
             }
+            else if option == "--cpu" {
+                try advance()
+                let cpuName = try peek()
+                try advance()
+                options.append(.cpu(cpuName))
+            }
             else if option == "--no-runtime" {
                 try advance()
                 options.append(.noRuntime)
             }
+            else if option == "--backend-jobs" {
+                try advance()
+                let jobCount = try peek()
+                try advance()
+                options.append(.backendJobs(jobCount))
+            }
+            else if option == "--jobs" {
+                try advance()
+                let jobCount = try peek()
+                try advance()
+                options.append(.jobs(jobCount))
+            }
+            else if option == "--time-passes" {
+                try advance()
+                options.append(.timePasses)
+            }
+            else if option == "--time-passes-json" {
+                try advance()
+                let fileName = try peek()
+                try advance()
+                options.append(.timePassesJSON(fileName))
+            }
+            else if option == "--regalloc" {
+                try advance()
+                let allocatorName = try peek()
+                try advance()
+                options.append(.registerAllocator(allocatorName))
+            }
+            else if option == "--regalloc-report" {
+                try advance()
+                options.append(.registerAllocationReport)
+            }
             else {
                 throw SnapCommandLineParserError.unknownOption(option)
             }
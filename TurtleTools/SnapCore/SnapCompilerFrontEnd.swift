@@ -15,20 +15,67 @@ public final class SnapCompilerFrontEnd {
         public let isUsingStandardLibrary: Bool
         public let runtimeSupport: String?
         public let shouldRunSpecificTest: String?
+
+        /// If set, the program includes every test and runs the one selected
+        /// by the value stored in `__testSelector` before the program starts
+        public let isTestDispatchEnabled: Bool
+
         public let injectedModules: [String: String]
 
+        /// The number of subroutines the backend may compile concurrently
+        public let backendJobs: Int
+
+        /// If set, the backend reorders instructions to avoid pipeline stalls
+        /// and lays out branches so that the hot path falls through
+        public let isInstructionSchedulingEnabled: Bool
+
+        /// If set, the Tack program is optimized before it is lowered to a
+        /// target or run in the virtual machine
+        public let isTackOptimizationEnabled: Bool
+
+        /// If set, the backend rewrites short sequences of assembly into
+        /// cheaper equivalents just before assembling them
+        public let isPeepholeOptimizationEnabled: Bool
+
+        /// If set, calls to small subroutines are replaced with a copy of the
+        /// subroutine body
+        public let isInliningEnabled: Bool
+
+        /// If set, the backend removes the stack frame from subroutines which
+        /// make no calls, saving only the registers they write
+        public let isLeafFrameEliminationEnabled: Bool
+
+        /// The method the backend uses to assign physical registers
+        public let registerAllocator: RegisterAllocatorDriver.Algorithm
+
         public init(
             isBoundsCheckEnabled: Bool = false,
             isUsingStandardLibrary: Bool = false,
             runtimeSupport: String? = nil,
             shouldRunSpecificTest: String? = nil,
-            injectedModules: [String: String] = [:]
+            isTestDispatchEnabled: Bool = false,
+            injectedModules: [String: String] = [:],
+            backendJobs: Int = 1,
+            isInstructionSchedulingEnabled: Bool = true,
+            isTackOptimizationEnabled: Bool = true,
+            isPeepholeOptimizationEnabled: Bool = true,
+            isInliningEnabled: Bool = true,
+            isLeafFrameEliminationEnabled: Bool = true,
+            registerAllocator: RegisterAllocatorDriver.Algorithm = .linearScan
         ) {
             self.isBoundsCheckEnabled = isBoundsCheckEnabled
             self.isUsingStandardLibrary = isUsingStandardLibrary
             self.runtimeSupport = runtimeSupport
             self.shouldRunSpecificTest = shouldRunSpecificTest
+            self.isTestDispatchEnabled = isTestDispatchEnabled
             self.injectedModules = injectedModules
+            self.backendJobs = backendJobs
+            self.isInstructionSchedulingEnabled = isInstructionSchedulingEnabled
+            self.isTackOptimizationEnabled = isTackOptimizationEnabled
+            self.isPeepholeOptimizationEnabled = isPeepholeOptimizationEnabled
+            self.isInliningEnabled = isInliningEnabled
+            self.isLeafFrameEliminationEnabled = isLeafFrameEliminationEnabled
+            self.registerAllocator = registerAllocator
         }
     }
 
@@ -41,6 +88,12 @@ public final class SnapCompilerFrontEnd {
 
     public var sandboxAccessManager: SandboxAccessManager?
 
+    /// If set, the compiler records the time spent in each phase
+    public var phaseReport: CompilerPhaseReport?
+
+    /// If set, the compiler records each call which was inlined
+    public var inliningReport: TackInliner.Report?
+
     public init(
         options: Options = Options(),
         memoryLayoutStrategy: MemoryLayoutStrategy
@@ -60,7 +113,8 @@ public final class SnapCompilerFrontEnd {
             injectModules: Array(options.injectedModules),
             isUsingStandardLibrary: options.isUsingStandardLibrary,
             runtimeSupport: options.runtimeSupport,
-            sandboxAccessManager: sandboxAccessManager
+            sandboxAccessManager: sandboxAccessManager,
+            phaseReport: phaseReport
         )
         return testNames
     }
@@ -74,40 +128,98 @@ public final class SnapCompilerFrontEnd {
         let ast0 = try parse(tokens)
         let (ast1, testNames) = try ast0.snapToCore(
             shouldRunSpecificTest: options.shouldRunSpecificTest,
+            isTestDispatchEnabled: options.isTestDispatchEnabled,
             injectModules: Array(options.injectedModules),
             isUsingStandardLibrary: options.isUsingStandardLibrary,
             runtimeSupport: options.runtimeSupport,
             sandboxAccessManager: sandboxAccessManager,
-            memoryLayoutStrategy: memoryLayoutStrategy
-        )
-        let tackProgram = try ast1.coreToTack(
             memoryLayoutStrategy: memoryLayoutStrategy,
-            options: options
+            phaseReport: phaseReport
         )
+        let tackProgram0 = try measure(
+            "coreToTack",
+            nodeCountBefore: self.phaseReport?.nodeCount(ast1),
+            nodeCountAfter: { self.phaseReport?.nodeCount($0.ast) }
+        ) {
+            try ast1.coreToTack(
+                memoryLayoutStrategy: memoryLayoutStrategy,
+                options: options
+            )
+        }
+        let tackProgram1 =
+            if options.isInliningEnabled {
+                try measure(
+                    "inlineTack",
+                    nodeCountBefore: self.phaseReport?.nodeCount(tackProgram0.ast),
+                    nodeCountAfter: { self.phaseReport?.nodeCount($0.ast) }
+                ) {
+                    try tackProgram0.inlined(
+                        memoryLayoutStrategy: memoryLayoutStrategy,
+                        report: inliningReport
+                    )
+                }
+            }
+            else {
+                tackProgram0
+            }
+        let tackProgram2 =
+            if options.isTackOptimizationEnabled {
+                try measure(
+                    "optimizeTack",
+                    nodeCountBefore: self.phaseReport?.nodeCount(tackProgram1.ast),
+                    nodeCountAfter: { self.phaseReport?.nodeCount($0.ast) }
+                ) {
+                    try tackProgram1.optimized(jobs: options.backendJobs)
+                }
+            }
+            else {
+                tackProgram1
+            }
 
         syntaxTree = ast0
         symbolsOfTopLevelScope = ast1.symbols
         self.testNames = testNames
 
-        return tackProgram
+        return tackProgram2
+    }
+
+    private func measure<T>(
+        _ name: String,
+        nodeCountBefore: @autoclosure () -> Int? = nil,
+        nodeCountAfter: (T) -> Int? = { _ in nil },
+        _ body: () throws -> T
+    ) rethrows -> T {
+        guard let phaseReport else {
+            return try body()
+        }
+        return try phaseReport.measure(
+            name,
+            nodeCountBefore: nodeCountBefore(),
+            nodeCountAfter: nodeCountAfter,
+            body
+        )
     }
 
     private func lex(_ text: String, _ url: URL?) throws -> [Token] {
-        let lexer = SnapLexer(text, url)
-        lexer.scanTokens()
-        if let error = lexer.errors.first {
-            throw error
+        try measure("lex") {
+            let lexer = SnapLexer(text, url)
+            lexer.scanTokens()
+            if let error = lexer.errors.first {
+                throw error
+            }
+            return lexer.tokens
         }
-        return lexer.tokens
     }
 
     private func parse(_ tokens: [Token]) throws -> TopLevel {
-        let parser = SnapParser(tokens: tokens)
-        parser.parse()
-        if let error = parser.errors.first {
-            throw error
+        try measure("parse", nodeCountAfter: { self.phaseReport?.nodeCount($0) }) {
+            let parser = SnapParser(tokens: tokens)
+            parser.parse()
+            if let error = parser.errors.first {
+                throw error
+            }
+            syntaxTree = parser.syntaxTree
+            return parser.syntaxTree!
         }
-        syntaxTree = parser.syntaxTree
-        return parser.syntaxTree!
     }
 }
@@ -8,6 +8,7 @@
 
 public let kMainFunctionName = "main"
 public let kTestMainFunctionName = "__testMain"
+public let kTestSelectorName = "__testSelector"
 public let kStandardLibraryModuleName = "stdlib"
 
 public enum SnapCompilerMetrics {
@@ -19,29 +19,36 @@ public final class SnapToCoreCompiler {
     public private(set) var testNames: [String] = []
 
     private let shouldRunSpecificTest: String?
+    private let isTestDispatchEnabled: Bool
     private let isUsingStandardLibrary: Bool
     private let runtimeSupport: String?
     private let sandboxAccessManager: SandboxAccessManager?
     private let injectModules: [(String, String)]
     private let memoryLayoutStrategy: MemoryLayoutStrategy
+    private let phaseReport: CompilerPhaseReport?
 
     public init(
         shouldRunSpecificTest: String? = nil,
+        isTestDispatchEnabled: Bool = false,
         injectModules: [(String, String)] = [],
         isUsingStandardLibrary: Bool = false,
         runtimeSupport: String? = nil,
         sandboxAccessManager: SandboxAccessManager? = nil,
-        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyNull()
+        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyNull(),
+        phaseReport: CompilerPhaseReport? = nil
     ) {
         self.shouldRunSpecificTest = shouldRunSpecificTest
+        self.isTestDispatchEnabled = isTestDispatchEnabled
         self.injectModules = injectModules
         self.isUsingStandardLibrary = isUsingStandardLibrary
         self.runtimeSupport = runtimeSupport
         self.sandboxAccessManager = sandboxAccessManager
         self.memoryLayoutStrategy = memoryLayoutStrategy
+        self.phaseReport = phaseReport
     }
 
     public func run(_ root: AbstractSyntaxTreeNode) throws -> (Block, testNames: [String]) {
+        let report = phaseReport
         let core = try root
             .withImplicitImport(moduleName: standardLibraryName)?
             .withImplicitImport(
@@ -50,36 +57,50 @@ public final class SnapToCoreCompiler {
             )?
             .replaceTopLevelWithBlock()
             .reconnect(parent: nil)
-            .desugarTestDeclarations(
-                testNames: &testNames,
-                shouldRunSpecificTest: shouldRunSpecificTest
-            )?
-            .importPass(
-                injectModules: injectModules,
-                runtimeSupport: runtimeSupport
-            )?
-            .forInPass()?
-            .genericsPass()?
-            .vtablesPass()?
-            .implForPass()?
-            .eraseMethodCalls()?
-            .typeCheck()? // more thoroughly check expressions in the program before continuing
-            .synthesizeTerminalReturnStatements()?
-            .eraseImplPass()?
-            .eraseCompileTimeExpressions(memoryLayoutStrategy)?
-            .matchPass()?
-            .exposeImplicitConversions()?
-            .eraseUnions(memoryLayoutStrategy)?
-            .decomposeExpressions()?
-            .eraseEseq(options: .ignoreLoopCondition)? // type checking Eseq is fraught with peril
-            .eraseConst()?
-            .escapeAnalysis()?
-            .assertPass()?
-            .returnPass()?
-            .whilePass()?
-            .ifPass()?
-            .eraseEseq()? // erase the rest of them now that loops have been erased
-            .flatten()
+            .phase("desugarTestDeclarations", report) {
+                try $0.desugarTestDeclarations(
+                    testNames: &testNames,
+                    shouldRunSpecificTest: shouldRunSpecificTest,
+                    isTestDispatchEnabled: isTestDispatchEnabled
+                )
+            }?
+            .phase("importPass", report) {
+                try $0.importPass(
+                    injectModules: injectModules,
+                    runtimeSupport: runtimeSupport
+                )
+            }?
+            .phase("forInPass", report) { try $0.forInPass() }?
+            .phase("genericsPass", report) { try $0.genericsPass() }?
+            .phase("vtablesPass", report) { try $0.vtablesPass() }?
+            .phase("implForPass", report) { try $0.implForPass() }?
+            .phase("eraseMethodCalls", report) { try $0.eraseMethodCalls() }?
+            // more thoroughly check expressions in the program before continuing
+            .phase("typeCheck", report) { try $0.typeCheck() }?
+            .phase("synthesizeTerminalReturnStatements", report) {
+                try $0.synthesizeTerminalReturnStatements()
+            }?
+            .phase("eraseImplPass", report) { try $0.eraseImplPass() }?
+            .phase("eraseCompileTimeExpressions", report) {
+                try $0.eraseCompileTimeExpressions(memoryLayoutStrategy)
+            }?
+            .phase("matchPass", report) { try $0.matchPass() }?
+            .phase("exposeImplicitConversions", report) { try $0.exposeImplicitConversions() }?
+            .phase("eraseUnions", report) { try $0.eraseUnions(memoryLayoutStrategy) }?
+            .phase("decomposeExpressions", report) { try $0.decomposeExpressions() }?
+            // type checking Eseq is fraught with peril
+            .phase("eraseEseq(ignoreLoopCondition)", report) {
+                try $0.eraseEseq(options: .ignoreLoopCondition)
+            }?
+            .phase("eraseConst", report) { try $0.eraseConst() }?
+            .phase("escapeAnalysis", report) { try $0.escapeAnalysis() }?
+            .phase("assertPass", report) { try $0.assertPass() }?
+            .phase("returnPass", report) { try $0.returnPass() }?
+            .phase("whilePass", report) { try $0.whilePass() }?
+            .phase("ifPass", report) { try $0.ifPass() }?
+            // erase the rest of them now that loops have been erased
+            .phase("eraseEseq", report) { try $0.eraseEseq() }?
+            .phase("flatten", report) { try $0.flatten() }
         guard let block = core as? Block else {
             throw CompilerError(
                 message: "internal compiler error: expected Block after lowering Snap to the core language representation"
@@ -133,19 +154,23 @@ public extension AbstractSyntaxTreeNode {
     /// language
     func snapToCore(
         shouldRunSpecificTest: String? = nil,
+        isTestDispatchEnabled: Bool = false,
         injectModules: [(String, String)] = [],
         isUsingStandardLibrary: Bool = false,
         runtimeSupport: String? = nil,
         sandboxAccessManager: SandboxAccessManager? = nil,
-        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyNull()
+        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyNull(),
+        phaseReport: CompilerPhaseReport? = nil
     ) throws -> (Block, testNames: [String]) {
         let compiler = SnapToCoreCompiler(
             shouldRunSpecificTest: shouldRunSpecificTest,
+            isTestDispatchEnabled: isTestDispatchEnabled,
             injectModules: injectModules,
             isUsingStandardLibrary: isUsingStandardLibrary,
             runtimeSupport: runtimeSupport,
             sandboxAccessManager: sandboxAccessManager,
-            memoryLayoutStrategy: memoryLayoutStrategy
+            memoryLayoutStrategy: memoryLayoutStrategy,
+            phaseReport: phaseReport
         )
         return try compiler.run(self)
     }
@@ -24,6 +24,24 @@ public struct SnapToTurtle16Compiler {
 
     private let memoryLayoutStrategy = MemoryLayoutStrategyTurtle16()
 
+    /// If set, the compiler records each call which was inlined
+    public var inliningReport: TackInliner.Report?
+
+    /// If set, register allocation records statistics for each subroutine
+    public var registerAllocationReport: RegisterAllocatorDriver.Report?
+
+    /// If set, the compiler records each subroutine whose frame was removed
+    public var leafFrameReport: LeafFrameEliminator.Report?
+
+    /// If set, instruction scheduling records statistics for each subroutine
+    public var instructionSchedulingReport: InstructionScheduler.Report?
+
+    /// If set, peephole optimization records the rewrites made by each pattern
+    public var peepholeReport: PeepholeOptimizer.Report?
+
+    /// If set, the compiler records the time spent in each phase
+    public var phaseReport: CompilerPhaseReport?
+
     public init() {}
 
     public func compile(
@@ -36,8 +54,21 @@ public struct SnapToTurtle16Compiler {
             options: options,
             memoryLayoutStrategy: memoryLayoutStrategy
         )
+        frontEnd.phaseReport = phaseReport
+        frontEnd.inliningReport = inliningReport
         let tackProgram = try frontEnd.compile(program: text, base: base, url: url)
-        let (instructions, assembly) = try tackProgram.machineCode()
+        let (instructions, assembly) = try tackProgram.machineCode(
+            backendJobs: options.backendJobs,
+            registerAllocator: options.registerAllocator,
+            isLeafFrameEliminationEnabled: options.isLeafFrameEliminationEnabled,
+            isInstructionSchedulingEnabled: options.isInstructionSchedulingEnabled,
+            isPeepholeOptimizationEnabled: options.isPeepholeOptimizationEnabled,
+            registerAllocationReport: registerAllocationReport,
+            leafFrameReport: leafFrameReport,
+            instructionSchedulingReport: instructionSchedulingReport,
+            peepholeReport: peepholeReport,
+            phaseReport: phaseReport
+        )
         return TurtleProgram(
             testNames: frontEnd.testNames,
             symbolsOfTopLevelScope: frontEnd.symbolsOfTopLevelScope,
@@ -57,6 +88,7 @@ public struct SnapToTurtle16Compiler {
             options: options,
             memoryLayoutStrategy: memoryLayoutStrategy
         )
+        frontEnd.phaseReport = phaseReport
         let testNames = try frontEnd.collectTestNames(
             program: text,
             url: url
@@ -65,32 +97,120 @@ public struct SnapToTurtle16Compiler {
     }
 }
 
+public extension TackProgram {
+    /// Lower the program to Turtle16 machine code with the same back end as
+    /// `SnapToTurtle16Compiler`: instruction selection, register allocation,
+    /// leaf frame elimination, instruction scheduling, peephole optimization,
+    /// and assembly.
+    func turtle16MachineCode() throws -> [UInt16] {
+        try machineCode(
+            backendJobs: 1,
+            registerAllocator: .linearScan,
+            isLeafFrameEliminationEnabled: true,
+            isInstructionSchedulingEnabled: true,
+            isPeepholeOptimizationEnabled: true,
+            registerAllocationReport: nil,
+            leafFrameReport: nil,
+            instructionSchedulingReport: nil,
+            peepholeReport: nil,
+            phaseReport: nil
+        ).0
+    }
+}
+
 private extension TackProgram {
-    func machineCode() throws -> ([UInt16], TopLevel) {
-        var assembly: TopLevel!
-        let instructions = try assemble()
-            .registerAllocation()
-            .map {
-                assembly = $0
-                return $0
+    func machineCode(
+        backendJobs: Int,
+        registerAllocator: RegisterAllocatorDriver.Algorithm,
+        isLeafFrameEliminationEnabled: Bool,
+        isInstructionSchedulingEnabled: Bool,
+        isPeepholeOptimizationEnabled: Bool,
+        registerAllocationReport: RegisterAllocatorDriver.Report?,
+        leafFrameReport: LeafFrameEliminator.Report?,
+        instructionSchedulingReport: InstructionScheduler.Report?,
+        peepholeReport: PeepholeOptimizer.Report?,
+        phaseReport: CompilerPhaseReport?
+    ) throws -> ([UInt16], TopLevel) {
+        let allocated = try assemble(phaseReport)
+            .registerAllocation(
+                algorithm: registerAllocator,
+                jobs: backendJobs,
+                report: registerAllocationReport,
+                phaseReport: phaseReport
+            )
+        let framed =
+            if isLeafFrameEliminationEnabled {
+                allocated.leafFrameElimination(report: leafFrameReport, phaseReport: phaseReport)
+            }
+            else {
+                allocated
             }
-            .lowerAssembly()
-            .machineCode()
+        let assembly =
+            if isInstructionSchedulingEnabled {
+                try framed.instructionScheduling(
+                    jobs: backendJobs,
+                    report: instructionSchedulingReport,
+                    phaseReport: phaseReport
+                )
+            }
+            else {
+                framed
+            }
+        let lowered = try assembly.lowerAssembly(phaseReport)
+        let optimized =
+            if isPeepholeOptimizationEnabled {
+                lowered.peephole(report: peepholeReport, phaseReport: phaseReport)
+            }
+            else {
+                lowered
+            }
+        let instructions = try optimized.machineCode(phaseReport)
         return (instructions, assembly)
     }
 
-    func assemble() throws -> TopLevel {
-        try TackToTurtle16Compiler().visit(TopLevel(children: [ast])) as! TopLevel
+    func assemble(_ phaseReport: CompilerPhaseReport?) throws -> TopLevel {
+        try TopLevel(children: [ast]).phase("tackToTurtle16", phaseReport) {
+            try TackToTurtle16Compiler().visit($0)
+        } as! TopLevel
     }
 }
 
 private extension TopLevel {
-    func map(_ block: (TopLevel) -> TopLevel) -> TopLevel {
-        block(self)
+    func registerAllocation(
+        algorithm: RegisterAllocatorDriver.Algorithm,
+        jobs: Int,
+        report: RegisterAllocatorDriver.Report?,
+        phaseReport: CompilerPhaseReport?
+    ) throws -> TopLevel {
+        try phase("registerAllocation", phaseReport) { _ in
+            try RegisterAllocatorDriver(algorithm: algorithm, jobs: jobs, report: report)
+                .compile(topLevel: self)
+        } as! TopLevel
+    }
+
+    func leafFrameElimination(
+        report: LeafFrameEliminator.Report?,
+        phaseReport: CompilerPhaseReport?
+    ) -> TopLevel {
+        phase("leafFrameElimination", phaseReport) { _ in
+            LeafFrameEliminator(report: report).compile(topLevel: self)
+        } as! TopLevel
+    }
+
+    func instructionScheduling(
+        jobs: Int,
+        report: InstructionScheduler.Report?,
+        phaseReport: CompilerPhaseReport?
+    ) throws -> TopLevel {
+        try phase("instructionScheduling", phaseReport) { _ in
+            try InstructionScheduler(jobs: jobs, report: report).compile(topLevel: self)
+        } as! TopLevel
     }
 
-    func registerAllocation() throws -> TopLevel {
-        try RegisterAllocatorDriver().compile(topLevel: self)
+    func lowerAssembly(_ phaseReport: CompilerPhaseReport?) throws -> TopLevel {
+        try phase("lowerAssembly", phaseReport) { _ in
+            try lowerAssembly()
+        } as! TopLevel
     }
 
     func lowerAssembly() throws -> TopLevel {
@@ -114,6 +234,27 @@ private extension TopLevel {
         return topLevel1
     }
 
+    func peephole(
+        report: PeepholeOptimizer.Report?,
+        phaseReport: CompilerPhaseReport?
+    ) -> TopLevel {
+        phase("peephole", phaseReport) { _ in
+            PeepholeOptimizer(report: report).compile(topLevel: self)
+        } as! TopLevel
+    }
+
+    func machineCode(_ phaseReport: CompilerPhaseReport?) throws -> [UInt16] {
+        guard let phaseReport else {
+            return try machineCode()
+        }
+        return try phaseReport.measure(
+            "machineCode",
+            nodeCountBefore: phaseReport.nodeCount(self)
+        ) {
+            try machineCode()
+        }
+    }
+
     func machineCode() throws -> [UInt16] {
         let compiler = AssemblerCompiler()
         compiler.compile(self)
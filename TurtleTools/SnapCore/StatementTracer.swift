@@ -26,10 +26,133 @@ public struct StatementTracer {
     public typealias Trace = [TraceElement]
     private let symbols: Env
 
+    /// Summarizes the paths through a statement
+    public struct Reachability: Equatable {
+        /// Some path reaches the end of the statement without returning
+        public var fallsThrough: Bool
+
+        /// Some path ends in a return statement
+        public var returns: Bool
+
+        public init(fallsThrough: Bool, returns: Bool) {
+            self.fallsThrough = fallsThrough
+            self.returns = returns
+        }
+
+        /// The state on entry to a statement which is reached
+        static let entry = Reachability(fallsThrough: true, returns: false)
+
+        /// The paths which returned before the statement, and so pass over it
+        var returnedPaths: Reachability {
+            Reachability(fallsThrough: false, returns: returns)
+        }
+
+        /// Some path reaches the statement, whether or not it has returned
+        var isVisited: Bool {
+            fallsThrough || returns
+        }
+
+        func union(_ other: Reachability) -> Reachability {
+            Reachability(
+                fallsThrough: fallsThrough || other.fallsThrough,
+                returns: returns || other.returns
+            )
+        }
+    }
+
     public init(symbols: Env = Env()) {
         self.symbols = symbols
     }
 
+    /// Determine whether the paths through the statement fall through or
+    /// return, and throw if there is code after a return statement.
+    ///
+    /// This reaches the same conclusions as `trace(ast:)`, and throws the same
+    /// errors, but visits each node once. Rather than carry each path through
+    /// the control flow graph, it carries only whether any path is live and
+    /// whether any path has returned. The time taken is linear in the size of
+    /// the tree, where `trace(ast:)` takes time exponential in the number of
+    /// sequential branches.
+    public func reachability(ast node: AbstractSyntaxTreeNode) throws -> Reachability {
+        try reachability(.entry, node)
+    }
+
+    private func reachability(
+        _ state: Reachability,
+        _ genericNode: AbstractSyntaxTreeNode
+    ) throws -> Reachability {
+        switch genericNode {
+        case is TopLevel:
+            fatalError("unimplemented")
+
+        case let node as Seq:
+            try checkForCodeAfterReturn(stmts: node.children)
+            return try reachability(state, node.children)
+
+        case let node as Block:
+            try checkForCodeAfterReturn(stmts: node.children)
+            return try reachability(state, node.children)
+
+        case let node as If:
+            guard state.fallsThrough else {
+                return state
+            }
+            let thenState = try reachability(.entry, node.thenBranch)
+            let elseState =
+                if let elseBranch = node.elseBranch {
+                    try reachability(.entry, elseBranch)
+                }
+                else {
+                    Reachability.entry
+                }
+            return state.returnedPaths.union(thenState).union(elseState)
+
+        case let node as While:
+            guard state.fallsThrough else {
+                return state
+            }
+            let bodyState = try reachability(.entry, node.body)
+            return state.returnedPaths.union(bodyState).union(.entry)
+
+        case let node as Match:
+            guard state.fallsThrough else {
+                return state
+            }
+            var result = state.returnedPaths
+            for clause in node.clauses {
+                result = try result.union(reachability(.entry, clause.block))
+            }
+            if let elseClause = node.elseClause {
+                result = try result.union(reachability(.entry, elseClause))
+            }
+            return result
+
+        case is Return:
+            return Reachability(fallsThrough: false, returns: state.isVisited)
+
+        default:
+            return state
+        }
+    }
+
+    private func reachability(
+        _ state0: Reachability,
+        _ stmts: [AbstractSyntaxTreeNode]
+    ) throws -> Reachability {
+        var state = state0
+        for stmt in stmts {
+            // A statement which no path reaches is not visited at all.
+            guard state.isVisited else {
+                break
+            }
+            state = try reachability(state, stmt)
+        }
+        return state
+    }
+
+    /// Enumerate every path through the statement. The number of paths is
+    /// exponential in the number of sequential branches, so the compiler uses
+    /// `reachability(ast:)` instead.
     public func trace(ast node: AbstractSyntaxTreeNode) throws -> [Trace] {
         let traces = try trace(currentTrace: [], genericNode: node)
         return traces
@@ -0,0 +1,419 @@
+//
+//  TackInliner.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+
+/// Replaces calls to small subroutines with a copy of the subroutine body
+///
+/// Besides the CALL itself, a call costs the ENTER, LEAVE, and RET of the
+/// callee, and on Turtle16 ENTER and LEAVE save and restore every register.
+/// For a small callee this overhead is larger than the body. A callee is
+/// inlined at every call site when its body is no larger than
+/// kMaxInlinedSize, or when it is called from only one place and its body is
+/// no larger than kMaxInlinedSizeAtOnlyCallSite. Each caller may grow by no
+/// more than kMaxGrowth instructions.
+///
+/// The copy of the body gets a frame on the stack which is laid out exactly
+/// as ENTER would lay it out, so the arguments and the locals are found at
+/// the same offsets as before. A fresh virtual register stands in for fp.
+/// The virtual registers and the labels of the callee are renamed so that
+/// they do not clash with those of the caller, and each LEAVE and RET becomes
+/// a jump to the end of the copy. The end is marked with a label which names
+/// the callee, so inlined calls can be seen in a listing of the program.
+///
+/// Only the bodies of subroutines as written are copied, so a call within an
+/// inlined body is not itself inlined. A subroutine is kept even when every
+/// call to it was inlined, since its address may still be taken.
+///
+/// A callee is not inlined if it contains inline assembly, if it calls
+/// itself, if it writes fp, or if its frame is not set up by one ENTER at the
+/// start and torn down by a LEAVE immediately before each RET.
+public struct TackInliner {
+    public typealias Register = TackInstruction.Register
+
+    /// The calls which were inlined
+    public final class Report {
+        public struct Entry {
+            /// The subroutine which made the call, or nil for top-level code
+            public let caller: String?
+
+            public let callee: String
+
+            /// The number of instructions copied in place of the call
+            public let instructionCount: Int
+        }
+
+        public private(set) var entries: [Entry] = []
+
+        public init() {}
+
+        fileprivate func append(_ entry: Entry) {
+            entries.append(entry)
+        }
+    }
+
+    /// A callee whose body is no larger than this is inlined everywhere
+    private let kMaxInlinedSize = 12
+
+    /// A callee with only one call site is inlined if its body is no larger
+    /// than this
+    private let kMaxInlinedSizeAtOnlyCallSite = 48
+
+    /// The largest number of instructions which inlining may add to a caller
+    private let kMaxGrowth = 256
+
+    private let sizeOfSaveArea: Int
+    private let report: Report?
+
+    public init(
+        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyTurtle16(),
+        report: Report? = nil
+    ) {
+        sizeOfSaveArea = memoryLayoutStrategy.sizeOfSaveArea
+        self.report = report
+    }
+
+    /// A subroutine which may be copied in place of a call
+    private struct Callee {
+        let identifier: String
+
+        /// The size of the frame allocated by ENTER
+        let sizeOfLocals: Int
+
+        /// Everything after the ENTER
+        let body: [AbstractSyntaxTreeNode]
+
+        /// The number of instructions in the body, not counting LEAVE and RET
+        let size: Int
+
+        /// The labels declared in the body
+        let labels: Set<String>
+
+        /// The body moves the stack pointer, so the copy must move it too
+        let isAdjustingStack: Bool
+
+        /// The highest index of a virtual register in the body, or -1
+        let maxRegisterIndex: Int
+
+        init?(_ subroutine: Subroutine) {
+            guard let nodes = TackOptimizer.linearize(subroutine.children),
+                  let first = nodes.first as? TackInstructionNode,
+                  case let .enter(sizeOfLocals) = first.instruction
+            else {
+                return nil
+            }
+            let body = Array(nodes.dropFirst())
+            var size = 0
+            var labels = Set<String>()
+            var hasAlloca = false
+            for (i, node) in body.enumerated() {
+                if let node = node as? LabelDeclaration {
+                    labels.insert(node.identifier)
+                    continue
+                }
+                let instruction = (node as! TackInstructionNode).instruction
+                switch instruction {
+                case .enter:
+                    return nil
+
+                case .leave:
+                    guard i + 1 < body.count,
+                          let next = body[i + 1] as? TackInstructionNode,
+                          case .ret = next.instruction
+                    else {
+                        return nil
+                    }
+
+                case .ret:
+                    guard i > 0,
+                          let prev = body[i - 1] as? TackInstructionNode,
+                          case .leave = prev.instruction
+                    else {
+                        return nil
+                    }
+
+                case let .call(target) where target == subroutine.identifier:
+                    return nil
+
+                default:
+                    guard instruction.definition != .p(.fp) else {
+                        return nil
+                    }
+                    if case .alloca = instruction {
+                        hasAlloca = true
+                    }
+                    size += 1
+                }
+            }
+            identifier = subroutine.identifier
+            self.sizeOfLocals = sizeOfLocals
+            self.body = body
+            self.size = size
+            self.labels = labels
+            isAdjustingStack = sizeOfLocals > 0 || hasAlloca
+            maxRegisterIndex = TackInliner.maxRegisterIndex(body)
+        }
+    }
+
+    /// Names and registers handed out to inlined code
+    private struct Counters {
+        var nextRegisterIndex: Int
+        var nextCopy = 0
+    }
+
+    /// Inline calls in a Tack program as produced by CoreToTackCompiler
+    public func compile(_ node: AbstractSyntaxTreeNode) -> AbstractSyntaxTreeNode {
+        let children0 = (node as? Seq)?.children ?? [node]
+        let callees = selectCallees(children0)
+        guard !callees.isEmpty else {
+            return node
+        }
+
+        // The registers of an inlined copy are numbered above those of its
+        // caller, since each subroutine has a register frame of its own. The
+        // runs of top-level code share one set of registers, so numbering
+        // them separately is not safe.
+        let topLevel = children0.filter { !($0 is Subroutine) }
+        var counters = Counters(nextRegisterIndex: Self.maxRegisterIndex(topLevel) + 1)
+
+        // Each run of top-level code between subroutines is a caller of its
+        // own, as in TackOptimizer.
+        var children1: [AbstractSyntaxTreeNode] = []
+        var run: [AbstractSyntaxTreeNode] = []
+        for child in children0 {
+            if let subroutine = child as? Subroutine {
+                children1 += inline(run, nil, callees, &counters)
+                let nextTopLevelRegisterIndex = counters.nextRegisterIndex
+                counters.nextRegisterIndex = Self.maxRegisterIndex(subroutine.children) + 1
+                children1.append(
+                    subroutine.withChildren(
+                        inline(subroutine.children, subroutine.identifier, callees, &counters)
+                    )
+                )
+                counters.nextRegisterIndex = nextTopLevelRegisterIndex
+                run = []
+            }
+            else {
+                run.append(child)
+            }
+        }
+        children1 += inline(run, nil, callees, &counters)
+
+        if let seq = node as? Seq {
+            return seq.withChildren(children1)
+        }
+        return Seq(sourceAnchor: node.sourceAnchor, children: children1)
+    }
+
+    /// The subroutines which are worth inlining, by the cost model
+    private func selectCallees(_ children: [AbstractSyntaxTreeNode]) -> [String: Callee] {
+        var callSiteCount: [String: Int] = [:]
+        Self.forEachInstruction(children) { instruction in
+            if case let .call(target) = instruction {
+                callSiteCount[target, default: 0] += 1
+            }
+        }
+        var result: [String: Callee] = [:]
+        for case let subroutine as Subroutine in children {
+            guard let callee = Callee(subroutine) else {
+                continue
+            }
+            let limit =
+                callSiteCount[callee.identifier] == 1
+                ? kMaxInlinedSizeAtOnlyCallSite : kMaxInlinedSize
+            if callee.size <= limit {
+                result[callee.identifier] = callee
+            }
+        }
+        return result
+    }
+
+    private func inline(
+        _ children: [AbstractSyntaxTreeNode],
+        _ caller: String?,
+        _ callees: [String: Callee],
+        _ counters: inout Counters
+    ) -> [AbstractSyntaxTreeNode] {
+        // Inline assembly may use registers in ways which cannot be seen here.
+        guard let nodes = TackOptimizer.linearize(children) else {
+            return children
+        }
+        var result: [AbstractSyntaxTreeNode] = []
+        var growth = 0
+        var didInline = false
+        for node in nodes {
+            guard let call = node as? TackInstructionNode,
+                  case let .call(target) = call.instruction,
+                  let callee = callees[target],
+                  growth + callee.size <= kMaxGrowth
+            else {
+                result.append(node)
+                continue
+            }
+            result += expand(callee, at: call, &counters)
+            growth += callee.size
+            didInline = true
+            report?.append(
+                Report.Entry(
+                    caller: caller,
+                    callee: callee.identifier,
+                    instructionCount: callee.size
+                )
+            )
+        }
+        return didInline ? result : children
+    }
+
+    /// A copy of the body of the callee, in place of a call to it
+    private func expand(
+        _ callee: Callee,
+        at call: TackInstructionNode,
+        _ counters: inout Counters
+    ) -> [AbstractSyntaxTreeNode] {
+        let frame = TackInstruction.RegisterPointer.p(counters.nextRegisterIndex)
+        let offset = counters.nextRegisterIndex + 1
+        counters.nextRegisterIndex = offset + callee.maxRegisterIndex + 1
+        let copy = counters.nextCopy
+        counters.nextCopy += 1
+
+        let exit = ".L\(callee.identifier)_inline\(copy)"
+        func rename(label: String) -> String {
+            callee.labels.contains(label) ? "\(label)_inline\(copy)" : label
+        }
+        func rename(register: Register) -> Register {
+            register == .p(.fp) ? .p(frame) : register.renumbered(by: offset)
+        }
+        func make(_ instruction: TackInstruction, _ node: AbstractSyntaxTreeNode) -> TackInstructionNode {
+            TackInstructionNode(
+                instruction: instruction,
+                sourceAnchor: node.sourceAnchor,
+                symbols: (node as? TackInstructionNode)?.symbols
+            )
+        }
+
+        // The frame of the copy is laid out as ENTER would lay it out.
+        var result: [AbstractSyntaxTreeNode] = [
+            make(.subip(frame, .sp, sizeOfSaveArea), call)
+        ]
+        if callee.isAdjustingStack {
+            result.append(make(.subip(.sp, .sp, sizeOfSaveArea + callee.sizeOfLocals), call))
+        }
+        for node in callee.body {
+            if let node = node as? LabelDeclaration {
+                result.append(
+                    LabelDeclaration(
+                        sourceAnchor: node.sourceAnchor,
+                        identifier: rename(label: node.identifier)
+                    )
+                )
+                continue
+            }
+            let instruction = (node as! TackInstructionNode).instruction
+            switch instruction {
+            case .leave:
+                if callee.isAdjustingStack {
+                    result.append(make(.addip(.sp, frame, sizeOfSaveArea), node))
+                }
+
+            case .ret:
+                result.append(make(.jmp(exit), node))
+
+            default:
+                let renamed =
+                    instruction
+                    .mapRegisters(definition: rename(register:), use: rename(register:))
+                    .mapLabels(rename(label:))
+                result.append(make(renamed, node))
+            }
+        }
+        result.append(LabelDeclaration(sourceAnchor: call.sourceAnchor, identifier: exit))
+        return result
+    }
+
+    private static func forEachInstruction(
+        _ children: [AbstractSyntaxTreeNode],
+        _ body: (TackInstruction) -> Void
+    ) {
+        var stack = children
+        while let node = stack.popLast() {
+            switch node {
+            case let node as TackInstructionNode:
+                body(node.instruction)
+
+            case let node as Seq:
+                stack += node.children
+
+            case let node as Subroutine:
+                stack += node.children
+
+            default:
+                break
+            }
+        }
+    }
+
+    private static func maxRegisterIndex(_ children: [AbstractSyntaxTreeNode]) -> Int {
+        var result = -1
+        forEachInstruction(children) { instruction in
+            for register in instruction.uses + [instruction.definition].compactMap({ $0 }) {
+                if let index = register.index {
+                    result = max(result, index)
+                }
+            }
+        }
+        return result
+    }
+}
+
+extension TackInstruction.Register {
+    /// The index of a virtual register
+    fileprivate var index: Int? {
+        switch self {
+        case let .p(.p(i)), let .w(.w(i)), let .b(.b(i)), let .o(.o(i)): i
+        default: nil
+        }
+    }
+
+    /// Add an offset to the index of a virtual register
+    fileprivate func renumbered(by offset: Int) -> Self {
+        switch self {
+        case let .p(.p(i)): .p(.p(i + offset))
+        case let .w(.w(i)): .w(.w(i + offset))
+        case let .b(.b(i)): .b(.b(i + offset))
+        case let .o(.o(i)): .o(.o(i + offset))
+        default: self
+        }
+    }
+}
+
+extension TackInstruction {
+    /// Replace each label which is the target of a branch, or whose address
+    /// is taken
+    fileprivate func mapLabels(_ transform: (String) -> String) -> TackInstruction {
+        switch self {
+        case let .jmp(label): .jmp(transform(label))
+        case let .bz(a, label): .bz(a, transform(label))
+        case let .bnz(a, label): .bnz(a, transform(label))
+        case let .bzw(a, label): .bzw(a, transform(label))
+        case let .la(c, label): .la(c, transform(label))
+        default: self
+        }
+    }
+}
+
+extension TackProgram {
+    /// Inline calls to small subroutines with TackInliner
+    public func inlined(
+        memoryLayoutStrategy: MemoryLayoutStrategy = MemoryLayoutStrategyTurtle16(),
+        report: TackInliner.Report? = nil
+    ) throws -> TackProgram {
+        let inliner = TackInliner(memoryLayoutStrategy: memoryLayoutStrategy, report: report)
+        return try TackFlattener.compile(inliner.compile(ast))
+    }
+}
@@ -0,0 +1,1076 @@
+//
+//  TackOptimizer.swift
+//  SnapCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import TurtleCore
+
+/// Optimizes a Tack program before it is lowered to a target
+///
+/// The top-level code and each subroutine are optimized separately. The code
+/// is split into basic blocks and a forward dataflow analysis finds the
+/// registers which hold a known constant at each point. These are used to
+/// fold constant expressions and conditional branches, and to replace
+/// register operands with immediate values. Within each basic block, copies
+/// are propagated to the instructions which read them and an instruction
+/// which repeats an earlier computation is replaced with a copy of the
+/// earlier result. Finally, a backward liveness analysis removes instructions
+/// whose results are never read.
+///
+/// Copies and common subexpressions are not carried from one block to the
+/// next. The register allocator computes live intervals in program order,
+/// so extending the life of a register around a loop is not safe.
+///
+/// Code which contains inline assembly is left alone, since the assembly may
+/// use registers in ways which cannot be seen here.
+public struct TackOptimizer {
+    public typealias Register = TackInstruction.Register
+
+    /// The largest number of times the passes are repeated on one subroutine
+    private let kMaxIterations = 4
+
+    private let jobs: Int
+
+    /// - Parameter jobs: The number of subroutines which may be optimized at
+    ///   once. The output does not depend on this.
+    public init(jobs: Int = 1) {
+        self.jobs = jobs
+    }
+
+    /// Optimize a Tack program as produced by CoreToTackCompiler
+    public func compile(_ node: AbstractSyntaxTreeNode) throws -> AbstractSyntaxTreeNode {
+        let children0 = (node as? Seq)?.children ?? [node]
+        let addressTaken = labelsWithAddressTaken(children0)
+
+        // Each run of top-level code between subroutines is optimized as a
+        // unit of its own.
+        var children1: [AbstractSyntaxTreeNode] = []
+        var run: [AbstractSyntaxTreeNode] = []
+        for child in children0 {
+            if child is Subroutine {
+                children1 += optimize(run, addressTaken)
+                children1.append(child)
+                run = []
+            }
+            else {
+                run.append(child)
+            }
+        }
+        children1 += optimize(run, addressTaken)
+
+        // Subroutines are independent of one another and so they may be
+        // optimized concurrently.
+        let subroutines = children1.compactMap { $0 as? Subroutine }
+        let optimizedSubroutines = try subroutines.concurrentMap(jobs: jobs) { subroutine in
+            subroutine.withChildren(optimize(subroutine.children, addressTaken))
+        }
+        var nextSubroutine = optimizedSubroutines.makeIterator()
+        let children2 = children1.map { child -> AbstractSyntaxTreeNode in
+            guard child is Subroutine else {
+                return child
+            }
+            return nextSubroutine.next()!
+        }
+
+        if let seq = node as? Seq {
+            return seq.withChildren(children2)
+        }
+        return Seq(sourceAnchor: node.sourceAnchor, children: children2)
+    }
+
+    /// Optimize the body of one subroutine, or top-level code
+    public func optimize(children: [AbstractSyntaxTreeNode]) -> [AbstractSyntaxTreeNode] {
+        optimize(children, labelsWithAddressTaken(children))
+    }
+
+    private func optimize(
+        _ children: [AbstractSyntaxTreeNode],
+        _ addressTaken: Set<String>
+    ) -> [AbstractSyntaxTreeNode] {
+        guard var nodes = Self.linearize(children) else {
+            return children
+        }
+        for _ in 0..<kMaxIterations {
+            let next = eliminateDeadCode(
+                removeJumpsToTheNextInstruction(propagateValues(nodes, addressTaken)),
+                addressTaken
+            )
+            let isUnchanged = instructions(next) == instructions(nodes)
+            nodes = next
+            if isUnchanged {
+                break
+            }
+        }
+        return nodes
+    }
+
+    private func instructions(_ nodes: [AbstractSyntaxTreeNode]) -> [TackInstruction] {
+        nodes.compactMap { ($0 as? TackInstructionNode)?.instruction }
+    }
+
+    /// Labels whose address is loaded into a register may be reached from
+    /// anywhere, e.g., through a function pointer.
+    private func labelsWithAddressTaken(_ children: [AbstractSyntaxTreeNode]) -> Set<String> {
+        var result = Set<String>()
+        var stack = children
+        while let node = stack.popLast() {
+            switch node {
+            case let node as TackInstructionNode:
+                if case let .la(_, label) = node.instruction {
+                    result.insert(label)
+                }
+
+            case let node as Seq:
+                stack += node.children
+
+            case let node as Subroutine:
+                stack += node.children
+
+            default:
+                break
+            }
+        }
+        return result
+    }
+
+    /// Flatten the code to a list of instructions and labels, or return nil
+    /// if it contains anything else, or inline assembly
+    static func linearize(_ children: [AbstractSyntaxTreeNode]) -> [AbstractSyntaxTreeNode]? {
+        var result: [AbstractSyntaxTreeNode] = []
+        var stack = Array(children.reversed())
+        while let node = stack.popLast() {
+            switch node {
+            case let node as TackInstructionNode:
+                if case .inlineAssembly = node.instruction {
+                    return nil
+                }
+                result.append(node)
+
+            case is LabelDeclaration:
+                result.append(node)
+
+            case let node as Seq:
+                stack += node.children.reversed()
+
+            default:
+                return nil
+            }
+        }
+        return result
+    }
+
+    // MARK: - Control Flow
+
+    /// The basic blocks of a list of instructions and labels
+    private struct ControlFlowGraph {
+        /// The indices of the nodes in each block
+        let blocks: [Range<Int>]
+
+        /// The blocks to which control may pass from the end of each block
+        private(set) var successors: [[Int]]
+
+        /// The blocks from which control may pass to the start of each block
+        private(set) var predecessors: [[Int]]
+
+        /// The blocks which may be reached from outside the code
+        let entries: [Int]
+
+        private let blockWithLabel: [String: Int]
+
+        init(_ nodes: [AbstractSyntaxTreeNode], _ addressTaken: Set<String>) {
+            var blocks: [Range<Int>] = []
+            var start = 0
+            for i in nodes.indices {
+                if nodes[i] is LabelDeclaration, i > start {
+                    blocks.append(start..<i)
+                    start = i
+                }
+                if let instruction = (nodes[i] as? TackInstructionNode)?.instruction,
+                    instruction.isEndOfBlock
+                {
+                    blocks.append(start..<(i + 1))
+                    start = i + 1
+                }
+            }
+            if start < nodes.count || blocks.isEmpty {
+                blocks.append(start..<nodes.count)
+            }
+
+            var blockWithLabel: [String: Int] = [:]
+            for (b, block) in blocks.enumerated() {
+                if let label = block.first.flatMap({ nodes[$0] as? LabelDeclaration }) {
+                    blockWithLabel[label.identifier] = b
+                }
+            }
+
+            var entries = [0]
+            for (label, b) in blockWithLabel where addressTaken.contains(label) {
+                entries.append(b)
+            }
+
+            self.blocks = blocks
+            self.blockWithLabel = blockWithLabel
+            self.entries = entries
+            self.successors = []
+            self.predecessors = []
+
+            var successors = [[Int]](repeating: [], count: blocks.count)
+            var predecessors = [[Int]](repeating: [], count: blocks.count)
+            for (b, block) in blocks.enumerated() {
+                let last = block.last.flatMap { nodes[$0] as? TackInstructionNode }
+                successors[b] = self.successors(of: b, endingWith: last?.instruction)
+                for s in successors[b] {
+                    predecessors[s].append(b)
+                }
+            }
+            self.successors = successors
+            self.predecessors = predecessors
+        }
+
+        /// The blocks to which control may pass from the end of the given
+        /// block, if its last instruction were the one given
+        func successors(of b: Int, endingWith last: TackInstruction?) -> [Int] {
+            let next = b + 1 < blocks.count ? [b + 1] : []
+            switch last {
+            case let .jmp(target)?:
+                return blockWithLabel[target].map { [$0] } ?? []
+
+            case let .bz(_, target)?,
+                let .bnz(_, target)?,
+                let .bzw(_, target)?:
+                return (blockWithLabel[target].map { [$0] } ?? []) + next
+
+            case .ret?, .hlt?:
+                return []
+
+            default:
+                return next
+            }
+        }
+    }
+
+    /// Remove a jump to a label which immediately follows it
+    private func removeJumpsToTheNextInstruction(
+        _ nodes: [AbstractSyntaxTreeNode]
+    ) -> [AbstractSyntaxTreeNode] {
+        var result: [AbstractSyntaxTreeNode] = []
+        for (i, node) in nodes.enumerated() {
+            if case let .jmp(target)? = (node as? TackInstructionNode)?.instruction {
+                let labels = nodes[(i + 1)...].prefix { $0 is LabelDeclaration }
+                if labels.contains(where: { ($0 as? LabelDeclaration)?.identifier == target }) {
+                    continue
+                }
+            }
+            result.append(node)
+        }
+        return result
+    }
+
+    // MARK: - Constants, Copies, and Common Subexpressions
+
+    /// The value of each register known to hold a constant. Values are stored
+    /// as the unsigned bit pattern of the register.
+    private typealias Constants = [Register: Int]
+
+    private func propagateValues(
+        _ nodes: [AbstractSyntaxTreeNode],
+        _ addressTaken: Set<String>
+    ) -> [AbstractSyntaxTreeNode] {
+        let cfg = ControlFlowGraph(nodes, addressTaken)
+
+        // The constants known on entry to each block, or nil if the block has
+        // not been reached
+        var constantsIn = [Constants?](repeating: nil, count: cfg.blocks.count)
+        var worklist: [Int] = []
+        for entry in cfg.entries {
+            constantsIn[entry] = [:]
+            worklist.append(entry)
+        }
+        while let b = worklist.popLast() {
+            // Follow only the edges which remain once the block's branch has
+            // been folded.
+            let (rewritten, constantsOut) = rewrite(nodes[cfg.blocks[b]], constantsIn[b]!)
+            let last = rewritten.last as? TackInstructionNode
+            for s in cfg.successors(of: b, endingWith: last?.instruction) {
+                let merged = constantsIn[s].map { meet($0, constantsOut) } ?? constantsOut
+                if merged != constantsIn[s] {
+                    constantsIn[s] = merged
+                    worklist.append(s)
+                }
+            }
+        }
+
+        var result: [AbstractSyntaxTreeNode] = []
+        for (b, block) in cfg.blocks.enumerated() {
+            if let constants = constantsIn[b] {
+                result += rewrite(nodes[block], constants).0
+            }
+            else {
+                // The block is unreachable. Keep its labels in case a jump in
+                // another unreachable block still refers to one.
+                result += nodes[block].filter { $0 is LabelDeclaration }
+            }
+        }
+        return result
+    }
+
+    private func meet(_ a: Constants, _ b: Constants) -> Constants {
+        a.filter { b[$0.key] == $0.value }
+    }
+
+    /// Rewrite the instructions of one basic block given the constants known
+    /// on entry to it. Returns the new nodes and the constants known on exit.
+    private func rewrite(
+        _ nodes: ArraySlice<AbstractSyntaxTreeNode>,
+        _ constantsIn: Constants
+    ) -> ([AbstractSyntaxTreeNode], Constants) {
+        var constants = constantsIn
+        var values = LocalValues()
+        var result: [AbstractSyntaxTreeNode] = []
+        for node in nodes {
+            guard let node = node as? TackInstructionNode else {
+                result.append(node)
+                continue
+            }
+
+            switch node.instruction {
+            case .enter, .leave:
+                // The set of registers is saved or restored here.
+                constants = [:]
+                values = LocalValues()
+                result.append(node)
+                continue
+
+            default:
+                break
+            }
+
+            let propagated = node.instruction.mapRegisters(
+                definition: { $0 },
+                use: { values.source(of: $0) }
+            )
+            guard var instruction = simplify(propagated, constants) else {
+                continue
+            }
+
+            if let dst = instruction.definition, isPure(instruction), dst.isVirtual,
+                instruction.copySource == nil
+            {
+                let uses = instruction.uses
+                let expression = instruction.mapRegisters(
+                    definition: { $0.placeholder },
+                    use: { $0 }
+                )
+                if let holder = values.register(holding: expression), holder != dst {
+                    instruction = TackInstruction.move(dst, holder)!
+                }
+                else if uses.allSatisfy(\.isUnchangedWithinFrame), !uses.contains(dst) {
+                    let value = evaluate(instruction, constants)
+                    values.kill(dst)
+                    values.record(expression, uses: uses, in: dst)
+                    constants[dst] = value
+                    result.append(node.withInstruction(instruction))
+                    continue
+                }
+            }
+
+            if let dst = instruction.definition {
+                let value = evaluate(instruction, constants)
+                values.kill(dst)
+                if let src = instruction.copySource, src.isVirtual, dst.isVirtual, src != dst {
+                    values.recordCopy(of: src, in: dst)
+                }
+
+                // The stack and frame pointers also change implicitly, e.g.,
+                // by ALLOCA, and so their values are never tracked.
+                constants[dst] = dst.isVirtual ? value : nil
+            }
+            result.append(node.withInstruction(instruction))
+        }
+        return (result, constants)
+    }
+
+    /// Copies and computed expressions available within one basic block
+    private struct LocalValues {
+        private var copyOf: [Register: Register] = [:]
+        private var copiesOf: [Register: [Register]] = [:]
+        private var holderOf: [TackInstruction: Register] = [:]
+        private var expressionIn: [Register: TackInstruction] = [:]
+        private var expressionsReading: [Register: [TackInstruction]] = [:]
+
+        /// The register from which the given one was copied, or the register
+        /// itself if it is not a copy
+        func source(of register: Register) -> Register {
+            copyOf[register] ?? register
+        }
+
+        /// The register holding the result of the expression, if any
+        func register(holding expression: TackInstruction) -> Register? {
+            holderOf[expression]
+        }
+
+        /// Forget everything which depends on the value of the register
+        mutating func kill(_ register: Register) {
+            if let src = copyOf.removeValue(forKey: register) {
+                copiesOf[src]?.removeAll { $0 == register }
+            }
+            for copy in copiesOf.removeValue(forKey: register) ?? [] {
+                copyOf[copy] = nil
+            }
+            if let expression = expressionIn.removeValue(forKey: register) {
+                holderOf[expression] = nil
+            }
+            for expression in expressionsReading.removeValue(forKey: register) ?? [] {
+                if let holder = holderOf.removeValue(forKey: expression) {
+                    expressionIn[holder] = nil
+                }
+            }
+        }
+
+        mutating func recordCopy(of src: Register, in dst: Register) {
+            copyOf[dst] = src
+            copiesOf[src, default: []].append(dst)
+        }
+
+        mutating func record(_ expression: TackInstruction, uses: [Register], in dst: Register) {
+            holderOf[expression] = dst
+            expressionIn[dst] = expression
+            for use in uses {
+                expressionsReading[use, default: []].append(expression)
+            }
+        }
+    }
+
+    /// Fold constant expressions and branches, and use immediate operands
+    /// where a register operand is known to be constant. Returns nil if the
+    /// instruction may be removed.
+    private func simplify(_ instruction: TackInstruction, _ constants: Constants) -> TackInstruction? {
+        switch instruction {
+        case let .bz(test, target):
+            if let value = constants[.o(test)] {
+                return value == 0 ? .jmp(target) : nil
+            }
+
+        case let .bnz(test, target):
+            if let value = constants[.o(test)] {
+                return value != 0 ? .jmp(target) : nil
+            }
+
+        case let .bzw(test, target):
+            if let value = constants[.w(test)] {
+                return value == 0 ? .jmp(target) : nil
+            }
+
+        default:
+            break
+        }
+
+        if let dst = instruction.definition, isPure(instruction),
+            !instruction.isLoadImmediate, instruction.copySource == nil,
+            let value = evaluate(instruction, constants)
+        {
+            return .loadImmediate(dst, value)
+        }
+
+        func w(_ register: TackInstruction.Register16) -> Int? {
+            constants[.w(register)]
+        }
+
+        func signed(_ value: Int) -> Int {
+            Int(Int16(truncatingIfNeeded: value))
+        }
+
+        switch instruction {
+        case let .addw(c, a, b):
+            if let k = w(b) {
+                return .addiw(c, a, signed(k))
+            }
+            if let k = w(a) {
+                return .addiw(c, b, signed(k))
+            }
+
+        case let .subw(c, a, b):
+            if let k = w(b) {
+                return .subiw(c, a, signed(k))
+            }
+
+        case let .andw(c, a, b):
+            if let k = w(b) {
+                return .andiw(c, a, k)
+            }
+            if let k = w(a) {
+                return .andiw(c, b, k)
+            }
+
+        case let .addpw(c, a, b):
+            if let k = w(b) {
+                return .addip(c, a, k)
+            }
+
+        case let .addiw(c, a, 0),
+            let .subiw(c, a, 0),
+            let .andiw(c, a, 0xffff),
+            let .muliw(c, a, 1):
+            if Register.w(a).isVirtual {
+                return .movw(c, a)
+            }
+
+        case let .addip(c, a, 0),
+            let .subip(c, a, 0):
+            if Register.p(a).isVirtual {
+                return .movp(c, a)
+            }
+
+        default:
+            break
+        }
+
+        return instruction
+    }
+
+    /// The value computed by the instruction, if its operands are constant.
+    /// This follows the semantics of TackVirtualMachine.
+    private func evaluate(_ instruction: TackInstruction, _ constants: Constants) -> Int? {
+        func p(_ r: TackInstruction.RegisterPointer) -> Int? {
+            constants[.p(r)]
+        }
+
+        func w(_ r: TackInstruction.Register16) -> UInt16? {
+            constants[.w(r)].map { UInt16(truncatingIfNeeded: $0) }
+        }
+
+        func sw(_ r: TackInstruction.Register16) -> Int? {
+            w(r).map { Int(Int16(bitPattern: $0)) }
+        }
+
+        func b(_ r: TackInstruction.Register8) -> UInt8? {
+            constants[.b(r)].map { UInt8(truncatingIfNeeded: $0) }
+        }
+
+        func sb(_ r: TackInstruction.Register8) -> Int? {
+            b(r).map { Int(Int8(bitPattern: $0)) }
+        }
+
+        func o(_ r: TackInstruction.RegisterBoolean) -> Bool? {
+            constants[.o(r)].map { $0 != 0 }
+        }
+
+        func both<T, U>(_ a: T?, _ b: T?, _ f: (T, T) -> U?) -> U? {
+            guard let a, let b else {
+                return nil
+            }
+            return f(a, b)
+        }
+
+        func bool(_ value: Bool?) -> Int? {
+            value.map { $0 ? 1 : 0 }
+        }
+
+        func word(_ value: UInt16?) -> Int? {
+            value.map { Int($0) }
+        }
+
+        func byte(_ value: UInt8?) -> Int? {
+            value.map { Int($0) }
+        }
+
+        // Pointer registers are not truncated by the virtual machine, so only
+        // fold pointer arithmetic which stays within the address space.
+        func pointer(_ value: Int?) -> Int? {
+            value.flatMap { (0...0xffff).contains($0) ? $0 : nil }
+        }
+
+        let int16 = Int(Int16.min)...Int(Int16.max)
+        let int8 = Int(Int8.min)...Int(Int8.max)
+
+        switch instruction {
+        case let .not(_, a):
+            return bool(o(a).map { !$0 })
+        case let .eqo(_, a, c):
+            return bool(both(o(a), o(c)) { $0 == $1 })
+        case let .neo(_, a, c):
+            return bool(both(o(a), o(c)) { $0 != $1 })
+        case let .lio(_, value):
+            return bool(value)
+        case let .eqp(_, a, c):
+            return bool(both(p(a), p(c)) { $0 == $1 })
+        case let .nep(_, a, c):
+            return bool(both(p(a), p(c)) { $0 != $1 })
+        case let .lip(_, value):
+            return pointer(value)
+        case let .addip(_, a, k):
+            return pointer(p(a).map { $0 + k })
+        case let .subip(_, a, k):
+            return pointer(p(a).map { $0 - k })
+        case let .addpw(_, a, c):
+            return pointer(both(p(a), word(w(c))) { $0 + $1 })
+        case let .andiw(_, a, k):
+            guard (0...0xffff).contains(k) else {
+                return nil
+            }
+            return word(w(a).map { $0 & UInt16(k) })
+        case let .addiw(_, a, k):
+            guard int16.contains(k) else {
+                return nil
+            }
+            return word(w(a).map { $0 &+ UInt16(truncatingIfNeeded: k) })
+        case let .subiw(_, a, k):
+            guard int16.contains(k) else {
+                return nil
+            }
+            return word(w(a).map { $0 &- UInt16(truncatingIfNeeded: k) })
+        case let .muliw(_, a, k):
+            guard int16.contains(k) else {
+                return nil
+            }
+            return word(w(a).map { $0 &* UInt16(truncatingIfNeeded: k) })
+        case let .liw(_, value):
+            return int16.contains(value) ? Int(UInt16(truncatingIfNeeded: value)) : nil
+        case let .liuw(_, value):
+            return (0...0xffff).contains(value) ? value : nil
+        case let .andw(_, a, c):
+            return word(both(w(a), w(c)) { $0 & $1 })
+        case let .orw(_, a, c):
+            return word(both(w(a), w(c)) { $0 | $1 })
+        case let .xorw(_, a, c):
+            return word(both(w(a), w(c)) { $0 ^ $1 })
+        case let .negw(_, a):
+            return word(w(a).map { ~$0 })
+        case let .addw(_, a, c):
+            return word(both(w(a), w(c)) { $0 &+ $1 })
+        case let .subw(_, a, c):
+            return word(both(w(a), w(c)) { $0 &- $1 })
+        case let .mulw(_, a, c):
+            return word(both(w(a), w(c)) { $0 &* $1 })
+        case let .divw(_, a, c):
+            return both(sw(a), sw(c)) { n, d in
+                guard d != 0, int16.contains(n / d) else {
+                    return nil
+                }
+                return Int(UInt16(truncatingIfNeeded: n / d))
+            }
+        case let .divuw(_, a, c):
+            return word(both(w(a), w(c)) { $1 == 0 ? nil : $0 / $1 })
+        case let .modw(_, a, c):
+            return word(both(w(a), w(c)) { $1 == 0 ? nil : $0 % $1 })
+        case let .lslw(_, a, c):
+            return word(both(w(a), w(c)) { $0 << $1 })
+        case let .lsrw(_, a, c):
+            return word(both(w(a), w(c)) { $0 >> $1 })
+        case let .eqw(_, a, c):
+            return bool(both(w(a), w(c)) { $0 == $1 })
+        case let .new(_, a, c):
+            return bool(both(w(a), w(c)) { $0 != $1 })
+        case let .ltw(_, a, c):
+            return bool(both(sw(a), sw(c)) { $0 < $1 })
+        case let .gew(_, a, c):
+            return bool(both(sw(a), sw(c)) { $0 >= $1 })
+        case let .lew(_, a, c):
+            return bool(both(sw(a), sw(c)) { $0 <= $1 })
+        case let .gtw(_, a, c):
+            return bool(both(sw(a), sw(c)) { $0 > $1 })
+        case let .ltuw(_, a, c):
+            return bool(both(w(a), w(c)) { $0 < $1 })
+        case let .geuw(_, a, c):
+            return bool(both(w(a), w(c)) { $0 >= $1 })
+        case let .leuw(_, a, c):
+            return bool(both(w(a), w(c)) { $0 <= $1 })
+        case let .gtuw(_, a, c):
+            return bool(both(w(a), w(c)) { $0 > $1 })
+        case let .lib(_, value):
+            return int8.contains(value) ? Int(UInt8(truncatingIfNeeded: value)) : nil
+        case let .liub(_, value):
+            return (0...0xff).contains(value) ? value : nil
+        case let .andb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 & $1 })
+        case let .orb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 | $1 })
+        case let .xorb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 ^ $1 })
+        case let .negb(_, a):
+            return byte(b(a).map { ~$0 })
+        case let .addb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 &+ $1 })
+        case let .subb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 &- $1 })
+        case let .mulb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 &* $1 })
+        case let .divb(_, a, c):
+            return both(sb(a), sb(c)) { n, d in
+                guard d != 0, int8.contains(n / d) else {
+                    return nil
+                }
+                return Int(UInt8(truncatingIfNeeded: n / d))
+            }
+        case let .divub(_, a, c):
+            return byte(both(b(a), b(c)) { $1 == 0 ? nil : $0 / $1 })
+        case let .modb(_, a, c):
+            return byte(both(b(a), b(c)) { $1 == 0 ? nil : $0 % $1 })
+        case let .lslb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 << $1 })
+        case let .lsrb(_, a, c):
+            return byte(both(b(a), b(c)) { $0 >> $1 })
+        case let .eqb(_, a, c):
+            return bool(both(b(a), b(c)) { $0 == $1 })
+        case let .neb(_, a, c):
+            return bool(both(b(a), b(c)) { $0 != $1 })
+        case let .ltb(_, a, c):
+            return bool(both(sb(a), sb(c)) { $0 < $1 })
+        case let .geb(_, a, c):
+            return bool(both(sb(a), sb(c)) { $0 >= $1 })
+        case let .leb(_, a, c):
+            return bool(both(sb(a), sb(c)) { $0 <= $1 })
+        case let .gtb(_, a, c):
+            return bool(both(sb(a), sb(c)) { $0 > $1 })
+        case let .ltub(_, a, c):
+            return bool(both(b(a), b(c)) { $0 < $1 })
+        case let .geub(_, a, c):
+            return bool(both(b(a), b(c)) { $0 >= $1 })
+        case let .leub(_, a, c):
+            return bool(both(b(a), b(c)) { $0 <= $1 })
+        case let .gtub(_, a, c):
+            return bool(both(b(a), b(c)) { $0 > $1 })
+        case let .movsbw(_, a), let .movzbw(_, a):
+            return byte(w(a).map { UInt8(truncatingIfNeeded: $0) })
+        case let .movswb(_, a):
+            return word(sb(a).map { UInt16(bitPattern: Int16($0)) })
+        case let .movzwb(_, a):
+            return word(b(a).map { UInt16($0) })
+        case let .movp(_, a):
+            return p(a)
+        case let .movw(_, a):
+            return word(w(a))
+        case let .movb(_, a):
+            return byte(b(a))
+        case let .movo(_, a):
+            return bool(o(a))
+        default:
+            return nil
+        }
+    }
+
+    /// An instruction which only computes a value in its destination
+    /// register, and which cannot fail. It may be removed if the value is
+    /// never read.
+    private func isPure(_ instruction: TackInstruction) -> Bool {
+        switch instruction {
+        case .not, .eqo, .neo, .lio, .eqp, .nep, .lip, .addip, .subip, .addpw,
+            .andiw, .addiw, .subiw, .muliw, .liw, .liuw, .andw, .orw, .xorw,
+            .negw, .addw, .subw, .mulw, .lslw, .lsrw, .eqw, .new, .ltw, .gew,
+            .lew, .gtw, .ltuw, .geuw, .leuw, .gtuw, .lib, .liub, .andb, .orb,
+            .xorb, .negb, .addb, .subb, .mulb, .lslb, .lsrb, .eqb, .neb, .ltb,
+            .geb, .leb, .gtb, .ltub, .geub, .leub, .gtub, .movsbw, .movswb,
+            .movzwb, .movzbw, .movp, .movw, .movb, .movo, .bitcast, .la:
+            true
+
+        default:
+            false
+        }
+    }
+
+    // MARK: - Dead Code
+
+    /// Remove pure instructions whose results are never read
+    private func eliminateDeadCode(
+        _ nodes: [AbstractSyntaxTreeNode],
+        _ addressTaken: Set<String>
+    ) -> [AbstractSyntaxTreeNode] {
+        let cfg = ControlFlowGraph(nodes, addressTaken)
+
+        func isDead(_ instruction: TackInstruction, _ live: Set<Register>) -> Bool {
+            guard let dst = instruction.definition else {
+                return false
+            }
+            return isPure(instruction) && dst.isVirtual && !live.contains(dst)
+        }
+
+        // Step backward over one instruction. The uses of a dead instruction
+        // do not make anything live.
+        func transfer(_ instruction: TackInstruction, _ live: inout Set<Register>) {
+            switch instruction {
+            case .enter, .leave:
+                live = []
+
+            default:
+                guard !isDead(instruction, live) else {
+                    return
+                }
+                if let dst = instruction.definition {
+                    live.remove(dst)
+                }
+                live.formUnion(instruction.uses)
+            }
+        }
+
+        var liveIn = [Set<Register>](repeating: [], count: cfg.blocks.count)
+        var worklist = Array(cfg.blocks.indices)
+        var isInWorklist = [Bool](repeating: true, count: cfg.blocks.count)
+        while let b = worklist.popLast() {
+            isInWorklist[b] = false
+            var live = cfg.successors[b].reduce(into: Set<Register>()) { $0.formUnion(liveIn[$1]) }
+            for node in nodes[cfg.blocks[b]].reversed() {
+                if let instruction = (node as? TackInstructionNode)?.instruction {
+                    transfer(instruction, &live)
+                }
+            }
+            if live != liveIn[b] {
+                liveIn[b] = live
+                for pred in cfg.predecessors[b] where !isInWorklist[pred] {
+                    isInWorklist[pred] = true
+                    worklist.append(pred)
+                }
+            }
+        }
+
+        var result: [AbstractSyntaxTreeNode] = []
+        for (b, block) in cfg.blocks.enumerated() {
+            var live = cfg.successors[b].reduce(into: Set<Register>()) { $0.formUnion(liveIn[$1]) }
+            var kept: [AbstractSyntaxTreeNode] = []
+            for node in nodes[block].reversed() {
+                if let instruction = (node as? TackInstructionNode)?.instruction {
+                    if isDead(instruction, live) {
+                        continue
+                    }
+                    transfer(instruction, &live)
+                }
+                kept.append(node)
+            }
+            result += kept.reversed()
+        }
+        return result
+    }
+}
+
+extension TackInstruction.Register {
+    /// Registers other than sp, fp, and ra are virtual registers which hold
+    /// temporary values
+    var isVirtual: Bool {
+        switch self {
+        case .p(.p): true
+        case .p: false
+        default: true
+        }
+    }
+
+    /// The register changes only when it is written explicitly, or at ENTER
+    /// and LEAVE. The stack pointer also changes implicitly, e.g., by
+    /// ALLOCA, and the return address by CALL.
+    fileprivate var isUnchangedWithinFrame: Bool {
+        isVirtual || self == .p(.fp)
+    }
+
+    /// A register of the same type which never appears in a program
+    fileprivate var placeholder: Self {
+        switch self {
+        case .p: .p(.p(-1))
+        case .w: .w(.w(-1))
+        case .b: .b(.b(-1))
+        case .o: .o(.o(-1))
+        }
+    }
+}
+
+extension TackInstruction {
+    /// Ends a basic block
+    fileprivate var isEndOfBlock: Bool {
+        switch self {
+        case .jmp, .bz, .bnz, .bzw, .ret, .hlt: true
+        default: false
+        }
+    }
+
+    fileprivate var isLoadImmediate: Bool {
+        switch self {
+        case .lio, .lip, .liw, .liuw, .lib, .liub: true
+        default: false
+        }
+    }
+
+    /// The source register, if this copies one register to another of the
+    /// same type
+    fileprivate var copySource: Register? {
+        switch self {
+        case let .movp(_, src): .p(src)
+        case let .movw(_, src): .w(src)
+        case let .movb(_, src): .b(src)
+        case let .movo(_, src): .o(src)
+        default: nil
+        }
+    }
+
+    /// Copy one register to another of the same type
+    fileprivate static func move(_ dst: Register, _ src: Register) -> TackInstruction? {
+        switch (dst, src) {
+        case let (.p(dst), .p(src)): .movp(dst, src)
+        case let (.w(dst), .w(src)): .movw(dst, src)
+        case let (.b(dst), .b(src)): .movb(dst, src)
+        case let (.o(dst), .o(src)): .movo(dst, src)
+        default: nil
+        }
+    }
+
+    /// Load a constant, given as the unsigned bit pattern of the register
+    fileprivate static func loadImmediate(_ dst: Register, _ value: Int) -> TackInstruction {
+        switch dst {
+        case let .p(dst):
+            return .lip(dst, value)
+
+        case let .w(dst):
+            // LIW is cheaper on Turtle16 when the value fits in a signed byte.
+            let signed = Int(Int16(truncatingIfNeeded: value))
+            return (-128...127).contains(signed) ? .liw(dst, signed) : .liuw(dst, value)
+
+        case let .b(dst):
+            return .liub(dst, value)
+
+        case let .o(dst):
+            return .lio(dst, value != 0)
+        }
+    }
+
+    /// The register written by the instruction, if any
+    var definition: Register? {
+        var result: Register?
+        _ = mapRegisters(
+            definition: {
+                result = $0
+                return $0
+            },
+            use: { $0 }
+        )
+        return result
+    }
+
+    /// The registers read by the instruction
+    var uses: [Register] {
+        var result: [Register] = []
+        _ = mapRegisters(
+            definition: { $0 },
+            use: {
+                result.append($0)
+                return $0
+            }
+        )
+        return result
+    }
+
+    /// Replace each register written by the instruction, and each register
+    /// read by it. The replacement must have the same type as the original.
+    func mapRegisters(
+        definition: (Register) -> Register,
+        use: (Register) -> Register
+    ) -> TackInstruction {
+        func defP(_ r: RegisterPointer) -> RegisterPointer { definition(.p(r)).unwrapPointer! }
+        func defW(_ r: Register16) -> Register16 { definition(.w(r)).unwrap16! }
+        func defB(_ r: Register8) -> Register8 { definition(.b(r)).unwrap8! }
+        func defO(_ r: RegisterBoolean) -> RegisterBoolean { definition(.o(r)).unwrapBool! }
+        func useP(_ r: RegisterPointer) -> RegisterPointer { use(.p(r)).unwrapPointer! }
+        func useW(_ r: Register16) -> Register16 { use(.w(r)).unwrap16! }
+        func useB(_ r: Register8) -> Register8 { use(.b(r)).unwrap8! }
+        func useO(_ r: RegisterBoolean) -> RegisterBoolean { use(.o(r)).unwrapBool! }
+
+        switch self {
+        case .nop, .hlt, .call, .enter, .leave, .ret, .jmp, .free, .inlineAssembly:
+            return self
+        case let .callptr(a): return .callptr(useP(a))
+        case let .la(c, label): return .la(defP(c), label)
+        case let .ststr(a, s): return .ststr(useP(a), s)
+        case let .memcpy(a, b, n): return .memcpy(useP(a), useP(b), n)
+        case let .alloca(c, n): return .alloca(defP(c), n)
+        case let .syscall(a, b): return .syscall(useP(a), useP(b))
+        case let .bz(a, label): return .bz(useO(a), label)
+        case let .bnz(a, label): return .bnz(useO(a), label)
+        case let .not(c, a): return .not(defO(c), useO(a))
+        case let .eqo(c, a, b): return .eqo(defO(c), useO(a), useO(b))
+        case let .neo(c, a, b): return .neo(defO(c), useO(a), useO(b))
+        case let .lio(c, k): return .lio(defO(c), k)
+        case let .lo(c, a, k): return .lo(defO(c), useP(a), k)
+        case let .so(c, a, k): return .so(useO(c), useP(a), k)
+        case let .eqp(c, a, b): return .eqp(defO(c), useP(a), useP(b))
+        case let .nep(c, a, b): return .nep(defO(c), useP(a), useP(b))
+        case let .lip(c, k): return .lip(defP(c), k)
+        case let .addip(c, a, k): return .addip(defP(c), useP(a), k)
+        case let .subip(c, a, k): return .subip(defP(c), useP(a), k)
+        case let .addpw(c, a, b): return .addpw(defP(c), useP(a), useW(b))
+        case let .lp(c, a, k): return .lp(defP(c), useP(a), k)
+        case let .sp(c, a, k): return .sp(useP(c), useP(a), k)
+        case let .lw(c, a, k): return .lw(defW(c), useP(a), k)
+        case let .sw(c, a, k): return .sw(useW(c), useP(a), k)
+        case let .bzw(a, label): return .bzw(useW(a), label)
+        case let .andiw(c, a, k): return .andiw(defW(c), useW(a), k)
+        case let .addiw(c, a, k): return .addiw(defW(c), useW(a), k)
+        case let .subiw(c, a, k): return .subiw(defW(c), useW(a), k)
+        case let .muliw(c, a, k): return .muliw(defW(c), useW(a), k)
+        case let .liw(c, k): return .liw(defW(c), k)
+        case let .liuw(c, k): return .liuw(defW(c), k)
+        case let .andw(c, a, b): return .andw(defW(c), useW(a), useW(b))
+        case let .orw(c, a, b): return .orw(defW(c), useW(a), useW(b))
+        case let .xorw(c, a, b): return .xorw(defW(c), useW(a), useW(b))
+        case let .negw(c, a): return .negw(defW(c), useW(a))
+        case let .addw(c, a, b): return .addw(defW(c), useW(a), useW(b))
+        case let .subw(c, a, b): return .subw(defW(c), useW(a), useW(b))
+        case let .mulw(c, a, b): return .mulw(defW(c), useW(a), useW(b))
+        case let .divw(c, a, b): return .divw(defW(c), useW(a), useW(b))
+        case let .divuw(c, a, b): return .divuw(defW(c), useW(a), useW(b))
+        case let .modw(c, a, b): return .modw(defW(c), useW(a), useW(b))
+        case let .lslw(c, a, b): return .lslw(defW(c), useW(a), useW(b))
+        case let .lsrw(c, a, b): return .lsrw(defW(c), useW(a), useW(b))
+        case let .eqw(c, a, b): return .eqw(defO(c), useW(a), useW(b))
+        case let .new(c, a, b): return .new(defO(c), useW(a), useW(b))
+        case let .ltw(c, a, b): return .ltw(defO(c), useW(a), useW(b))
+        case let .gew(c, a, b): return .gew(defO(c), useW(a), useW(b))
+        case let .lew(c, a, b): return .lew(defO(c), useW(a), useW(b))
+        case let .gtw(c, a, b): return .gtw(defO(c), useW(a), useW(b))
+        case let .ltuw(c, a, b): return .ltuw(defO(c), useW(a), useW(b))
+        case let .geuw(c, a, b): return .geuw(defO(c), useW(a), useW(b))
+        case let .leuw(c, a, b): return .leuw(defO(c), useW(a), useW(b))
+        case let .gtuw(c, a, b): return .gtuw(defO(c), useW(a), useW(b))
+        case let .lb(c, a, k): return .lb(defB(c), useP(a), k)
+        case let .sb(c, a, k): return .sb(useB(c), useP(a), k)
+        case let .lib(c, k): return .lib(defB(c), k)
+        case let .liub(c, k): return .liub(defB(c), k)
+        case let .andb(c, a, b): return .andb(defB(c), useB(a), useB(b))
+        case let .orb(c, a, b): return .orb(defB(c), useB(a), useB(b))
+        case let .xorb(c, a, b): return .xorb(defB(c), useB(a), useB(b))
+        case let .negb(c, a): return .negb(defB(c), useB(a))
+        case let .addb(c, a, b): return .addb(defB(c), useB(a), useB(b))
+        case let .subb(c, a, b): return .subb(defB(c), useB(a), useB(b))
+        case let .mulb(c, a, b): return .mulb(defB(c), useB(a), useB(b))
+        case let .divb(c, a, b): return .divb(defB(c), useB(a), useB(b))
+        case let .divub(c, a, b): return .divub(defB(c), useB(a), useB(b))
+        case let .modb(c, a, b): return .modb(defB(c), useB(a), useB(b))
+        case let .lslb(c, a, b): return .lslb(defB(c), useB(a), useB(b))
+        case let .lsrb(c, a, b): return .lsrb(defB(c), useB(a), useB(b))
+        case let .eqb(c, a, b): return .eqb(defO(c), useB(a), useB(b))
+        case let .neb(c, a, b): return .neb(defO(c), useB(a), useB(b))
+        case let .ltb(c, a, b): return .ltb(defO(c), useB(a), useB(b))
+        case let .geb(c, a, b): return .geb(defO(c), useB(a), useB(b))
+        case let .leb(c, a, b): return .leb(defO(c), useB(a), useB(b))
+        case let .gtb(c, a, b): return .gtb(defO(c), useB(a), useB(b))
+        case let .ltub(c, a, b): return .ltub(defO(c), useB(a), useB(b))
+        case let .geub(c, a, b): return .geub(defO(c), useB(a), useB(b))
+        case let .leub(c, a, b): return .leub(defO(c), useB(a), useB(b))
+        case let .gtub(c, a, b): return .gtub(defO(c), useB(a), useB(b))
+        case let .movsbw(c, a): return .movsbw(defB(c), useW(a))
+        case let .movswb(c, a): return .movswb(defW(c), useB(a))
+        case let .movzwb(c, a): return .movzwb(defW(c), useB(a))
+        case let .movzbw(c, a): return .movzbw(defB(c), useW(a))
+        case let .movp(c, a): return .movp(defP(c), useP(a))
+        case let .movw(c, a): return .movw(defW(c), useW(a))
+        case let .movb(c, a): return .movb(defB(c), useB(a))
+        case let .movo(c, a): return .movo(defO(c), useO(a))
+        case let .bitcast(c, a): return .bitcast(definition(c), use(a))
+        }
+    }
+}
+
+extension TackProgram {
+    /// Optimize the program with TackOptimizer
+    public func optimized(jobs: Int = 1) throws -> TackProgram {
+        try TackFlattener.compile(TackOptimizer(jobs: jobs).compile(ast))
+    }
+}
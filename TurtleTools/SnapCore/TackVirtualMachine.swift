@@ -33,10 +33,28 @@ public final class TackVirtualMachine {
     public var pc: UInt = 0
     public var nextPc: UInt = 0
     public var isHalted = false
-    private var globalRegisters: [Register: UInt] = [:]
-    public var registers: [[Register: UInt]] = [[:]]
-    private var memoryPages: [UInt: [UInt]] = [:]
+
+    // The number of instructions executed so far
+    public private(set) var instructionCount: UInt = 0
+
+    // If true then run() executes the program through pre-bound handlers
+    // whenever no breakpoints are set. See `runCompiled()`.
+    public var isCompiledExecutionEnabled = true
+    private var registerSP: UInt = 0
+    private var registerFP: UInt = 0
+    private var frameSlots: [UInt]
+    private var frameSlotIsDefined: [Bool]
+    private var frameBases: [Int] = [0]
+    private var frameSizes: [Int]
+    private var frameBase = 0
+    private var frameSize: Int
+    private let frameSizeAtEnter: [Int]
+    private var memory: [UInt] = []
+    private var pageTable: [Int32]
+    private var distantPages: [UInt: Int] = [:]
     private var breakPoints: [Bool]
+    private var hasBreakPoints = false
+    private lazy var compiledInstructions: [CompiledInstruction] = compileProgram()
     public var onSerialOutput: (UInt8) -> Void = { _ in }
     public var onSerialInput: () -> UInt8 = { 0 }
 
@@ -46,45 +64,92 @@ public final class TackVirtualMachine {
         case putc
     }
 
+    // The register frames on the stack, from the outermost to the current
+    // frame. Each frame maps the registers defined in it to their values.
+    // The VM keeps these in a dense form internally, so this is a copy.
+    public var registers: [[Register: UInt]] {
+        get {
+            zip(frameBases, frameSizes).map { base, size in
+                var result: [Register: UInt] = [:]
+                for slot in 0..<size where frameSlotIsDefined[base + slot] {
+                    result[TackVirtualMachine.register(slot: slot)] = frameSlots[base + slot]
+                }
+                return result
+            }
+        }
+        set {
+            frameBases = []
+            frameSizes = []
+            var top = 0
+            for frameRegisters in newValue {
+                let maxSlot = frameRegisters.keys
+                    .compactMap { TackVirtualMachine.slot($0) }
+                    .max() ?? 0
+                frameBases.append(top)
+                frameSizes.append(maxSlot + 1)
+                top += maxSlot + 1
+            }
+            frameBase = frameBases.last ?? 0
+            frameSize = frameSizes.last ?? 0
+            frameSlots = [UInt](repeating: 0, count: top)
+            frameSlotIsDefined = [Bool](repeating: false, count: top)
+            for (frame, frameRegisters) in newValue.enumerated() {
+                for (reg, value) in frameRegisters {
+                    if let slot = TackVirtualMachine.slot(reg) {
+                        frameSlots[frameBases[frame] + slot] = value
+                        frameSlotIsDefined[frameBases[frame] + slot] = true
+                    }
+                }
+            }
+        }
+    }
+
+    private var frameCount: Int {
+        frameBases.count
+    }
+
     public var backtrace: [UInt] {
         var result: [UInt] = []
-        for currentRegisterSet in registers {
-            guard let registerRA = currentRegisterSet[.ra] else {
+        for (base, size) in zip(frameBases, frameSizes) {
+            let index = base + TackVirtualMachine.kSlotRA
+            guard TackVirtualMachine.kSlotRA < size, frameSlotIsDefined[index] else {
                 break
             }
-            result.append(registerRA)
+            result.append(frameSlots[index])
         }
         result.append(pc)
         return result
     }
 
+    // The symbols and the source anchor in effect at each instruction, built
+    // once from the per-instruction tables of the program, so that a lookup
+    // does not scan backwards through those tables.
+    public let symbolsIndex: ProgramCounterIndex<Env>
+    public let sourceAnchorIndex: ProgramCounterIndex<SourceAnchor>
+
     public var symbols: Env? {
-        var result: Env? = nil
-        var i = Int(pc)
-        while i >= 0, result == nil {
-            if i < program.symbols.count {
-                result = program.symbols[i]
-            }
-            i = i - 1
-        }
-        return result
+        symbolsIndex[pc: pc]
     }
 
-    public func findSourceAnchor(pc pc_: UInt) -> SourceAnchor? {
-        var result: SourceAnchor? = nil
-        var i = Int(pc_)
-        while i >= 0, result == nil {
-            if i < program.sourceAnchor.count {
-                result = program.sourceAnchor[i]
-            }
-            i = i - 1
-        }
-        return result
+    public func findSourceAnchor(pc: UInt) -> SourceAnchor? {
+        sourceAnchorIndex[pc: pc]
     }
 
     public init(_ program: TackProgram) {
         self.program = program
+        symbolsIndex = ProgramCounterIndex(program.symbols, isSame: { $0 === $1 })
+        sourceAnchorIndex = ProgramCounterIndex(program.sourceAnchor)
         breakPoints = [Bool](repeating: false, count: program.instructions.count)
+        let (topLevelFrameSize, frameSizeAtEnter) = TackVirtualMachine.measureFrameSizes(program)
+        self.frameSizeAtEnter = frameSizeAtEnter
+        frameSize = topLevelFrameSize
+        frameSizes = [topLevelFrameSize]
+        frameSlots = [UInt](repeating: 0, count: topLevelFrameSize)
+        frameSlotIsDefined = [Bool](repeating: false, count: topLevelFrameSize)
+        pageTable = [Int32](
+            repeating: TackVirtualMachine.kUnmappedPage,
+            count: Int((2 * TackVirtualMachine.kPageTableReach) >> TackVirtualMachine.kPageShift)
+        )
         setRegister(.sp, p: 0)
         setRegister(.fp, p: 0)
     }
@@ -92,6 +157,7 @@ public final class TackVirtualMachine {
     public func setBreakPoint(pc: UInt, value: Bool) {
         assert(pc >= 0 && pc < program.instructions.count)
         breakPoints[Int(pc)] = value
+        hasBreakPoints = value || breakPoints.contains(true)
     }
 
     public func isBreakPoint(pc: UInt) -> Bool {
@@ -162,84 +228,241 @@ public final class TackVirtualMachine {
     }
 
     public func getRegister(p reg: RegisterPointer) throws -> UInt {
-        let val = try getRegister(.p(reg))
-        return val
+        switch reg {
+        case .sp:
+            return registerSP
+
+        case .fp:
+            return registerFP
+
+        case .ra:
+            guard let val = readFrameSlot(TackVirtualMachine.kSlotRA) else {
+                throw TackVirtualMachineError.undefinedRegister(.p(reg))
+            }
+            return val
+
+        case let .p(i):
+            guard let val = readFrameSlot(TackVirtualMachine.slot(p: i)) else {
+                throw TackVirtualMachineError.undefinedRegister(.p(reg))
+            }
+            return val
+        }
     }
 
     public func getRegister(w reg: Register16) throws -> UInt16 {
-        let val = try getRegister(.w(reg))
+        guard case let .w(i) = reg, let val = readFrameSlot(TackVirtualMachine.slot(w: i)) else {
+            throw TackVirtualMachineError.undefinedRegister(.w(reg))
+        }
         return UInt16(val & 0xffff)
     }
 
     public func getRegister(b reg: Register8) throws -> UInt8 {
-        let val = try getRegister(.b(reg))
+        guard case let .b(i) = reg, let val = readFrameSlot(TackVirtualMachine.slot(b: i)) else {
+            throw TackVirtualMachineError.undefinedRegister(.b(reg))
+        }
         return UInt8(val & 0xff)
     }
 
     public func getRegister(o reg: RegisterBoolean) throws -> Bool {
-        let val = try getRegister(.o(reg))
+        guard case let .o(i) = reg, let val = readFrameSlot(TackVirtualMachine.slot(o: i)) else {
+            throw TackVirtualMachineError.undefinedRegister(.o(reg))
+        }
         return val != 0
     }
 
     public func getRegister(_ reg: Register) throws -> UInt {
         switch reg {
-        case .sp,
-             .fp:
-            // We should have set fp and sp in init() so this ought never fail.
-            return globalRegisters[reg]!
-
-        case .ra,
-             .p(_),
-             .w(_),
-             .b(_),
-             .o:
-            guard let value = registers[registers.count - 1][reg] else {
+        case let .p(p):
+            return try getRegister(p: p)
+
+        case .w, .b, .o:
+            guard let val = readFrameSlot(TackVirtualMachine.slot(reg)!) else {
                 throw TackVirtualMachineError.undefinedRegister(reg)
             }
-            return value
+            return val
         }
     }
 
     public func setRegister(_ reg: RegisterPointer, p value: UInt) {
-        setRegister(.p(reg), value)
+        switch reg {
+        case .sp:
+            registerSP = value
+
+        case .fp:
+            registerFP = value
+
+        case .ra:
+            writeFrameSlot(TackVirtualMachine.kSlotRA, value)
+
+        case let .p(i):
+            writeFrameSlot(TackVirtualMachine.slot(p: i), value)
+        }
     }
 
     public func setRegister(_ reg: Register16, w value: UInt16) {
-        setRegister(.w(reg), UInt(value))
+        switch reg {
+        case let .w(i):
+            writeFrameSlot(TackVirtualMachine.slot(w: i), UInt(value))
+        }
     }
 
     public func setRegister(_ reg: Register8, b value: UInt8) {
-        setRegister(.b(reg), UInt(value))
+        switch reg {
+        case let .b(i):
+            writeFrameSlot(TackVirtualMachine.slot(b: i), UInt(value))
+        }
     }
 
     public func setRegister(_ reg: RegisterBoolean, o value: Bool) {
-        setRegister(.o(reg), value ? 1 : 0)
+        switch reg {
+        case let .o(i):
+            writeFrameSlot(TackVirtualMachine.slot(o: i), value ? 1 : 0)
+        }
     }
 
     public func setRegister(_ reg: Register, _ value: UInt) {
-        switch reg {
-        case .sp,
-             .fp:
-            globalRegisters[reg] = value
-
-        case .ra,
-             .p(_),
-             .w(_),
-             .b(_),
-             .o:
-            registers[registers.count - 1][reg] = value
+        if let slot = TackVirtualMachine.slot(reg) {
+            writeFrameSlot(slot, value)
+        }
+        else {
+            setRegister(reg.unwrapPointer!, p: value)
         }
     }
 
     public func pushRegisters() throws {
-        registers.append([:])
+        try pushRegisters(frameSize: TackVirtualMachine.kDefaultFrameSize)
+    }
+
+    // Push a frame with room for the given number of slots. The frame is
+    // placed directly above the current one, so that a call only touches
+    // the slots of its own frame.
+    private func pushRegisters(frameSize size: Int) throws {
+        let base = frameCount > 0 ? frameBase + frameSize : 0
+        frameBases.append(base)
+        frameSizes.append(size)
+        frameBase = base
+        frameSize = size
+        reserveFrameSlots(base..<(base + size))
     }
 
     public func popRegisters() throws {
-        guard !registers.isEmpty else {
+        guard frameCount > 0 else {
             throw TackVirtualMachineError.underflowRegisterStack
         }
-        registers.removeLast()
+        frameBases.removeLast()
+        frameSizes.removeLast()
+        frameBase = frameBases.last ?? 0
+        frameSize = frameSizes.last ?? 0
+    }
+
+    // Make room for the slots at the top of the stack and mark them as
+    // undefined. Slots above the top of the stack are kept to avoid
+    // reallocating on every call, so they must be cleared when reused.
+    private func reserveFrameSlots(_ range: Range<Int>) {
+        let reused = range.lowerBound..<min(range.upperBound, frameSlotIsDefined.count)
+        for i in reused {
+            frameSlotIsDefined[i] = false
+        }
+        if frameSlots.count < range.upperBound {
+            frameSlots.append(contentsOf: repeatElement(0, count: range.upperBound - frameSlots.count))
+            frameSlotIsDefined.append(
+                contentsOf: repeatElement(false, count: range.upperBound - frameSlotIsDefined.count)
+            )
+        }
+    }
+
+    // Registers other than sp and fp are numbered densely within a frame.
+    // The register classes are interleaved so that any register with index i
+    // has a slot below 4(i+1)+1, and ra is always in slot zero.
+    private static let kSlotRA = 0
+    private static let kDefaultFrameSize = 1 + 4 * 16
+
+    @inline(__always) private static func slot(p i: Int) -> Int { 1 + 4 * i }
+    @inline(__always) private static func slot(w i: Int) -> Int { 2 + 4 * i }
+    @inline(__always) private static func slot(b i: Int) -> Int { 3 + 4 * i }
+    @inline(__always) private static func slot(o i: Int) -> Int { 4 + 4 * i }
+
+    private static func register(slot: Int) -> Register {
+        if slot == kSlotRA {
+            return .ra
+        }
+        let i = (slot - 1) / 4
+        switch (slot - 1) % 4 {
+        case 0: return .p(.p(i))
+        case 1: return .w(.w(i))
+        case 2: return .b(.b(i))
+        default: return .o(.o(i))
+        }
+    }
+
+    private static func slot(_ reg: Register) -> Int? {
+        switch reg {
+        case .p(.sp), .p(.fp): nil
+        case .p(.ra): kSlotRA
+        case let .p(.p(i)): slot(p: i)
+        case let .w(.w(i)): slot(w: i)
+        case let .b(.b(i)): slot(b: i)
+        case let .o(.o(i)): slot(o: i)
+        }
+    }
+
+    @inline(__always)
+    private func readFrameSlot(_ slot: Int) -> UInt? {
+        guard slot >= 0, slot < frameSize else {
+            return nil
+        }
+        let index = frameBase + slot
+        return frameSlotIsDefined[index] ? frameSlots[index] : nil
+    }
+
+    @inline(__always)
+    private func writeFrameSlot(_ slot: Int, _ value: UInt) {
+        precondition(slot >= 0 && frameCount > 0)
+        if slot >= frameSize {
+            growFrame(toInclude: slot)
+        }
+        let index = frameBase + slot
+        frameSlots[index] = value
+        frameSlotIsDefined[index] = true
+    }
+
+    // Widen the current frame so that it has room for the slot. Registers
+    // are only ever written in the frame at the top of the stack, so this
+    // does not move any other frame. It is rare since each frame is sized
+    // for the subroutine which entered it.
+    private func growFrame(toInclude slot: Int) {
+        let newSize = slot + 1
+        reserveFrameSlots((frameBase + frameSize)..<(frameBase + newSize))
+        frameSize = newSize
+        frameSizes[frameSizes.count - 1] = newSize
+    }
+
+    // The number of slots needed by the top-level code, and by the frame
+    // pushed by the ENTER at each instruction index. The registers of a
+    // subroutine are numbered from zero, so each ENTER needs only the slots
+    // of the registers used between it and the next ENTER.
+    private static func measureFrameSizes(_ program: TackProgram) -> (Int, [Int]) {
+        var frameSizeAtEnter = [Int](repeating: 0, count: program.instructions.count)
+        var topLevelFrameSize = kSlotRA + 1
+        var enter: Int?
+        for (pc, ins) in program.instructions.enumerated() {
+            if case .enter = ins {
+                enter = pc
+                frameSizeAtEnter[pc] = kSlotRA + 1
+            }
+            for reg in ins.uses + [ins.definition].compactMap({ $0 }) {
+                guard let slot = TackVirtualMachine.slot(reg) else {
+                    continue
+                }
+                if let enter {
+                    frameSizeAtEnter[enter] = max(frameSizeAtEnter[enter], slot + 1)
+                }
+                else {
+                    topLevelFrameSize = max(topLevelFrameSize, slot + 1)
+                }
+            }
+        }
+        return (topLevelFrameSize, frameSizeAtEnter)
     }
 
     public func loadp(address: UInt) -> UInt {
@@ -270,14 +493,11 @@ public final class TackVirtualMachine {
             else {
                 base &- UInt(-signedOffset)
             }
-        let pageMask: UInt = kPageSize - 1
-        let pageIndex: UInt = address & ~pageMask
-        let pageOffset: UInt = address & pageMask
-        if memoryPages[pageIndex] == nil {
-            memoryPages[pageIndex] = [UInt](repeating: 0, count: Int(kPageSize))
+        guard let index = memoryIndex(address, allocate: false) else {
+            // Memory which has never been written reads as zero.
+            return 0
         }
-        let result = memoryPages[pageIndex]![Int(pageOffset)]
-        return result
+        return memory[index]
     }
 
     public func store(p val: UInt, address: UInt) {
@@ -309,19 +529,71 @@ public final class TackVirtualMachine {
             onSerialOutput(octet)
         }
         else {
-            let pageMask: UInt = kPageSize - 1
-            let pageIndex: UInt = address & ~pageMask
-            let pageOffset: UInt = address & pageMask
-            if memoryPages[pageIndex] == nil {
-                memoryPages[pageIndex] = [UInt](repeating: 0, count: Int(kPageSize))
+            let index = memoryIndex(address, allocate: true)!
+            memory[index] = value
+        }
+    }
+
+    // Pages are allocated contiguously in `memory`, in the order in which
+    // they are first written. The page table maps the pages within
+    // kPageTableReach of address zero, in either direction, to their offset
+    // in `memory`. The stack grows down from zero and wraps around to the top
+    // of the address space, so this window covers the stack and the heap of
+    // any ordinary program. Pages outside the window are found through a
+    // dictionary instead.
+    private static let kPageShift: UInt = 12
+    private static let kPageTableReach: UInt = 1 << 24
+    private static let kUnmappedPage: Int32 = -1
+
+    @inline(__always)
+    private func memoryIndex(_ address: UInt, allocate: Bool) -> Int? {
+        let pageMask: UInt = (1 << TackVirtualMachine.kPageShift) - 1
+        let pageOffset = Int(address & pageMask)
+        let biased = address &+ TackVirtualMachine.kPageTableReach
+        if biased < 2 * TackVirtualMachine.kPageTableReach {
+            let pageNumber = Int(biased >> TackVirtualMachine.kPageShift)
+            var page = pageTable[pageNumber]
+            if page == TackVirtualMachine.kUnmappedPage {
+                guard allocate else {
+                    return nil
+                }
+                page = Int32(allocatePage())
+                pageTable[pageNumber] = page
             }
-            memoryPages[pageIndex]![Int(pageOffset)] = value
+            return (Int(page) << TackVirtualMachine.kPageShift) | pageOffset
         }
+        else {
+            let pageIndex = address & ~pageMask
+            let page: Int
+            if let existing = distantPages[pageIndex] {
+                page = existing
+            }
+            else {
+                guard allocate else {
+                    return nil
+                }
+                page = allocatePage()
+                distantPages[pageIndex] = page
+            }
+            return (page << TackVirtualMachine.kPageShift) | pageOffset
+        }
+    }
+
+    private func allocatePage() -> Int {
+        let page = memory.count >> TackVirtualMachine.kPageShift
+        memory.append(contentsOf: repeatElement(0, count: Int(kPageSize)))
+        return page
     }
 
     public func run() throws {
         var shouldStepOver = true
         while !isHalted {
+            if isCompiledExecutionEnabled, !hasBreakPoints {
+                try runCompiled()
+                shouldStepOver = false
+                continue
+            }
+
             if pc < program.instructions.count, breakPoints[Int(pc)], !shouldStepOver {
                 return
             }
@@ -338,6 +610,7 @@ public final class TackVirtualMachine {
         }
 
         nextPc = pc + 1
+        instructionCount = instructionCount &+ 1
         let ins = program.instructions[Int(pc)]
 
         switch ins {
@@ -350,7 +623,7 @@ public final class TackVirtualMachine {
         case let .callptr(target):
             try callptr(target)
         case let .enter(numberOfWords):
-            try enter(numberOfWords)
+            try enter(numberOfWords, frameSize: frameSizeAtEnter[Int(pc)])
         case .leave:
             try leave()
         case .ret:
@@ -571,12 +844,12 @@ public final class TackVirtualMachine {
     let kSizeOfSavedRegisters: UInt =
         7 // TODO: The size of this register save-area needs to be machine-specific. Different targets will need different sizes.
 
-    private func enter(_ numberOfWords: Int) throws {
+    private func enter(_ numberOfWords: Int, frameSize: Int) throws {
         guard numberOfWords >= 0 else {
             throw TackVirtualMachineError.invalidArgument
         }
 
-        try pushRegisters()
+        try pushRegisters(frameSize: frameSize)
         let fp = try getRegister(p: .fp)
         var sp = try getRegister(p: .sp)
         sp = sp &- kSizeOfSavedRegisters
@@ -642,52 +915,52 @@ public final class TackVirtualMachine {
 
     private func lp(_ dst: RegisterPointer, _ address: RegisterPointer, _ signedOffset: Int) throws
     {
-        let base = try getRegister(.p(address))
+        let base = try getRegister(p: address)
         let value = load(address: base, signedOffset: signedOffset)
         setRegister(.p(dst), value)
     }
 
     private func lw(_ dst: Register16, _ address: RegisterPointer, _ signedOffset: Int) throws {
-        let base = try getRegister(.p(address))
+        let base = try getRegister(p: address)
         let value = load(address: base, signedOffset: signedOffset)
         setRegister(.w(dst), value)
     }
 
     private func lb(_ dst: Register8, _ address: RegisterPointer, _ signedOffset: Int) throws {
-        let base = try getRegister(.p(address))
+        let base = try getRegister(p: address)
         let value = load(address: base, signedOffset: signedOffset)
         setRegister(.b(dst), value)
     }
 
     private func lo(_ dst: RegisterBoolean, _ address: RegisterPointer, _ signedOffset: Int) throws
     {
-        let base = try getRegister(.p(address))
+        let base = try getRegister(p: address)
         let value = load(address: base, signedOffset: signedOffset)
         setRegister(.o(dst), value)
     }
 
     private func sp(_ src: RegisterPointer, _ address: RegisterPointer, _ signedOffset: Int) throws
     {
-        let addressToAccess = try getRegister(.p(address))
-        let value = try getRegister(.p(src))
+        let addressToAccess = try getRegister(p: address)
+        let value = try getRegister(p: src)
         store(value: value, address: addressToAccess, signedOffset: signedOffset)
     }
 
     private func sw(_ src: Register16, _ address: RegisterPointer, _ signedOffset: Int) throws {
-        let addressToAccess = try getRegister(.p(address))
+        let addressToAccess = try getRegister(p: address)
         let value = try getRegister(.w(src))
         store(value: value, address: addressToAccess, signedOffset: signedOffset)
     }
 
     private func sb(_ src: Register8, _ address: RegisterPointer, _ signedOffset: Int) throws {
-        let addressToAccess = try getRegister(.p(address))
+        let addressToAccess = try getRegister(p: address)
         let value = try getRegister(.b(src))
         store(value: value, address: addressToAccess, signedOffset: signedOffset)
     }
 
     private func so(_ src: RegisterBoolean, _ address: RegisterPointer, _ signedOffset: Int) throws
     {
-        let addressToAccess = try getRegister(.p(address))
+        let addressToAccess = try getRegister(p: address)
         let value = try getRegister(.o(src))
         store(value: value, address: addressToAccess, signedOffset: signedOffset)
     }
@@ -1402,6 +1675,7 @@ public final class TackVirtualMachine {
         case "BREAK":
             if nextPc < breakPoints.count {
                 breakPoints[Int(nextPc)] = true
+                hasBreakPoints = true
             }
 
         default:
@@ -1464,3 +1738,523 @@ public final class TackVirtualMachine {
         setRegister(dst, p: result)
     }
 }
+
+// MARK: - Compiled execution
+
+// The interpreter in step() decodes each instruction afresh every time it is
+// executed, looking up labels by name and registers by their operands. In
+// compiled execution, each instruction is instead translated once into a
+// closure with its labels resolved to instruction indices, its immediates
+// unpacked, and its register operands resolved to frame slots.
+//
+// The compiled form behaves exactly as the interpreter does, including the
+// errors thrown. Breakpoints are only checked by the interpreter, and so run()
+// falls back to the interpreter whenever a breakpoint is set. step() always
+// uses the interpreter.
+extension TackVirtualMachine {
+    fileprivate typealias CompiledInstruction = (TackVirtualMachine) throws -> Void
+
+    // Run compiled instructions until the machine halts or until a breakpoint
+    // is set, such as by a BREAK instruction.
+    private func runCompiled() throws {
+        let code = compiledInstructions
+        let count = UInt(code.count)
+        while !isHalted, !hasBreakPoints {
+            guard pc < count else {
+                isHalted = true
+                return
+            }
+            nextPc = pc + 1
+            instructionCount = instructionCount &+ 1
+            try code[Int(pc)](self)
+            if !isHalted {
+                pc = nextPc
+            }
+            if pc >= count {
+                isHalted = true
+            }
+        }
+    }
+
+    private func compileProgram() -> [CompiledInstruction] {
+        program.instructions.enumerated().map { compile($1, at: $0) }
+    }
+
+    private func compile(_ ins: TackInstruction, at pc: Int) -> CompiledInstruction {
+        switch ins {
+        case .nop:
+            return { _ in }
+        case .hlt:
+            return { vm in vm.hlt() }
+        case let .call(target):
+            return compileJump(target) { vm, destination in
+                vm.writeFrameSlot(TackVirtualMachine.kSlotRA, vm.nextPc)
+                vm.nextPc = destination
+            }
+        case let .callptr(target):
+            return { vm in try vm.callptr(target) }
+        case let .enter(numberOfWords):
+            // The size of the frame is known when the program is loaded.
+            let frameSize = frameSizeAtEnter[pc]
+            return { vm in try vm.enter(numberOfWords, frameSize: frameSize) }
+        case .leave:
+            return { vm in try vm.leave() }
+        case .ret:
+            return { vm in try vm.ret() }
+        case let .jmp(target):
+            return compileJump(target) { vm, destination in
+                vm.nextPc = destination
+            }
+        case let .la(dst, label):
+            return compileJump(label) { vm, value in
+                vm.setRegister(dst, p: value)
+            }
+        case let .ststr(address, str):
+            return { vm in try vm.ststr(address, str) }
+        case let .memcpy(dst, src, count):
+            return { vm in try vm.memcpy(dst, src, count) }
+        case let .alloca(dst, count):
+            return { vm in try vm.alloca(dst, count) }
+        case let .free(count):
+            return { vm in try vm.free(count) }
+        case let .inlineAssembly(asm):
+            return { vm in try vm.inlineAssembly(asm) }
+        case let .syscall(n, ptr):
+            return { vm in try vm.syscall(n, ptr) }
+        case let .bz(test, target):
+            let testSlot = TackVirtualMachine.slot(test)
+            return compileJump(target) { vm, destination in
+                if try vm.readSlot(testSlot, .o(test)) == 0 {
+                    vm.nextPc = destination
+                }
+            }
+        case let .bnz(test, target):
+            let testSlot = TackVirtualMachine.slot(test)
+            return compileJump(target) { vm, destination in
+                if try vm.readSlot(testSlot, .o(test)) != 0 {
+                    vm.nextPc = destination
+                }
+            }
+        case let .bzw(test, target):
+            let testSlot = TackVirtualMachine.slot(test)
+            return compileJump(target) { vm, destination in
+                if try vm.readSlot(testSlot, .w(test)) & 0xffff == 0 {
+                    vm.nextPc = destination
+                }
+            }
+        case let .eqo(dst, left, right):
+            return compileComparisonOfBooleans(dst, left, right) { $0 == $1 }
+        case let .neo(dst, left, right):
+            return compileComparisonOfBooleans(dst, left, right) { $0 != $1 }
+        case let .not(dst, src):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let srcSlot = TackVirtualMachine.slot(src)
+            return { vm in
+                let r = try vm.readSlot(srcSlot, .o(src)) != 0
+                vm.writeFrameSlot(dstSlot, r ? 0 : 1)
+            }
+        case let .lio(dst, imm):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let value: UInt = imm ? 1 : 0
+            return { vm in vm.writeFrameSlot(dstSlot, value) }
+        case let .lo(dst, address, offset):
+            return compileLoad(.o(dst), address, offset)
+        case let .so(src, address, offset):
+            return compileStore(.o(src), address, offset)
+        case let .eqp(dst, left, right):
+            return { vm in try vm.eqp(dst, left, right) }
+        case let .nep(dst, left, right):
+            return { vm in try vm.nep(dst, left, right) }
+        case let .lip(dst, imm):
+            return { vm in try vm.lip(dst, imm) }
+        case let .addip(dst, left, right):
+            return { vm in try vm.addip(dst, left, right) }
+        case let .subip(dst, left, right):
+            return { vm in try vm.subip(dst, left, right) }
+        case let .addpw(dst, left, right):
+            let rightSlot = TackVirtualMachine.slot(right)
+            return { vm in
+                let l = try vm.getRegister(p: left)
+                let r = try vm.readSlot(rightSlot, .w(right)) & 0xffff
+                vm.setRegister(dst, p: l &+ r)
+            }
+        case let .lp(dst, address, offset):
+            return { vm in try vm.lp(dst, address, offset) }
+        case let .sp(src, address, offset):
+            return { vm in try vm.sp(src, address, offset) }
+        case let .lw(dst, address, offset):
+            return compileLoad(.w(dst), address, offset)
+        case let .sw(src, address, offset):
+            return compileStore(.w(src), address, offset)
+        case let .andiw(dst, left, right):
+            guard right >= 0, right <= UInt16.max else {
+                return { vm in try vm.andiw(dst, left, right) }
+            }
+            let imm = UInt16(right)
+            return compileUnaryOp16(dst, left) { $0 & imm }
+        case let .addiw(dst, left, right):
+            guard let imm = TackVirtualMachine.word(right) else {
+                return { vm in try vm.addiw(dst, left, right) }
+            }
+            return compileUnaryOp16(dst, left) { $0 &+ imm }
+        case let .subiw(dst, left, right):
+            guard let imm = TackVirtualMachine.word(right) else {
+                return { vm in try vm.subiw(dst, left, right) }
+            }
+            return compileUnaryOp16(dst, left) { $0 &- imm }
+        case let .muliw(dst, left, right):
+            guard let imm = TackVirtualMachine.word(right) else {
+                return { vm in try vm.muliw(dst, left, right) }
+            }
+            return compileUnaryOp16(dst, left) { $0 &* imm }
+        case let .liw(dst, imm):
+            guard let value = TackVirtualMachine.word(imm) else {
+                return { vm in try vm.liw(dst, imm) }
+            }
+            let dstSlot = TackVirtualMachine.slot(dst)
+            return { vm in vm.writeFrameSlot(dstSlot, UInt(value)) }
+        case let .liuw(dst, imm):
+            guard imm >= 0, imm <= UInt16.max else {
+                return { vm in try vm.liuw(dst, imm) }
+            }
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let value = UInt(imm)
+            return { vm in vm.writeFrameSlot(dstSlot, value) }
+        case let .andw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 & $1 }
+        case let .orw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 | $1 }
+        case let .xorw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 ^ $1 }
+        case let .negw(dst, src):
+            return compileUnaryOp16(dst, src) { ~$0 }
+        case let .addw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 &+ $1 }
+        case let .subw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 &- $1 }
+        case let .mulw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 &* $1 }
+        case let .divw(dst, left, right):
+            return { vm in try vm.divw(dst, left, right) }
+        case let .divuw(dst, left, right):
+            return { vm in try vm.divuw(dst, left, right) }
+        case let .modw(dst, left, right):
+            return { vm in try vm.mod16(dst, left, right) }
+        case let .lslw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 << $1 }
+        case let .lsrw(dst, left, right):
+            return compileBinaryOp16(dst, left, right) { $0 >> $1 }
+        case let .eqw(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 == $1 }
+        case let .new(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 != $1 }
+        case let .ltw(dst, left, right):
+            return compileComparison16(dst, left, right) {
+                Int16(bitPattern: $0) < Int16(bitPattern: $1)
+            }
+        case let .gew(dst, left, right):
+            return compileComparison16(dst, left, right) {
+                Int16(bitPattern: $0) >= Int16(bitPattern: $1)
+            }
+        case let .lew(dst, left, right):
+            return compileComparison16(dst, left, right) {
+                Int16(bitPattern: $0) <= Int16(bitPattern: $1)
+            }
+        case let .gtw(dst, left, right):
+            return compileComparison16(dst, left, right) {
+                Int16(bitPattern: $0) > Int16(bitPattern: $1)
+            }
+        case let .ltuw(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 < $1 }
+        case let .geuw(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 >= $1 }
+        case let .leuw(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 <= $1 }
+        case let .gtuw(dst, left, right):
+            return compileComparison16(dst, left, right) { $0 > $1 }
+        case let .lb(dst, address, offset):
+            return compileLoad(.b(dst), address, offset)
+        case let .sb(src, address, offset):
+            return compileStore(.b(src), address, offset)
+        case let .lib(dst, imm):
+            guard imm >= Int8.min, imm <= Int8.max else {
+                return { vm in try vm.li8(dst, imm) }
+            }
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let value = UInt(UInt8(bitPattern: Int8(imm)))
+            return { vm in vm.writeFrameSlot(dstSlot, value) }
+        case let .liub(dst, imm):
+            guard imm >= 0, imm <= UInt8.max else {
+                return { vm in try vm.liu8(dst, imm) }
+            }
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let value = UInt(imm)
+            return { vm in vm.writeFrameSlot(dstSlot, value) }
+        case let .andb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 & $1 }
+        case let .orb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 | $1 }
+        case let .xorb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 ^ $1 }
+        case let .negb(dst, src):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let srcSlot = TackVirtualMachine.slot(src)
+            return { vm in
+                let a = try UInt8(truncatingIfNeeded: vm.readSlot(srcSlot, .b(src)))
+                vm.writeFrameSlot(dstSlot, UInt(~a))
+            }
+        case let .addb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 &+ $1 }
+        case let .subb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 &- $1 }
+        case let .mulb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 &* $1 }
+        case let .divb(dst, left, right):
+            return { vm in try vm.divb(dst, left, right) }
+        case let .divub(dst, left, right):
+            return { vm in try vm.divub(dst, left, right) }
+        case let .modb(dst, left, right):
+            return { vm in try vm.mod8(dst, left, right) }
+        case let .lslb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 << $1 }
+        case let .lsrb(dst, left, right):
+            return compileBinaryOp8(dst, left, right) { $0 >> $1 }
+        case let .eqb(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 == $1 }
+        case let .neb(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 != $1 }
+        case let .ltb(dst, left, right):
+            return compileComparison8(dst, left, right) {
+                Int8(bitPattern: $0) < Int8(bitPattern: $1)
+            }
+        case let .geb(dst, left, right):
+            return compileComparison8(dst, left, right) {
+                Int8(bitPattern: $0) >= Int8(bitPattern: $1)
+            }
+        case let .leb(dst, left, right):
+            return compileComparison8(dst, left, right) {
+                Int8(bitPattern: $0) <= Int8(bitPattern: $1)
+            }
+        case let .gtb(dst, left, right):
+            return compileComparison8(dst, left, right) {
+                Int8(bitPattern: $0) > Int8(bitPattern: $1)
+            }
+        case let .ltub(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 < $1 }
+        case let .geub(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 >= $1 }
+        case let .leub(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 <= $1 }
+        case let .gtub(dst, left, right):
+            return compileComparison8(dst, left, right) { $0 > $1 }
+        case let .movsbw(dst, src), let .movzbw(dst, src):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let srcSlot = TackVirtualMachine.slot(src)
+            return { vm in
+                let a = try vm.readSlot(srcSlot, .w(src))
+                vm.writeFrameSlot(dstSlot, a & 0xff)
+            }
+        case let .movswb(dst, src):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let srcSlot = TackVirtualMachine.slot(src)
+            return { vm in
+                let a = try UInt8(truncatingIfNeeded: vm.readSlot(srcSlot, .b(src)))
+                vm.writeFrameSlot(dstSlot, UInt(UInt16(bitPattern: Int16(Int8(bitPattern: a)))))
+            }
+        case let .movzwb(dst, src):
+            let dstSlot = TackVirtualMachine.slot(dst)
+            let srcSlot = TackVirtualMachine.slot(src)
+            return { vm in
+                let a = try vm.readSlot(srcSlot, .b(src))
+                vm.writeFrameSlot(dstSlot, a & 0xff)
+            }
+        case let .movp(dst, src):
+            return compileBitcast(.p(dst), .p(src))
+        case let .movw(dst, src):
+            return compileBitcast(.w(dst), .w(src))
+        case let .movb(dst, src):
+            return compileBitcast(.b(dst), .b(src))
+        case let .movo(dst, src):
+            return compileBitcast(.o(dst), .o(src))
+        case let .bitcast(dst, src):
+            return compileBitcast(dst, src)
+        }
+    }
+
+    // Resolve the label now. If the label is undefined then the instruction
+    // throws when executed, just as in the interpreter.
+    private func compileJump(
+        _ label: String,
+        _ body: @escaping (TackVirtualMachine, UInt) throws -> Void
+    ) -> CompiledInstruction {
+        guard let destination = program.labels[label] else {
+            return { _ in throw TackVirtualMachineError.undefinedLabel(label) }
+        }
+        let target = UInt(destination)
+        return { vm in try body(vm, target) }
+    }
+
+    private func compileLoad(
+        _ dst: Register,
+        _ address: RegisterPointer,
+        _ offset: Int
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)!
+        return { vm in
+            let base = try vm.getRegister(p: address)
+            let value = vm.load(address: base, signedOffset: offset)
+            vm.writeFrameSlot(dstSlot, value)
+        }
+    }
+
+    private func compileStore(
+        _ src: Register,
+        _ address: RegisterPointer,
+        _ offset: Int
+    ) -> CompiledInstruction {
+        let srcSlot = TackVirtualMachine.slot(src)!
+        return { vm in
+            let addressToAccess = try vm.getRegister(p: address)
+            let value = try vm.readSlot(srcSlot, src)
+            vm.store(value: value, address: addressToAccess, signedOffset: offset)
+        }
+    }
+
+    private func compileBitcast(_ dst: Register, _ src: Register) -> CompiledInstruction {
+        guard let dstSlot = TackVirtualMachine.slot(dst),
+              let srcSlot = TackVirtualMachine.slot(src)
+        else {
+            return { vm in try vm.bitcast(dst, src) }
+        }
+        return { vm in
+            try vm.writeFrameSlot(dstSlot, vm.readSlot(srcSlot, src))
+        }
+    }
+
+    private func compileUnaryOp16(
+        _ dst: Register16,
+        _ src: Register16,
+        _ op: @escaping (UInt16) -> UInt16
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let srcSlot = TackVirtualMachine.slot(src)
+        return { vm in
+            let a = try UInt16(truncatingIfNeeded: vm.readSlot(srcSlot, .w(src)))
+            vm.writeFrameSlot(dstSlot, UInt(op(a)))
+        }
+    }
+
+    private func compileBinaryOp16(
+        _ dst: Register16,
+        _ left: Register16,
+        _ right: Register16,
+        _ op: @escaping (UInt16, UInt16) -> UInt16
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let leftSlot = TackVirtualMachine.slot(left)
+        let rightSlot = TackVirtualMachine.slot(right)
+        return { vm in
+            let a = try UInt16(truncatingIfNeeded: vm.readSlot(leftSlot, .w(left)))
+            let b = try UInt16(truncatingIfNeeded: vm.readSlot(rightSlot, .w(right)))
+            vm.writeFrameSlot(dstSlot, UInt(op(a, b)))
+        }
+    }
+
+    private func compileBinaryOp8(
+        _ dst: Register8,
+        _ left: Register8,
+        _ right: Register8,
+        _ op: @escaping (UInt8, UInt8) -> UInt8
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let leftSlot = TackVirtualMachine.slot(left)
+        let rightSlot = TackVirtualMachine.slot(right)
+        return { vm in
+            let a = try UInt8(truncatingIfNeeded: vm.readSlot(leftSlot, .b(left)))
+            let b = try UInt8(truncatingIfNeeded: vm.readSlot(rightSlot, .b(right)))
+            vm.writeFrameSlot(dstSlot, UInt(op(a, b)))
+        }
+    }
+
+    private func compileComparison16(
+        _ dst: RegisterBoolean,
+        _ left: Register16,
+        _ right: Register16,
+        _ op: @escaping (UInt16, UInt16) -> Bool
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let leftSlot = TackVirtualMachine.slot(left)
+        let rightSlot = TackVirtualMachine.slot(right)
+        return { vm in
+            let a = try UInt16(truncatingIfNeeded: vm.readSlot(leftSlot, .w(left)))
+            let b = try UInt16(truncatingIfNeeded: vm.readSlot(rightSlot, .w(right)))
+            vm.writeFrameSlot(dstSlot, op(a, b) ? 1 : 0)
+        }
+    }
+
+    private func compileComparison8(
+        _ dst: RegisterBoolean,
+        _ left: Register8,
+        _ right: Register8,
+        _ op: @escaping (UInt8, UInt8) -> Bool
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let leftSlot = TackVirtualMachine.slot(left)
+        let rightSlot = TackVirtualMachine.slot(right)
+        return { vm in
+            let a = try UInt8(truncatingIfNeeded: vm.readSlot(leftSlot, .b(left)))
+            let b = try UInt8(truncatingIfNeeded: vm.readSlot(rightSlot, .b(right)))
+            vm.writeFrameSlot(dstSlot, op(a, b) ? 1 : 0)
+        }
+    }
+
+    private func compileComparisonOfBooleans(
+        _ dst: RegisterBoolean,
+        _ left: RegisterBoolean,
+        _ right: RegisterBoolean,
+        _ op: @escaping (Bool, Bool) -> Bool
+    ) -> CompiledInstruction {
+        let dstSlot = TackVirtualMachine.slot(dst)
+        let leftSlot = TackVirtualMachine.slot(left)
+        let rightSlot = TackVirtualMachine.slot(right)
+        return { vm in
+            let a = try vm.readSlot(leftSlot, .o(left)) != 0
+            let b = try vm.readSlot(rightSlot, .o(right)) != 0
+            vm.writeFrameSlot(dstSlot, op(a, b) ? 1 : 0)
+        }
+    }
+
+    @inline(__always)
+    private func readSlot(_ slot: Int, _ reg: Register) throws -> UInt {
+        guard let val = readFrameSlot(slot) else {
+            throw TackVirtualMachineError.undefinedRegister(reg)
+        }
+        return val
+    }
+
+    // The immediate as a 16-bit word, or nil if it does not fit in an Int16
+    private static func word(_ value: Int) -> UInt16? {
+        guard value >= Int16.min, value <= Int16.max else {
+            return nil
+        }
+        return UInt16(bitPattern: Int16(value))
+    }
+
+    private static func slot(_ reg: Register16) -> Int {
+        switch reg {
+        case let .w(i): slot(w: i)
+        }
+    }
+
+    private static func slot(_ reg: Register8) -> Int {
+        switch reg {
+        case let .b(i): slot(b: i)
+        }
+    }
+
+    private static func slot(_ reg: RegisterBoolean) -> Int {
+        switch reg {
+        case let .o(i): slot(o: i)
+        }
+    }
+}
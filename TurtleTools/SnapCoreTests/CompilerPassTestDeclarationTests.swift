@@ -365,4 +365,78 @@ final class CompilerPassTestDeclarationTests: XCTestCase {
 
         XCTAssertEqual(actual, expected)
     }
+
+    func testTestDispatchSelectsEachTestByIndex() {
+        let input = Block(children: [
+            TestDeclaration(
+                name: "bar",
+                body: Block(children: [
+                    Call(callee: Identifier("bar"), arguments: [])
+                ])
+            ),
+            TestDeclaration(
+                name: "baz",
+                body: Block(children: [
+                    Call(callee: Identifier("baz"), arguments: [])
+                ])
+            )
+        ])
+        .reconnect(parent: nil)
+
+        let expected = Block(children: [
+            VarDeclaration(
+                identifier: Identifier("__testSelector"),
+                explicitType: PrimitiveType(.u16),
+                expression: nil,
+                storage: .staticStorage(offset: nil),
+                isMutable: true
+            ),
+            FunctionDeclaration(
+                identifier: Identifier("__testMain"),
+                functionType: FunctionType(
+                    name: "__testMain",
+                    returnType: PrimitiveType(.void),
+                    arguments: []
+                ),
+                argumentNames: [],
+                body: Block(children: [
+                    If(
+                        condition: Binary(
+                            op: .eq,
+                            left: Identifier("__testSelector"),
+                            right: LiteralInt(0)
+                        ),
+                        then: Block(children: [
+                            Block(children: [
+                                Call(callee: Identifier("bar"), arguments: [])
+                            ]),
+                            Call(callee: Identifier("__puts"), arguments: [LiteralString("passed\n")])
+                        ])
+                    ),
+                    If(
+                        condition: Binary(
+                            op: .eq,
+                            left: Identifier("__testSelector"),
+                            right: LiteralInt(1)
+                        ),
+                        then: Block(children: [
+                            Block(children: [
+                                Call(callee: Identifier("baz"), arguments: [])
+                            ]),
+                            Call(callee: Identifier("__puts"), arguments: [LiteralString("passed\n")])
+                        ])
+                    )
+                ])
+            ),
+            Call(callee: Identifier("__testMain"), arguments: [])
+        ])
+        .reconnect(parent: nil)
+
+        let transformer = CompilerPassTestDeclaration(isTestDispatchEnabled: true)
+        var actual: AbstractSyntaxTreeNode? = nil
+        XCTAssertNoThrow(actual = try transformer.visit(input))
+
+        XCTAssertEqual(actual, expected)
+        XCTAssertEqual(transformer.testNames, ["bar", "baz"])
+    }
 }
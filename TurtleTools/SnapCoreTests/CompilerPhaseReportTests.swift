@@ -0,0 +1,89 @@
+//
+//  CompilerPhaseReportTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import XCTest
+
+final class CompilerPhaseReportTests: XCTestCase {
+    let program = """
+        func add(a: u16, b: u16) -> u16 {
+            return a + b
+        }
+        let c = add(1, 2)
+        """
+
+    func testFrontEndRecordsEachPhaseInOrder() throws {
+        let report = CompilerPhaseReport()
+        let frontEnd = SnapCompilerFrontEnd(memoryLayoutStrategy: MemoryLayoutStrategyTurtle16())
+        frontEnd.phaseReport = report
+        _ = try frontEnd.compile(program: program)
+        let names = report.entries.map(\.name)
+        XCTAssertEqual(names.first, "lex")
+        XCTAssertEqual(names.dropFirst().first, "parse")
+        XCTAssertEqual(Array(names.suffix(3)), ["coreToTack", "inlineTack", "optimizeTack"])
+        XCTAssertTrue(names.contains("typeCheck"))
+        XCTAssertTrue(names.contains("flatten"))
+    }
+
+    func testNodeCountsChainFromOnePhaseToTheNext() throws {
+        let report = CompilerPhaseReport()
+        let frontEnd = SnapCompilerFrontEnd(memoryLayoutStrategy: MemoryLayoutStrategyTurtle16())
+        frontEnd.phaseReport = report
+        _ = try frontEnd.compile(program: program)
+        let passes = report.entries.filter { $0.nodeCountBefore != nil }
+        XCTAssertFalse(passes.isEmpty)
+        for entry in passes {
+            XCTAssertGreaterThan(entry.nodeCountBefore!, 0, entry.name)
+            XCTAssertGreaterThanOrEqual(entry.elapsedTime, 0, entry.name)
+            XCTAssertGreaterThan(entry.peakMemory, 0, entry.name)
+        }
+    }
+
+    func testBackendPhasesAreRecorded() throws {
+        var compiler = SnapToTurtle16Compiler()
+        let report = CompilerPhaseReport()
+        compiler.phaseReport = report
+        let expected = try SnapToTurtle16Compiler().compile(program: program)
+        let actual = try compiler.compile(program: program)
+        XCTAssertEqual(actual.instructions, expected.instructions)
+        let names = report.entries.map(\.name)
+        XCTAssertEqual(
+            Array(names.suffix(7)),
+            [
+                "tackToTurtle16",
+                "registerAllocation",
+                "leafFrameElimination",
+                "instructionScheduling",
+                "lowerAssembly",
+                "peephole",
+                "machineCode"
+            ]
+        )
+    }
+
+    func testJSONRepresentationRoundTrips() throws {
+        let report = CompilerPhaseReport()
+        let frontEnd = SnapCompilerFrontEnd(memoryLayoutStrategy: MemoryLayoutStrategyTurtle16())
+        frontEnd.phaseReport = report
+        _ = try frontEnd.compile(program: program)
+        let data = try report.jsonRepresentation()
+        let decoded = try JSONDecoder().decode([CompilerPhaseReport.Entry].self, from: data)
+        XCTAssertEqual(decoded, report.entries)
+    }
+
+    func testListingHasOneLinePerPhasePlusTotal() {
+        let report = CompilerPhaseReport()
+        report.measure("a") {}
+        report.measure("b", nodeCountBefore: 3, nodeCountAfter: { _ in 2 }) {}
+        let lines = report.listing.split(separator: "\n")
+        XCTAssertEqual(lines.count, 3)
+        XCTAssertTrue(lines[1].hasSuffix("3 -> 2 nodes"))
+        XCTAssertTrue(lines[2].hasPrefix("total"))
+    }
+}
@@ -0,0 +1,46 @@
+//
+//  ConcurrentMapTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import XCTest
+
+final class ConcurrentMapTests: XCTestCase {
+    struct TestError: Error, Equatable {
+        let value: Int
+    }
+
+    func testResultsAreInInputOrder() throws {
+        let input = Array(0..<1000)
+        let actual = try input.concurrentMap(jobs: 8) { $0 * 2 }
+        XCTAssertEqual(actual, input.map { $0 * 2 })
+    }
+
+    func testSingleJobIsSerial() throws {
+        var visited: [Int] = []
+        let actual = try [1, 2, 3].concurrentMap(jobs: 1) { (value: Int) -> Int in
+            visited.append(value)
+            return value
+        }
+        XCTAssertEqual(actual, [1, 2, 3])
+        XCTAssertEqual(visited, [1, 2, 3])
+    }
+
+    func testRethrowsTheEarliestError() throws {
+        let input = Array(0..<100)
+        XCTAssertThrowsError(
+            try input.concurrentMap(jobs: 8) { value -> Int in
+                if value % 10 == 7 {
+                    throw TestError(value: value)
+                }
+                return value
+            }
+        ) {
+            XCTAssertEqual($0 as? TestError, TestError(value: 7))
+        }
+    }
+}
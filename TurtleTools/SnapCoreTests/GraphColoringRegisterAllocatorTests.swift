@@ -0,0 +1,219 @@
+//
+//  GraphColoringRegisterAllocatorTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import TurtleSimulatorCore
+import XCTest
+
+final class GraphColoringRegisterAllocatorTests: XCTestCase {
+    fileprivate func ins(_ instruction: String, _ parameters: Parameter...) -> InstructionNode {
+        InstructionNode(instruction: instruction, parameters: parameters)
+    }
+
+    fileprivate func r(_ name: String) -> ParameterIdentifier {
+        ParameterIdentifier(name)
+    }
+
+    fileprivate func n(_ value: Int) -> ParameterNumber {
+        ParameterNumber(value)
+    }
+
+    func testEmpty() throws {
+        let allocation = try GraphColoringRegisterAllocator().allocate([])
+        XCTAssertEqual(allocation.children.count, 0)
+        XCTAssertEqual(allocation.roundCount, 1)
+    }
+
+    func testRegistersWhichAreLiveAtOnceGetDifferentColors() throws {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("vr0"), n(1)),
+            ins(kLI, r("vr1"), n(2)),
+            ins(kADD, r("vr2"), r("vr1"), r("vr0")),
+            ins(kADD, r("vr3"), r("vr2"), r("ra"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r1"), n(1)),
+            ins(kLI, r("r0"), n(2)),
+            ins(kADD, r("r0"), r("r0"), r("r1")),
+            ins(kADD, r("r0"), r("r0"), r("ra"))
+        ]
+        let actual = try GraphColoringRegisterAllocator().allocate(input)
+        XCTAssertEqual(TopLevel(children: actual.children), TopLevel(children: expected))
+        XCTAssertEqual(actual.virtualRegisterCount, 4)
+    }
+
+    func testCoalesceMove() throws {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("vr0"), n(1)),
+            ins(kADDI, r("vr1"), r("vr0"), n(0)),
+            ins(kADD, r("vr2"), r("vr1"), r("vr1"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(1)),
+            ins(kADDI, r("r0"), r("r0"), n(0)),
+            ins(kADD, r("r0"), r("r0"), r("r0"))
+        ]
+        let actual = try GraphColoringRegisterAllocator().allocate(input)
+        XCTAssertEqual(TopLevel(children: actual.children), TopLevel(children: expected))
+    }
+
+    func testValueLiveAroundALoopInterferesWithTheLoopBody() throws {
+        // vr0 is last referenced at the top of the loop, but it is needed
+        // again on the next iteration and so must not share with vr1.
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("vr0"), n(1)),
+            LabelDeclaration(identifier: "loop"),
+            ins(kCMPI, r("vr0"), n(0)),
+            ins(kLI, r("vr1"), n(2)),
+            ins(kCMPI, r("vr1"), n(0)),
+            ins(kBNE, r("loop")),
+            ins(kHLT)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r1"), n(1)),
+            LabelDeclaration(identifier: "loop"),
+            ins(kCMPI, r("r1"), n(0)),
+            ins(kLI, r("r0"), n(2)),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBNE, r("loop")),
+            ins(kHLT)
+        ]
+        let actual = try GraphColoringRegisterAllocator().allocate(input)
+        XCTAssertEqual(TopLevel(children: actual.children), TopLevel(children: expected))
+    }
+
+    func testAvoidPrecoloredRegister() throws {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(1)),
+            ins(kLI, r("vr0"), n(2)),
+            ins(kADD, r("vr1"), r("vr0"), r("r0"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(1)),
+            ins(kLI, r("r1"), n(2)),
+            ins(kADD, r("r0"), r("r1"), r("r0"))
+        ]
+        let actual = try GraphColoringRegisterAllocator().allocate(input)
+        XCTAssertEqual(TopLevel(children: actual.children), TopLevel(children: expected))
+    }
+
+    func testSpillTheRegisterWhichIsNotUsedInALoop() throws {
+        // With one register, either vr0 or vr1 must spill. vr1 is used in
+        // the loop and so it is the more expensive of the two.
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER, n(0)),
+            ins(kLI, r("vr0"), n(1)),
+            ins(kLI, r("vr1"), n(2)),
+            LabelDeclaration(identifier: "loop"),
+            ins(kCMPI, r("vr1"), n(0)),
+            ins(kBNE, r("loop")),
+            ins(kCMPI, r("vr0"), n(0)),
+            ins(kHLT)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kENTER, n(1)),
+            ins(kLI, r("r0"), n(1)),
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kLI, r("r0"), n(2)),
+            LabelDeclaration(identifier: "loop"),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBNE, r("loop")),
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kHLT)
+        ]
+        let actual = try GraphColoringRegisterAllocator(numRegisters: 1).allocate(input)
+        XCTAssertEqual(TopLevel(children: actual.children), TopLevel(children: expected))
+        XCTAssertEqual(actual.roundCount, 2)
+    }
+
+    func testInsertEnterToMakeRoomForASpill() throws {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("vr0"), n(1)),
+            ins(kLI, r("vr1"), n(2)),
+            ins(kCMPI, r("vr1"), n(0)),
+            ins(kCMPI, r("vr0"), n(0))
+        ]
+        let actual = try GraphColoringRegisterAllocator(numRegisters: 1).allocate(input)
+        let enter = try XCTUnwrap(actual.children.first as? InstructionNode)
+        XCTAssertEqual(enter.instruction, kENTER)
+        XCTAssertEqual((enter.parameters.first as? ParameterNumber)?.value, 1)
+        let names = actual.children.flatMap { RegisterUtils.getReferencedRegisters($0) }
+        XCTAssertFalse(names.contains { $0.hasPrefix("vr") })
+    }
+
+    func testDriverReportsSpillCodeComparedToLinearScan() throws {
+        let input = TopLevel(children: [
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(kENTER, n(0)),
+                    ins(kLI, r("vr0"), n(1)),
+                    ins(kLI, r("vr1"), n(2)),
+                    LabelDeclaration(identifier: "loop"),
+                    ins(kCMPI, r("vr1"), n(0)),
+                    ins(kBNE, r("loop")),
+                    ins(kCMPI, r("vr0"), n(0)),
+                    ins(kLEAVE),
+                    ins(kRET)
+                ]
+            )
+        ])
+        let report = RegisterAllocatorDriver.Report()
+        let driver = RegisterAllocatorDriver(
+            numRegisters: 1,
+            algorithm: .graphColoring,
+            report: report
+        )
+        _ = try driver.compile(topLevel: input)
+        XCTAssertEqual(report.entries.map(\.identifier), [nil, "foo"])
+        XCTAssertEqual(report.entries.map(\.spillLoadCount), [0, 1])
+        XCTAssertEqual(report.entries.map(\.spillStoreCount), [0, 1])
+        XCTAssertEqual(report.entries.map(\.linearScanSpillLoadCount), [0, 2])
+        XCTAssertEqual(report.entries.map(\.linearScanSpillStoreCount), [0, 2])
+    }
+
+    func testProgramComputesTheSameResultAsWithLinearScan() throws {
+        let program = """
+            func add(a: u16, b: u16) -> u16 {
+                return a + b
+            }
+            var total: u16 = 0
+            var i: u16 = 0
+            while i < 10 {
+                var j: u16 = 0
+                while j < i {
+                    total = add(total, i * j + 3)
+                    j = j + 1
+                }
+                i = i + 1
+            }
+            """
+
+        func run(_ registerAllocator: RegisterAllocatorDriver.Algorithm) throws -> UInt16 {
+            let options = SnapToTurtle16Compiler.Options(registerAllocator: registerAllocator)
+            let turtleProgram = try SnapToTurtle16Compiler().compile(
+                program: program,
+                options: options
+            )
+            let computer = TurtleComputer(FastCPUModel())
+            computer.instructions = turtleProgram.instructions
+            computer.reset()
+            let result = computer.run(cycles: 1_000_000)
+            XCTAssertEqual(result.stopReason, .halted)
+            let debugger = SnapDebugConsole(computer: computer)
+            debugger.symbols = turtleProgram.symbolsOfTopLevelScope
+            return try XCTUnwrap(debugger.loadSymbolU16("total"))
+        }
+
+        let total = try run(.graphColoring)
+        XCTAssertEqual(total, 1005)
+        XCTAssertEqual(total, try run(.linearScan))
+    }
+}
@@ -0,0 +1,267 @@
+//
+//  InstructionSchedulerTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import TurtleSimulatorCore
+import XCTest
+
+final class InstructionSchedulerTests: XCTestCase {
+    fileprivate func ins(_ instruction: String, _ parameters: Parameter...) -> InstructionNode {
+        InstructionNode(instruction: instruction, parameters: parameters)
+    }
+
+    fileprivate func r(_ name: String) -> ParameterIdentifier {
+        ParameterIdentifier(name)
+    }
+
+    fileprivate func n(_ value: Int) -> ParameterNumber {
+        ParameterNumber(value)
+    }
+
+    func testEmpty() {
+        let scheduler = InstructionScheduler()
+        XCTAssertEqual(scheduler.compile(children: []).count, 0)
+    }
+
+    func testSeparateLoadFromUse() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r1"), r("r0"), r("r0")),
+            ins(kLOAD, r("r2"), r("fp"), n(-2)),
+            ins(kLOAD, r("r3"), r("fp"), n(-3))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kLOAD, r("r2"), r("fp"), n(-2)),
+            ins(kLOAD, r("r3"), r("fp"), n(-3)),
+            ins(kADD, r("r1"), r("r0"), r("r0"))
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+        XCTAssertLessThan(scheduler.estimateStallCycles(actual), scheduler.estimateStallCycles(input))
+    }
+
+    func testFillTheSlotBetweenCompareAndBranch() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kNOT, r("r1"), r("r2")),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBEQ, r("foo")),
+            LabelDeclaration(identifier: "foo")
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kNOT, r("r1"), r("r2")),
+            ins(kBEQ, r("foo")),
+            LabelDeclaration(identifier: "foo")
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testTheFlagsWriterWhichTheBranchObservesStaysLast() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r2"), r("fp"), n(-1)),
+            ins(kADDI, r("r3"), r("r2"), n(1)),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBEQ, r("foo")),
+            LabelDeclaration(identifier: "foo")
+        ]
+        let actual = scheduler.compile(children: input)
+        let mnemonics = actual.compactMap { ($0 as? InstructionNode)?.instruction }
+        XCTAssertEqual(mnemonics, [kLOAD, kADDI, kCMPI, kBEQ])
+    }
+
+    func testLoadAfterStoreToTheSameAddressKeepsItsOrder() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r1"), r("fp"), n(-1)),
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r2"), r("r0"), r("r0")),
+            ins(kLOAD, r("r3"), r("fp"), n(-2))
+        ]
+        let actual = scheduler.compile(children: input)
+        let store = actual.firstIndex { ($0 as? InstructionNode)?.instruction == kSTORE }!
+        let load = actual.firstIndex {
+            (($0 as? InstructionNode)?.parameters.first as? ParameterIdentifier)?.value == "r0"
+        }!
+        let add = actual.firstIndex { ($0 as? InstructionNode)?.instruction == kADD }!
+        XCTAssertLessThan(store, load)
+        XCTAssertLessThan(load, add)
+    }
+
+    func testStoreThroughAnotherBaseRegisterIsNotReordered() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r1"), r("r0"), r("r0")),
+            ins(kSTORE, r("r1"), r("r4"), n(0)),
+            ins(kLOAD, r("r2"), r("fp"), n(-2))
+        ]
+        let actual = scheduler.compile(children: input)
+        let mnemonics = actual.compactMap { ($0 as? InstructionNode)?.instruction }
+        XCTAssertEqual(mnemonics, [kLOAD, kADD, kSTORE, kLOAD])
+    }
+
+    func testDoNotMoveInstructionsAcrossCallsOrLabels() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kCALL, r("foo")),
+            ins(kADD, r("r1"), r("r0"), r("r0")),
+            LabelDeclaration(identifier: "bar"),
+            ins(kLOAD, r("r2"), r("fp"), n(-2))
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: input))
+    }
+
+    func testLeaveVirtualRegistersAlone() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("vr0"), r("fp"), n(-1)),
+            ins(kADD, r("vr1"), r("vr0"), r("vr0")),
+            ins(kLOAD, r("vr2"), r("fp"), n(-2)),
+            ins(kLOAD, r("vr3"), r("fp"), n(-3))
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: input))
+    }
+
+    func testRemoveJumpToTheNextInstruction() {
+        let scheduler = InstructionScheduler()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kJMP, r("foo")),
+            LabelDeclaration(identifier: "foo"),
+            ins(kNOP)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            LabelDeclaration(identifier: "foo"),
+            ins(kNOP)
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testInvertBranchOverJump() {
+        let report = InstructionScheduler.Report()
+        let scheduler = InstructionScheduler(report: report)
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBEQ, r("foo")),
+            ins(kJMP, r("bar")),
+            LabelDeclaration(identifier: "foo"),
+            ins(kNOP),
+            LabelDeclaration(identifier: "bar"),
+            ins(kHLT)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBNE, r("bar")),
+            LabelDeclaration(identifier: "foo"),
+            ins(kNOP),
+            LabelDeclaration(identifier: "bar"),
+            ins(kHLT)
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+        XCTAssertEqual(report.entries.first?.jumpsRemoved, 1)
+    }
+
+    func testRotateLoop() {
+        let report = InstructionScheduler.Report()
+        let scheduler = InstructionScheduler(report: report)
+        let input: [AbstractSyntaxTreeNode] = [
+            LabelDeclaration(identifier: ".L0"),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBEQ, r(".L1")),
+            ins(kSUBI, r("r0"), r("r0"), n(1)),
+            ins(kJMP, r(".L0")),
+            LabelDeclaration(identifier: ".L1"),
+            ins(kHLT)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            LabelDeclaration(identifier: ".L0"),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBEQ, r(".L1")),
+            LabelDeclaration(identifier: ".L0_body"),
+            ins(kSUBI, r("r0"), r("r0"), n(1)),
+            ins(kCMPI, r("r0"), n(0)),
+            ins(kBNE, r(".L0_body")),
+            LabelDeclaration(identifier: ".L1"),
+            ins(kHLT)
+        ]
+        let actual = scheduler.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+        XCTAssertEqual(report.entries.first?.loopsRotated, 1)
+    }
+
+    func testScheduleEachSubroutine() throws {
+        let report = InstructionScheduler.Report()
+        let scheduler = InstructionScheduler(jobs: 2, report: report)
+        let body: [AbstractSyntaxTreeNode] = [
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r1"), r("r0"), r("r0")),
+            ins(kLOAD, r("r2"), r("fp"), n(-2)),
+            ins(kLOAD, r("r3"), r("fp"), n(-3)),
+            ins(kRET)
+        ]
+        let input = TopLevel(children: [
+            ins(kHLT),
+            Subroutine(identifier: "foo", children: body),
+            Subroutine(identifier: "bar", children: body)
+        ])
+        let actual = try scheduler.compile(topLevel: input)
+        let subroutines = actual.children.compactMap { $0 as? Subroutine }
+        XCTAssertEqual(subroutines.map(\.identifier), ["foo", "bar"])
+        for subroutine in subroutines {
+            let mnemonics = subroutine.children.compactMap { ($0 as? InstructionNode)?.instruction }
+            XCTAssertEqual(mnemonics, [kLOAD, kLOAD, kLOAD, kADD, kRET])
+        }
+        XCTAssertEqual(report.entries.map(\.identifier), [nil, "foo", "bar"])
+        XCTAssertLessThan(report.totalStallCyclesAfter, report.totalStallCyclesBefore)
+    }
+
+    func testScheduledProgramComputesTheSameResultInFewerCycles() throws {
+        let program = """
+            func add(a: u16, b: u16) -> u16 {
+                return a + b
+            }
+            var total: u16 = 0
+            var i: u16 = 0
+            while i < 10 {
+                total = add(total, i)
+                i = i + 1
+            }
+            """
+
+        func run(_ isInstructionSchedulingEnabled: Bool) throws -> ([UInt16], UInt) {
+            let options = SnapToTurtle16Compiler.Options(
+                isInstructionSchedulingEnabled: isInstructionSchedulingEnabled
+            )
+            let turtleProgram = try SnapToTurtle16Compiler().compile(
+                program: program,
+                options: options
+            )
+            let computer = TurtleComputer(FastCPUModel())
+            computer.instructions = turtleProgram.instructions
+            computer.reset()
+            let result = computer.run(cycles: 1_000_000)
+            XCTAssertEqual(result.stopReason, .halted)
+            return (computer.ram, result.cyclesRun)
+        }
+
+        let (scheduledRAM, scheduledCycles) = try run(true)
+        let (unscheduledRAM, unscheduledCycles) = try run(false)
+        XCTAssertEqual(scheduledRAM, unscheduledRAM)
+        XCTAssertLessThanOrEqual(scheduledCycles, unscheduledCycles)
+    }
+}
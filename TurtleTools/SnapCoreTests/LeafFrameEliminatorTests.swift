@@ -0,0 +1,193 @@
+//
+//  LeafFrameEliminatorTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import TurtleSimulatorCore
+import XCTest
+
+final class LeafFrameEliminatorTests: XCTestCase {
+    fileprivate func ins(_ instruction: String, _ parameters: Parameter...) -> InstructionNode {
+        InstructionNode(instruction: instruction, parameters: parameters)
+    }
+
+    fileprivate func r(_ name: String) -> ParameterIdentifier {
+        ParameterIdentifier(name)
+    }
+
+    fileprivate func n(_ value: Int) -> ParameterNumber {
+        ParameterNumber(value)
+    }
+
+    func testRemoveFrameAndSaveOnlyTheRegistersWhichAreWritten() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER, n(1)),
+            ins(kLOAD, r("r0"), r("fp"), n(7)),
+            ins(kLOAD, r("r1"), r("fp"), n(8)),
+            ins(kADD, r("r0"), r("r0"), r("r1")),
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kSTORE, r("r0"), r("fp"), n(9)),
+            ins(kLEAVE),
+            ins(kRET)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("sp"), n(-1)),
+            ins(kSTORE, r("r1"), r("sp"), n(-2)),
+            ins(kLOAD, r("r0"), r("sp"), n(0)),
+            ins(kLOAD, r("r1"), r("sp"), n(1)),
+            ins(kADD, r("r0"), r("r0"), r("r1")),
+            ins(kSTORE, r("r0"), r("sp"), n(-8)),
+            ins(kSTORE, r("r0"), r("sp"), n(2)),
+            ins(kLOAD, r("r0"), r("sp"), n(-1)),
+            ins(kLOAD, r("r1"), r("sp"), n(-2)),
+            ins(kRET)
+        ]
+        let actual = LeafFrameEliminator().compile(input)
+        XCTAssertEqual(actual.map { TopLevel(children: $0) }, TopLevel(children: expected))
+    }
+
+    func testRebaseAddressOfALocal() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER, n(4)),
+            ins(kSUBI, r("r2"), r("fp"), n(4)),
+            ins(kADDI, r("r3"), r("fp"), n(7)),
+            ins(kLEAVE),
+            ins(kRET)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r2"), r("sp"), n(-1)),
+            ins(kSTORE, r("r3"), r("sp"), n(-2)),
+            ins(kADDI, r("r2"), r("sp"), n(-11)),
+            ins(kADDI, r("r3"), r("sp"), n(0)),
+            ins(kLOAD, r("r2"), r("sp"), n(-1)),
+            ins(kLOAD, r("r3"), r("sp"), n(-2)),
+            ins(kRET)
+        ]
+        let actual = LeafFrameEliminator().compile(input)
+        XCTAssertEqual(actual.map { TopLevel(children: $0) }, TopLevel(children: expected))
+    }
+
+    func testKeepFrameOfSubroutineWhichMakesACall() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER),
+            ins(kCALL, r("foo")),
+            ins(kLEAVE),
+            ins(kRET)
+        ]
+        XCTAssertNil(LeafFrameEliminator().compile(input))
+    }
+
+    func testKeepFrameWhenTheOffsetFromSPDoesNotFit() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER, n(10)),
+            ins(kLOAD, r("r0"), r("fp"), n(-10)),
+            ins(kLEAVE),
+            ins(kRET)
+        ]
+        XCTAssertNil(LeafFrameEliminator().compile(input))
+    }
+
+    func testKeepFrameWhenFPIsUsedAsAValue() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kENTER),
+            ins(kADD, r("r0"), r("fp"), r("r1")),
+            ins(kLEAVE),
+            ins(kRET)
+        ]
+        XCTAssertNil(LeafFrameEliminator().compile(input))
+    }
+
+    func testReportEachSubroutine() {
+        let report = LeafFrameEliminator.Report()
+        let input = TopLevel(children: [
+            ins(kHLT),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(kENTER),
+                    ins(kLI, r("r0"), n(1)),
+                    ins(kLEAVE),
+                    ins(kRET)
+                ]
+            ),
+            Subroutine(
+                identifier: "bar",
+                children: [
+                    ins(kENTER),
+                    ins(kCALL, r("foo")),
+                    ins(kLEAVE),
+                    ins(kRET)
+                ]
+            )
+        ])
+        let expected = TopLevel(children: [
+            ins(kHLT),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(kSTORE, r("r0"), r("sp"), n(-1)),
+                    ins(kLI, r("r0"), n(1)),
+                    ins(kLOAD, r("r0"), r("sp"), n(-1)),
+                    ins(kRET)
+                ]
+            ),
+            Subroutine(
+                identifier: "bar",
+                children: [
+                    ins(kENTER),
+                    ins(kCALL, r("foo")),
+                    ins(kLEAVE),
+                    ins(kRET)
+                ]
+            )
+        ])
+        XCTAssertEqual(LeafFrameEliminator(report: report).compile(topLevel: input), expected)
+        XCTAssertEqual(report.entries.map(\.identifier), ["foo"])
+        XCTAssertEqual(report.entries.map(\.savedRegisterCount), [1])
+    }
+
+    func testProgramComputesTheSameResultInFewerCycles() throws {
+        let program = """
+            func add(a: u16, b: u16) -> u16 {
+                return a + b
+            }
+            var total: u16 = 0
+            var i: u16 = 0
+            while i < 10 {
+                total = add(total, i * 20)
+                i = i + 1
+            }
+            """
+
+        func run(_ isLeafFrameEliminationEnabled: Bool) throws -> (UInt16, UInt) {
+            // Inlining would remove the call to the leaf.
+            let options = SnapToTurtle16Compiler.Options(
+                isInliningEnabled: false,
+                isLeafFrameEliminationEnabled: isLeafFrameEliminationEnabled
+            )
+            let turtleProgram = try SnapToTurtle16Compiler().compile(
+                program: program,
+                options: options
+            )
+            let computer = TurtleComputer(FastCPUModel())
+            computer.instructions = turtleProgram.instructions
+            computer.reset()
+            let result = computer.run(cycles: 1_000_000)
+            XCTAssertEqual(result.stopReason, .halted)
+            let debugger = SnapDebugConsole(computer: computer)
+            debugger.symbols = turtleProgram.symbolsOfTopLevelScope
+            return (try XCTUnwrap(debugger.loadSymbolU16("total")), result.cyclesRun)
+        }
+
+        let (total, cycles) = try run(true)
+        let (expectedTotal, expectedCycles) = try run(false)
+        XCTAssertEqual(total, 900)
+        XCTAssertEqual(total, expectedTotal)
+        XCTAssertLessThan(cycles, expectedCycles)
+    }
+}
@@ -249,4 +249,57 @@ final class LinearScanRegisterAllocatorTests: XCTestCase {
             ]
         )
     }
+
+    func testSpillPrefersTheLatestAddedOfIntervalsWithTheSameEndPoint() throws {
+        let actual = LinearScanRegisterAllocator.allocate(
+            numRegisters: 2,
+            liveIntervals: [
+                LiveInterval(range: 0..<10, virtualRegisterName: "vr0", physicalRegisterName: nil),
+                LiveInterval(range: 1..<10, virtualRegisterName: "vr1", physicalRegisterName: nil),
+                LiveInterval(range: 2..<5, virtualRegisterName: "vr2", physicalRegisterName: nil)
+            ]
+        )
+        XCTAssertEqual(
+            actual,
+            [
+                LiveInterval(range: 0..<10, virtualRegisterName: "vr0", physicalRegisterName: "r0"),
+                LiveInterval(
+                    range: 1..<10,
+                    virtualRegisterName: "vr1",
+                    physicalRegisterName: nil,
+                    spillSlot: 0
+                ),
+                LiveInterval(range: 2..<5, virtualRegisterName: "vr2", physicalRegisterName: "r1")
+            ]
+        )
+    }
+
+    func testManyOverlappingIntervalsNeverShareARegister() throws {
+        let n = 5000
+        let liveIntervals = (0..<n).map { i in
+            LiveInterval(
+                range: i..<(i + 1 + (i * 7919) % 13),
+                virtualRegisterName: "vr\(i)",
+                physicalRegisterName: nil
+            )
+        }
+        let actual = LinearScanRegisterAllocator.allocate(
+            numRegisters: 5,
+            liveIntervals: liveIntervals
+        )
+        XCTAssertEqual(actual.count, n)
+        var lastEndByRegister: [String: Int] = [:]
+        for interval in actual {
+            if let name = interval.physicalRegisterName {
+                XCTAssertNil(interval.spillSlot)
+                if let lastEnd = lastEndByRegister[name] {
+                    XCTAssertLessThanOrEqual(lastEnd, interval.range.startIndex)
+                }
+                lastEndByRegister[name] = interval.range.endIndex
+            }
+            else {
+                XCTAssertNotNil(interval.spillSlot)
+            }
+        }
+    }
 }
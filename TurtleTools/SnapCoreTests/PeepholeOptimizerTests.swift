@@ -0,0 +1,257 @@
+//
+//  PeepholeOptimizerTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import TurtleSimulatorCore
+import XCTest
+
+final class PeepholeOptimizerTests: XCTestCase {
+    fileprivate func ins(_ instruction: String, _ parameters: Parameter...) -> InstructionNode {
+        InstructionNode(instruction: instruction, parameters: parameters)
+    }
+
+    fileprivate func r(_ name: String) -> ParameterIdentifier {
+        ParameterIdentifier(name)
+    }
+
+    fileprivate func n(_ value: Int) -> ParameterNumber {
+        ParameterNumber(value)
+    }
+
+    func testEmpty() {
+        let optimizer = PeepholeOptimizer()
+        XCTAssertEqual(optimizer.compile(children: []).count, 0)
+    }
+
+    func testRemoveReloadAfterSpill() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kLOAD, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r1"), r("r0"), r("r0"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kADD, r("r1"), r("r0"), r("r0"))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testReloadAfterSpillToAnotherRegisterIsAMove() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kLOAD, r("r1"), r("fp"), n(-1)),
+            ins(kCMP, r("r1"), r("r2"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kADDI, r("r1"), r("r0"), n(0)),
+            ins(kCMP, r("r1"), r("r2"))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testDoNotSetFlagsWhichAreUsedLater() {
+        // LOAD leaves the flags alone, but ADDI would not.
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kCMPI, r("r2"), n(0)),
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            ins(kLOAD, r("r1"), r("fp"), n(-1)),
+            ins(kBEQ, r("foo")),
+            ins(kNOP),
+            LabelDeclaration(identifier: "foo")
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: input))
+    }
+
+    func testDoNotMatchAcrossALabel() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kSTORE, r("r0"), r("fp"), n(-1)),
+            LabelDeclaration(identifier: "foo"),
+            ins(kLOAD, r("r0"), r("fp"), n(-1))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: input))
+    }
+
+    func testRemoveMoveToSelf() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kADDI, r("r1"), r("r1"), n(0)),
+            ins(kADD, r("r2"), r("r1"), r("r1"))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kADD, r("r2"), r("r1"), r("r1"))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testKeepMoveToSelfWhichSetsTheFlagsForABranch() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kADDI, r("r1"), r("r1"), n(0)),
+            ins(kBEQ, r("foo")),
+            ins(kNOP),
+            LabelDeclaration(identifier: "foo")
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: input))
+    }
+
+    func testRemoveJumpToTheNextInstruction() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kJMP, r("foo")),
+            LabelDeclaration(identifier: "foo"),
+            ins(kBNE, r("bar")),
+            LabelDeclaration(identifier: "bar"),
+            ins(kHLT)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            LabelDeclaration(identifier: "foo"),
+            LabelDeclaration(identifier: "bar"),
+            ins(kHLT)
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testRemoveRedundantLoadImmediate() {
+        let optimizer = PeepholeOptimizer()
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(1)),
+            ins(kLI, r("r0"), n(2)),
+            ins(kLI, r("r1"), n(20)),
+            ins(kLUI, r("r1"), n(0)),
+            ins(kLI, r("r2"), n(200)),
+            ins(kLUI, r("r2"), n(0))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(2)),
+            ins(kLI, r("r1"), n(20)),
+            ins(kLI, r("r2"), n(200)),
+            ins(kLUI, r("r2"), n(0))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+    }
+
+    func testRewritesExposeFurtherMatches() {
+        let report = PeepholeOptimizer.Report()
+        let optimizer = PeepholeOptimizer(report: report)
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(1)),
+            ins(kADDI, r("r1"), r("r1"), n(0)),
+            ins(kLI, r("r0"), n(2)),
+            ins(kLI, r("r0"), n(3)),
+            ins(kCMPI, r("r0"), n(0))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kLI, r("r0"), n(3)),
+            ins(kCMPI, r("r0"), n(0))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+        XCTAssertEqual(report.hits("moveToSelf"), 1)
+        XCTAssertEqual(report.hits("overwrittenLoadImmediate"), 2)
+        XCTAssertEqual(report.instructionCountBefore, 5)
+        XCTAssertEqual(report.instructionCountAfter, 2)
+    }
+
+    func testCustomPattern() {
+        let patterns = [
+            PeepholeOptimizer.Pattern(
+                "addZero",
+                match: "ADD $a, $b, $c; ADDI $a, $a, $k",
+                rewrite: "ADD $a, $b, $c",
+                where: { $0.number("k") == 0 }
+            )
+        ]
+        let report = PeepholeOptimizer.Report()
+        let optimizer = PeepholeOptimizer(patterns: patterns, report: report)
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(kADD, r("r0"), r("r1"), r("r2")),
+            ins(kADDI, r("r0"), r("r0"), n(0)),
+            ins(kADD, r("r0"), r("r1"), r("r2")),
+            ins(kADDI, r("r0"), r("r0"), n(1))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(kADD, r("r0"), r("r1"), r("r2")),
+            ins(kADD, r("r0"), r("r1"), r("r2")),
+            ins(kADDI, r("r0"), r("r0"), n(1))
+        ]
+        let actual = optimizer.compile(children: input)
+        XCTAssertEqual(TopLevel(children: actual), TopLevel(children: expected))
+        XCTAssertEqual(report.entries.map(\.name), ["addZero"])
+        XCTAssertEqual(report.entries.map(\.hits), [1])
+        XCTAssertEqual(report.entries.map(\.instructionsRemoved), [1])
+    }
+
+    func testOptimizeEachSubroutine() {
+        let optimizer = PeepholeOptimizer()
+        let input = TopLevel(children: [
+            ins(kHLT),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(kADDI, r("r0"), r("r0"), n(0)),
+                    ins(kRET)
+                ]
+            )
+        ])
+        let expected = TopLevel(children: [
+            ins(kHLT),
+            Subroutine(identifier: "foo", children: [ins(kRET)])
+        ])
+        XCTAssertEqual(optimizer.compile(topLevel: input), expected)
+    }
+
+    func testOptimizedProgramComputesTheSameResultInFewerInstructions() throws {
+        let program = """
+            func add(a: u16, b: u16) -> u16 {
+                return a + b
+            }
+            var total: u16 = 0
+            var i: u16 = 0
+            while i < 10 {
+                total = add(total, i * 20)
+                i = i + 1
+            }
+            """
+
+        func run(_ isPeepholeOptimizationEnabled: Bool) throws -> ([UInt16], Int, UInt) {
+            let options = SnapToTurtle16Compiler.Options(
+                isPeepholeOptimizationEnabled: isPeepholeOptimizationEnabled
+            )
+            let turtleProgram = try SnapToTurtle16Compiler().compile(
+                program: program,
+                options: options
+            )
+            let computer = TurtleComputer(FastCPUModel())
+            computer.instructions = turtleProgram.instructions
+            computer.reset()
+            let result = computer.run(cycles: 1_000_000)
+            XCTAssertEqual(result.stopReason, .halted)
+            return (computer.ram, turtleProgram.instructions.count, result.cyclesRun)
+        }
+
+        let (optimizedRAM, optimizedSize, optimizedCycles) = try run(true)
+        let (unoptimizedRAM, unoptimizedSize, unoptimizedCycles) = try run(false)
+        XCTAssertEqual(optimizedRAM, unoptimizedRAM)
+        XCTAssertLessThanOrEqual(optimizedSize, unoptimizedSize)
+        XCTAssertLessThanOrEqual(optimizedCycles, unoptimizedCycles)
+    }
+}
@@ -1935,4 +1935,74 @@ final class RegisterAllocatorDriverTests: XCTestCase {
         let actual = try driver.compile(topLevel: input)
         XCTAssertEqual(actual, expected)
     }
+
+    func testReportRecordsEachSubroutine() throws {
+        let report = RegisterAllocatorDriver.Report()
+        let driver = RegisterAllocatorDriver(report: report)
+        let input = TopLevel(children: [
+            InstructionNode(instruction: kNOP),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    InstructionNode(
+                        instruction: kADD,
+                        parameters: [
+                            ParameterIdentifier("vr0"),
+                            ParameterIdentifier("vr1"),
+                            ParameterIdentifier("vr2")
+                        ]
+                    ),
+                    InstructionNode(instruction: kRET)
+                ]
+            )
+        ])
+        _ = try driver.compile(topLevel: input)
+        XCTAssertEqual(report.entries.map(\.identifier), [nil, "foo"])
+        XCTAssertEqual(report.entries.map(\.nodeCount), [1, 2])
+        XCTAssertEqual(report.entries[1].liveIntervalCount, 3)
+        XCTAssertEqual(report.entries[1].allocationCount, 1)
+        XCTAssertEqual(report.entries[1].livenessCount, 1)
+    }
+
+    func testConcurrentCompileMatchesSerialCompile() throws {
+        // Each subroutine needs more registers than are available, and so
+        // each involves spilling.
+        let subroutines: [AbstractSyntaxTreeNode] = (0..<32).map { i in
+            let names = (0..<8).map { ParameterIdentifier("vr\($0)") }
+            var children: [AbstractSyntaxTreeNode] = [InstructionNode(instruction: kENTER)]
+            for name in names {
+                children.append(
+                    InstructionNode(
+                        instruction: kLI,
+                        parameters: [name, ParameterNumber(i)]
+                    )
+                )
+            }
+            for name in names {
+                children.append(
+                    InstructionNode(
+                        instruction: kADD,
+                        parameters: [names[0], names[0], name]
+                    )
+                )
+            }
+            children.append(InstructionNode(instruction: kLEAVE))
+            children.append(InstructionNode(instruction: kRET))
+            return Subroutine(identifier: "sub\(i)", children: children)
+        }
+        let input = TopLevel(children: [InstructionNode(instruction: kNOP)] + subroutines)
+
+        let serialReport = RegisterAllocatorDriver.Report()
+        let serial = try RegisterAllocatorDriver(jobs: 1, report: serialReport)
+            .compile(topLevel: input)
+        let concurrentReport = RegisterAllocatorDriver.Report()
+        let concurrent = try RegisterAllocatorDriver(jobs: 8, report: concurrentReport)
+            .compile(topLevel: input)
+
+        XCTAssertEqual(serial, concurrent)
+        XCTAssertEqual(
+            serialReport.entries.map(\.identifier),
+            concurrentReport.entries.map(\.identifier)
+        )
+    }
 }
@@ -105,4 +105,53 @@ final class SnapCommandLineArgumentParserTests: XCTestCase {
         XCTAssertNoThrow(try parser.parse())
         XCTAssertEqual(parser.options, [.run, .inputFileName("foo")])
     }
+
+    func testParseCPUModelOption() {
+        let parser = SnapCommandLineArgumentParser(args: ["snap", "run", "--cpu", "lockstep", "foo"])
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.run, .cpu("lockstep"), .inputFileName("foo")])
+    }
+
+    func testParseBackendJobsOption() {
+        let parser = SnapCommandLineArgumentParser(args: ["snap", "--backend-jobs", "8", "foo"])
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.backendJobs("8"), .inputFileName("foo")])
+    }
+
+    func testParseJobsOption() {
+        let parser = SnapCommandLineArgumentParser(args: ["snap", "test", "--jobs", "4", "foo"])
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.test, .jobs("4"), .inputFileName("foo")])
+    }
+
+    func testParseTimePassesOption() {
+        let parser = SnapCommandLineArgumentParser(args: ["snap", "--time-passes", "foo"])
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.timePasses, .inputFileName("foo")])
+    }
+
+    func testParseTimePassesJSONOption() {
+        let parser = SnapCommandLineArgumentParser(
+            args: ["snap", "--time-passes-json", "passes.json", "foo"]
+        )
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.timePassesJSON("passes.json"), .inputFileName("foo")])
+    }
+
+    func testParseRegisterAllocatorOptions() {
+        let parser = SnapCommandLineArgumentParser(
+            args: ["snap", "--regalloc", "graph-coloring", "--regalloc-report", "foo"]
+        )
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(
+            parser.options,
+            [.registerAllocator("graph-coloring"), .registerAllocationReport, .inputFileName("foo")]
+        )
+    }
+
+    func testParseOptimizationLevelOptions() {
+        let parser = SnapCommandLineArgumentParser(args: ["snap", "-O0", "-O1", "foo"])
+        XCTAssertNoThrow(try parser.parse())
+        XCTAssertEqual(parser.options, [.unoptimized, .optimized, .inputFileName("foo")])
+    }
 }
@@ -0,0 +1,88 @@
+//
+//  SnapCommandLineDriverTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import XCTest
+
+final class SnapCommandLineDriverTests: XCTestCase {
+    private var temporaryFiles: [URL] = []
+
+    override func tearDown() {
+        for url in temporaryFiles {
+            try? FileManager.default.removeItem(at: url)
+        }
+        temporaryFiles = []
+        super.tearDown()
+    }
+
+    fileprivate func runDriver(_ program: String, _ arguments: [String]) throws -> SnapCommandLineDriver {
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString)
+            .appendingPathExtension("snap")
+        try program.write(to: url, atomically: true, encoding: .utf8)
+        temporaryFiles.append(url)
+        let driver = SnapCommandLineDriver(withArguments: ["snap"] + arguments + [url.path])
+        driver.run()
+        return driver
+    }
+
+    let kTwoTests = """
+        test "foo" {
+        }
+        test "bar" {
+        }
+        """
+
+    func testRunSpecificTest() throws {
+        let driver = try runDriver(kTwoTests, ["test", "--platform", "tack", "-t", "bar"])
+        XCTAssertEqual(driver.status, 0)
+        let stdout = try XCTUnwrap(driver.stdout as? String)
+        XCTAssertTrue(stdout.contains("Running test \"bar\"..."))
+        XCTAssertFalse(stdout.contains("Running test \"foo\"..."))
+    }
+
+    func testRejectUnknownSpecificTest() throws {
+        let driver = try runDriver(kTwoTests, ["test", "--platform", "tack", "-t", "baz"])
+        XCTAssertEqual(driver.status, 1)
+        let stderr = try XCTUnwrap(driver.stderr as? String)
+        XCTAssertTrue(stderr.contains("no test named `baz'"))
+        let stdout = try XCTUnwrap(driver.stdout as? String)
+        XCTAssertFalse(stdout.contains("Running test"))
+    }
+
+    func testConcurrentTestsPrintOutputInOrderAndThenTheSummary() throws {
+        // The Tack VM cannot run inline assembly and so "beta" fails.
+        let program = """
+            test "alpha" {
+            }
+            test "beta" {
+                asm("NOP")
+            }
+            test "gamma" {
+            }
+            """
+        let driver = try runDriver(program, ["test", "--platform", "tack", "--jobs", "2"])
+        XCTAssertEqual(driver.status, 1)
+        let stdout = try XCTUnwrap(driver.stdout as? String)
+        let markers = [
+            "Running test \"alpha\"...",
+            "Running test \"beta\"...",
+            "Running test \"gamma\"...",
+            "Test summary:"
+        ]
+        let positions = try markers.map {
+            try XCTUnwrap(stdout.range(of: $0)?.lowerBound, "missing \($0)")
+        }
+        XCTAssertEqual(positions, positions.sorted())
+        let summary = stdout[positions.last!...].split(separator: "\n")
+        let beta = try XCTUnwrap(summary.first { $0.hasSuffix("beta") })
+        XCTAssertTrue(beta.contains("error"))
+        let gamma = try XCTUnwrap(summary.first { $0.hasSuffix("gamma") })
+        XCTAssertTrue(gamma.contains("instructions"))
+        XCTAssertFalse(try XCTUnwrap(driver.stderr as? String).isEmpty)
+    }
+}
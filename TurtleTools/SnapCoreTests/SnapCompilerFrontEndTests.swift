@@ -10,14 +10,24 @@ import SnapCore
 import TurtleCore
 import XCTest
 
-final class SnapCompilerFrontEndTests: XCTestCase {
+class SnapCompilerFrontEndTests: XCTestCase {
     fileprivate typealias Word = TackVirtualMachine.Word
     fileprivate let kRuntime = "runtime_TackVM"
     fileprivate let memoryLayoutStrategy = MemoryLayoutStrategyTurtle16()
     fileprivate lazy var kUnionPayloadOffset: Int = memoryLayoutStrategy.sizeof(type: .u16)
 
+    /// Whether the programs compiled by these tests are run through
+    /// TackInliner and TackOptimizer
+    var isTackOptimizationEnabled: Bool { true }
+
     fileprivate func makeCompiler() -> SnapCompilerFrontEnd {
-        SnapCompilerFrontEnd(memoryLayoutStrategy: memoryLayoutStrategy)
+        SnapCompilerFrontEnd(
+            options: SnapCompilerFrontEnd.Options(
+                isTackOptimizationEnabled: isTackOptimizationEnabled,
+                isInliningEnabled: isTackOptimizationEnabled
+            ),
+            memoryLayoutStrategy: memoryLayoutStrategy
+        )
     }
 
     fileprivate func compile(program: String) throws -> TackProgram {
@@ -120,7 +130,9 @@ final class SnapCompilerFrontEndTests: XCTestCase {
             isUsingStandardLibrary: options.isUsingStandardLibrary,
             runtimeSupport: options.runtimeSupport,
             shouldRunSpecificTest: options.shouldRunSpecificTest,
-            injectedModules: options.injectModules
+            injectedModules: options.injectModules,
+            isTackOptimizationEnabled: isTackOptimizationEnabled,
+            isInliningEnabled: isTackOptimizationEnabled
         )
 
         let compiler = SnapCompilerFrontEnd(
@@ -2564,6 +2576,45 @@ final class SnapCompilerFrontEndTests: XCTestCase {
         XCTAssertEqual(str, "PANIC: assertion failed: `1 == 2' on line 2 in test \"foo\"\n")
     }
 
+    func testRunTests_DispatchRunsTheSelectedTest() throws {
+        let compiler = SnapCompilerFrontEnd(
+            options: SnapCompilerFrontEnd.Options(
+                isBoundsCheckEnabled: true,
+                runtimeSupport: kRuntime,
+                isTestDispatchEnabled: true,
+                isTackOptimizationEnabled: isTackOptimizationEnabled,
+                isInliningEnabled: isTackOptimizationEnabled
+            ),
+            memoryLayoutStrategy: memoryLayoutStrategy
+        )
+        let tackProgram = try compiler.compile(
+            program: """
+                test "foo" {
+                }
+                test "bar" {
+                    assert(1 == 2)
+                }
+                """
+        )
+        XCTAssertEqual(compiler.testNames, ["foo", "bar"])
+        let selector = compiler.symbolsOfTopLevelScope.maybeResolve(identifier: kTestSelectorName)
+        let address = try XCTUnwrap(selector?.storage.offset)
+
+        var outputs: [String] = []
+        for index in compiler.testNames.indices {
+            var serialOutput: [UInt8] = []
+            let vm = TackVirtualMachine(tackProgram)
+            vm.onSerialOutput = { serialOutput.append($0) }
+            vm.store(w: UInt16(index), address: UInt(address))
+            try vm.run()
+            outputs.append(String(bytes: serialOutput, encoding: .utf8) ?? "")
+        }
+        XCTAssertEqual(outputs, [
+            "passed\n",
+            "PANIC: assertion failed: `1 == 2' on line 4 in test \"bar\"\n"
+        ])
+    }
+
     func testImportModule() throws {
         var serialOutput: [UInt8] = []
         let onSerialOutput = { (value: UInt8) in
@@ -4289,3 +4340,10 @@ final class SnapCompilerFrontEndTests: XCTestCase {
         try debugger.vm.run()
     }
 }
+
+/// Runs every test again with the Tack program left unoptimized, so that each
+/// program is checked to give the same result in the Tack virtual machine
+/// with optimization on and off
+final class SnapCompilerFrontEndUnoptimizedTests: SnapCompilerFrontEndTests {
+    override var isTackOptimizationEnabled: Bool { false }
+}
@@ -139,4 +139,176 @@ final class StatementTracerTests: XCTestCase {
         XCTAssertEqual(traces[1], [.matchClause, .Return])
         XCTAssertEqual(traces[2], [.matchElseClause, .Return])
     }
+
+    // MARK: - Reachability
+
+    // The reachability implied by the traces of every path
+    func reachability(of traces: [StatementTracer.Trace]) -> StatementTracer.Reachability {
+        StatementTracer.Reachability(
+            fallsThrough: traces.contains { $0.last != .Return },
+            returns: traces.contains { $0.last == .Return }
+        )
+    }
+
+    func testReachabilityOfReturnStatementsThroughIf() throws {
+        let tracer = StatementTracer()
+        let ast = Block(children: [
+            If(condition: LiteralBool(true), then: Return(LiteralInt(1)), else: nil)
+        ])
+        XCTAssertEqual(
+            try tracer.reachability(ast: ast),
+            StatementTracer.Reachability(fallsThrough: true, returns: true)
+        )
+    }
+
+    func testReachabilityOfReturnStatementsThroughIfElse() throws {
+        let tracer = StatementTracer()
+        let ast = Block(children: [
+            If(
+                condition: LiteralBool(true),
+                then: Return(LiteralInt(1)),
+                else: Return(LiteralInt(2))
+            )
+        ])
+        XCTAssertEqual(
+            try tracer.reachability(ast: ast),
+            StatementTracer.Reachability(fallsThrough: false, returns: true)
+        )
+    }
+
+    func testReachabilityThrowsErrorWhenStatementAfterReturnInBlock() {
+        let tracer = StatementTracer()
+        let one = LiteralInt(1)
+        let ast = Block(children: [
+            While(
+                condition: LiteralBool(true),
+                body: Block(children: [
+                    Return(one),
+                    ExprUtils.makeAssignment(name: "foo", right: one)
+                ])
+            )
+        ])
+        XCTAssertThrowsError(try tracer.reachability(ast: ast)) {
+            XCTAssertEqual(
+                ($0 as? CompilerError)?.message,
+                "code after return will never be executed"
+            )
+        }
+    }
+
+    func testReachabilityOfMatchWithoutElseClause() throws {
+        let ast = Block(children: [
+            Match(
+                expr: Identifier("test"),
+                clauses: [
+                    Match.Clause(
+                        valueIdentifier: Identifier("foo"),
+                        valueType: PrimitiveType(.u8),
+                        block: Block(children: [Return(LiteralInt(1))])
+                    )
+                ],
+                elseClause: nil
+            )
+        ])
+        let tracer = StatementTracer()
+        XCTAssertEqual(
+            try tracer.reachability(ast: ast),
+            try reachability(of: tracer.trace(ast: ast))
+        )
+    }
+
+    func testReachabilityAgreesWithTracesOfRandomPrograms() throws {
+        var generator = RandomStatementGenerator(seed: 1)
+        let tracer = StatementTracer()
+        for _ in 0..<500 {
+            let ast = generator.makeBlock(depth: 4)
+            let expected = Result { try reachability(of: tracer.trace(ast: ast)) }
+            let actual = Result { try tracer.reachability(ast: ast) }
+            switch (expected, actual) {
+            case let (.success(expected), .success(actual)):
+                XCTAssertEqual(actual, expected)
+            case let (.failure(expected), .failure(actual)):
+                XCTAssertEqual(
+                    (actual as? CompilerError)?.message,
+                    (expected as? CompilerError)?.message
+                )
+            default:
+                XCTFail("expected \(expected), got \(actual)")
+            }
+        }
+    }
+
+    func testReachabilityOfDeepConditionalChain() throws {
+        // There are 2^200 paths through this function.
+        let children: [AbstractSyntaxTreeNode] = (0..<200).map { _ in
+            If(condition: LiteralBool(true), then: Return(LiteralInt(1)), else: nil)
+        }
+        let ast = Block(children: children + [Return(LiteralInt(2))])
+        XCTAssertEqual(
+            try StatementTracer().reachability(ast: ast),
+            StatementTracer.Reachability(fallsThrough: false, returns: true)
+        )
+    }
+}
+
+/// Generates random statements from a fixed seed, for comparing the
+/// reachability analysis against the traces of every path
+private struct RandomStatementGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    private mutating func next(_ n: Int) -> Int {
+        state = state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+        return Int((state >> 33) % UInt64(n))
+    }
+
+    mutating func makeBlock(depth: Int) -> Block {
+        let count = next(4)
+        var children: [AbstractSyntaxTreeNode] = []
+        for _ in 0..<count {
+            children.append(makeStatement(depth: depth))
+        }
+        // Occasionally place a return in the middle of the block.
+        if next(8) == 0 {
+            children.insert(Return(nil), at: next(children.count + 1))
+        }
+        return Block(children: children)
+    }
+
+    mutating func makeStatement(depth: Int) -> AbstractSyntaxTreeNode {
+        let kind = depth > 0 ? next(7) : next(2)
+        switch kind {
+        case 0:
+            return Return(nil)
+        case 1:
+            return ExprUtils.makeAssignment(name: "foo", right: LiteralInt(1))
+        case 2:
+            return If(
+                condition: LiteralBool(true),
+                then: makeBlock(depth: depth - 1),
+                else: next(2) == 0 ? nil : makeBlock(depth: depth - 1)
+            )
+        case 3:
+            return While(condition: LiteralBool(true), body: makeBlock(depth: depth - 1))
+        case 4:
+            return Match(
+                expr: Identifier("test"),
+                clauses: (0..<next(3)).map { _ in
+                    Match.Clause(
+                        valueIdentifier: Identifier("foo"),
+                        valueType: PrimitiveType(.u8),
+                        block: makeBlock(depth: depth - 1)
+                    )
+                },
+                elseClause: next(2) == 0 ? nil : makeBlock(depth: depth - 1)
+            )
+        case 5:
+            return Seq(children: [makeStatement(depth: depth - 1), makeStatement(depth: depth - 1)])
+        default:
+            return makeBlock(depth: depth - 1)
+        }
+    }
 }
@@ -47,7 +47,10 @@ final class TackDebuggerTests: XCTestCase {
             isUsingStandardLibrary: options.isUsingStandardLibrary,
             runtimeSupport: options.runtimeSupport,
             shouldRunSpecificTest: options.shouldRunSpecificTest,
-            injectedModules: options.injectModules
+            injectedModules: options.injectModules,
+            // Each call keeps a frame of its own, so that it appears in the
+            // backtrace.
+            isInliningEnabled: false
         )
 
         let compiler = SnapCompilerFrontEnd(
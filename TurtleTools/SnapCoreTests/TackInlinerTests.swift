@@ -0,0 +1,223 @@
+//
+//  TackInlinerTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import XCTest
+
+final class TackInlinerTests: XCTestCase {
+    fileprivate func ins(_ instruction: TackInstruction) -> TackInstructionNode {
+        TackInstructionNode(instruction)
+    }
+
+    fileprivate func label(_ identifier: String) -> LabelDeclaration {
+        LabelDeclaration(identifier: identifier)
+    }
+
+    func testEmpty() {
+        let input = Seq()
+        XCTAssertEqual(TackInliner().compile(input), input)
+    }
+
+    func testInlineSmallCallee() {
+        let foo = Subroutine(
+            identifier: "foo",
+            children: [
+                ins(.enter(0)),
+                ins(.liw(.w(0), 1)),
+                ins(.sw(.w(0), .fp, 7)),
+                ins(.leave),
+                ins(.ret)
+            ]
+        )
+        let input = Seq(children: [
+            ins(.call("foo")),
+            foo
+        ])
+        let expected = Seq(children: [
+            ins(.subip(.p(0), .sp, 7)),
+            ins(.liw(.w(1), 1)),
+            ins(.sw(.w(1), .p(0), 7)),
+            ins(.jmp(".Lfoo_inline0")),
+            label(".Lfoo_inline0"),
+            foo
+        ])
+        XCTAssertEqual(TackInliner().compile(input), expected)
+    }
+
+    func testEachCopyHasItsOwnFrameRegistersAndLabels() {
+        let bar = Subroutine(
+            identifier: "bar",
+            children: [
+                ins(.enter(1)),
+                label(".L0"),
+                ins(.lw(.w(0), .fp, -1)),
+                ins(.bzw(.w(0), ".L0")),
+                ins(.leave),
+                ins(.ret)
+            ]
+        )
+        let input = Seq(children: [
+            ins(.call("bar")),
+            ins(.call("bar")),
+            bar
+        ])
+        let expected = Seq(children: [
+            ins(.subip(.p(0), .sp, 7)),
+            ins(.subip(.sp, .sp, 8)),
+            label(".L0_inline0"),
+            ins(.lw(.w(1), .p(0), -1)),
+            ins(.bzw(.w(1), ".L0_inline0")),
+            ins(.addip(.sp, .p(0), 7)),
+            ins(.jmp(".Lbar_inline0")),
+            label(".Lbar_inline0"),
+            ins(.subip(.p(2), .sp, 7)),
+            ins(.subip(.sp, .sp, 8)),
+            label(".L0_inline1"),
+            ins(.lw(.w(3), .p(2), -1)),
+            ins(.bzw(.w(3), ".L0_inline1")),
+            ins(.addip(.sp, .p(2), 7)),
+            ins(.jmp(".Lbar_inline1")),
+            label(".Lbar_inline1"),
+            bar
+        ])
+        let report = TackInliner.Report()
+        XCTAssertEqual(TackInliner(report: report).compile(input), expected)
+        XCTAssertEqual(report.entries.map(\.callee), ["bar", "bar"])
+        XCTAssertEqual(report.entries.map(\.caller), [nil, nil])
+        XCTAssertEqual(report.entries.map(\.instructionCount), [2, 2])
+    }
+
+    func testInlinedRegistersAreNumberedAboveThoseOfTheCaller() {
+        // The top level uses many registers, but the copy inlined into bar
+        // only needs to avoid the registers of bar.
+        let foo = Subroutine(
+            identifier: "foo",
+            children: [
+                ins(.enter(0)),
+                ins(.liw(.w(0), 1)),
+                ins(.leave),
+                ins(.ret)
+            ]
+        )
+        let bar = Subroutine(
+            identifier: "bar",
+            children: [
+                ins(.enter(0)),
+                ins(.liw(.w(2), 2)),
+                ins(.call("foo")),
+                ins(.leave),
+                ins(.ret)
+            ]
+        )
+        let input = Seq(children: [
+            ins(.liw(.w(50), 3)),
+            foo,
+            bar
+        ])
+        let expected = Seq(children: [
+            ins(.liw(.w(50), 3)),
+            foo,
+            Subroutine(
+                identifier: "bar",
+                children: [
+                    ins(.enter(0)),
+                    ins(.liw(.w(2), 2)),
+                    ins(.subip(.p(3), .sp, 7)),
+                    ins(.liw(.w(4), 1)),
+                    ins(.jmp(".Lfoo_inline0")),
+                    label(".Lfoo_inline0"),
+                    ins(.leave),
+                    ins(.ret)
+                ]
+            )
+        ])
+        XCTAssertEqual(TackInliner().compile(input), expected)
+    }
+
+    func testDoNotInlineRecursiveCallee() {
+        let input = Seq(children: [
+            ins(.call("foo")),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(.enter(0)),
+                    ins(.call("foo")),
+                    ins(.leave),
+                    ins(.ret)
+                ]
+            )
+        ])
+        XCTAssertEqual(TackInliner().compile(input), input)
+    }
+
+    func testDoNotInlineCalleeWithInlineAssembly() {
+        let input = Seq(children: [
+            ins(.call("foo")),
+            Subroutine(
+                identifier: "foo",
+                children: [
+                    ins(.enter(0)),
+                    ins(.inlineAssembly("NOP")),
+                    ins(.leave),
+                    ins(.ret)
+                ]
+            )
+        ])
+        XCTAssertEqual(TackInliner().compile(input), input)
+    }
+
+    func testDoNotInlineLargeCalleeWithManyCallSites() {
+        let body = (0..<20).map { i in ins(.liw(.w(i), i)) }
+        let input = Seq(children: [
+            ins(.call("foo")),
+            ins(.call("foo")),
+            Subroutine(
+                identifier: "foo",
+                children: [ins(.enter(0))] + body + [ins(.leave), ins(.ret)]
+            )
+        ])
+        XCTAssertEqual(TackInliner().compile(input), input)
+    }
+
+    func testInlinedProgramComputesTheSameResult() throws {
+        let program = """
+            func add(a: u16, b: u16) -> u16 {
+                return a + b
+            }
+            var total: u16 = 0
+            var i: u16 = 0
+            while i < 10 {
+                total = add(total, i)
+                i = i + 1
+            }
+            """
+
+        func run(_ isInliningEnabled: Bool) throws -> (TackProgram, UInt, UInt16) {
+            let memoryLayoutStrategy = MemoryLayoutStrategyTurtle16()
+            let compiler = SnapCompilerFrontEnd(
+                options: SnapCompilerFrontEnd.Options(isInliningEnabled: isInliningEnabled),
+                memoryLayoutStrategy: memoryLayoutStrategy
+            )
+            let tackProgram = try compiler.compile(program: program)
+            let vm = TackVirtualMachine(tackProgram)
+            try vm.run()
+            let debugger = TackDebugger(vm, memoryLayoutStrategy)
+            debugger.symbolsOfTopLevelScope = compiler.symbolsOfTopLevelScope
+            return (tackProgram, vm.instructionCount, try XCTUnwrap(debugger.loadSymbolU16("total")))
+        }
+
+        let (inlinedProgram, inlinedCount, inlinedResult) = try run(true)
+        let (program, count, result) = try run(false)
+        XCTAssertEqual(inlinedResult, 45)
+        XCTAssertEqual(inlinedResult, result)
+        XCTAssertLessThan(inlinedCount, count)
+        XCTAssertTrue(inlinedProgram.listing.contains("_inline0"))
+        XCTAssertFalse(program.listing.contains("_inline0"))
+    }
+}
@@ -0,0 +1,338 @@
+//
+//  TackOptimizerTests.swift
+//  SnapCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import SnapCore
+import TurtleCore
+import XCTest
+
+final class TackOptimizerTests: XCTestCase {
+    fileprivate func ins(_ instruction: TackInstruction) -> TackInstructionNode {
+        TackInstructionNode(instruction)
+    }
+
+    fileprivate func label(_ identifier: String) -> LabelDeclaration {
+        LabelDeclaration(identifier: identifier)
+    }
+
+    func testEmpty() {
+        let optimizer = TackOptimizer()
+        XCTAssertEqual(optimizer.optimize(children: []).count, 0)
+    }
+
+    func testFoldConstants() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 2)),
+            ins(.liw(.w(1), 3)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 0))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(2), 5)),
+            ins(.sw(.w(2), .fp, 0))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testFoldingFollowsTheVirtualMachine() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), -1)),
+            ins(.liw(.w(1), 1)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 0)),
+            ins(.ltw(.o(0), .w(0), .w(1))),
+            ins(.so(.o(0), .fp, 2)),
+            ins(.ltuw(.o(1), .w(0), .w(1))),
+            ins(.so(.o(1), .fp, 3)),
+            ins(.liub(.b(0), 200)),
+            ins(.liub(.b(1), 100)),
+            ins(.addb(.b(2), .b(0), .b(1))),
+            ins(.sb(.b(2), .fp, 4))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(2), 0)),
+            ins(.sw(.w(2), .fp, 0)),
+            ins(.lio(.o(0), true)),
+            ins(.so(.o(0), .fp, 2)),
+            ins(.lio(.o(1), false)),
+            ins(.so(.o(1), .fp, 3)),
+            ins(.liub(.b(2), 44)),
+            ins(.sb(.b(2), .fp, 4))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testDoNotFoldDivisionByZero() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 1)),
+            ins(.liw(.w(1), 0)),
+            ins(.divw(.w(2), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 0))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testUseImmediateOperands() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.liw(.w(1), 3)),
+            ins(.addw(.w(2), .w(1), .w(0))),
+            ins(.sw(.w(2), .fp, 2))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.addiw(.w(2), .w(0), 3)),
+            ins(.sw(.w(2), .fp, 2))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testPropagateCopies() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.movw(.w(1), .w(0))),
+            ins(.addw(.w(2), .w(1), .w(1))),
+            ins(.sw(.w(2), .fp, 2))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.addw(.w(2), .w(0), .w(0))),
+            ins(.sw(.w(2), .fp, 2))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testEliminateCommonSubexpressions() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.lw(.w(1), .fp, 2)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.addw(.w(3), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 4)),
+            ins(.sw(.w(3), .fp, 6))
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.lw(.w(1), .fp, 2)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 4)),
+            ins(.sw(.w(2), .fp, 6))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testDoNotReuseAnExpressionAfterItsOperandChanges() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.addw(.w(1), .w(0), .w(0))),
+            ins(.lw(.w(0), .fp, 2)),
+            ins(.addw(.w(2), .w(0), .w(0))),
+            ins(.sw(.w(1), .fp, 4)),
+            ins(.sw(.w(2), .fp, 6))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testDoNotLoadAgainFromMemory() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(0), .fp, 0)),
+            ins(.sw(.w(0), .fp, 2)),
+            ins(.lw(.w(1), .fp, 0)),
+            ins(.sw(.w(1), .fp, 4))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testPropagateConstantsAcrossBlocks() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(5), .fp, 0)),
+            ins(.liw(.w(0), 7)),
+            ins(.bzw(.w(5), "foo")),
+            ins(.sw(.w(0), .fp, 2)),
+            label("foo"),
+            ins(.addiw(.w(1), .w(0), 1)),
+            ins(.sw(.w(1), .fp, 4)),
+            ins(.ret)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(5), .fp, 0)),
+            ins(.liw(.w(0), 7)),
+            ins(.bzw(.w(5), "foo")),
+            ins(.sw(.w(0), .fp, 2)),
+            label("foo"),
+            ins(.liw(.w(1), 8)),
+            ins(.sw(.w(1), .fp, 4)),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testDifferentConstantsOnEachPathAreNotFolded() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lw(.w(5), .fp, 0)),
+            ins(.liw(.w(0), 7)),
+            ins(.bzw(.w(5), "foo")),
+            ins(.liw(.w(0), 8)),
+            label("foo"),
+            ins(.addiw(.w(1), .w(0), 1)),
+            ins(.sw(.w(1), .fp, 4)),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testRemoveBranchWhichIsNeverTaken() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lio(.o(0), true)),
+            ins(.bz(.o(0), "foo")),
+            ins(.liw(.w(0), 1)),
+            ins(.sw(.w(0), .fp, 0)),
+            label("foo"),
+            ins(.ret)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 1)),
+            ins(.sw(.w(0), .fp, 0)),
+            label("foo"),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testRemoveCodeSkippedByBranchWhichIsAlwaysTaken() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.lio(.o(0), false)),
+            ins(.bz(.o(0), "foo")),
+            ins(.liw(.w(0), 1)),
+            ins(.sw(.w(0), .fp, 0)),
+            label("foo"),
+            ins(.ret)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            label("foo"),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testLabelWithAddressTakenIsReachable() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.la(.p(0), "foo")),
+            ins(.sp(.p(0), .fp, 0)),
+            ins(.liw(.w(0), 1)),
+            ins(.sw(.w(0), .fp, 2)),
+            ins(.ret),
+            label("foo"),
+            ins(.addiw(.w(1), .w(0), 1)),
+            ins(.sw(.w(1), .fp, 4)),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testRegistersAreNotCarriedAcrossEnterAndLeave() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 1)),
+            ins(.enter(0)),
+            ins(.addiw(.w(1), .w(0), 1)),
+            ins(.sw(.w(1), .fp, 0)),
+            ins(.leave),
+            ins(.ret)
+        ]
+        let expected: [AbstractSyntaxTreeNode] = [
+            ins(.enter(0)),
+            ins(.addiw(.w(1), .w(0), 1)),
+            ins(.sw(.w(1), .fp, 0)),
+            ins(.leave),
+            ins(.ret)
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: expected))
+    }
+
+    func testLeaveCodeWithInlineAssemblyAlone() {
+        let input: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 2)),
+            ins(.liw(.w(1), 3)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.inlineAssembly("NOP"))
+        ]
+        let actual = TackOptimizer().optimize(children: input)
+        XCTAssertEqual(Seq(children: actual), Seq(children: input))
+    }
+
+    func testOptimizeEachSubroutine() throws {
+        let body: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(0), 2)),
+            ins(.liw(.w(1), 3)),
+            ins(.addw(.w(2), .w(0), .w(1))),
+            ins(.sw(.w(2), .fp, 0))
+        ]
+        let optimizedBody: [AbstractSyntaxTreeNode] = [
+            ins(.liw(.w(2), 5)),
+            ins(.sw(.w(2), .fp, 0))
+        ]
+        let input = Seq(children: [
+            Seq(children: body),
+            Subroutine(identifier: "foo", children: [ins(.enter(0)), Seq(children: body)]),
+            Subroutine(identifier: "bar", children: [ins(.enter(0)), Seq(children: body)])
+        ])
+        let expected = Seq(children: optimizedBody + [
+            Subroutine(identifier: "foo", children: [ins(.enter(0))] + optimizedBody),
+            Subroutine(identifier: "bar", children: [ins(.enter(0))] + optimizedBody)
+        ])
+        let actual = try TackOptimizer(jobs: 2).compile(input)
+        XCTAssertEqual(actual, expected)
+    }
+
+    func testOptimizedProgramComputesTheSameResult() throws {
+        let program = """
+            let a: u16 = 2 * 3 + 4
+            var b: u16 = a
+            var i: u16 = 0
+            while i < 5 {
+                b = b + a
+                i = i + 1
+            }
+            """
+
+        func run(_ isTackOptimizationEnabled: Bool) throws -> (TackProgram, UInt16) {
+            let memoryLayoutStrategy = MemoryLayoutStrategyTurtle16()
+            let compiler = SnapCompilerFrontEnd(
+                options: SnapCompilerFrontEnd.Options(
+                    isTackOptimizationEnabled: isTackOptimizationEnabled
+                ),
+                memoryLayoutStrategy: memoryLayoutStrategy
+            )
+            let tackProgram = try compiler.compile(program: program)
+            let vm = TackVirtualMachine(tackProgram)
+            try vm.run()
+            let debugger = TackDebugger(vm, memoryLayoutStrategy)
+            debugger.symbolsOfTopLevelScope = compiler.symbolsOfTopLevelScope
+            return (tackProgram, try XCTUnwrap(debugger.loadSymbolU16("b")))
+        }
+
+        let (optimizedProgram, optimizedResult) = try run(true)
+        let (unoptimizedProgram, unoptimizedResult) = try run(false)
+        XCTAssertEqual(optimizedResult, 60)
+        XCTAssertEqual(optimizedResult, unoptimizedResult)
+        XCTAssertLessThan(optimizedProgram.instructions.count, unoptimizedProgram.instructions.count)
+    }
+}
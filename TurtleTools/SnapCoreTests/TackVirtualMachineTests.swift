@@ -470,6 +470,105 @@ final class TackVirtualMachineTests: XCTestCase {
         XCTAssertEqual(0, try vm.getRegister(p: .sp))
     }
 
+    func testRegistersInDeeplyNestedFrames() throws {
+        let depth = 1000
+        let program = TackProgram(
+            instructions: [TackInstruction](repeating: .enter(0), count: depth)
+                + [TackInstruction](repeating: .leave, count: depth),
+            labels: [:]
+        )
+        let vm = TackVirtualMachine(program)
+        for i in 0..<depth {
+            vm.setRegister(.w(0), w: UInt16(i))
+            try vm.step()
+        }
+        for i in (0..<depth).reversed() {
+            try vm.step()
+            XCTAssertEqual(UInt16(i), try vm.getRegister(w: .w(0)))
+        }
+        XCTAssertEqual(0, try vm.getRegister(p: .sp))
+    }
+
+    func testRegisterWithLargeIndexIsPreservedInOuterFrames() throws {
+        let program = TackProgram(instructions: [], labels: [:])
+        let vm = TackVirtualMachine(program)
+        vm.setRegister(.p(1), p: 0xcafe)
+        try vm.pushRegisters()
+        vm.setRegister(.o(1000), o: true)
+        XCTAssertEqual(true, try vm.getRegister(o: .o(1000)))
+        try vm.popRegisters()
+        XCTAssertEqual(0xcafe, try vm.getRegister(p: .p(1)))
+        XCTAssertThrowsError(try vm.getRegister(o: .o(1000)))
+    }
+
+    func testRegistersPropertyRoundTrips() throws {
+        let program = TackProgram(instructions: [], labels: [:])
+        let vm = TackVirtualMachine(program)
+        vm.setRegister(.ra, p: 3)
+        vm.setRegister(.b(2), b: 4)
+        try vm.pushRegisters()
+        vm.setRegister(.w(7), w: 5)
+        let expected: [[TackInstruction.Register: UInt]] = [
+            [.ra: 3, .b(.b(2)): 4],
+            [.w(.w(7)): 5]
+        ]
+        XCTAssertEqual(vm.registers, expected)
+        XCTAssertEqual(vm.backtrace, [3, 0])
+
+        vm.registers = [[.o(.o(40)): 1]]
+        XCTAssertEqual(true, try vm.getRegister(o: .o(40)))
+        XCTAssertThrowsError(try vm.getRegister(w: .w(7)))
+    }
+
+    func testRecursiveSubroutineDoesNotDisturbTopLevelRegisters() throws {
+        // The top level uses a register with a large index. The frames of
+        // the subroutine are sized for its own registers only.
+        let program = TackProgram(
+            instructions: [
+                .lip(.p(1), 0x100),
+                .liw(.w(500), 7),
+                .liw(.w(2), 10),
+                .sw(.w(2), .p(1), 0),
+                .call("f"),
+                .hlt,
+                .enter(0), // f
+                .lip(.p(0), 0x100),
+                .lw(.w(1), .p(0), 0),
+                .bzw(.w(1), "done"),
+                .subiw(.w(1), .w(1), 1),
+                .sw(.w(1), .p(0), 0),
+                .call("f"),
+                .leave, // done
+                .ret
+            ],
+            labels: [
+                "f": 6,
+                "done": 13
+            ]
+        )
+        for isCompiledExecutionEnabled in [false, true] {
+            let vm = TackVirtualMachine(program)
+            vm.isCompiledExecutionEnabled = isCompiledExecutionEnabled
+            try vm.run()
+            XCTAssertEqual(7, try vm.getRegister(w: .w(500)))
+            XCTAssertEqual(0, vm.loadw(address: 0x100))
+            XCTAssertEqual(vm.registers.count, 1)
+        }
+    }
+
+    func testMemoryAtTheTopOfTheAddressSpace() throws {
+        let program = TackProgram(instructions: [], labels: [:])
+        let vm = TackVirtualMachine(program)
+        vm.store(w: 0x1234, address: UInt.max)
+        vm.store(w: 0x5678, address: UInt.max / 2)
+        vm.store(w: 0x9abc, address: 0x100)
+        XCTAssertEqual(0x1234, vm.loadw(address: UInt.max))
+        XCTAssertEqual(0x5678, vm.loadw(address: UInt.max / 2))
+        XCTAssertEqual(0x9abc, vm.loadw(address: 0x100))
+        XCTAssertEqual(0, vm.loadw(address: UInt.max - 1))
+        XCTAssertEqual(0, vm.loadw(address: 0x7fff_0000))
+    }
+
     func testLOAD16_ZeroOffset() throws {
         let program = TackProgram(
             instructions: [
@@ -2400,6 +2499,90 @@ final class TackVirtualMachineTests: XCTestCase {
         XCTAssertTrue(vm.isHalted)
     }
 
+    fileprivate func makeLoopProgram() -> TackProgram {
+        TackProgram(
+            instructions: [
+                .liw(.w(0), 0),
+                .liw(.w(1), 10),
+                .liw(.w(2), 0),
+                .call("add3"), // loop
+                .addiw(.w(0), .w(0), 3),
+                .subiw(.w(1), .w(1), 1),
+                .new(.o(0), .w(1), .w(2)),
+                .bnz(.o(0), "loop"),
+                .hlt,
+                .enter(1), // add3
+                .leave,
+                .ret
+            ],
+            labels: ["loop": 3, "add3": 9]
+        )
+    }
+
+    func testCompiledExecutionMatchesTheInterpreter() throws {
+        let compiled = TackVirtualMachine(makeLoopProgram())
+        try compiled.run()
+
+        let interpreted = TackVirtualMachine(makeLoopProgram())
+        interpreted.isCompiledExecutionEnabled = false
+        try interpreted.run()
+
+        XCTAssertTrue(compiled.isHalted)
+        XCTAssertEqual(30, try compiled.getRegister(w: .w(0)))
+        XCTAssertEqual(compiled.pc, interpreted.pc)
+        XCTAssertEqual(compiled.registers, interpreted.registers)
+        XCTAssertEqual(compiled.instructionCount, interpreted.instructionCount)
+        XCTAssertEqual(try compiled.getRegister(p: .sp), try interpreted.getRegister(p: .sp))
+    }
+
+    func testCompiledExecution_UndefinedLabel() throws {
+        let program = TackProgram(
+            instructions: [
+                .nop,
+                .jmp("foo")
+            ],
+            labels: [:]
+        )
+        let vm = TackVirtualMachine(program)
+        XCTAssertThrowsError(try vm.run()) {
+            XCTAssertEqual($0 as? TackVirtualMachineError, .undefinedLabel("foo"))
+        }
+        XCTAssertEqual(vm.pc, 1)
+    }
+
+    func testCompiledExecution_UndefinedRegister() throws {
+        let program = TackProgram(
+            instructions: [
+                .addw(.w(0), .w(1), .w(2))
+            ],
+            labels: [:]
+        )
+        let vm = TackVirtualMachine(program)
+        vm.setRegister(.w(1), w: 1)
+        XCTAssertThrowsError(try vm.run()) {
+            XCTAssertEqual($0 as? TackVirtualMachineError, .undefinedRegister(.w(.w(2))))
+        }
+    }
+
+    func testCompiledExecution_FallsBackToTheInterpreterAtBREAK() throws {
+        let program = TackProgram(
+            instructions: [
+                .nop,
+                .inlineAssembly("BREAK"),
+                .liw(.w(0), 1),
+                .liw(.w(0), 2)
+            ],
+            labels: [:]
+        )
+        let vm = TackVirtualMachine(program)
+        try vm.run()
+        XCTAssertEqual(vm.pc, 2)
+        XCTAssertFalse(vm.isHalted)
+        try vm.run()
+        XCTAssertTrue(vm.isHalted)
+        XCTAssertEqual(2, try vm.getRegister(w: .w(0)))
+    }
+
     func testSyscall_Invalid() throws {
         let syscallNumber = TackVirtualMachine.Syscall.invalid.rawValue
         let addressOfArgumentStructure = 0
@@ -9,102 +9,374 @@
 import Foundation
 import Logging
 
+/// Summarizes how well a run of `runTestInBatches` kept its jobs busy
+struct BatchSchedulerReport: Equatable {
+    /// The number of batches run after calibration
+    var batchCount = 0
+
+    /// The batch size chosen at the end of calibration
+    var initialBatchSize = 0
+
+    /// The batch size in use when the last batch was started
+    var finalBatchSize = 0
+
+    /// Wall-clock time spent after calibration, in seconds
+    var elapsedTime: TimeInterval = 0
+
+    /// The sum of the time spent running each batch, in seconds
+    var busyTime: TimeInterval = 0
+
+    /// The maximum number of batches in flight at any one time
+    var jobCount: Int
+
+    /// The fraction of the available job time which was spent running batches
+    var utilization: Double {
+        guard elapsedTime > 0, jobCount > 0 else {
+            return 1
+        }
+        return busyTime / (elapsedTime * Double(jobCount))
+    }
+}
+
+/// Selects one of several equal slices of the values of each test, so that a run may be split
+/// across processes or machines. Shard `index` of `count` tests the `index`th slice, counting
+/// from zero, of the values for every register combination.
+struct Shard: Equatable, Sendable, CustomStringConvertible {
+    let index: Int
+    let count: Int
+
+    static let all = Shard(index: 0, count: 1)
+
+    init(index: Int, count: Int) {
+        precondition(count > 0 && index >= 0 && index < count)
+        self.index = index
+        self.count = count
+    }
+
+    /// Parse a shard written as "i/N"
+    init?(argument: String) {
+        let parts = argument.split(separator: "/", omittingEmptySubsequences: false)
+        guard parts.count == 2,
+              let index = Int(parts[0]),
+              let count = Int(parts[1]),
+              count > 0, index >= 0, index < count
+        else {
+            return nil
+        }
+        self.init(index: index, count: count)
+    }
+
+    var description: String {
+        "\(index)/\(count)"
+    }
+
+    /// This shard's slice of the range, or nil if the slice is empty
+    func slice(of range: ClosedRange<Int>) -> ClosedRange<Int>? {
+        let lowerBound = range.lowerBound + range.count * index / count
+        let upperBound = range.lowerBound + range.count * (index + 1) / count - 1
+        guard lowerBound <= upperBound else {
+            return nil
+        }
+        return lowerBound...upperBound
+    }
+}
+
+/// Determines how the work of one test is divided up and where its progress is recorded
+struct BatchSchedule: Sendable {
+    /// The maximum number of batches in flight at any one time
+    var jobCount: Int
+
+    /// The slice of the values which this process is responsible for
+    var shard: Shard = .all
+
+    /// Records the ranges which pass, and supplies the ranges which passed in an earlier run
+    var checkpoint: ValidationCheckpoint?
+
+    /// The name under which the test's progress is recorded in the checkpoint
+    var testName = ""
+
+    /// The machine on which each test program runs
+    var backend: ValidationBackend = .vm
+}
+
+/// Hands out consecutive ranges of values for each register combination in turn
+struct BatchCursor<RegisterType> {
+    /// A range of values still to be tested with one register combination
+    struct WorkItem {
+        let combination: Int
+        let registers: [RegisterType]
+        let range: ClosedRange<Int>
+    }
+
+    private var workItems: [WorkItem]
+    private var itemIndex = 0
+    private var nextValue: Int
+
+    /// The number of values not yet handed out, over all register combinations
+    private(set) var remainingIterations: Int
+
+    init(workItems: [WorkItem]) {
+        self.workItems = workItems
+        nextValue = workItems.first?.range.lowerBound ?? 0
+        remainingIterations = workItems.reduce(0) { $0 + $1.range.count }
+    }
+
+    init(registerCombinations: [[RegisterType]], valueRange: ClosedRange<Int>) {
+        self.init(
+            workItems: registerCombinations.enumerated().map {
+                WorkItem(combination: $0.offset, registers: $0.element, range: valueRange)
+            }
+        )
+    }
+
+    /// Cover the shard's slice of the values for each register combination, less the ranges
+    /// which the checkpoint records as having passed already
+    init(
+        registerCombinations: [[RegisterType]],
+        valueRange: ClosedRange<Int>,
+        schedule: BatchSchedule
+    ) {
+        var workItems: [WorkItem] = []
+        for (combination, registers) in registerCombinations.enumerated() {
+            guard let slice = schedule.shard.slice(of: valueRange) else {
+                continue
+            }
+            let completed = schedule.checkpoint?.completedRanges(
+                test: schedule.testName,
+                combination: combination
+            ) ?? []
+            for range in ValidationCheckpoint.subtract(completed, from: slice) {
+                workItems.append(
+                    WorkItem(combination: combination, registers: registers, range: range)
+                )
+            }
+        }
+        self.init(workItems: workItems)
+    }
+
+    var isExhausted: Bool {
+        remainingIterations == 0
+    }
+
+    /// Take the next range of at most `batchSize` values. A range never spans
+    /// two register combinations.
+    mutating func next(
+        batchSize: Int
+    ) -> (combination: Int, registers: [RegisterType], range: ClosedRange<Int>)? {
+        guard itemIndex < workItems.count else {
+            return nil
+        }
+        let item = workItems[itemIndex]
+        let upperBound = nextValue + min(batchSize, item.range.upperBound - nextValue + 1) - 1
+        let range = nextValue...upperBound
+        remainingIterations -= range.count
+        if upperBound == item.range.upperBound {
+            itemIndex += 1
+            nextValue = itemIndex < workItems.count ? workItems[itemIndex].range.lowerBound : 0
+        }
+        else {
+            nextValue = upperBound + 1
+        }
+        return (item.combination, item.registers, range)
+    }
+}
+
+/// A batch which has run to completion
+struct CompletedBatch<RegisterType: Sendable>: Sendable {
+    let combination: Int
+    let registers: [RegisterType]
+    let range: ClosedRange<Int>
+    let elapsedTime: TimeInterval
+}
+
 /// Runs a test function in batches with controlled parallelism and adaptive batch sizing
+@discardableResult
 func runTestInBatches<Config: TackRegisterConfiguration>(
-    _: Config.Type,
+    _ config: Config.Type,
     registers: [Config.RegisterType],
     testFunction: @escaping @Sendable ([Config.RegisterType], ClosedRange<Int>) throws -> Void,
     progress: Progress,
     jobCount: Int
-) async throws {
-    let totalIterations = Int(Config.ValueType.max) - Int(Config.ValueType.min) + 1
+) async throws -> BatchSchedulerReport {
+    try await runTestInBatches(
+        config,
+        registerCombinations: [registers],
+        testFunction: testFunction,
+        progress: progress,
+        jobCount: jobCount
+    )
+}
+
+@discardableResult
+func runTestInBatches<Config: TackRegisterConfiguration>(
+    _ config: Config.Type,
+    registerCombinations: [[Config.RegisterType]],
+    testFunction: @escaping @Sendable ([Config.RegisterType], ClosedRange<Int>) throws -> Void,
+    progress: Progress,
+    jobCount: Int
+) async throws -> BatchSchedulerReport {
+    try await runTestInBatches(
+        config,
+        registerCombinations: registerCombinations,
+        testFunction: testFunction,
+        progress: progress,
+        schedule: BatchSchedule(jobCount: jobCount)
+    )
+}
+
+/// Runs a test function in batches over every value of the configuration's value type, for each
+/// of the given register combinations.
+///
+/// A new batch is started as soon as any batch finishes so that exactly `jobCount` batches are in
+/// flight until the work runs out. There is no barrier between register combinations. The batch
+/// size is recalibrated from the time taken by each batch, and batches shrink towards the end of
+/// the run so that the jobs finish at about the same time.
+///
+/// Only the schedule's shard of the values is tested, less any ranges which its checkpoint
+/// records as having passed. The progress is adjusted to count only that work. Each range which
+/// passes is recorded in the checkpoint, which is saved periodically and before returning or
+/// throwing.
+@discardableResult
+func runTestInBatches<Config: TackRegisterConfiguration>(
+    _: Config.Type,
+    registerCombinations: [[Config.RegisterType]],
+    testFunction: @escaping @Sendable ([Config.RegisterType], ClosedRange<Int>) throws -> Void,
+    progress: Progress,
+    schedule: BatchSchedule
+) async throws -> BatchSchedulerReport {
+    let jobCount = max(schedule.jobCount, 1)
+    let checkpoint = schedule.checkpoint
+    let testName = schedule.testName
+    var cursor = BatchCursor(
+        registerCombinations: registerCombinations,
+        valueRange: Int(Config.ValueType.min)...Int(Config.ValueType.max),
+        schedule: schedule
+    )
+    var report = BatchSchedulerReport(jobCount: jobCount)
+    if checkpoint != nil || schedule.shard != .all {
+        progress.totalUnitCount = progress.completedUnitCount + Int64(cursor.remainingIterations)
+    }
+    defer {
+        do {
+            try checkpoint?.save()
+        }
+        catch {
+            TestLogger.logger.error("Failed to save the checkpoint", metadata: [
+                "error": "\(error)"
+            ])
+        }
+    }
 
     // Phase 1: Calibration - run a small batch, measuring how long it takes to complete
     TestLogger.logger.debug("Starting calibration phase", metadata: [
-        "registers": "\(registers)",
-        "total_iterations": "\(totalIterations)"
+        "register_combinations": "\(registerCombinations)",
+        "total_iterations": "\(cursor.remainingIterations)"
     ])
 
-    // Run the test for one value in the range repeatedly, until 1s has elapsed, or the test is
-    // actually completed. Count the number of iterations this took. If the test was not completed
-    // then we can use this count along with the actual elapsed time to determine a good batch size.
-    var currentValue = Int(Config.ValueType.min)
+    // Run the test for one value at a time, until 1s has elapsed, or the test is actually
+    // completed. Count the number of iterations this took. If the test was not completed then we
+    // can use this count along with the actual elapsed time to determine a good batch size.
     var calibrationIterations = 0
     let calibrationStart = Date()
     var calibrationElapsed = TimeInterval()
-    while calibrationElapsed < 1.0 {
-        try testFunction(registers, currentValue...currentValue)
+    while calibrationElapsed < 1.0, let batch = cursor.next(batchSize: 1) {
+        try testFunction(batch.registers, batch.range)
         calibrationElapsed = Date().timeIntervalSince(calibrationStart)
         calibrationIterations += 1
-        currentValue = currentValue + 1
         progress.completedUnitCount += 1
+        checkpoint?.recordCompleted(test: testName, combination: batch.combination, range: batch.range)
+    }
 
-        // Check if calibration completed the entire test
-        guard currentValue <= Config.ValueType.max else {
-            TestLogger.logger.debug("Test completed during calibration", metadata: [
-                "elapsed": "\(String(format: "%.3f", calibrationElapsed))",
-                "iterations": "\(calibrationIterations)"
-            ])
-            return
-        }
+    // Check if calibration completed the entire test
+    guard !cursor.isExhausted else {
+        TestLogger.logger.debug("Test completed during calibration", metadata: [
+            "elapsed": "\(String(format: "%.3f", calibrationElapsed))",
+            "iterations": "\(calibrationIterations)"
+        ])
+        return report
     }
 
-    // Compute a good batch size, aiming for each batch to complete in much less than one second.
-    let iterationsPerSecond = Double(calibrationIterations) / calibrationElapsed
+    // Each batch should complete in much less than one second. The rate is an estimate of the
+    // iterations per second of one job, and it is updated as batches complete since the rate
+    // drops once all the jobs are competing for the machine.
     let targetBatchDuration = 0.1 // seconds
-    let batchSize = min(max(Int(iterationsPerSecond * targetBatchDuration), 1), totalIterations)
+    var iterationsPerSecond = Double(calibrationIterations) / calibrationElapsed
+    func nextBatchSize() -> Int {
+        let calibrated = Int(iterationsPerSecond * targetBatchDuration)
+        let tail = cursor.remainingIterations / (2 * jobCount)
+        return max(min(calibrated, tail), 1)
+    }
+    report.initialBatchSize = nextBatchSize()
 
     TestLogger.logger.debug("Calibration complete", metadata: [
         "elapsed": "\(String(format: "%.3f", calibrationElapsed))",
         "calibration_iterations": "\(calibrationIterations)",
         "iterations_per_sec": "\(String(format: "%.0f", iterationsPerSecond))",
-        "computed_batch_size": "\(batchSize)"
+        "computed_batch_size": "\(report.initialBatchSize)"
     ])
 
-    // Split the remaining work into batches, and split batches into waves, where the batches in
-    // each wave are processed in parallel in a task. The number of tasks in flight at any given
-    // time is limited by the wave size.
-    let waves = (currentValue...Int(Config.ValueType.max))
-        .batched(by: batchSize)
-        .unfold(by: jobCount)
-    for waveBatches in waves {
-        try await withThrowingTaskGroup(of: ClosedRange<Int>.self) { group in
-            // Start a task for each batch in the wave.
-            for batchRange in waveBatches {
-                group.addTask {
-                    try testFunction(registers, batchRange)
-                    return batchRange
-                }
+    // Phase 2: Keep `jobCount` batches in flight, starting the next batch as each one completes.
+    let start = Date()
+    try await withThrowingTaskGroup(of: CompletedBatch<Config.RegisterType>.self) { group in
+        func startNextBatch() -> Bool {
+            let batchSize = nextBatchSize()
+            guard let batch = cursor.next(batchSize: batchSize) else {
+                return false
             }
-
-            // Wait for all tasks in this wave to complete before starting the next wave.
-            for try await batchRange in group {
-                let batchIterations = batchRange.upperBound - batchRange.lowerBound + 1
-                progress.completedUnitCount += Int64(batchIterations)
-                TestLogger.logger.trace(
-                    "Batch completed",
-                    metadata: [
-                        "batchRange": "\(batchRange)",
-                        "registers": "\(registers)",
-                        "progress": "\(progress.completedUnitCount)/\(progress.totalUnitCount)",
-                        "percent": "\(String(format: "%.2f", progress.fractionCompleted * 100.0))%"
-                    ]
+            let combination = batch.combination
+            let registers = batch.registers
+            let range = batch.range
+            report.finalBatchSize = batchSize
+            group.addTask {
+                let batchStart = Date()
+                try testFunction(registers, range)
+                return CompletedBatch(
+                    combination: combination,
+                    registers: registers,
+                    range: range,
+                    elapsedTime: Date().timeIntervalSince(batchStart)
                 )
             }
-        } // withThrowingTaskGroup
-
-        TestLogger.logger.trace(
-            "Wave completed",
-            metadata: [
-                "waveBatches": "\(waveBatches)",
-                "registers": "\(registers)",
-                "progress": "\(progress.completedUnitCount)/\(progress.totalUnitCount)",
-                "percent": "\(String(format: "%.2f", progress.fractionCompleted * 100.0))%"
-            ]
-        )
-    } // for waveBatches in waves
+            return true
+        }
+
+        for _ in 0..<jobCount {
+            guard startNextBatch() else {
+                break
+            }
+        }
 
-    TestLogger.logger.debug("All batches completed", metadata: [
-        "registers": "\(registers)"
+        while let batch = try await group.next() {
+            progress.completedUnitCount += Int64(batch.range.count)
+            report.batchCount += 1
+            report.busyTime += batch.elapsedTime
+            checkpoint?.recordCompleted(test: testName, combination: batch.combination, range: batch.range)
+            try checkpoint?.saveIfDue()
+            if batch.elapsedTime > 0 {
+                let sample = Double(batch.range.count) / batch.elapsedTime
+                iterationsPerSecond = 0.75 * iterationsPerSecond + 0.25 * sample
+            }
+            TestLogger.logger.trace(
+                "Batch completed",
+                metadata: [
+                    "batchRange": "\(batch.range)",
+                    "registers": "\(batch.registers)",
+                    "progress": "\(progress.completedUnitCount)/\(progress.totalUnitCount)",
+                    "percent": "\(String(format: "%.2f", progress.fractionCompleted * 100.0))%"
+                ]
+            )
+            _ = startNextBatch()
+        }
+    } // withThrowingTaskGroup
+    report.elapsedTime = Date().timeIntervalSince(start)
+
+    TestLogger.logger.info("All batches completed", metadata: [
+        "register_combinations": "\(registerCombinations)",
+        "shard": "\(schedule.shard)",
+        "batches": "\(report.batchCount)",
+        "batch_size": "\(report.initialBatchSize) -> \(report.finalBatchSize)",
+        "utilization": "\(String(format: "%.1f", report.utilization * 100.0))%"
     ])
+
+    return report
 }
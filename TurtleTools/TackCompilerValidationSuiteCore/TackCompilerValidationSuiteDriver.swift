@@ -19,6 +19,12 @@ public struct TackCompilerValidationSuiteDriver: AsyncParsableCommand {
             Runs exhaustive tests on all arithmetic and bitwise Tack instructions.
             Tests all possible input combinations for 8-bit and 16-bit operations.
             Execution aborts on the first failure.
+
+            With --checkpoint, an interrupted run resumes where it left off. With --shard, a run \
+            may be split across several processes or machines.
+
+            With --backend turtle16, each test program is also lowered to Turtle16 machine code \
+            and run on the fast CPU model, and every result is compared with the Tack VM.
             """
     )
 
@@ -34,6 +40,42 @@ public struct TackCompilerValidationSuiteDriver: AsyncParsableCommand {
     )
     var jobs: Int = 0 // Default to auto-detect
 
+    @Option(
+        name: .long,
+        help: """
+            Test only the i-th of N equal slices of the values of each test, written as i/N and \
+            counting from zero. Merge the checkpoints of all N shards with --merge.
+            """
+    )
+    var shard: Shard = .all
+
+    @Option(
+        name: .long,
+        help: """
+            Record the ranges of values which pass in this file, and skip the ranges which it \
+            records as passing in an earlier run.
+            """
+    )
+    var checkpoint: String?
+
+    @Option(
+        name: .long,
+        help: """
+            Merge this checkpoint, written by one shard, into the file given by --checkpoint. \
+            May be repeated. Reports the coverage of each test instead of running it.
+            """
+    )
+    var merge: [String] = []
+
+    @Option(
+        name: .long,
+        help: """
+            The machine on which to run each test: vm for the Tack VM, or turtle16 to also \
+            lower each test to Turtle16 and compare its results with the Tack VM. Default: vm
+            """
+    )
+    var backend: ValidationBackend = .vm
+
     @Option(
         name: .long,
         help: "Log level (trace, debug, info, notice, warning, error, critical). Default: warning"
@@ -82,15 +124,40 @@ public struct TackCompilerValidationSuiteDriver: AsyncParsableCommand {
         }
         TestLogger.logger.logLevel = level
 
+        let validationCheckpoint = try checkpoint.map {
+            try ValidationCheckpoint(url: URL(fileURLWithPath: $0))
+        }
+
         if listTests {
             TestRunner.printAvailableTests()
         }
+        else if !merge.isEmpty {
+            guard let validationCheckpoint else {
+                throw ValidationError("--merge requires --checkpoint")
+            }
+            try TestRunner.mergeCheckpoints(
+                merge.map { URL(fileURLWithPath: $0) },
+                into: validationCheckpoint,
+                testFilters: testNames,
+                backend: backend
+            )
+        }
         else {
             let actualJobs = jobs <= 0
                 ? ProcessInfo.processInfo.processorCount
                 : jobs
 
-            try await TestRunner.runTests(testFilters: testNames, jobCount: actualJobs)
+            try await TestRunner.runTests(
+                testFilters: testNames,
+                jobCount: actualJobs,
+                shard: shard,
+                checkpoint: validationCheckpoint,
+                backend: backend
+            )
         }
     }
 }
+
+extension Shard: ExpressibleByArgument {}
+
+extension ValidationBackend: ExpressibleByArgument {}
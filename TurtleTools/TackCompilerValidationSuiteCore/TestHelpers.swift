@@ -8,11 +8,15 @@
 
 import Foundation
 import SnapCore
+import TurtleCore
+
+private let kLoopLabel = "loop"
 
 func testBinaryOp<Config: TackRegisterConfiguration>(
     _: Config.Type,
     registers: [Config.RegisterType],
     aRange aRange0: ClosedRange<Int>,
+    backend: ValidationBackend = .vm,
     expected expectedResultFn: (Config.ValueType, Config.ValueType) -> Config.ValueType?,
     ins: (_ c: Config.RegisterType, _ a: Config.RegisterType, _ b: Config.RegisterType)
         -> TackInstruction
@@ -21,57 +25,39 @@ func testBinaryOp<Config: TackRegisterConfiguration>(
     let a = registers[0]
     let b = registers[1]
     let c = registers[2]
-    let addressA: UInt = 0x1000
-    let addressB: UInt = 0x1001
-    let addressResult: UInt = 0x1002
     let pa: Pointer = .p(0)
     let pb: Pointer = .p(1)
     let pc: Pointer = .p(2)
-    let vm = TackVirtualMachine(
-        TackProgram(
-            instructions: [
-                .lip(pa, Int(addressA)),
-                .lip(pb, Int(addressB)),
-                .lip(pc, Int(addressResult)),
-                Config.load(a, pa, 0),
-                Config.load(b, pb, 0),
-                ins(c, a, b),
-                Config.store(c, pc, 0)
-            ],
-            labels: [:]
-        )
+    let layout = backend.layout
+    let program = try makeOperandLoop(
+        layout: layout,
+        operandPointer: pb,
+        resultPointer: pc,
+        prologue: [.lip(pa, Int(layout.addressA))],
+        body: [
+            Config.load(a, pa, 0),
+            Config.load(b, pb, 0),
+            ins(c, a, b),
+            Config.store(c, pc, 0)
+        ]
     )
+    let machines = try backend.makeMachines(program)
 
+    // Each value of A is tested against every value of B.
+    var block = OperandBlock<Config>(layout: layout)
     for aVal in aRange {
+        block.removeAll()
         for bVal in Config.ValueType.min...Config.ValueType.max {
-            guard let expectedResult = expectedResultFn(aVal, bVal) else {
-                continue
-            }
-            vm.store(aVal, address: addressA)
-            vm.store(bVal, address: addressB)
-
-            vm.pc = 0
-            vm.isHalted = false
-            do {
-                try vm.run()
-                let actual: Config.ValueType = vm.load(address: addressResult)
-                try testAssert(
-                    actual == expectedResult,
-                    "Expected \(expectedResult), got \(actual) for inputs \(aVal), \(bVal)"
-                )
-            }
-            catch {
-                if let vmError = error as? TackVirtualMachineError,
-                   vmError == TackVirtualMachineError.divideByZero {
-                    throw TestFailure(
-                        "TackVirtualMachineError.divideByZero indicates a problem with the test"
-                    )
-                }
-                else {
-                    throw error
-                }
+            if let expectedResult = expectedResultFn(aVal, bVal) {
+                block.append(bVal, expectedResult)
             }
         }
+        for machine in machines {
+            machine.storeCell(OperandBlock<Config>.bitPattern(aVal), at: layout.addressA)
+        }
+        try block.run(machines) { bVal in
+            "inputs \(aVal), \(bVal)"
+        }
     }
 }
 
@@ -79,79 +65,169 @@ func testUnaryOp<Config: TackRegisterConfiguration>(
     _: Config.Type,
     registers: [Config.RegisterType],
     aRange aRange0: ClosedRange<Int>,
+    backend: ValidationBackend = .vm,
     expected expectedResultFn: (Config.ValueType) -> Config.ValueType?,
     ins: (_ c: Config.RegisterType, _ a: Config.RegisterType) -> TackInstruction
 ) throws {
     let aRange = aRange0.converted(to: Config.ValueType.self)!
     let a = registers[0]
     let c = registers[1]
-    let addressA: UInt = 0x1000
-    let addressResult: UInt = 0x1001
     let pa: Pointer = .p(0)
     let pc: Pointer = .p(1)
-    let vm = TackVirtualMachine(
-        TackProgram(
-            instructions: [
-                .lip(pa, Int(addressA)),
-                .lip(pc, Int(addressResult)),
-                Config.load(a, pa, 0),
-                ins(c, a),
-                Config.store(c, pc, 0)
-            ],
-            labels: [:]
-        )
+    let program = try makeOperandLoop(
+        layout: backend.layout,
+        operandPointer: pa,
+        resultPointer: pc,
+        prologue: [],
+        body: [
+            Config.load(a, pa, 0),
+            ins(c, a),
+            Config.store(c, pc, 0)
+        ]
     )
+    let machines = try backend.makeMachines(program)
 
+    var block = OperandBlock<Config>(layout: backend.layout)
     for aVal in aRange {
-        guard let expectedResult = expectedResultFn(aVal) else {
-            continue
-        }
-        vm.store(aVal, address: addressA)
-
-        vm.pc = 0
-        vm.isHalted = false
-        do {
-            try vm.run()
-            let actual: Config.ValueType = vm.load(address: addressResult)
-            try testAssert(
-                actual == expectedResult,
-                "Expected \(expectedResult), got \(actual) for input \(aVal)"
-            )
-        }
-        catch {
-            throw error
+        if let expectedResult = expectedResultFn(aVal) {
+            block.append(aVal, expectedResult)
         }
     }
+    try block.run(machines) { aVal in
+        "input \(aVal)"
+    }
+}
+
+/// Build a program which runs `body` once for each operand in the operand block, advancing the
+/// operand pointer and the result pointer by one after each iteration.
+///
+/// The address one past the end of the operand block is read from `layout.addressEnd`. The
+/// prologue runs once, before the loop. The program is built as a Tack AST so that it may also
+/// be lowered to Turtle16.
+private func makeOperandLoop(
+    layout: OperandLoopLayout,
+    operandPointer: Pointer,
+    resultPointer: Pointer,
+    prologue: [TackInstruction],
+    body: [TackInstruction]
+) throws -> TackProgram {
+    let end: Pointer = .p(3)
+    let isNotDone: TackInstruction.RegisterBoolean = .o(0)
+    let setup: [TackInstruction] =
+        prologue + [
+            .lip(operandPointer, Int(layout.addressOperands)),
+            .lip(resultPointer, Int(layout.addressResults)),
+            .lip(end, Int(layout.addressEnd)),
+            .lp(end, end, 0)
+        ]
+    let loop: [TackInstruction] =
+        body + [
+            .addip(operandPointer, operandPointer, 1),
+            .addip(resultPointer, resultPointer, 1),
+            .nep(isNotDone, operandPointer, end),
+            .bnz(isNotDone, kLoopLabel)
+        ]
+    let ast = Seq(
+        children: setup.map { TackInstructionNode($0) }
+            + [LabelDeclaration(identifier: kLoopLabel)]
+            + loop.map { TackInstructionNode($0) }
+            + [TackInstructionNode(.hlt)]
+    )
+    return try TackFlattener.compile(ast)
 }
 
-extension TackVirtualMachine {
-    func store<T: FixedWidthInteger>(_ value: T, address: UInt) {
-        switch value {
-        case let val as UInt8:
-            store(b: val, address: address)
-        case let val as Int8:
-            store(b: UInt8(bitPattern: val), address: address)
-        case let val as UInt16:
-            store(w: val, address: address)
-        case let val as Int16:
-            store(w: UInt16(bitPattern: val), address: address)
-        default:
-            fatalError("Unsupported type: \(T.self)")
+/// A block of operands, and the result expected for each, for a program built by
+/// `makeOperandLoop`
+private struct OperandBlock<Config: TackRegisterConfiguration> {
+    let layout: OperandLoopLayout
+    private(set) var operands: [Config.ValueType] = []
+    private(set) var expectedResults: [Config.ValueType] = []
+
+    /// The operands which are currently stored in the operand block of each machine
+    private var storedOperands: [Config.ValueType] = []
+
+    init(layout: OperandLoopLayout) {
+        self.layout = layout
+    }
+
+    /// Mask which selects the bits of a value of ValueType in a memory cell
+    private static var mask: UInt {
+        UInt.max >> (UInt.bitWidth - Config.ValueType.bitWidth)
+    }
+
+    /// The contents of a memory cell which holds the given value
+    static func bitPattern(_ value: Config.ValueType) -> UInt {
+        UInt(truncatingIfNeeded: value) & mask
+    }
+
+    mutating func removeAll() {
+        operands.removeAll(keepingCapacity: true)
+        expectedResults.removeAll(keepingCapacity: true)
+    }
+
+    mutating func append(_ operand: Config.ValueType, _ expectedResult: Config.ValueType) {
+        operands.append(operand)
+        expectedResults.append(expectedResult)
+    }
+
+    /// Run the program over the block, in chunks of at most `layout.capacity` operands, and
+    /// check the results. The results of the first machine are checked against the expected
+    /// results, and the results of every other machine are checked against those of the first.
+    ///
+    /// Operands are only written to memory where they differ from the previous chunk, which
+    /// is usually not at all when the whole block fits in one chunk.
+    mutating func run(
+        _ machines: [OperandLoopMachine],
+        describe: (_ operand: Config.ValueType) -> String
+    ) throws {
+        for chunkStart in stride(from: 0, to: operands.count, by: layout.capacity) {
+            let chunk = chunkStart..<min(chunkStart + layout.capacity, operands.count)
+            try run(machines, chunk: chunk, describe: describe)
         }
     }
 
-    func load<T: FixedWidthInteger>(address: UInt) -> T {
-        switch T.self {
-        case is UInt8.Type:
-            loadb(address: address) as! T
-        case is Int8.Type:
-            Int8(bitPattern: loadb(address: address)) as! T
-        case is UInt16.Type:
-            loadw(address: address) as! T
-        case is Int16.Type:
-            Int16(bitPattern: loadw(address: address)) as! T
-        default:
-            fatalError("Unsupported type: \(T.self)")
+    private mutating func run(
+        _ machines: [OperandLoopMachine],
+        chunk: Range<Int>,
+        describe: (_ operand: Config.ValueType) -> String
+    ) throws {
+        let chunkOperands = operands[chunk]
+        if !chunkOperands.elementsEqual(storedOperands) {
+            for (slot, operand) in chunkOperands.enumerated()
+            where slot >= storedOperands.count || storedOperands[slot] != operand {
+                let address = layout.addressOperands + UInt(slot)
+                for machine in machines {
+                    machine.storeCell(Self.bitPattern(operand), at: address)
+                }
+            }
+            let end = layout.addressOperands + UInt(chunk.count)
+            for machine in machines {
+                machine.storeCell(end, at: layout.addressEnd)
+            }
+            storedOperands = Array(chunkOperands)
+        }
+
+        for machine in machines {
+            try machine.runFromStart(operandCount: chunk.count)
+        }
+
+        let reference = machines[0]
+        for (slot, index) in chunk.enumerated() {
+            let address = layout.addressResults + UInt(slot)
+            let actual = Config.ValueType(truncatingIfNeeded: reference.loadCell(at: address))
+            guard actual == expectedResults[index] else {
+                throw TestFailure(
+                    "Expected \(expectedResults[index]), got \(actual) for \(describe(operands[index]))"
+                )
+            }
+            for machine in machines.dropFirst() {
+                let other = Config.ValueType(truncatingIfNeeded: machine.loadCell(at: address))
+                guard other == actual else {
+                    throw TestFailure(
+                        "\(machine.machineName) computed \(other), but \(reference.machineName) computed \(actual) for \(describe(operands[index]))"
+                    )
+                }
+            }
         }
     }
 }
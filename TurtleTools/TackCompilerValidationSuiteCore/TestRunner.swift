@@ -38,12 +38,12 @@ private func printClearLine(_ message: String, terminator: String = "\n") {
 
 struct TestCase: Sendable {
     let name: String
-    let test: @Sendable (Progress, Int) async throws -> Void
+    let test: @Sendable (Progress, BatchSchedule) async throws -> Void
     let totalIterations: Int
 
     init(
         name: String,
-        test: @escaping @Sendable (Progress, Int) async throws -> Void,
+        test: @escaping @Sendable (Progress, BatchSchedule) async throws -> Void,
         totalIterations: Int
     ) {
         self.name = name
@@ -228,7 +228,13 @@ enum TestRunner {
         return selectedTests
     }
 
-    static func runTests(testFilters: [String], jobCount: Int = 0) async throws {
+    static func runTests(
+        testFilters: [String],
+        jobCount: Int = 0,
+        shard: Shard = .all,
+        checkpoint: ValidationCheckpoint? = nil,
+        backend: ValidationBackend = .vm
+    ) async throws {
         let tests: [TestCase]
 
         do {
@@ -264,6 +270,15 @@ enum TestRunner {
         else {
             print("Running \(tests.count) tests: \(tests.map(\.name).joined(separator: ", "))")
         }
+        if shard != .all {
+            print("Testing shard \(shard) of the values of each test")
+        }
+        if backend == .turtle16 {
+            print("Running each test on Turtle16 and comparing with the Tack VM")
+        }
+        if let url = checkpoint?.url {
+            print("Recording progress in \(url.path)")
+        }
         print()
 
         var passedCount = 0
@@ -328,9 +343,17 @@ enum TestRunner {
                 }
             }
 
+            let schedule = BatchSchedule(
+                jobCount: numJobs,
+                shard: shard,
+                checkpoint: checkpoint,
+                testName: backend.checkpointName(testCase.name),
+                backend: backend
+            )
+
             do {
                 // Run test with specified number of concurrent jobs
-                try await testCase.test(progress, numJobs)
+                try await testCase.test(progress, schedule)
 
                 // Cancel spinner animation now that tests are done
                 spinnerTask.cancel()
@@ -386,7 +409,41 @@ enum TestRunner {
 
         print()
         print("========================================")
-        print("All tests passed! (\(passedCount)/\(tests.count))")
+        if shard != .all {
+            print("Shard \(shard) passed all tests! (\(passedCount)/\(tests.count))")
+            print("Merge the checkpoints of every shard to confirm full coverage")
+        }
+        else {
+            print("All tests passed! (\(passedCount)/\(tests.count))")
+        }
         print("========================================")
     }
+
+    /// Merge the checkpoints written by several shards and print how much of each test has passed
+    static func mergeCheckpoints(
+        _ urls: [URL],
+        into checkpoint: ValidationCheckpoint,
+        testFilters: [String],
+        backend: ValidationBackend = .vm
+    ) throws {
+        for url in urls {
+            try checkpoint.merge(ValidationCheckpoint(url: url))
+        }
+        try checkpoint.save()
+
+        var isComplete = true
+        print("Merged \(urls.count) checkpoint(s)")
+        for testCase in try selectTests(filters: testFilters, from: allTests) {
+            let completedCount = checkpoint.completedCount(
+                test: backend.checkpointName(testCase.name)
+            )
+            let percent = 100.0 * Double(completedCount) / Double(testCase.totalIterations)
+            let status = completedCount == testCase.totalIterations ? "✓ complete" : "incomplete"
+            print("  \(testCase.name): \(String(format: "%.2f", percent))% \(status)")
+            isComplete = isComplete && completedCount == testCase.totalIterations
+        }
+        if !isComplete {
+            throw ExitCode.failure
+        }
+    }
 }
@@ -0,0 +1,197 @@
+//
+//  ValidationBackend.swift
+//  TackCompilerValidationSuiteCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import SnapCore
+import TurtleSimulatorCore
+
+/// The machine on which the exhaustive tests run each Tack program
+enum ValidationBackend: String, CaseIterable, Sendable {
+    /// Run the Tack program on TackVirtualMachine
+    case vm
+
+    /// Lower the Tack program to Turtle16 machine code with TackToTurtle16Compiler and register
+    /// allocation, run it on the fast CPU model, and compare each result with the result from
+    /// TackVirtualMachine
+    case turtle16
+
+    /// Where the operand loop program keeps its operands and results
+    var layout: OperandLoopLayout {
+        switch self {
+        case .vm: .large
+        case .turtle16: .turtle16
+        }
+    }
+
+    /// The name under which a test's progress is recorded in a checkpoint. Progress on one
+    /// backend says nothing about progress on another.
+    func checkpointName(_ testName: String) -> String {
+        switch self {
+        case .vm: testName
+        case .turtle16: "\(testName)@turtle16"
+        }
+    }
+
+    /// The machines which run the program. The first is checked against the expected results,
+    /// and each of the others is checked against the first.
+    func makeMachines(_ program: TackProgram) throws -> [OperandLoopMachine] {
+        let vm = TackVirtualMachine(program)
+        switch self {
+        case .vm:
+            return [vm]
+        case .turtle16:
+            return [vm, try Turtle16OperandLoopMachine(program)]
+        }
+    }
+}
+
+/// Where the program built by `makeOperandLoop` keeps its operands and results
+struct OperandLoopLayout: Equatable {
+    /// The address of operand A, for a binary op
+    let addressA: UInt
+
+    /// The address of a pointer to one past the end of the operand block
+    let addressEnd: UInt
+
+    /// The address of the first operand
+    let addressOperands: UInt
+
+    /// The address of the first result
+    let addressResults: UInt
+
+    /// The maximum number of operands in one block
+    let capacity: Int
+
+    /// A layout which holds every value of a 16-bit type in one block, for TackVirtualMachine
+    static let large = OperandLoopLayout(
+        addressA: 0x1000,
+        addressEnd: 0x1001,
+        addressOperands: 0x10000,
+        addressResults: 0x20000,
+        capacity: 0x10000
+    )
+
+    /// A layout which fits in the 16-bit address space of Turtle16, below the stack
+    static let turtle16 = OperandLoopLayout(
+        addressA: 0x1000,
+        addressEnd: 0x1001,
+        addressOperands: 0x2000,
+        addressResults: 0x6000,
+        capacity: 0x4000
+    )
+}
+
+/// A machine which runs the program built by `makeOperandLoop`
+protocol OperandLoopMachine: AnyObject {
+    /// The name of the machine, for failure messages
+    var machineName: String { get }
+
+    func storeCell(_ value: UInt, at address: UInt)
+    func loadCell(at address: UInt) -> UInt
+
+    /// Run the program from its first instruction until it halts
+    ///
+    /// - Parameter operandCount: The number of operands in the block, which bounds the time
+    ///   the program may take
+    func runFromStart(operandCount: Int) throws
+}
+
+extension TackVirtualMachine: OperandLoopMachine {
+    var machineName: String {
+        "the Tack VM"
+    }
+
+    func storeCell(_ value: UInt, at address: UInt) {
+        store(value: value, address: address)
+    }
+
+    func loadCell(at address: UInt) -> UInt {
+        load(address: address)
+    }
+
+    func runFromStart(operandCount _: Int) throws {
+        pc = 0
+        isHalted = false
+        do {
+            try run()
+        }
+        catch {
+            if let vmError = error as? TackVirtualMachineError,
+               vmError == TackVirtualMachineError.divideByZero {
+                throw TestFailure(
+                    "TackVirtualMachineError.divideByZero indicates a problem with the test"
+                )
+            }
+            else {
+                throw error
+            }
+        }
+    }
+}
+
+/// Runs the program on the Turtle16 fast CPU model
+///
+/// The program is lowered and assembled once per distinct Tack program, which is once per
+/// register combination, and the machine code is shared by every batch. Between runs only the
+/// registers and the operand block are reset. Memory is not cleared.
+final class Turtle16OperandLoopMachine: OperandLoopMachine {
+    /// Caches machine code by the listing of the Tack program
+    private final class MachineCodeCache: @unchecked Sendable {
+        private let lock = NSLock()
+        private var machineCode: [String: [UInt16]] = [:]
+
+        func machineCode(_ program: TackProgram) throws -> [UInt16] {
+            let key = program.instructions.map(\.description).joined(separator: "\n")
+                + "\n" + program.labels.sorted { $0.key < $1.key }.description
+            if let cached = lock.withLock({ machineCode[key] }) {
+                return cached
+            }
+            let instructions = try program.turtle16MachineCode()
+            lock.withLock {
+                machineCode[key] = instructions
+            }
+            return instructions
+        }
+    }
+
+    private static let cache = MachineCodeCache()
+
+    /// The maximum number of cycles the program may take for each operand
+    private static let kCyclesPerOperand: UInt = 10_000
+
+    let computer: TurtleComputer
+
+    var machineName: String {
+        "Turtle16"
+    }
+
+    init(_ program: TackProgram) throws {
+        computer = TurtleComputer(FastCPUModel())
+        computer.instructions = try Turtle16OperandLoopMachine.cache.machineCode(program)
+    }
+
+    func storeCell(_ value: UInt, at address: UInt) {
+        computer.ram[Int(address)] = UInt16(truncatingIfNeeded: value)
+    }
+
+    func loadCell(at address: UInt) -> UInt {
+        UInt(computer.ram[Int(address)])
+    }
+
+    func runFromStart(operandCount: Int) throws {
+        computer.reset()
+        for i in 0..<computer.numberOfRegisters {
+            computer.setRegister(i, 0)
+        }
+        let cycles = UInt(operandCount + 1) * Turtle16OperandLoopMachine.kCyclesPerOperand
+        _ = computer.run(cycles: cycles)
+        guard computer.isHalted else {
+            throw TestFailure("Turtle16 program did not halt within \(cycles) cycles")
+        }
+    }
+}
@@ -0,0 +1,160 @@
+//
+//  ValidationCheckpoint.swift
+//  TackCompilerValidationSuiteCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+/// Records the ranges of values which have passed, per test and per register combination.
+///
+/// An interrupted run resumes from the checkpoint by skipping the ranges which have already
+/// passed. The checkpoints written by several shards of one run may be merged to check that,
+/// together, they cover every value.
+final class ValidationCheckpoint: @unchecked Sendable {
+    /// The contents of the checkpoint file
+    struct Contents: Codable, Equatable {
+        /// Passed ranges, keyed by test name and then by the index of the register combination.
+        /// The ranges for each combination are sorted and do not overlap or touch.
+        var completed: [String: [String: [ClosedRange<Int>]]] = [:]
+    }
+
+    /// The file to which the checkpoint is saved, if any
+    let url: URL?
+
+    /// The minimum time between two saves by `saveIfDue()`, in seconds
+    let saveInterval: TimeInterval
+
+    private let lock = NSLock()
+    private var contents: Contents
+    private var lastSaveTime = Date()
+    private var isDirty = false
+
+    /// Load the checkpoint from the given file, or start an empty one if the file does not exist
+    init(url: URL? = nil, saveInterval: TimeInterval = 5.0) throws {
+        self.url = url
+        self.saveInterval = saveInterval
+        if let url, FileManager.default.fileExists(atPath: url.path) {
+            let data = try Data(contentsOf: url)
+            contents = try JSONDecoder().decode(Contents.self, from: data)
+        }
+        else {
+            contents = Contents()
+        }
+    }
+
+    var snapshot: Contents {
+        lock.withLock { contents }
+    }
+
+    /// The ranges of values which have passed for the given test and register combination
+    func completedRanges(test: String, combination: Int) -> [ClosedRange<Int>] {
+        lock.withLock {
+            contents.completed[test]?[String(combination)] ?? []
+        }
+    }
+
+    /// The number of values which have passed for the given test, over all register combinations
+    func completedCount(test: String) -> Int {
+        lock.withLock {
+            (contents.completed[test] ?? [:]).values.joined().reduce(0) { $0 + $1.count }
+        }
+    }
+
+    /// Record that every value in the range has passed
+    func recordCompleted(test: String, combination: Int, range: ClosedRange<Int>) {
+        lock.withLock {
+            let key = String(combination)
+            let ranges = contents.completed[test]?[key] ?? []
+            contents.completed[test, default: [:]][key] = ValidationCheckpoint.union(ranges, range)
+            isDirty = true
+        }
+    }
+
+    /// Add the ranges which passed in another checkpoint, e.g., one written by another shard
+    func merge(_ other: ValidationCheckpoint) {
+        let otherContents = other.snapshot
+        for (test, combinations) in otherContents.completed {
+            for (key, ranges) in combinations {
+                guard let combination = Int(key) else {
+                    continue
+                }
+                for range in ranges {
+                    recordCompleted(test: test, combination: combination, range: range)
+                }
+            }
+        }
+    }
+
+    /// Write the checkpoint to its file, atomically replacing the previous contents
+    func save() throws {
+        guard let url else {
+            return
+        }
+        let data = try lock.withLock {
+            isDirty = false
+            lastSaveTime = Date()
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+            return try encoder.encode(contents)
+        }
+        try data.write(to: url, options: .atomic)
+    }
+
+    /// Save the checkpoint if it has changed and the save interval has passed since the last save
+    func saveIfDue() throws {
+        let isDue = lock.withLock {
+            isDirty && Date().timeIntervalSince(lastSaveTime) >= saveInterval
+        }
+        if isDue {
+            try save()
+        }
+    }
+
+    /// Add a range to a sorted list of disjoint ranges, coalescing ranges which overlap or touch
+    static func union(_ ranges: [ClosedRange<Int>], _ range: ClosedRange<Int>) -> [ClosedRange<Int>] {
+        var result: [ClosedRange<Int>] = []
+        var merged = range
+        var didInsert = false
+        for existing in ranges {
+            if existing.upperBound + 1 < merged.lowerBound {
+                result.append(existing)
+            }
+            else if merged.upperBound + 1 < existing.lowerBound {
+                if !didInsert {
+                    result.append(merged)
+                    didInsert = true
+                }
+                result.append(existing)
+            }
+            else {
+                merged = min(existing.lowerBound, merged.lowerBound)...max(
+                    existing.upperBound,
+                    merged.upperBound
+                )
+            }
+        }
+        if !didInsert {
+            result.append(merged)
+        }
+        return result
+    }
+
+    /// The parts of `range` which are not covered by a sorted list of disjoint ranges
+    static func subtract(_ ranges: [ClosedRange<Int>], from range: ClosedRange<Int>) -> [ClosedRange<Int>] {
+        var result: [ClosedRange<Int>] = []
+        var lowerBound = range.lowerBound
+        for existing in ranges where existing.overlaps(range) {
+            if existing.lowerBound > lowerBound {
+                result.append(lowerBound...(existing.lowerBound - 1))
+            }
+            lowerBound = max(lowerBound, existing.upperBound + 1)
+        }
+        if lowerBound <= range.upperBound {
+            result.append(lowerBound...range.upperBound)
+        }
+        return result
+    }
+}
@@ -305,6 +305,84 @@ struct BatchOrchestrationTests {
         #expect(allValues.count == 256)
     }
 
+    @Test func runTestInBatches_NeverExceedsJobCount() async throws {
+        final class ConcurrencyRecorder: @unchecked Sendable {
+            private let lock = NSLock()
+            private var inFlight = 0
+            private(set) var maxInFlight = 0
+
+            func testFunction(range: ClosedRange<Int>) {
+                lock.withLock {
+                    inFlight += 1
+                    maxInFlight = max(maxInFlight, inFlight)
+                }
+                Thread.sleep(forTimeInterval: 0.004 * Double(range.count))
+                lock.withLock {
+                    inFlight -= 1
+                }
+            }
+        }
+        let recorder = ConcurrencyRecorder()
+        let progress = Progress(totalUnitCount: 3 * 256)
+
+        let report = try await runTestInBatches(
+            MockConfig.self,
+            registerCombinations: MockConfig.combinations3,
+            testFunction: { _, range in recorder.testFunction(range: range) },
+            progress: progress,
+            jobCount: 3
+        )
+
+        #expect(recorder.maxInFlight <= 3)
+        #expect(report.batchCount > 0)
+        #expect(report.utilization > 0)
+        #expect(progress.completedUnitCount == 3 * 256)
+    }
+
+    // MARK: - Register Combination Tests
+
+    @Test func runTestInBatches_CoversEachRegisterCombination() async throws {
+        final class CombinationRecorder: @unchecked Sendable {
+            private let lock = NSLock()
+            private(set) var testedValues: [Int: [Int]] = [:]
+
+            func testFunction(registers: [Int], range: ClosedRange<Int>) {
+                lock.withLock {
+                    testedValues[registers[0], default: []] += Array(range)
+                }
+                Thread.sleep(forTimeInterval: 0.001 * Double(range.count))
+            }
+        }
+        let recorder = CombinationRecorder()
+        let progress = Progress(totalUnitCount: 3 * 256)
+
+        try await runTestInBatches(
+            MockConfig.self,
+            registerCombinations: MockConfig.combinations3,
+            testFunction: { r, range in recorder.testFunction(registers: r, range: range) },
+            progress: progress,
+            jobCount: 4
+        )
+
+        let expectedValues = Array(Int(Int8.min)...Int(Int8.max))
+        #expect(recorder.testedValues.keys.sorted() == [0, 1, 2])
+        for (_, values) in recorder.testedValues {
+            #expect(values.sorted() == expectedValues)
+        }
+        #expect(progress.completedUnitCount == 3 * 256)
+    }
+
+    @Test func batchCursor_RangesDoNotSpanRegisterCombinations() {
+        var cursor = BatchCursor(registerCombinations: [[0], [1]], valueRange: 0...9)
+        var batches: [([Int], ClosedRange<Int>)] = []
+        while let batch = cursor.next(batchSize: 4) {
+            batches.append((batch.registers, batch.range))
+        }
+        #expect(batches.map { $0.0 } == [[0], [0], [0], [1], [1], [1]])
+        #expect(batches.map { $0.1 } == [0...3, 4...7, 8...9, 0...3, 4...7, 8...9])
+        #expect(cursor.isExhausted)
+    }
+
     // MARK: - Error Handling Tests
 
     @Test func runTestInBatches_PropagatesErrors() async throws {
@@ -0,0 +1,120 @@
+//
+//  TestHelpersTests.swift
+//  TackCompilerValidationSuiteCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import SnapCore
+@testable import TackCompilerValidationSuiteCore
+import Testing
+
+/// Unit tests for the batched operand harness used by the exhaustive tests
+struct TestHelpersTests {
+    typealias SignedByte = Byte8Configuration<Int8>
+    typealias SignedWord = Word16Configuration<Int16>
+
+    @Test(arguments: SignedByte.combinations3)
+    func testBinaryOp_PassesForEveryRegisterCombination(registers: [SignedByte.RegisterType])
+        throws
+    {
+        try testBinaryOp(
+            SignedByte.self,
+            registers: registers,
+            aRange: -128...127,
+            expected: { (a: Int8, b: Int8) in a &+ b },
+            ins: { .addb($0, $1, $2) }
+        )
+    }
+
+    @Test func testBinaryOp_SkipsOperandsWithNoExpectedResult() throws {
+        // Dividing by zero would stop the VM, so the harness must leave those operands out.
+        try testBinaryOp(
+            SignedWord.self,
+            registers: SignedWord.combinations3[0],
+            aRange: -32768...(-32760),
+            expected: { (a: Int16, b: Int16) in
+                b == 0 || (a == Int16.min && b == -1) ? nil : a / b
+            },
+            ins: { .divw($0, $1, $2) }
+        )
+    }
+
+    @Test func testBinaryOp_ReportsTheFailingInputs() throws {
+        do {
+            try testBinaryOp(
+                SignedByte.self,
+                registers: SignedByte.combinations3[0],
+                aRange: 0...3,
+                expected: { (a: Int8, b: Int8) in a == 2 && b == 5 ? 0 : a &+ b },
+                ins: { .addb($0, $1, $2) }
+            )
+            Issue.record("Expected TestFailure to be thrown")
+        }
+        catch let error as TestFailure {
+            #expect(error.message == "Expected 0, got 7 for inputs 2, 5")
+        }
+    }
+
+    @Test func testUnaryOp_PassesOverTheWholeRange() throws {
+        try testUnaryOp(
+            SignedWord.self,
+            registers: SignedWord.combinations2[1],
+            aRange: -32768...32767,
+            expected: { (a: Int16) in 0 &- a },
+            ins: { .negw($0, $1) }
+        )
+    }
+
+    @Test func testUnaryOp_ReportsTheFailingInput() throws {
+        do {
+            try testUnaryOp(
+                SignedWord.self,
+                registers: SignedWord.combinations2[0],
+                aRange: -32768...32767,
+                expected: { (a: Int16) in a == 1000 ? 0 : 0 &- a },
+                ins: { .negw($0, $1) }
+            )
+            Issue.record("Expected TestFailure to be thrown")
+        }
+        catch let error as TestFailure {
+            #expect(error.message == "Expected 0, got -1000 for input 1000")
+        }
+    }
+
+    // MARK: - Turtle16 Backend
+
+    @Test(arguments: SignedByte.combinations3)
+    func testBinaryOp_AgreesWithTheTackVMOnTurtle16(registers: [SignedByte.RegisterType])
+        throws
+    {
+        try testBinaryOp(
+            SignedByte.self,
+            registers: registers,
+            aRange: -2...2,
+            backend: .turtle16,
+            expected: { (a: Int8, b: Int8) in a &- b },
+            ins: { .subb($0, $1, $2) }
+        )
+    }
+
+    @Test func testUnaryOp_RunsInChunksOnTurtle16() throws {
+        // Every value of a 16-bit type does not fit in the Turtle16 address space at once.
+        #expect(ValidationBackend.turtle16.layout.capacity < 65536)
+        try testUnaryOp(
+            SignedWord.self,
+            registers: SignedWord.combinations2[0],
+            aRange: -32768...32767,
+            backend: .turtle16,
+            expected: { (a: Int16) in 0 &- a },
+            ins: { .negw($0, $1) }
+        )
+    }
+
+    @Test func checkpointName_DiffersByBackend() {
+        #expect(ValidationBackend.vm.checkpointName("tackADDB") == "tackADDB")
+        #expect(ValidationBackend.turtle16.checkpointName("tackADDB") != "tackADDB")
+    }
+}
@@ -0,0 +1,175 @@
+//
+//  ValidationCheckpointTests.swift
+//  TackCompilerValidationSuiteCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+import SnapCore
+@testable import TackCompilerValidationSuiteCore
+import Testing
+
+/// Unit tests for checkpoints and shards of exhaustive test runs
+struct ValidationCheckpointTests {
+    struct MockConfig: TackRegisterConfiguration {
+        typealias RegisterType = Int
+        typealias ValueType = Int8
+
+        static let combinations2 = [[0], [1]]
+        static let combinations3 = [[0], [1], [2]]
+
+        static func load(
+            _: RegisterType, _: TackInstruction.RegisterPointer, _: Int
+        ) -> TackInstruction {
+            .nop
+        }
+
+        static func store(
+            _: RegisterType, _: TackInstruction.RegisterPointer, _: Int
+        ) -> TackInstruction {
+            .nop
+        }
+    }
+
+    /// Records the values tested for each register combination
+    final class ValueRecorder: @unchecked Sendable {
+        private let lock = NSLock()
+        private var values: [Int: [Int]] = [:]
+
+        func testFunction(registers: [Int], range: ClosedRange<Int>) {
+            lock.withLock {
+                values[registers[0], default: []] += Array(range)
+            }
+        }
+
+        func testedValues(_ combination: Int) -> [Int] {
+            lock.withLock {
+                (values[combination] ?? []).sorted()
+            }
+        }
+    }
+
+    func makeTemporaryURL() -> URL {
+        FileManager.default.temporaryDirectory
+            .appendingPathComponent("ValidationCheckpointTests-\(UUID().uuidString).json")
+    }
+
+    // MARK: - Range Arithmetic
+
+    @Test func union_CoalescesOverlappingAndAdjacentRanges() {
+        var ranges: [ClosedRange<Int>] = []
+        ranges = ValidationCheckpoint.union(ranges, 10...19)
+        ranges = ValidationCheckpoint.union(ranges, 30...39)
+        ranges = ValidationCheckpoint.union(ranges, 0...4)
+        #expect(ranges == [0...4, 10...19, 30...39])
+        ranges = ValidationCheckpoint.union(ranges, 20...29)
+        #expect(ranges == [0...4, 10...39])
+        ranges = ValidationCheckpoint.union(ranges, 3...12)
+        #expect(ranges == [0...39])
+    }
+
+    @Test func subtract_LeavesTheGaps() {
+        let ranges: [ClosedRange<Int>] = [0...4, 10...19, 30...39]
+        #expect(ValidationCheckpoint.subtract(ranges, from: 0...39) == [5...9, 20...29])
+        #expect(ValidationCheckpoint.subtract(ranges, from: 12...15) == [])
+        #expect(ValidationCheckpoint.subtract([], from: 12...15) == [12...15])
+        #expect(ValidationCheckpoint.subtract(ranges, from: -5...2) == [-5...(-1)])
+    }
+
+    // MARK: - Persistence
+
+    @Test func saveAndLoad_RoundTrips() throws {
+        let url = makeTemporaryURL()
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        let checkpoint = try ValidationCheckpoint(url: url)
+        checkpoint.recordCompleted(test: "tackADDB", combination: 1, range: -128...0)
+        try checkpoint.save()
+
+        let loaded = try ValidationCheckpoint(url: url)
+        #expect(loaded.snapshot == checkpoint.snapshot)
+        #expect(loaded.completedRanges(test: "tackADDB", combination: 1) == [-128...0])
+        #expect(loaded.completedCount(test: "tackADDB") == 129)
+    }
+
+    @Test func merge_CombinesShards() throws {
+        let a = try ValidationCheckpoint()
+        a.recordCompleted(test: "t", combination: 0, range: 0...9)
+        let b = try ValidationCheckpoint()
+        b.recordCompleted(test: "t", combination: 0, range: 10...19)
+        b.recordCompleted(test: "t", combination: 2, range: 0...1)
+        a.merge(b)
+        #expect(a.completedRanges(test: "t", combination: 0) == [0...19])
+        #expect(a.completedRanges(test: "t", combination: 2) == [0...1])
+    }
+
+    // MARK: - Shards
+
+    @Test func shard_ParsesArgument() {
+        #expect(Shard(argument: "0/4") == Shard(index: 0, count: 4))
+        #expect(Shard(argument: "3/4") == Shard(index: 3, count: 4))
+        #expect(Shard(argument: "4/4") == nil)
+        #expect(Shard(argument: "-1/4") == nil)
+        #expect(Shard(argument: "1/0") == nil)
+        #expect(Shard(argument: "1") == nil)
+    }
+
+    @Test func shard_SlicesCoverTheRangeExactlyOnce() {
+        let range = -128...127
+        let slices = (0..<3).compactMap { Shard(index: $0, count: 3).slice(of: range) }
+        #expect(slices.count == 3)
+        #expect(slices.flatMap { Array($0) } == Array(range))
+    }
+
+    // MARK: - Scheduling
+
+    @Test func runTestInBatches_SkipsCompletedRanges() async throws {
+        let checkpoint = try ValidationCheckpoint()
+        checkpoint.recordCompleted(test: "t", combination: 1, range: -128...(-1))
+        let recorder = ValueRecorder()
+        let progress = Progress(totalUnitCount: 3 * 256)
+
+        try await runTestInBatches(
+            MockConfig.self,
+            registerCombinations: MockConfig.combinations3,
+            testFunction: { r, range in recorder.testFunction(registers: r, range: range) },
+            progress: progress,
+            schedule: BatchSchedule(jobCount: 2, checkpoint: checkpoint, testName: "t")
+        )
+
+        #expect(recorder.testedValues(0) == Array(-128...127))
+        #expect(recorder.testedValues(1) == Array(0...127))
+        #expect(recorder.testedValues(2) == Array(-128...127))
+        #expect(progress.totalUnitCount == 3 * 256 - 128)
+        #expect(progress.completedUnitCount == progress.totalUnitCount)
+        #expect(checkpoint.completedCount(test: "t") == 3 * 256)
+    }
+
+    @Test func runTestInBatches_ShardsTogetherCoverEveryValue() async throws {
+        let merged = try ValidationCheckpoint()
+        let recorder = ValueRecorder()
+        for index in 0..<4 {
+            let checkpoint = try ValidationCheckpoint()
+            try await runTestInBatches(
+                MockConfig.self,
+                registerCombinations: MockConfig.combinations3,
+                testFunction: { r, range in recorder.testFunction(registers: r, range: range) },
+                progress: Progress(totalUnitCount: 3 * 256),
+                schedule: BatchSchedule(
+                    jobCount: 2,
+                    shard: Shard(index: index, count: 4),
+                    checkpoint: checkpoint,
+                    testName: "t"
+                )
+            )
+            #expect(checkpoint.completedCount(test: "t") == 3 * 64)
+            merged.merge(checkpoint)
+        }
+        #expect(merged.completedCount(test: "t") == 3 * 256)
+        for combination in 0..<3 {
+            #expect(recorder.testedValues(combination) == Array(-128...127))
+        }
+    }
+}
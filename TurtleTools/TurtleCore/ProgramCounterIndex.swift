@@ -0,0 +1,78 @@
+//
+//  ProgramCounterIndex.swift
+//  TurtleCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+/// Maps a program counter to the nearest entry at or before it in a table of
+/// per-instruction entries, most of which are nil. This is the answer given by
+/// scanning backwards from the program counter to the first non-nil entry.
+///
+/// The table is run-length encoded once, when the index is built. Each run
+/// begins at a non-nil entry which is not the same as the entry of the run
+/// before it, and a lookup is a binary search over the starts of the runs.
+/// The index serves Tack program counters and Turtle16 machine-code program
+/// counters alike.
+public struct ProgramCounterIndex<Value> {
+    private let starts: [Int]
+    private let values: [Value]
+
+    /// The number of runs in the index
+    public var runCount: Int {
+        starts.count
+    }
+
+    public init(_ entries: [Value?], isSame: (Value, Value) -> Bool) {
+        var starts: [Int] = []
+        var values: [Value] = []
+        for (pc, entry) in entries.enumerated() {
+            guard let entry else {
+                continue
+            }
+            if let last = values.last, isSame(last, entry) {
+                continue
+            }
+            starts.append(pc)
+            values.append(entry)
+        }
+        self.starts = starts
+        self.values = values
+    }
+
+    public init() {
+        starts = []
+        values = []
+    }
+
+    /// The entry in effect at the given program counter, or nil if there is
+    /// no non-nil entry at or before it
+    public subscript(pc pc: Int) -> Value? {
+        // Find the first run which begins after the program counter.
+        var low = 0
+        var high = starts.count
+        while low < high {
+            let mid = (low + high) / 2
+            if starts[mid] <= pc {
+                low = mid + 1
+            }
+            else {
+                high = mid
+            }
+        }
+        return low == 0 ? nil : values[low - 1]
+    }
+
+    public subscript(pc pc: UInt) -> Value? {
+        self[pc: Int(clamping: pc)]
+    }
+}
+
+extension ProgramCounterIndex where Value: Equatable {
+    public init(_ entries: [Value?]) {
+        self.init(entries, isSame: { $0 == $1 })
+    }
+}
+
+extension ProgramCounterIndex: Sendable where Value: Sendable {}
@@ -0,0 +1,123 @@
+//
+//  SerialOutputDecoder.swift
+//  TurtleCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+private let kReplacementCharacter: Character = "\u{FFFD}"
+
+/// Decodes the bytes written to a serial output port as UTF-8 text, one byte
+/// at a time. Each byte is examined once. A complete scalar is appended to a
+/// buffer as soon as its last byte arrives. The buffer is passed to `onText`
+/// when it fills up and when flush() is called, e.g., when the program halts.
+/// Malformed input decodes to U+FFFD REPLACEMENT CHARACTER.
+public final class SerialOutputDecoder {
+    public let capacity: Int
+    public var onText: (String) -> Void
+
+    private var buffer = ""
+    private var bufferedByteCount = 0
+    private var sequence: [UInt8] = []
+    private var expectedByteCount = 0
+
+    /// - Parameters:
+    ///   - capacity: Buffered text is passed along once it is at least this
+    ///     many bytes long. A capacity of one passes along every scalar
+    ///     without delay.
+    ///   - onText: Receives the decoded text
+    public init(capacity: Int = 4096, onText: @escaping (String) -> Void) {
+        self.capacity = capacity
+        self.onText = onText
+        buffer.reserveCapacity(capacity)
+        sequence.reserveCapacity(4)
+    }
+
+    public func write(_ byte: UInt8) {
+        if expectedByteCount > 0 {
+            if byte & 0xc0 == 0x80 {
+                sequence.append(byte)
+                if sequence.count == expectedByteCount {
+                    // This rejects overlong forms and surrogates.
+                    let string = String(decoding: sequence, as: UTF8.self)
+                    sequence.removeAll(keepingCapacity: true)
+                    expectedByteCount = 0
+                    append(string)
+                }
+                return
+            }
+
+            // The sequence ended early. Decode this byte on its own.
+            abandonSequence()
+        }
+
+        switch byte {
+        case 0x00...0x7f:
+            append(Character(Unicode.Scalar(byte)))
+        case 0xc2...0xdf:
+            begin(byte, expectedByteCount: 2)
+        case 0xe0...0xef:
+            begin(byte, expectedByteCount: 3)
+        case 0xf0...0xf4:
+            begin(byte, expectedByteCount: 4)
+        default:
+            append(kReplacementCharacter)
+        }
+    }
+
+    public func write(_ bytes: some Sequence<UInt8>) {
+        for byte in bytes {
+            write(byte)
+        }
+    }
+
+    /// Pass along all buffered text. An incomplete sequence at the end of the
+    /// stream decodes to a replacement character.
+    public func flush() {
+        if expectedByteCount > 0 {
+            abandonSequence()
+        }
+        passAlongBufferedText()
+    }
+
+    private func passAlongBufferedText() {
+        guard !buffer.isEmpty else {
+            return
+        }
+        let text = buffer
+        buffer = ""
+        buffer.reserveCapacity(capacity)
+        bufferedByteCount = 0
+        onText(text)
+    }
+
+    private func begin(_ byte: UInt8, expectedByteCount: Int) {
+        sequence.append(byte)
+        self.expectedByteCount = expectedByteCount
+    }
+
+    private func abandonSequence() {
+        sequence.removeAll(keepingCapacity: true)
+        expectedByteCount = 0
+        append(kReplacementCharacter)
+    }
+
+    private func append(_ character: Character) {
+        buffer.append(character)
+        bufferedByteCount += character.utf8.count
+        flushIfFull()
+    }
+
+    private func append(_ string: String) {
+        buffer += string
+        bufferedByteCount += string.utf8.count
+        flushIfFull()
+    }
+
+    private func flushIfFull() {
+        if bufferedByteCount >= capacity {
+            passAlongBufferedText()
+        }
+    }
+}
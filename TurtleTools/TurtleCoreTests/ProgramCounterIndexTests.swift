@@ -0,0 +1,45 @@
+//
+//  ProgramCounterIndexTests.swift
+//  TurtleCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleCore
+import XCTest
+
+final class ProgramCounterIndexTests: XCTestCase {
+    // The answer given by scanning backwards from the program counter
+    func scan(_ entries: [String?], _ pc: Int) -> String? {
+        var i = pc
+        while i >= 0 {
+            if i < entries.count, let entry = entries[i] {
+                return entry
+            }
+            i -= 1
+        }
+        return nil
+    }
+
+    func testEmptyIndexHasNoEntries() {
+        let index = ProgramCounterIndex<String>([])
+        XCTAssertNil(index[pc: 0])
+        XCTAssertNil(index[pc: 100])
+    }
+
+    func testLookupMatchesBackwardScan() {
+        let entries: [String?] = [nil, nil, "a", nil, "a", "b", nil, nil, "c", "a", nil]
+        let index = ProgramCounterIndex(entries)
+        for pc in 0..<(entries.count + 5) {
+            XCTAssertEqual(index[pc: pc], scan(entries, pc), "pc=\(pc)")
+        }
+        XCTAssertEqual(index[pc: UInt.max], "a")
+    }
+
+    func testConsecutiveEqualEntriesShareOneRun() {
+        let entries: [String?] = ["a", "a", nil, "a", "b", "b", nil, "a"]
+        let index = ProgramCounterIndex(entries)
+        XCTAssertEqual(index.runCount, 3)
+    }
+}
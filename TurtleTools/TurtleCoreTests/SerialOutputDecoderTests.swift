@@ -0,0 +1,61 @@
+//
+//  SerialOutputDecoderTests.swift
+//  TurtleCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleCore
+import XCTest
+
+final class SerialOutputDecoderTests: XCTestCase {
+    func testASCIIIsBufferedUntilFlush() {
+        var output: [String] = []
+        let decoder = SerialOutputDecoder { output.append($0) }
+        decoder.write(Array("hello".utf8))
+        XCTAssertEqual(output, [])
+        decoder.flush()
+        XCTAssertEqual(output, ["hello"])
+    }
+
+    func testMultibyteScalarsAreEmittedWhenComplete() {
+        var output = ""
+        let decoder = SerialOutputDecoder(capacity: 1) { output += $0 }
+        let bytes = Array("é€🐢".utf8)
+        decoder.write(bytes[0])
+        XCTAssertEqual(output, "")
+        decoder.write(bytes[1])
+        XCTAssertEqual(output, "é")
+        decoder.write(bytes[2..<5])
+        XCTAssertEqual(output, "é€")
+        decoder.write(bytes[5..<8])
+        XCTAssertEqual(output, "é€")
+        decoder.write(bytes[8])
+        XCTAssertEqual(output, "é€🐢")
+    }
+
+    func testBufferIsPassedAlongWhenFull() {
+        var output: [String] = []
+        let decoder = SerialOutputDecoder(capacity: 4) { output.append($0) }
+        decoder.write(Array("abcdefghij".utf8))
+        XCTAssertEqual(output, ["abcd", "efgh"])
+        decoder.flush()
+        XCTAssertEqual(output, ["abcd", "efgh", "ij"])
+    }
+
+    func testMalformedInputDecodesToReplacementCharacter() {
+        var output = ""
+        let decoder = SerialOutputDecoder { output += $0 }
+        decoder.write([0x61, 0xff, 0x62, 0xc3, 0x63, 0xe2, 0x82])
+        decoder.flush()
+        XCTAssertEqual(output, "a\u{FFFD}b\u{FFFD}c\u{FFFD}")
+    }
+
+    func testFlushWithNothingBufferedDoesNothing() {
+        var count = 0
+        let decoder = SerialOutputDecoder { _ in count += 1 }
+        decoder.flush()
+        XCTAssertEqual(count, 0)
+    }
+}
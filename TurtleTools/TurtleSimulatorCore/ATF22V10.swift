@@ -171,6 +171,51 @@ public struct ATF22V10 {
         return results
     }
 
+    // The outputs of the compiled evaluation path, one bit per OLMC.
+    public struct Outputs: Equatable {
+        // Bit k holds the logic level output by OLMC k.
+        public let values: UInt32
+
+        // Bit k is set when the output of OLMC k is enabled.
+        public let enabled: UInt32
+
+        // Returns the output of the given OLMC, or nil if it is disabled.
+        public subscript(index: Int) -> UInt? {
+            assert(index >= 0 && index < 10)
+            guard (enabled >> index) & 1 != 0 else {
+                return nil
+            }
+            return UInt((values >> index) & 1)
+        }
+    }
+
+    // Evaluate the GAL with product terms compiled to bitmasks when the fuse
+    // list was loaded. This is equivalent to step(inputs:) but avoids
+    // allocating and walking arrays of optionals.
+    // In `pins', bit i holds the logic level of pin i. In `driven', bit i is
+    // set if pin i is actively driven. This corresponds to a non-nil input.
+    public func step(pins: UInt32, driven: UInt32) -> Outputs {
+        _ = stepOneIteration(pins: pins, driven: driven)
+        let results = stepOneIteration(pins: pins, driven: driven)
+        return results
+    }
+
+    private func stepOneIteration(pins: UInt32, driven: UInt32) -> Outputs {
+        var feedbackPins: UInt32 = 0
+        for (k, olmc) in outputLogicMacroCells.enumerated() {
+            feedbackPins |= UInt32(olmc.feedback & 1) << (23 - k)
+        }
+        var values: UInt32 = 0
+        var enabled: UInt32 = 0
+        for (k, olmc) in outputLogicMacroCells.enumerated() {
+            if let result = olmc.step(pins: pins, driven: driven, feedbackPins: feedbackPins) {
+                values |= UInt32(result & 1) << k
+                enabled |= 1 << k
+            }
+        }
+        return Outputs(values: values, enabled: enabled)
+    }
+
     private func stepOneIteration(inputs: [UInt?]) -> [UInt?] {
         let feedback = outputLogicMacroCells.map { olmc -> UInt in olmc.feedback }
         let results = outputLogicMacroCells.map { olmc -> UInt? in
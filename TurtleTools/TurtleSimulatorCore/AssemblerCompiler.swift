@@ -56,6 +56,9 @@ public final class AssemblerCompiler {
     public private(set) var errors: [CompilerError] = []
     public private(set) var instructions: [UInt16] = []
 
+    // The source anchor of the node from which each instruction was assembled
+    public private(set) var sourceAnchorIndex = ProgramCounterIndex<SourceAnchor>()
+
     public init() {}
 
     public func compile(_ topLevel: TopLevel) {
@@ -65,6 +68,7 @@ public final class AssemblerCompiler {
     public func compile(ast: [AbstractSyntaxTreeNode]) {
         codeGenerator.begin()
 
+        var sourceAnchors: [SourceAnchor?] = []
         for node in ast {
             do {
                 try compileNode(node)
@@ -75,7 +79,10 @@ public final class AssemblerCompiler {
             catch {
                 errors.append(errorUnknown(node.sourceAnchor))
             }
+            let count = codeGenerator.instructions.count - sourceAnchors.count
+            sourceAnchors += repeatElement(node.sourceAnchor, count: max(0, count))
         }
+        sourceAnchorIndex = ProgramCounterIndex(sourceAnchors)
 
         do {
             try codeGenerator.end()
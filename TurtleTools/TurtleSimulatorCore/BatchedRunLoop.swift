@@ -0,0 +1,123 @@
+//
+//  BatchedRunLoop.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Dispatch
+import Foundation
+
+// Runs a CPU in batches of clock cycles, reading the clock only between
+// batches. Reading the clock on every cycle is a measurable fraction of the
+// cost of simulating the cycle.
+//
+// The batch size adapts so that one batch takes about `targetLatency` to run.
+// This bounds how far a run may overshoot its deadline, and so bounds how
+// long a caller such as the free-running debugger waits to regain control.
+public final class BatchedRunLoop {
+    public struct Result: Equatable {
+        public enum StopReason: Equatable {
+            case halted, cycleLimit, deadline
+        }
+
+        // The number of clock cycles actually run
+        public let cyclesRun: UInt
+
+        // The reason the run loop returned
+        public let stopReason: StopReason
+
+        public init(cyclesRun: UInt, stopReason: StopReason) {
+            self.cyclesRun = cyclesRun
+            self.stopReason = stopReason
+        }
+    }
+
+    public static let minimumBatchSize: UInt = 64
+    public static let maximumBatchSize: UInt = 1 << 22
+
+    // The target wall-clock duration of one batch, in nanoseconds
+    public var targetLatency: UInt64
+
+    // The number of cycles to run between reads of the clock
+    public private(set) var batchSize: UInt
+
+    public init(targetLatency: UInt64 = 10_000_000, batchSize: UInt = 1024) {
+        self.targetLatency = targetLatency
+        self.batchSize = min(max(batchSize, Self.minimumBatchSize), Self.maximumBatchSize)
+    }
+
+    // Run the CPU until it halts, until it has run the specified number of
+    // cycles, or until the deadline passes, whichever is first. Unless the
+    // limit is zero, the CPU runs for at least one cycle.
+    public func run(
+        _ cpu: some CPU,
+        cycles limit: UInt = UInt.max,
+        until deadline: DispatchTime = .distantFuture
+    ) -> Result {
+        var cyclesRun: UInt = 0
+        while true {
+            let startOfBatch = DispatchTime.now().uptimeNanoseconds
+            let cyclesInThisBatch = min(batchSize, limit - cyclesRun)
+            var i: UInt = 0
+            var isHalted = false
+            while i < cyclesInThisBatch, !isHalted {
+                cpu.step()
+                isHalted = cpu.isHalted
+                i = i + 1
+            }
+            cyclesRun = cyclesRun + i
+
+            let endOfBatch = DispatchTime.now().uptimeNanoseconds
+            calibrate(cycles: i, elapsed: endOfBatch - startOfBatch)
+
+            if isHalted {
+                return Result(cyclesRun: cyclesRun, stopReason: .halted)
+            }
+            if cyclesRun >= limit {
+                return Result(cyclesRun: cyclesRun, stopReason: .cycleLimit)
+            }
+            if endOfBatch >= deadline.uptimeNanoseconds {
+                return Result(cyclesRun: cyclesRun, stopReason: .deadline)
+            }
+        }
+    }
+
+    // Run the CPU until it halts or until the date passes. Returns true if
+    // the CPU halted. This is the behavior of CPU.run(until:)
+    public func run(_ cpu: some CPU, until date: Date) -> Bool {
+        let result = run(cpu, until: BatchedRunLoop.deadline(for: date))
+        return result.stopReason == .halted
+    }
+
+    public static func deadline(for date: Date) -> DispatchTime {
+        guard date != Date.distantFuture else {
+            return .distantFuture
+        }
+        let seconds = date.timeIntervalSinceNow
+        guard seconds > 0 else {
+            return .now()
+        }
+        guard seconds < Double(UInt64.max / 2) / 1e9 else {
+            return .distantFuture
+        }
+        return .now() + .nanoseconds(Int(seconds * 1e9))
+    }
+
+    // Nudge the batch size towards the number of cycles which would run in
+    // the target latency, as measured on this batch. Short batches are
+    // ignored because they say little about the rate of simulation.
+    private func calibrate(cycles: UInt, elapsed: UInt64) {
+        guard cycles >= Self.minimumBatchSize, elapsed > 0 else {
+            return
+        }
+        let ideal = Double(cycles) * Double(targetLatency) / Double(elapsed)
+        let smoothed = (Double(batchSize) + ideal) / 2
+        let clamped = min(
+            max(smoothed, Double(Self.minimumBatchSize)),
+            Double(Self.maximumBatchSize)
+        )
+        batchSize = UInt(clamped)
+    }
+}
@@ -22,6 +22,18 @@ public struct MemoryAddress: Equatable {
     }
 }
 
+// Archives a CPU without its instruction memory. ComputerSnapshot keeps
+// instruction memory in pages of its own so that snapshots can share them.
+public final class CPUStateArchiver: NSKeyedArchiver {}
+
+public extension NSCoder {
+    // False if a CPU should leave its instruction memory out of the archive.
+    // A CPU decoded from such an archive has zero-filled instruction memory.
+    var encodesInstructionMemory: Bool {
+        !(self is CPUStateArchiver)
+    }
+}
+
 // Provides an abstract interface to a model of the Turtle16 CPU.
 public protocol CPU: NSObject, NSSecureCoding {
     var timeStamp: UInt { get }
@@ -0,0 +1,179 @@
+//
+//  ComputerSnapshot.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+// A copy of a memory which is stored as fixed-size, immutable pages.
+//
+// When built from the previous copy of the same memory, each page whose
+// contents have not changed is shared with that copy instead of being copied
+// again. The cost of a copy in memory is then proportional to the number of
+// pages written since the previous copy was made.
+public struct PagedMemory {
+    public static let kPageSize = 256
+
+    final class Page {
+        let words: [UInt16]
+
+        init(_ words: UnsafeBufferPointer<UInt16>) {
+            self.words = Array(words)
+        }
+
+        func matches(_ other: UnsafeBufferPointer<UInt16>) -> Bool {
+            words.withUnsafeBufferPointer { words in
+                words.count == other.count
+                    && memcmp(
+                        words.baseAddress!,
+                        other.baseAddress!,
+                        words.count * MemoryLayout<UInt16>.stride
+                    ) == 0
+            }
+        }
+    }
+
+    let pages: [Page]
+
+    // The number of words of memory
+    public let count: Int
+
+    // The number of pages which are not shared with the previous copy
+    public let newPageCount: Int
+
+    public var pageCount: Int {
+        pages.count
+    }
+
+    public init(_ words: [UInt16], previous: PagedMemory? = nil) {
+        let pageCount = (words.count + PagedMemory.kPageSize - 1) / PagedMemory.kPageSize
+        let previous = previous?.count == words.count ? previous : nil
+        var pages: [Page] = []
+        pages.reserveCapacity(pageCount)
+        var newPageCount = 0
+        words.withUnsafeBufferPointer { words in
+            for index in 0..<pageCount {
+                let page = UnsafeBufferPointer(rebasing: words[PagedMemory.range(index, words.count)])
+                if let previousPage = previous?.pages[index], previousPage.matches(page) {
+                    pages.append(previousPage)
+                }
+                else {
+                    pages.append(Page(page))
+                    newPageCount += 1
+                }
+            }
+        }
+        self.pages = pages
+        self.count = words.count
+        self.newPageCount = newPageCount
+    }
+
+    public subscript(address: Int) -> UInt16 {
+        pages[address / PagedMemory.kPageSize].words[address % PagedMemory.kPageSize]
+    }
+
+    // The contents of memory as one contiguous array
+    public var words: [UInt16] {
+        var result: [UInt16] = []
+        result.reserveCapacity(count)
+        for page in pages {
+            result += page.words
+        }
+        return result
+    }
+
+    // Overwrite each page of the given array which differs from this memory,
+    // and return the number of pages which were copied. If no page differs
+    // then the array is not written to and it continues to share its storage.
+    @discardableResult
+    public func copy(into words: inout [UInt16]) -> Int {
+        guard words.count == count else {
+            words = self.words
+            return pages.count
+        }
+        var copiedPageCount = 0
+        for (index, page) in pages.enumerated() {
+            let range = PagedMemory.range(index, count)
+            let matches = words.withUnsafeBufferPointer {
+                page.matches(UnsafeBufferPointer(rebasing: $0[range]))
+            }
+            if !matches {
+                words.replaceSubrange(range, with: page.words)
+                copiedPageCount += 1
+            }
+        }
+        return copiedPageCount
+    }
+
+    private static func range(_ index: Int, _ count: Int) -> Range<Int> {
+        let lowerBound = index * kPageSize
+        return lowerBound..<min(lowerBound + kPageSize, count)
+    }
+}
+
+// The state of a TurtleComputer at one moment, for undo and for showing the
+// state of a running computer in the UI.
+//
+// RAM and instruction memory are stored as paged memory which shares the
+// pages which are unchanged since the previous snapshot of the same computer.
+// The CPU is archived on its own, without instruction memory, which leaves
+// only the registers, flags, and pipeline state. Restoring a snapshot copies
+// back only those pages which differ from the current contents of memory.
+public final class ComputerSnapshot {
+    public let ram: PagedMemory
+    public let instructions: PagedMemory
+    public let bank: Int
+    let cpuState: Data
+
+    // The computer of which this is a snapshot
+    public private(set) weak var computer: TurtleComputer?
+
+    init(_ computer: TurtleComputer, previous: ComputerSnapshot?) {
+        ram = PagedMemory(computer.ram, previous: previous?.ram)
+        instructions = PagedMemory(computer.instructions, previous: previous?.instructions)
+        bank = computer.bank
+        let archiver = CPUStateArchiver(requiringSecureCoding: false)
+        archiver.encode(computer.cpu, forKey: NSKeyedArchiveRootObjectKey)
+        archiver.finishEncoding()
+        cpuState = archiver.encodedData
+        self.computer = computer
+    }
+
+    // The number of bytes of storage which this snapshot does not share with
+    // the previous snapshot
+    public var byteCount: Int {
+        let pageByteCount = PagedMemory.kPageSize * MemoryLayout<UInt16>.stride
+        return (ram.newPageCount + instructions.newPageCount) * pageByteCount + cpuState.count
+    }
+
+    // Decode a new CPU from the snapshot. Its instruction memory is zero-filled.
+    func makeCPU() -> CPU {
+        var cpu: CPU? = nil
+        do {
+            let unarchiver = try NSKeyedUnarchiver(forReadingFrom: cpuState)
+            unarchiver.requiresSecureCoding = false
+            let cpuClasses = [SchematicLevelCPUModel.self, FastCPUModel.self, LockstepCPUModel.self]
+            cpu = unarchiver.decodeObject(
+                of: cpuClasses,
+                forKey: NSKeyedArchiveRootObjectKey
+            ) as? CPU
+            if let error = unarchiver.error {
+                fatalError(
+                    "Error occured while attempting to restore the CPU from snapshot: \(error.localizedDescription)"
+                )
+            }
+        }
+        catch {
+            fatalError(
+                "Exception occured while attempting to restore the CPU from snapshot: \(error.localizedDescription)"
+            )
+        }
+        guard let cpu else {
+            fatalError("Failed to restore the CPU from snapshot.")
+        }
+        return cpu
+    }
+}
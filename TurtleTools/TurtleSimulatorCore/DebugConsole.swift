@@ -115,7 +115,7 @@ open class DebugConsole: NSObject, NSSecureCoding {
         if let actionName {
             undoManager.setActionName(actionName)
         }
-        let snapshotForUndo = computer.snapshot()
+        let snapshotForUndo = computer.makeSnapshot()
         undoManager.registerUndo(
             withTarget: self,
             handler: { [weak self] in
@@ -125,8 +125,8 @@ open class DebugConsole: NSObject, NSSecureCoding {
         )
     }
 
-    fileprivate func restore(from data: Data) {
-        computer.restore(from: data)
+    fileprivate func restore(from snapshot: ComputerSnapshot) {
+        computer.restore(from: snapshot)
     }
 
     public static func == (lhs: DebugConsole, rhs: DebugConsole) -> Bool {
@@ -62,13 +62,20 @@ public final class DebugConsoleActor {
 
     public init(debugConsole: DebugConsole) {
         self.debugConsole = debugConsole
-        internalLatestSnapshot = try? TurtleComputer.decode(from: debugConsole.computer.snapshot())
+        internalLatestSnapshot = TurtleComputer(debugConsole.computer.makeSnapshot())
 
         NotificationCenter.default
             .publisher(for: .computerStateDidChange)
-            .sink { [weak self] _ in
-                guard let self else { return }
-                let snapshot = try? TurtleComputer.decode(from: debugConsole.computer.snapshot())
+            .sink { [weak self] notification in
+                // The notification carries a snapshot taken when the state
+                // changed. Build the latest computer state from that.
+                guard let self,
+                      let computerSnapshot = notification.object as? ComputerSnapshot,
+                      computerSnapshot.computer === debugConsole.computer
+                else {
+                    return
+                }
+                let snapshot = TurtleComputer(computerSnapshot)
                 snapshotLock.withLock {
                     self.internalLatestSnapshot = snapshot
                 }
@@ -33,7 +33,7 @@ public final class DebugConsoleCommandLineInterpreter {
     }
 
     private func postComputerStateDidChangeNotification() {
-        let snapshot = computer.snapshot()
+        let snapshot = computer.makeSnapshot()
         NotificationCenter.default.post(
             name: .computerStateDidChange,
             object: snapshot
@@ -136,12 +136,23 @@ public final class DebugConsoleCommandLineInterpreter {
         }
     }
 
+    // The number of clock cycles run by the most recent `run' command
+    public private(set) var lastRunCycleCount: UInt = 0
+
     private func run() {
-        let timeout: TimeInterval = 1.0
+        // The run loop only reads the clock between batches of cycles, so
+        // the pause flag can be checked often without slowing the simulation.
+        let timeout: DispatchTimeInterval = .milliseconds(50)
 
         isFreeRunning = true
+        lastRunCycleCount = 0
 
-        while !computer.run(until: Date.now + timeout) {
+        while true {
+            let result = computer.run(until: .now() + timeout)
+            lastRunCycleCount += result.cyclesRun
+            if result.stopReason == .halted {
+                break
+            }
             if testAndSetPause() {
                 isFreeRunning = false
                 break
@@ -0,0 +1,644 @@
+//
+//  FastCPUModel.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+// Models the Turtle16 CPU for speed rather than for hardware validation.
+//
+// SchematicLevelCPUModel intentionally mirrors the schematics, stage by stage
+// and chip by chip. This model computes the same thing directly: the pipeline
+// latches are flat stored properties, the register file is a flat array, the
+// two IDT7381 ALUs are reduced to the handful of operations which the control
+// words can actually select, and the hazard control unit is reduced to the
+// boolean conditions it detects.
+//
+// The two models must agree on cycle counts and on architectural state after
+// every clock cycle. Use LockstepCPUModel to check this on a given program.
+public class FastCPUModel: NSObject, CPU {
+    public static var supportsSecureCoding = true
+    public static let kNumberOfResetCycles: UInt = SchematicLevelCPUModel.kNumberOfResetCycles
+
+    public var timeStamp: UInt = 0
+    public var resetCounter: UInt = kNumberOfResetCycles
+
+    public var isResetting: Bool {
+        resetCounter > 0
+    }
+
+    public var isHalted: Bool {
+        ex_hlt == 0
+    }
+
+    public var isStalling: Bool {
+        (id_stall & 1) != 0
+    }
+
+    public var pc: UInt16 = 0
+    var prevPC: UInt16 = 0
+
+    public var instructions: [UInt16] = .init(repeating: 0, count: 65535) {
+        didSet {
+            predecodeCache.instructions = instructions
+        }
+    }
+
+    public var decoder: InstructionDecoder {
+        didSet {
+            predecodeCache.decoder = decoder
+        }
+    }
+
+    // Instructions are decoded once, on the first fetch from a given address.
+    public let predecodeCache: PredecodeCache
+
+    // Reads the clock once per batch of cycles in run(until:)
+    let runLoop = BatchedRunLoop()
+
+    public var n: UInt = 0
+    public var c: UInt = 0
+    public var z: UInt = 0
+    public var v: UInt = 0
+
+    public let numberOfRegisters = 8
+    var registerFile: [UInt16] = .init(repeating: 0, count: 8)
+
+    public func setRegister(_ idx: Int, _ val: UInt16) {
+        assert(idx >= 0 && idx < numberOfRegisters)
+        registerFile[idx] = val
+    }
+
+    public func getRegister(_ idx: Int) -> UInt16 {
+        assert(idx >= 0 && idx < numberOfRegisters)
+        return registerFile[idx]
+    }
+
+    public var load: (MemoryAddress) -> UInt16 = { (_: MemoryAddress) in
+        0 // do nothing
+    }
+
+    public var store: (UInt16, MemoryAddress) -> Void = { (_: UInt16, _: MemoryAddress) in
+        // do nothing
+    }
+
+    // IF latch and IF stage state
+    // On the hardware, the IF stage's registers always hold the same values
+    // as its output latch so these do double duty.
+    var if_decoded: PredecodeCache.Entry
+    var if_pc: UInt16 = 0
+    var if_associatedPC: UInt16?
+    var if_aluF: UInt16 = 0 // The F register of the IF stage's IDT7381
+
+    // ID latch
+    var id_stall: UInt = 0
+    var id_ctl_EX: UInt = ID.nopControlWord
+    var id_a: UInt16 = 0
+    var id_b: UInt16 = 0
+    var id_ins: UInt = 0
+    var id_associatedPC: UInt16?
+
+    // EX latch
+    var ex_n: UInt = 0
+    var ex_c: UInt = 0
+    var ex_z: UInt = 0
+    var ex_v: UInt = 0
+    var ex_j: UInt = 1
+    var ex_jabs: UInt = 1
+    var ex_y: UInt16 = 0
+    var ex_hlt: UInt = 1
+    var ex_storeOp: UInt16 = 0
+    var ex_ctl: UInt = ID.nopControlWord
+    var ex_selC: UInt = 0
+    var ex_associatedPC: UInt16?
+
+    // MEM latch
+    var mem_y: UInt16 = 0
+    var mem_storeOp: UInt16 = 0
+    var mem_selC: UInt = 0
+    var mem_ctl: UInt = ID.nopControlWord
+    var mem_associatedPC: UInt16?
+
+    // WB latch
+    var wb_c: UInt16 = 0
+    var wb_wrl: UInt = 1
+    var wb_wrh: UInt = 1
+    var wb_wben: UInt = 1
+    var wb_associatedPC: UInt16?
+
+    public let numberOfPipelineStages = 5
+
+    public func getPipelineStageInfo(_ idx: Int) -> PipelineStageInfo {
+        assert(idx >= 0 && idx < numberOfPipelineStages)
+        return switch idx {
+        case 0:
+            PipelineStageInfo(
+                name: "IF",
+                pc: if_associatedPC,
+                status: "\(IF_Output(ins: if_decoded.ins, pc: if_pc))"
+            )
+        case 1:
+            PipelineStageInfo(
+                name: "ID",
+                pc: id_associatedPC,
+                status: "\(ID_Output(stall: id_stall, ctl_EX: id_ctl_EX, a: id_a, b: id_b, ins: id_ins))"
+            )
+        case 2:
+            PipelineStageInfo(
+                name: "EX",
+                pc: ex_associatedPC,
+                status: "\(EX_Output(n: ex_n, c: ex_c, z: ex_z, v: ex_v, j: ex_j, jabs: ex_jabs, y: ex_y, hlt: ex_hlt, storeOp: ex_storeOp, ctl: ex_ctl, selC: ex_selC))"
+            )
+        case 3:
+            PipelineStageInfo(
+                name: "MEM",
+                pc: mem_associatedPC,
+                status: "\(MEM_Output(y: mem_y, storeOp: mem_storeOp, selC: mem_selC, ctl: mem_ctl))"
+            )
+        case 4:
+            PipelineStageInfo(
+                name: "WB",
+                pc: wb_associatedPC,
+                status: "\(WB_Output(c: wb_c, wrl: wb_wrl, wrh: wb_wrh, wben: wb_wben))"
+            )
+        default:
+            fatalError("unreachable")
+        }
+    }
+
+    public override init() {
+        let rom = OpcodeDecoderROM()
+        rom.opcodeDecodeROM = DecoderGenerator().generate()
+        decoder = rom
+        let cache = PredecodeCache(decoder: rom)
+        predecodeCache = cache
+        if_decoded = cache.nop
+        super.init()
+        predecodeCache.instructions = instructions
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let timeStamp = coder.decodeObject(forKey: "timeStamp") as? UInt,
+              let resetCounter = coder.decodeObject(forKey: "resetCounter") as? UInt,
+              let pc = coder.decodeObject(forKey: "pc") as? UInt16,
+              let prevPC = coder.decodeObject(forKey: "prevPC") as? UInt16,
+              let decoder = coder.decodeObject(forKey: "decoder") as? InstructionDecoder,
+              let n = coder.decodeObject(forKey: "n") as? UInt,
+              let c = coder.decodeObject(forKey: "c") as? UInt,
+              let v = coder.decodeObject(forKey: "v") as? UInt,
+              let z = coder.decodeObject(forKey: "z") as? UInt,
+              let registerFile = coder.decodeObject(forKey: "registerFile") as? [UInt16],
+              let if_aluF = coder.decodeObject(forKey: "if_aluF") as? UInt16,
+              let latches = coder.decodeObject(
+                  of: PipelineLatchSnapshot.self,
+                  forKey: "latches"
+              ),
+              let wb_associatedPC = coder.decodeObject(forKey: "wb_associatedPC") as? UInt16?
+        else {
+            return nil
+        }
+        let instructions = coder.decodeObject(forKey: "instructions") as? [UInt16]
+            ?? [UInt16](repeating: 0, count: 65535)
+        self.timeStamp = timeStamp
+        self.resetCounter = resetCounter
+        self.pc = pc
+        self.prevPC = prevPC
+        self.instructions = instructions
+        self.decoder = decoder
+        let cache = PredecodeCache(instructions: instructions, decoder: decoder)
+        predecodeCache = cache
+        if_decoded = cache.predecode(latches.outputIF.ins)
+        self.n = n
+        self.c = c
+        self.z = z
+        self.v = v
+        self.registerFile = registerFile
+        self.if_aluF = if_aluF
+        self.wb_associatedPC = wb_associatedPC
+        super.init()
+        restoreLatches(latches)
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(timeStamp, forKey: "timeStamp")
+        coder.encode(resetCounter, forKey: "resetCounter")
+        coder.encode(pc, forKey: "pc")
+        coder.encode(prevPC, forKey: "prevPC")
+        if coder.encodesInstructionMemory {
+            coder.encode(instructions, forKey: "instructions")
+        }
+        coder.encode(decoder, forKey: "decoder")
+        coder.encode(n, forKey: "n")
+        coder.encode(z, forKey: "z")
+        coder.encode(c, forKey: "c")
+        coder.encode(v, forKey: "v")
+        coder.encode(registerFile, forKey: "registerFile")
+        coder.encode(if_aluF, forKey: "if_aluF")
+        coder.encode(latches, forKey: "latches")
+        coder.encode(wb_associatedPC, forKey: "wb_associatedPC")
+    }
+
+    // The contents of the pipeline latches in the same form used by
+    // SchematicLevelCPUModel.
+    public var latches: PipelineLatchSnapshot {
+        PipelineLatchSnapshot(
+            outputIF: IF_Output(ins: if_decoded.ins, pc: if_pc, associatedPC: if_associatedPC),
+            outputID: ID_Output(
+                stall: id_stall,
+                ctl_EX: id_ctl_EX,
+                a: id_a,
+                b: id_b,
+                ins: id_ins,
+                associatedPC: id_associatedPC
+            ),
+            outputEX: EX_Output(
+                n: ex_n,
+                c: ex_c,
+                z: ex_z,
+                v: ex_v,
+                j: ex_j,
+                jabs: ex_jabs,
+                y: ex_y,
+                hlt: ex_hlt,
+                storeOp: ex_storeOp,
+                ctl: ex_ctl,
+                selC: ex_selC,
+                associatedPC: ex_associatedPC
+            ),
+            outputMEM: MEM_Output(
+                y: mem_y,
+                storeOp: mem_storeOp,
+                selC: mem_selC,
+                ctl: mem_ctl,
+                associatedPC: mem_associatedPC
+            ),
+            outputWB: WB_Output(c: wb_c, wrl: wb_wrl, wrh: wb_wrh, wben: wb_wben)
+        )
+    }
+
+    private func restoreLatches(_ latches: PipelineLatchSnapshot) {
+        if_decoded = predecodeCache.predecode(latches.outputIF.ins)
+        if_pc = latches.outputIF.pc
+        if_associatedPC = latches.outputIF.associatedPC
+        id_stall = latches.outputID.stall
+        id_ctl_EX = latches.outputID.ctl_EX
+        id_a = latches.outputID.a
+        id_b = latches.outputID.b
+        id_ins = latches.outputID.ins
+        id_associatedPC = latches.outputID.associatedPC
+        ex_n = latches.outputEX.n
+        ex_c = latches.outputEX.c
+        ex_z = latches.outputEX.z
+        ex_v = latches.outputEX.v
+        ex_j = latches.outputEX.j
+        ex_jabs = latches.outputEX.jabs
+        ex_y = latches.outputEX.y
+        ex_hlt = latches.outputEX.hlt
+        ex_storeOp = latches.outputEX.storeOp
+        ex_ctl = latches.outputEX.ctl
+        ex_selC = latches.outputEX.selC
+        ex_associatedPC = latches.outputEX.associatedPC
+        mem_y = latches.outputMEM.y
+        mem_storeOp = latches.outputMEM.storeOp
+        mem_selC = latches.outputMEM.selC
+        mem_ctl = latches.outputMEM.ctl
+        mem_associatedPC = latches.outputMEM.associatedPC
+        wb_c = latches.outputWB.c
+        wb_wrl = latches.outputWB.wrl
+        wb_wrh = latches.outputWB.wrh
+        wb_wben = latches.outputWB.wben
+    }
+
+    public static func decode(from data: Data) throws -> FastCPUModel {
+        var decodedObject: FastCPUModel? = nil
+        let unarchiver = try NSKeyedUnarchiver(forReadingFrom: data)
+        unarchiver.requiresSecureCoding = false
+        decodedObject = unarchiver.decodeObject(of: self, forKey: NSKeyedArchiveRootObjectKey)
+        if let error = unarchiver.error {
+            fatalError(
+                "Error occured while attempting to decode \(self) from data: \(error.localizedDescription)"
+            )
+        }
+        guard let decodedObject else {
+            fatalError("Failed to decode \(self) from data.")
+        }
+        return decodedObject
+    }
+
+    public static func == (lhs: FastCPUModel, rhs: FastCPUModel) -> Bool {
+        lhs.isEqual(rhs)
+    }
+
+    public override func isEqual(_ rhs: Any?) -> Bool {
+        guard rhs != nil else {
+            return false
+        }
+        guard let rhs = rhs as? FastCPUModel else {
+            return false
+        }
+        guard timeStamp == rhs.timeStamp,
+              resetCounter == rhs.resetCounter,
+              pc == rhs.pc,
+              prevPC == rhs.prevPC,
+              instructions == rhs.instructions,
+              decoder == rhs.decoder,
+              n == rhs.n,
+              c == rhs.c,
+              v == rhs.v,
+              z == rhs.z,
+              registerFile == rhs.registerFile,
+              if_aluF == rhs.if_aluF,
+              latches == rhs.latches,
+              wb_associatedPC == rhs.wb_associatedPC
+        else {
+            return false
+        }
+        return true
+    }
+
+    public override var hash: Int {
+        var hasher = Hasher()
+        hasher.combine(timeStamp)
+        hasher.combine(resetCounter)
+        hasher.combine(pc)
+        hasher.combine(prevPC)
+        hasher.combine(instructions)
+        hasher.combine(decoder.hash)
+        hasher.combine(n)
+        hasher.combine(z)
+        hasher.combine(c)
+        hasher.combine(v)
+        hasher.combine(registerFile)
+        hasher.combine(if_aluF)
+        hasher.combine(latches)
+        hasher.combine(wb_associatedPC)
+        return hasher.finalize()
+    }
+
+    public func reset() {
+        resetCounter = FastCPUModel.kNumberOfResetCycles
+        while isResetting {
+            step()
+        }
+        timeStamp = 0
+    }
+
+    public func run(until date: Date = Date.distantFuture) -> Bool {
+        runLoop.run(self, until: date)
+    }
+
+    public func run() {
+        repeat {
+            step()
+        } while !isHalted
+    }
+
+    public func step() {
+        let rst: UInt = isResetting ? 0 : 1
+
+        // WB
+        let wbSrc = (mem_ctl >> 17) & 1
+        wb_c = (wbSrc == 0) ? mem_y : mem_storeOp
+        wb_wrl = (mem_ctl >> 18) & 1
+        wb_wrh = (mem_ctl >> 19) & 1
+        wb_wben = (mem_ctl >> 20) & 1
+        wb_associatedPC = mem_associatedPC
+        if wb_wben == 0 {
+            let selC_WB = Int(mem_selC)
+            let old = registerFile[selC_WB]
+            let upper = (wb_wrh == 0) ? (wb_c & 0xff00) : (old & 0xff00)
+            let lower = (wb_wrl == 0) ? (wb_c & 0x00ff) : (old & 0x00ff)
+            registerFile[selC_WB] = upper | lower
+        }
+
+        // MEM
+        var storeOp_MEM: UInt16 = 0
+        let isLoad = ((ex_ctl >> 14) & 1) == 0
+        let isStore = ((ex_ctl >> 15) & 1) == 0
+        let isAssertingStoreOp = ((ex_ctl >> 16) & 1) == 0
+        if isAssertingStoreOp {
+            storeOp_MEM = ex_storeOp
+        }
+        if isStore {
+            store(storeOp_MEM, MemoryAddress(ex_y))
+        }
+        if isLoad {
+            assert(!isAssertingStoreOp)
+            storeOp_MEM = load(MemoryAddress(ex_y))
+        }
+        mem_y = ex_y
+        mem_storeOp = storeOp_MEM
+        mem_selC = ex_selC
+        mem_ctl = ex_ctl
+        mem_associatedPC = ex_associatedPC
+
+        // EX
+        let ctl_EX = id_ctl_EX
+        let ins_EX = id_ins
+        executeInstruction(ctl: ctl_EX, a: id_a, b: id_b, ins: ins_EX, pc: if_pc)
+        ex_associatedPC = id_associatedPC
+
+        // ID
+        decodeInstruction(ins_EX: ins_EX, ctl_EX: ctl_EX)
+
+        // Only update flags if the appropriate bit in the control word is set.
+        if ((ctl_EX >> DecoderGenerator.FI) & 1) == 0 {
+            n = ex_n
+            c = ex_c
+            z = ex_z
+            v = ex_v
+        }
+
+        // IF
+        fetchInstruction(rst: rst)
+        prevPC = pc
+        pc = if_pc
+
+        if resetCounter > 0 {
+            resetCounter = resetCounter - 1
+        }
+
+        timeStamp = timeStamp + 1
+    }
+
+    @inline(__always)
+    private func executeInstruction(ctl: UInt, a: UInt16, b: UInt16, ins: UInt, pc: UInt16) {
+        let c0 = UInt16((ctl >> 6) & 1)
+        let aluOp = (ctl >> 7) & 0b111
+        let rs = (ctl >> 10) & 0b11
+
+        let right: UInt16 =
+            switch (ctl >> 3) & 3 {
+            case 0b00: b
+            case 0b01: signExtend5(UInt16(ins & 31))
+            case 0b10: signExtend5(UInt16(((ins >> 6) & 0b11100) | (ins & 0b11)))
+            default: signExtend11(UInt16(ins & 2047))
+            }
+
+        // The R and S multiplexers of the IDT7381. The EX stage ALU's F
+        // register always reads as zero here. See the EX class.
+        let r: UInt16 = (rs == 0b10) ? 0 : a
+        let s: UInt16 = ((rs & 0b10) != 0) ? right : 0
+
+        var y: UInt16
+        var carry: UInt = 0
+        var ovf: UInt = 0
+        switch aluOp {
+        case 0b000:
+            y = 0
+        case 0b001:
+            (y, carry, ovf) = add(~r, s, c0)
+        case 0b010:
+            (y, carry, ovf) = add(r, ~s, c0)
+        case 0b011:
+            (y, carry, ovf) = add(r, s, c0)
+        case 0b100:
+            y = r ^ s
+        case 0b101:
+            y = r | s
+        case 0b110:
+            y = r & s
+        default:
+            y = 0xffff
+        }
+
+        ex_n = (UInt(y) >> 15) & 1
+        ex_c = carry
+        ex_z = (y == 0) ? 1 : 0
+        ex_v = ovf
+        ex_j = (ctl >> 12) & 1
+        ex_jabs = (ctl >> 13) & 1
+        ex_y = y
+        ex_hlt = ctl & 1
+        ex_storeOp =
+            switch (ctl >> 1) & 3 {
+            case 0b00: b
+            case 0b01: pc
+            case 0b10: signExtend8(UInt16(ins & 0xff))
+            default: UInt16(ins & 0xff) << 8
+            }
+        ex_ctl = ctl
+        ex_selC = (ins >> 8) & 0b111
+    }
+
+    @inline(__always)
+    private func add(_ r: UInt16, _ s: UInt16, _ c0: UInt16) -> (UInt16, UInt, UInt) {
+        let wide = UInt32(r) + UInt32(s) + UInt32(c0)
+        let y = UInt16(truncatingIfNeeded: wide)
+        let carry: UInt = (wide > 0xffff) ? 1 : 0
+
+        // If the two operands have the same sign and the sum has a different
+        // sign then overflow has occurred. Otherwise, there is no overflow.
+        let ovf: UInt = (((r ^ s) & 0x8000) == 0 && ((r ^ y) & 0x8000) != 0) ? 1 : 0
+        return (y, carry, ovf)
+    }
+
+    @inline(__always)
+    private func signExtend5(_ val: UInt16) -> UInt16 {
+        (val & (1 << 4)) != 0 ? (val | 0b11111111_11100000) : val
+    }
+
+    @inline(__always)
+    private func signExtend8(_ val: UInt16) -> UInt16 {
+        (val & (1 << 7)) != 0 ? (val | 0b11111111_00000000) : val
+    }
+
+    @inline(__always)
+    private func signExtend11(_ val: UInt16) -> UInt16 {
+        (val & (1 << 10)) != 0 ? (val | 0b11111000_00000000) : val
+    }
+
+    @inline(__always)
+    private func decodeInstruction(ins_EX: UInt, ctl_EX: UInt) {
+        let decoded = if_decoded
+        let ctl_ID = predecodeCache.controlWord(decoded, n: n, c: c, z: z, v: v)
+
+        // The hazard control unit compares the register selects of the
+        // instruction in ID with the destination registers of the
+        // instructions in EX and MEM.
+        let selA = UInt(decoded.selA)
+        let selB = UInt(decoded.selB)
+        let selC_EX = (ins_EX >> 8) & 0b111
+        let selC_MEM = mem_selC
+
+        let isWritingBack_EX = ((ctl_EX >> 20) & 1) == 0
+        let isWritingBackStoreOp_EX = ((ctl_EX >> 17) & 1) != 0
+        let isWritingBack_MEM = ((mem_ctl >> 20) & 1) == 0
+        let isWritingBackStoreOp_MEM = ((mem_ctl >> 17) & 1) != 0
+        let isLeftOperandUsed = ((ctl_ID >> 21) & 1) == 0
+        let isRightOperandUsed = ((ctl_ID >> 22) & 1) == 0
+
+        // ALU results can be forwarded from EX or MEM. EX takes priority.
+        let fwd_ex_to_a = isWritingBack_EX && !isWritingBackStoreOp_EX && selA == selC_EX
+        let fwd_mem_to_a = !fwd_ex_to_a && isWritingBack_MEM && !isWritingBackStoreOp_MEM
+            && selA == selC_MEM
+        let fwd_ex_to_b = isWritingBack_EX && !isWritingBackStoreOp_EX && selB == selC_EX
+        let fwd_mem_to_b = !fwd_ex_to_b && isWritingBack_MEM && !isWritingBackStoreOp_MEM
+            && selB == selC_MEM
+
+        // The store operand cannot be forwarded, so the pipeline must stall.
+        let storeOpHazard_A = isLeftOperandUsed && (
+            (isWritingBack_EX && isWritingBackStoreOp_EX && selA == selC_EX)
+                || (isWritingBack_MEM && isWritingBackStoreOp_MEM && selA == selC_MEM)
+        )
+        let storeOpHazard_B = isRightOperandUsed && (
+            (isWritingBack_EX && isWritingBackStoreOp_EX && selB == selC_EX)
+                || (isWritingBack_MEM && isWritingBackStoreOp_MEM && selB == selC_MEM)
+        )
+
+        // Instructions which depend on the ALU flags are the last eight
+        // opcodes. They must wait for an instruction in EX which sets flags.
+        let isFlagsHazard = (decoded.opcode >> 3) == 0b11 && ((ctl_EX >> 5) & 1) == 0
+
+        let stall = isFlagsHazard || storeOpHazard_A || storeOpHazard_B
+        let flush = stall || ((ctl_EX >> 12) & 1) == 0
+
+        id_stall = stall ? 1 : 0
+        id_ctl_EX = flush ? ID.nopControlWord : (ctl_ID & UInt((1 << 21) - 1))
+        id_a = fwd_ex_to_a ? ex_y : (fwd_mem_to_a ? mem_y : registerFile[Int(selA)])
+        id_b = fwd_ex_to_b ? ex_y : (fwd_mem_to_b ? mem_y : registerFile[Int(selB)])
+        id_ins = UInt(decoded.imm)
+        id_associatedPC = flush ? nil : if_associatedPC
+    }
+
+    @inline(__always)
+    private func fetchInstruction(rst: UInt) {
+        let stall = id_stall
+        let j = ex_j
+        let jabs = ex_jabs
+        let y = ex_y
+
+        // The IF stage's IDT7381 computes the next program counter.
+        // While in reset, the ALU outputs zero. Otherwise, it adds.
+        let aluF: UInt16
+        if rst == 0 {
+            aluF = 0
+        }
+        else {
+            switch (j, jabs) {
+            case (0, 0): aluF = y // absolute jump
+            case (0, _): aluF = if_pc &+ y // relative jump
+            case (_, 0): aluF = if_pc &+ if_aluF &+ 1
+            default: aluF = if_pc &+ 1
+            }
+        }
+
+        let prevPC_IF = if_pc
+
+        if j == 0 {
+            if_associatedPC = nil
+        }
+        else if stall == 0 {
+            if_associatedPC = prevPC_IF
+        }
+
+        if stall == 0 {
+            if_aluF = aluF
+            if_pc = aluF
+            if_decoded = (j == 0) ? predecodeCache.nop : predecodeCache.entry(at: prevPC_IF)
+        }
+    }
+}
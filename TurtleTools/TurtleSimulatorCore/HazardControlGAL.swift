@@ -17,6 +17,9 @@ public final class HazardControlGAL: HazardControl {
     public let stageOneGAL: ATF22V10
     public let stageTwoGAL: ATF22V10
 
+    // Pins 0 through 13 are driven by the CPU. The I/O pins are all outputs.
+    static let drivenPins: UInt32 = 0b00111111_11111111
+
     public override init() {
         stageOneGAL = HazardControlGAL.makeGAL("HazardControl1")
         stageTwoGAL = HazardControlGAL.makeGAL("HazardControl2")
@@ -36,32 +39,18 @@ public final class HazardControlGAL: HazardControl {
     public override func generatedHazardControlSignalsStageOne(
         input: StageOneInput
     ) -> StageOneOutput {
-        let outputs = stageOneGAL.step(inputs: [
-            0,
-            0,
-            input.writeBackSrc_EX,
-            input.wben_EX,
-            input.writeBackSrc_MEM,
-            input.wben_MEM,
-            input.sel_a_matches_sel_c_ex,
-            input.sel_b_matches_sel_c_ex,
-            input.sel_a_matches_sel_c_mem,
-            input.sel_b_matches_sel_c_mem,
-            input.left_operand_is_unused,
-            input.right_operand_is_unused,
-            0,
-            0,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil
-        ])
+        var pins: UInt32 = 0
+        pins |= UInt32(input.writeBackSrc_EX & 1) << 2
+        pins |= UInt32(input.wben_EX & 1) << 3
+        pins |= UInt32(input.writeBackSrc_MEM & 1) << 4
+        pins |= UInt32(input.wben_MEM & 1) << 5
+        pins |= UInt32(input.sel_a_matches_sel_c_ex & 1) << 6
+        pins |= UInt32(input.sel_b_matches_sel_c_ex & 1) << 7
+        pins |= UInt32(input.sel_a_matches_sel_c_mem & 1) << 8
+        pins |= UInt32(input.sel_b_matches_sel_c_mem & 1) << 9
+        pins |= UInt32(input.left_operand_is_unused & 1) << 10
+        pins |= UInt32(input.right_operand_is_unused & 1) << 11
+        let outputs = stageOneGAL.step(pins: pins, driven: HazardControlGAL.drivenPins)
 
         let fwd_mem_to_a: UInt = outputs[0]!
         let fwd_ex_to_a: UInt = outputs[1]!
@@ -96,32 +85,16 @@ public final class HazardControlGAL: HazardControl {
     public override func generatedHazardControlSignalsStageTwo(
         input: StageTwoInput
     ) -> StageTwoOutput {
-        let outputs = stageTwoGAL.step(inputs: [
-            0,
-            0,
-            input.opcode3,
-            input.opcode4,
-            input.ctl_EX5,
-            input.j,
-            input.need_to_forward_storeOp_EX_to_a,
-            input.need_to_forward_storeOp_MEM_to_a,
-            input.need_to_forward_storeOp_EX_to_b,
-            input.need_to_forward_storeOp_MEM_to_b,
-            0,
-            0,
-            0,
-            0,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil,
-            nil
-        ])
+        var pins: UInt32 = 0
+        pins |= UInt32(input.opcode3 & 1) << 2
+        pins |= UInt32(input.opcode4 & 1) << 3
+        pins |= UInt32(input.ctl_EX5 & 1) << 4
+        pins |= UInt32(input.j & 1) << 5
+        pins |= UInt32(input.need_to_forward_storeOp_EX_to_a & 1) << 6
+        pins |= UInt32(input.need_to_forward_storeOp_MEM_to_a & 1) << 7
+        pins |= UInt32(input.need_to_forward_storeOp_EX_to_b & 1) << 8
+        pins |= UInt32(input.need_to_forward_storeOp_MEM_to_b & 1) << 9
+        let outputs = stageTwoGAL.step(pins: pins, driven: HazardControlGAL.drivenPins)
 
         let stall: UInt = outputs[0]!
         let flush: UInt = outputs[1]!
@@ -0,0 +1,323 @@
+//
+//  LockstepCPUModel.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+// Runs FastCPUModel in lockstep with SchematicLevelCPUModel and reports the
+// first clock cycle on which the two disagree.
+//
+// The schematic-level model is the reference. It alone performs memory
+// accesses through the load and store closures. The fast model sees the same
+// loaded values and its memory accesses are compared against those of the
+// reference, so memory-mapped peripherals observe each access exactly once.
+public class LockstepCPUModel: NSObject, CPU {
+    public static var supportsSecureCoding = true
+
+    public struct Divergence: Equatable, CustomStringConvertible {
+        public let timeStamp: UInt
+        public let what: String
+        public let expected: String
+        public let actual: String
+
+        public var description: String {
+            "fast CPU model diverged from the schematic-level CPU model at cycle \(timeStamp): \(what) is \(actual) but expected \(expected)"
+        }
+    }
+
+    public let reference: SchematicLevelCPUModel
+    public let fast: FastCPUModel
+
+    // The first divergence detected, if any
+    public private(set) var firstDivergence: Divergence?
+
+    // Called once, when the first divergence is detected
+    public var onDivergence: ((Divergence) -> Void)?
+
+    private enum MemoryAccess: Equatable {
+        case load(MemoryAddress, UInt16)
+        case store(UInt16, MemoryAddress)
+    }
+
+    private var referenceMemoryAccesses: [MemoryAccess] = []
+    private var fastMemoryAccesses: [MemoryAccess] = []
+
+    // Reads the clock once per batch of cycles in run(until:)
+    let runLoop = BatchedRunLoop()
+
+    public var timeStamp: UInt {
+        reference.timeStamp
+    }
+
+    public var isResetting: Bool {
+        reference.isResetting
+    }
+
+    public var isHalted: Bool {
+        reference.isHalted
+    }
+
+    public var isStalling: Bool {
+        reference.isStalling
+    }
+
+    public var pc: UInt16 {
+        get {
+            reference.pc
+        }
+        set(newValue) {
+            reference.pc = newValue
+            fast.pc = newValue
+        }
+    }
+
+    public var instructions: [UInt16] {
+        get {
+            reference.instructions
+        }
+        set(newValue) {
+            reference.instructions = newValue
+            fast.instructions = newValue
+        }
+    }
+
+    public var decoder: InstructionDecoder {
+        get {
+            reference.decoder
+        }
+        set(newValue) {
+            reference.decoder = newValue
+            fast.decoder = newValue
+        }
+    }
+
+    public var n: UInt {
+        get {
+            reference.n
+        }
+        set(newValue) {
+            reference.n = newValue
+            fast.n = newValue
+        }
+    }
+
+    public var c: UInt {
+        get {
+            reference.c
+        }
+        set(newValue) {
+            reference.c = newValue
+            fast.c = newValue
+        }
+    }
+
+    public var z: UInt {
+        get {
+            reference.z
+        }
+        set(newValue) {
+            reference.z = newValue
+            fast.z = newValue
+        }
+    }
+
+    public var v: UInt {
+        get {
+            reference.v
+        }
+        set(newValue) {
+            reference.v = newValue
+            fast.v = newValue
+        }
+    }
+
+    public var load: (MemoryAddress) -> UInt16 = { (_: MemoryAddress) in
+        0 // do nothing
+    }
+
+    public var store: (UInt16, MemoryAddress) -> Void = { (_: UInt16, _: MemoryAddress) in
+        // do nothing
+    }
+
+    public var numberOfRegisters: Int {
+        reference.numberOfRegisters
+    }
+
+    public func setRegister(_ idx: Int, _ val: UInt16) {
+        reference.setRegister(idx, val)
+        fast.setRegister(idx, val)
+    }
+
+    public func getRegister(_ idx: Int) -> UInt16 {
+        reference.getRegister(idx)
+    }
+
+    public var numberOfPipelineStages: Int {
+        reference.numberOfPipelineStages
+    }
+
+    public func getPipelineStageInfo(_ idx: Int) -> PipelineStageInfo {
+        reference.getPipelineStageInfo(idx)
+    }
+
+    public convenience override init() {
+        self.init(reference: SchematicLevelCPUModel(), fast: FastCPUModel())
+    }
+
+    public init(reference: SchematicLevelCPUModel, fast: FastCPUModel) {
+        self.reference = reference
+        self.fast = fast
+        super.init()
+        connectMemoryAccessClosures()
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let reference = coder.decodeObject(
+            of: SchematicLevelCPUModel.self,
+            forKey: "reference"
+        ),
+            let fast = coder.decodeObject(of: FastCPUModel.self, forKey: "fast")
+        else {
+            return nil
+        }
+        self.reference = reference
+        self.fast = fast
+        super.init()
+        connectMemoryAccessClosures()
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(reference, forKey: "reference")
+        coder.encode(fast, forKey: "fast")
+    }
+
+    private func connectMemoryAccessClosures() {
+        reference.load = { [weak self] (address: MemoryAddress) in
+            guard let self else { return 0 }
+            let value = load(address)
+            referenceMemoryAccesses.append(.load(address, value))
+            return value
+        }
+        reference.store = { [weak self] (value: UInt16, address: MemoryAddress) in
+            guard let self else { return }
+            store(value, address)
+            referenceMemoryAccesses.append(.store(value, address))
+        }
+        fast.load = { [weak self] (address: MemoryAddress) in
+            guard let self else { return 0 }
+            // Replay the value which the reference model loaded. If the fast
+            // model loads from somewhere else then the comparison at the end
+            // of the cycle will catch it.
+            let index = fastMemoryAccesses.count
+            let value: UInt16 =
+                if index < referenceMemoryAccesses.count,
+                case let .load(expectedAddress, expectedValue) = referenceMemoryAccesses[index],
+                expectedAddress == address {
+                    expectedValue
+                }
+                else {
+                    0
+                }
+            fastMemoryAccesses.append(.load(address, value))
+            return value
+        }
+        fast.store = { [weak self] (value: UInt16, address: MemoryAddress) in
+            guard let self else { return }
+            fastMemoryAccesses.append(.store(value, address))
+        }
+    }
+
+    public static func == (lhs: LockstepCPUModel, rhs: LockstepCPUModel) -> Bool {
+        lhs.isEqual(rhs)
+    }
+
+    public override func isEqual(_ rhs: Any?) -> Bool {
+        guard rhs != nil else {
+            return false
+        }
+        guard let rhs = rhs as? LockstepCPUModel else {
+            return false
+        }
+        guard reference == rhs.reference,
+              fast == rhs.fast
+        else {
+            return false
+        }
+        return true
+    }
+
+    public override var hash: Int {
+        var hasher = Hasher()
+        hasher.combine(reference)
+        hasher.combine(fast)
+        return hasher.finalize()
+    }
+
+    public func reset() {
+        referenceMemoryAccesses.removeAll(keepingCapacity: true)
+        fastMemoryAccesses.removeAll(keepingCapacity: true)
+        reference.reset()
+        fast.reset()
+        compare()
+    }
+
+    public func run(until date: Date = Date.distantFuture) -> Bool {
+        runLoop.run(self, until: date)
+    }
+
+    public func run() {
+        repeat {
+            step()
+        } while !isHalted
+    }
+
+    public func step() {
+        referenceMemoryAccesses.removeAll(keepingCapacity: true)
+        fastMemoryAccesses.removeAll(keepingCapacity: true)
+        reference.step()
+        fast.step()
+        compare()
+    }
+
+    private func compare() {
+        guard firstDivergence == nil else {
+            return
+        }
+        check("timeStamp", reference.timeStamp, fast.timeStamp)
+        check("isResetting", reference.isResetting, fast.isResetting)
+        check("isHalted", reference.isHalted, fast.isHalted)
+        check("isStalling", reference.isStalling, fast.isStalling)
+        check("pc", reference.pc, fast.pc)
+        check("n", reference.n, fast.n)
+        check("c", reference.c, fast.c)
+        check("z", reference.z, fast.z)
+        check("v", reference.v, fast.v)
+        for i in 0..<numberOfRegisters {
+            check("r\(i)", reference.getRegister(i), fast.getRegister(i))
+        }
+        for i in 0..<numberOfPipelineStages {
+            let expected = reference.getPipelineStageInfo(i)
+            let actual = fast.getPipelineStageInfo(i)
+            check("\(expected.name) pc", expected.pc, actual.pc)
+        }
+        check("memory accesses", referenceMemoryAccesses, fastMemoryAccesses)
+    }
+
+    private func check<T: Equatable>(_ what: String, _ expected: T, _ actual: T) {
+        guard firstDivergence == nil, expected != actual else {
+            return
+        }
+        let divergence = Divergence(
+            timeStamp: reference.timeStamp,
+            what: what,
+            expected: "\(expected)",
+            actual: "\(actual)"
+        )
+        firstDivergence = divergence
+        onDivergence?(divergence)
+    }
+}
@@ -112,6 +112,104 @@ public final class OutputLogicMacroCell {
         return result
     }
 
+    // The I/O pins, 14 through 23, may be driven externally or fed back from
+    // the OLMCs.
+    public static let ioPinMask: UInt32 = 0b11111111_11000000_00000000
+    public static let allPinsMask: UInt32 = 0b11111111_11111111_11111111
+
+    /// Step the OLMC using the product terms compiled to bitmasks.
+    ///
+    /// This is equivalent to step(_:) but operates on packed words rather than
+    /// arrays of optionals, so it does not allocate. In `pins', bit i holds the
+    /// logic level of pin i. In `driven', bit i is set if pin i is actively,
+    /// externally driven, which corresponds to a non-nil input to step(_:).
+    /// `feedbackPins' holds the feedback of OLMC k in bit 23-k, the position
+    /// of that OLMC's output pin.
+    public func step(
+        pins: UInt32,
+        driven: UInt32,
+        feedbackPins: UInt32,
+        ar: UInt = 0,
+        sp: UInt = 0
+    ) -> UInt? {
+        let isClockDriven = (driven & 0b10) != 0
+        let clock: UInt = isClockDriven ? UInt((pins >> 1) & 1) : 1
+        let isRisingEdgeOfClock = (prevClock == 0 && clock != 0)
+        prevClock = clock
+
+        let sumTerm: UInt = evaluateSumTerm(
+            pins: configureCombinatorialInputs(
+                pins: pins,
+                driven: driven,
+                feedbackPins: feedbackPins
+            )
+        )
+
+        if (ar & 1) == 1 {
+            flipFlopState = 0
+        }
+        else if isRisingEdgeOfClock {
+            if (sp & 1) == 1 {
+                flipFlopState = 1
+            }
+            else {
+                flipFlopState = sumTerm
+            }
+        }
+
+        let result: UInt =
+            switch (s1, s0) {
+            case (0, 0): ~flipFlopState & 1
+            case (0, 1): flipFlopState & 1
+            case (1, 0): ~sumTerm & 1
+            case (1, 1): sumTerm & 1
+            default: abort()
+            }
+
+        prevResult = result
+
+        // Pins which are not actively driven read as high for the purposes of
+        // the output enable product term.
+        let oe = outputEnableProductTermFuseMap.evaluate(pins: pins | ~driven)
+        if oe == 0 {
+            return nil
+        }
+
+        return result
+    }
+
+    private func configureCombinatorialInputs(
+        pins: UInt32,
+        driven: UInt32,
+        feedbackPins: UInt32
+    ) -> UInt32 {
+        let ioPinMask = OutputLogicMacroCell.ioPinMask
+        let allPinsMask = OutputLogicMacroCell.allPinsMask
+        assert((driven | ioPinMask) & allPinsMask == allPinsMask, "only I/O pins may float")
+        if s1 == 0 {
+            // Registered pin
+            // It is an error to attempt to actively, externally drive a registered output pin.
+            assert(driven & ioPinMask == 0)
+            return (pins & ~ioPinMask) | (feedbackPins & ioPinMask)
+        }
+        else {
+            // Combinatorial pin
+            let external = pins & driven & ioPinMask
+            let internal = feedbackPins & ~driven & ioPinMask
+            return (pins & ~ioPinMask) | external | internal
+        }
+    }
+
+    @inline(__always)
+    private func evaluateSumTerm(pins: UInt32) -> UInt {
+        for productTermFuseMap in productTermFuseMaps {
+            if productTermFuseMap.evaluate(pins: pins) != 0 {
+                return 1
+            }
+        }
+        return 0
+    }
+
     private func configureCombinatorialInputs(_ input: Input) -> [UInt] {
         var modified = input.inputs
 
@@ -8,9 +8,9 @@
 
 import Foundation
 
-public class EX_Output: NSObject, NSSecureCoding {
-    public static var supportsSecureCoding = true
-
+// The EX pipeline latch. This is a plain value so that stepping the CPU
+// does not allocate.
+public struct EX_Output: Hashable, CustomStringConvertible {
     public let n: UInt
     public let c: UInt
     public let z: UInt
@@ -24,7 +24,7 @@ public class EX_Output: NSObject, NSSecureCoding {
     public let selC: UInt
     public let associatedPC: UInt16?
 
-    public override var description: String {
+    public var description: String {
         let n = (n == 0) ? "n" : "N"
         let c = (c == 0) ? "c" : "C"
         let z = (z == 0) ? "z" : "Z"
@@ -36,7 +36,7 @@ public class EX_Output: NSObject, NSSecureCoding {
             "\(n)\(c)\(z)\(v)\(j)\(a)\(h), y: \(String(format: "%04x", y)), storeOp: \(String(format: "%04x", storeOp)), ctl: \(String(format: "%x", ctl)), selC: \(selC)"
     }
 
-    public required init(
+    public init(
         n: UInt,
         c: UInt,
         z: UInt,
@@ -63,97 +63,6 @@ public class EX_Output: NSObject, NSSecureCoding {
         self.selC = selC
         self.associatedPC = associatedPC
     }
-
-    public required init?(coder: NSCoder) {
-        guard let n = coder.decodeObject(forKey: "n") as? UInt,
-              let c = coder.decodeObject(forKey: "c") as? UInt,
-              let z = coder.decodeObject(forKey: "z") as? UInt,
-              let v = coder.decodeObject(forKey: "v") as? UInt,
-              let j = coder.decodeObject(forKey: "j") as? UInt,
-              let jabs = coder.decodeObject(forKey: "jabs") as? UInt,
-              let y = coder.decodeObject(forKey: "y") as? UInt16,
-              let hlt = coder.decodeObject(forKey: "hlt") as? UInt,
-              let storeOp = coder.decodeObject(forKey: "storeOp") as? UInt16,
-              let ctl = coder.decodeObject(forKey: "ctl") as? UInt,
-              let selC = coder.decodeObject(forKey: "selC") as? UInt,
-              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
-        else {
-            return nil
-        }
-        self.n = n
-        self.c = c
-        self.z = z
-        self.v = v
-        self.j = j
-        self.jabs = jabs
-        self.y = y
-        self.hlt = hlt
-        self.storeOp = storeOp
-        self.ctl = ctl
-        self.selC = selC
-        self.associatedPC = associatedPC
-    }
-
-    public func encode(with coder: NSCoder) {
-        coder.encode(n, forKey: "n")
-        coder.encode(c, forKey: "c")
-        coder.encode(z, forKey: "z")
-        coder.encode(v, forKey: "v")
-        coder.encode(j, forKey: "j")
-        coder.encode(jabs, forKey: "jabs")
-        coder.encode(y, forKey: "y")
-        coder.encode(hlt, forKey: "hlt")
-        coder.encode(storeOp, forKey: "storeOp")
-        coder.encode(ctl, forKey: "ctl")
-        coder.encode(selC, forKey: "selC")
-        coder.encode(associatedPC, forKey: "associatedPC")
-    }
-
-    public static func == (lhs: EX_Output, rhs: EX_Output) -> Bool {
-        lhs.isEqual(rhs)
-    }
-
-    public override func isEqual(_ rhs: Any?) -> Bool {
-        guard rhs != nil else {
-            return false
-        }
-        guard let rhs = rhs as? EX_Output else {
-            return false
-        }
-        guard n == rhs.n,
-              c == rhs.c,
-              z == rhs.z,
-              v == rhs.v,
-              j == rhs.j,
-              jabs == rhs.jabs,
-              y == rhs.y,
-              hlt == rhs.hlt,
-              storeOp == rhs.storeOp,
-              ctl == rhs.ctl,
-              selC == rhs.selC,
-              associatedPC == rhs.associatedPC
-        else {
-            return false
-        }
-        return true
-    }
-
-    public override var hash: Int {
-        var hasher = Hasher()
-        hasher.combine(n)
-        hasher.combine(c)
-        hasher.combine(z)
-        hasher.combine(v)
-        hasher.combine(j)
-        hasher.combine(jabs)
-        hasher.combine(y)
-        hasher.combine(hlt)
-        hasher.combine(storeOp)
-        hasher.combine(ctl)
-        hasher.combine(selC)
-        hasher.combine(associatedPC)
-        return hasher.finalize()
-    }
 }
 
 // Models the EX (execute) stage of the Turtle16 pipeline.
@@ -165,6 +74,10 @@ public class EX: NSObject, NSSecureCoding {
 
     public var associatedPC: UInt16?
 
+    // The EX stage uses the ALU purely combinationally. Keep one instance
+    // around rather than allocating a new one on every clock cycle.
+    let alu = IDT7381()
+
     public struct Input: Hashable {
         public let pc: UInt16
         public let ctl: UInt
@@ -246,7 +159,7 @@ public class EX: NSObject, NSSecureCoding {
         let jabs = (input.ctl >> 13) & 1
         let hlt = input.ctl & 1
         let right = selectRightOperand(input: input)
-        let alu = IDT7381()
+        alu.f = 0
         let aluOutput = alu.step(
             input: IDT7381.Input(
                 a: input.a,
@@ -8,9 +8,9 @@
 
 import Foundation
 
-public class ID_Output: NSObject, NSSecureCoding {
-    public static var supportsSecureCoding = true
-
+// The ID pipeline latch. This is a plain value so that stepping the CPU
+// does not allocate.
+public struct ID_Output: Hashable, CustomStringConvertible {
     public let stall: UInt
     public let ctl_EX: UInt
     public let a: UInt16
@@ -18,11 +18,11 @@ public class ID_Output: NSObject, NSSecureCoding {
     public let ins: UInt
     public let associatedPC: UInt16?
 
-    public override var description: String {
+    public var description: String {
         "stall: \(stall), ctl_EX: \(String(format: "%x", ctl_EX)), a: \(String(format: "%04x", a)), b: \(String(format: "%04x", b)), ins: \(String(format: "%04x", ins))"
     }
 
-    public required init(
+    public init(
         stall: UInt,
         ctl_EX: UInt,
         a: UInt16,
@@ -37,67 +37,6 @@ public class ID_Output: NSObject, NSSecureCoding {
         self.ins = ins
         self.associatedPC = associatedPC
     }
-
-    public required init?(coder: NSCoder) {
-        guard let stall = coder.decodeObject(forKey: "stall") as? UInt,
-              let ctl_EX = coder.decodeObject(forKey: "ctl_EX") as? UInt,
-              let a = coder.decodeObject(forKey: "a") as? UInt16,
-              let b = coder.decodeObject(forKey: "b") as? UInt16,
-              let ins = coder.decodeObject(forKey: "ins") as? UInt,
-              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
-        else {
-            return nil
-        }
-        self.stall = stall
-        self.ctl_EX = ctl_EX
-        self.a = a
-        self.b = b
-        self.ins = ins
-        self.associatedPC = associatedPC
-    }
-
-    public func encode(with coder: NSCoder) {
-        coder.encode(stall, forKey: "stall")
-        coder.encode(ctl_EX, forKey: "ctl_EX")
-        coder.encode(a, forKey: "a")
-        coder.encode(b, forKey: "b")
-        coder.encode(ins, forKey: "ins")
-        coder.encode(associatedPC, forKey: "associatedPC")
-    }
-
-    public static func == (lhs: ID_Output, rhs: ID_Output) -> Bool {
-        lhs.isEqual(rhs)
-    }
-
-    public override func isEqual(_ rhs: Any?) -> Bool {
-        guard rhs != nil else {
-            return false
-        }
-        guard let rhs = rhs as? ID_Output else {
-            return false
-        }
-        guard stall == rhs.stall,
-              ctl_EX == rhs.ctl_EX,
-              a == rhs.a,
-              b == rhs.b,
-              ins == rhs.ins,
-              associatedPC == rhs.associatedPC
-        else {
-            return false
-        }
-        return true
-    }
-
-    public override var hash: Int {
-        var hasher = Hasher()
-        hasher.combine(stall)
-        hasher.combine(ctl_EX)
-        hasher.combine(a)
-        hasher.combine(b)
-        hasher.combine(ins)
-        hasher.combine(associatedPC)
-        return hasher.finalize()
-    }
 }
 
 // Models the ID (instruction decode) stage of the Turtle16 pipeline.
@@ -292,7 +231,15 @@ public class ID: NSObject, NSSecureCoding {
     public var registerFile: [UInt16]
     public var decoder: InstructionDecoder
     public var associatedPC: UInt16?
-    let hazardControlUnit: HazardControl = HazardControlMockup()
+
+    // The hazard control unit is not archived. HazardControlMockup is the
+    // default. HazardControlGAL simulates the programmed ATF22V10s instead.
+    public var hazardControlUnit: HazardControl = HazardControlMockup()
+
+    // If set, the control word for an instruction fetched through the cache
+    // is taken from the cache instead of from the decoder. The cache must be
+    // configured with the same decoder. This is not archived.
+    public var predecodeCache: PredecodeCache?
 
     public override required init() {
         registerFile = [UInt16](repeating: 0, count: 8)
@@ -388,6 +335,11 @@ public class ID: NSObject, NSSecureCoding {
     }
 
     public func decodeOpcode(input: Input) -> UInt {
+        if let predecodeCache,
+           let pc = input.associatedPC,
+           let entry = predecodeCache.cachedEntry(at: pc, ins: input.ins) {
+            return predecodeCache.controlWord(entry, n: input.n, c: input.c, z: input.z, v: input.v)
+        }
         let opcode = UInt((input.ins >> 11) & 31)
         let ctl_ID = decoder.decode(n: input.n, c: input.c, z: input.z, v: input.v, opcode: opcode)
         return ctl_ID
@@ -8,70 +8,24 @@
 
 import Foundation
 
-public class IF_Output: NSObject, NSSecureCoding {
-    public static var supportsSecureCoding = true
-
+// The IF pipeline latch. This is a plain value so that stepping the CPU
+// does not allocate.
+public struct IF_Output: Hashable, CustomStringConvertible {
     public let ins: UInt16
     public let pc: UInt16
     public let associatedPC: UInt16?
 
-    public override var description: String {
+    public var description: String {
         let strIns = String(format: "%04x", ins)
         let strPC = String(format: "%04x", pc)
         return "ins: \(strIns), pc: \(strPC)"
     }
 
-    public required init(ins: UInt16, pc: UInt16, associatedPC: UInt16? = nil) {
+    public init(ins: UInt16, pc: UInt16, associatedPC: UInt16? = nil) {
         self.ins = ins
         self.pc = pc
         self.associatedPC = associatedPC
     }
-
-    public required init?(coder: NSCoder) {
-        guard let ins = coder.decodeObject(forKey: "ins") as? UInt16,
-              let pc = coder.decodeObject(forKey: "pc") as? UInt16,
-              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
-        else {
-            return nil
-        }
-        self.ins = ins
-        self.pc = pc
-        self.associatedPC = associatedPC
-    }
-
-    public func encode(with coder: NSCoder) {
-        coder.encode(ins, forKey: "ins")
-        coder.encode(pc, forKey: "pc")
-        coder.encode(associatedPC, forKey: "associatedPC")
-    }
-
-    public static func == (lhs: IF_Output, rhs: IF_Output) -> Bool {
-        lhs.isEqual(rhs)
-    }
-
-    public override func isEqual(_ rhs: Any?) -> Bool {
-        guard rhs != nil else {
-            return false
-        }
-        guard let rhs = rhs as? IF_Output else {
-            return false
-        }
-        guard ins == rhs.ins,
-              pc == rhs.pc,
-              associatedPC == rhs.associatedPC
-        else {
-            return false
-        }
-        return true
-    }
-
-    public override var hash: Int {
-        var hasher = Hasher()
-        hasher.combine(ins)
-        hasher.combine(pc)
-        hasher.combine(associatedPC)
-        return hasher.finalize()
-    }
 }
 
 // Models the IF (instruction fetch) stage of the Turtle16 pipeline.
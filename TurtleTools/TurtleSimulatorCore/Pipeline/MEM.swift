@@ -8,16 +8,16 @@
 
 import Foundation
 
-public class MEM_Output: NSObject, NSSecureCoding {
-    public static var supportsSecureCoding = true
-
+// The MEM pipeline latch. This is a plain value so that stepping the CPU
+// does not allocate.
+public struct MEM_Output: Hashable, CustomStringConvertible {
     public let y: UInt16
     public let storeOp: UInt16
     public let selC: UInt
     public let ctl: UInt
     public let associatedPC: UInt16?
 
-    public override var description: String {
+    public var description: String {
         "y: \(String(format: "%04x", y)), storeOp: \(String(format: "%04x", storeOp)), selC: \(selC), ctl: \(String(format: "%x", ctl))"
     }
 
@@ -28,62 +28,6 @@ public class MEM_Output: NSObject, NSSecureCoding {
         self.ctl = ctl
         self.associatedPC = associatedPC
     }
-
-    public required init?(coder: NSCoder) {
-        guard let y = coder.decodeObject(forKey: "y") as? UInt16,
-              let storeOp = coder.decodeObject(forKey: "storeOp") as? UInt16,
-              let selC = coder.decodeObject(forKey: "selC") as? UInt,
-              let ctl = coder.decodeObject(forKey: "ctl") as? UInt,
-              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
-        else {
-            return nil
-        }
-        self.y = y
-        self.storeOp = storeOp
-        self.selC = selC
-        self.ctl = ctl
-        self.associatedPC = associatedPC
-    }
-
-    public func encode(with coder: NSCoder) {
-        coder.encode(y, forKey: "y")
-        coder.encode(storeOp, forKey: "storeOp")
-        coder.encode(selC, forKey: "selC")
-        coder.encode(ctl, forKey: "ctl")
-        coder.encode(associatedPC, forKey: "associatedPC")
-    }
-
-    public static func == (lhs: MEM_Output, rhs: MEM_Output) -> Bool {
-        lhs.isEqual(rhs)
-    }
-
-    public override func isEqual(_ rhs: Any?) -> Bool {
-        guard rhs != nil else {
-            return false
-        }
-        guard let rhs = rhs as? MEM_Output else {
-            return false
-        }
-        guard y == rhs.y,
-              storeOp == rhs.storeOp,
-              selC == rhs.selC,
-              ctl == rhs.ctl,
-              associatedPC == rhs.associatedPC
-        else {
-            return false
-        }
-        return true
-    }
-
-    public override var hash: Int {
-        var hasher = Hasher()
-        hasher.combine(y)
-        hasher.combine(storeOp)
-        hasher.combine(selC)
-        hasher.combine(ctl)
-        hasher.combine(associatedPC)
-        return hasher.finalize()
-    }
 }
 
 // Models the MEM (memory) stage of the Turtle16 pipeline.
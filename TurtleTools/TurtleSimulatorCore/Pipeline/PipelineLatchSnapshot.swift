@@ -0,0 +1,395 @@
+//
+//  PipelineLatchSnapshot.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+// The pipeline latches are plain structs so the cycle loop never touches the
+// heap. This adapter carries their values through NSKeyedArchiver when the
+// CPU model is encoded for a snapshot, and is not used while simulating.
+public final class PipelineLatchSnapshot: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let outputIF: IF_Output
+    public let outputID: ID_Output
+    public let outputEX: EX_Output
+    public let outputMEM: MEM_Output
+    public let outputWB: WB_Output
+
+    public init(
+        outputIF: IF_Output,
+        outputID: ID_Output,
+        outputEX: EX_Output,
+        outputMEM: MEM_Output,
+        outputWB: WB_Output
+    ) {
+        self.outputIF = outputIF
+        self.outputID = outputID
+        self.outputEX = outputEX
+        self.outputMEM = outputMEM
+        self.outputWB = outputWB
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let ins_IF = coder.decodeObject(forKey: "IF.ins") as? UInt16,
+              let pc_IF = coder.decodeObject(forKey: "IF.pc") as? UInt16,
+              let associatedPC_IF = coder.decodeObject(forKey: "IF.associatedPC") as? UInt16?,
+              let stall_ID = coder.decodeObject(forKey: "ID.stall") as? UInt,
+              let ctl_EX_ID = coder.decodeObject(forKey: "ID.ctl_EX") as? UInt,
+              let a_ID = coder.decodeObject(forKey: "ID.a") as? UInt16,
+              let b_ID = coder.decodeObject(forKey: "ID.b") as? UInt16,
+              let ins_ID = coder.decodeObject(forKey: "ID.ins") as? UInt,
+              let associatedPC_ID = coder.decodeObject(forKey: "ID.associatedPC") as? UInt16?,
+              let n_EX = coder.decodeObject(forKey: "EX.n") as? UInt,
+              let c_EX = coder.decodeObject(forKey: "EX.c") as? UInt,
+              let z_EX = coder.decodeObject(forKey: "EX.z") as? UInt,
+              let v_EX = coder.decodeObject(forKey: "EX.v") as? UInt,
+              let j_EX = coder.decodeObject(forKey: "EX.j") as? UInt,
+              let jabs_EX = coder.decodeObject(forKey: "EX.jabs") as? UInt,
+              let y_EX = coder.decodeObject(forKey: "EX.y") as? UInt16,
+              let hlt_EX = coder.decodeObject(forKey: "EX.hlt") as? UInt,
+              let storeOp_EX = coder.decodeObject(forKey: "EX.storeOp") as? UInt16,
+              let ctl_EX = coder.decodeObject(forKey: "EX.ctl") as? UInt,
+              let selC_EX = coder.decodeObject(forKey: "EX.selC") as? UInt,
+              let associatedPC_EX = coder.decodeObject(forKey: "EX.associatedPC") as? UInt16?,
+              let y_MEM = coder.decodeObject(forKey: "MEM.y") as? UInt16,
+              let storeOp_MEM = coder.decodeObject(forKey: "MEM.storeOp") as? UInt16,
+              let selC_MEM = coder.decodeObject(forKey: "MEM.selC") as? UInt,
+              let ctl_MEM = coder.decodeObject(forKey: "MEM.ctl") as? UInt,
+              let associatedPC_MEM = coder.decodeObject(forKey: "MEM.associatedPC") as? UInt16?,
+              let c_WB = coder.decodeObject(forKey: "WB.c") as? UInt16,
+              let wrl_WB = coder.decodeObject(forKey: "WB.wrl") as? UInt,
+              let wrh_WB = coder.decodeObject(forKey: "WB.wrh") as? UInt,
+              let wben_WB = coder.decodeObject(forKey: "WB.wben") as? UInt
+        else {
+            return nil
+        }
+        outputIF = IF_Output(ins: ins_IF, pc: pc_IF, associatedPC: associatedPC_IF)
+        outputID = ID_Output(
+            stall: stall_ID,
+            ctl_EX: ctl_EX_ID,
+            a: a_ID,
+            b: b_ID,
+            ins: ins_ID,
+            associatedPC: associatedPC_ID
+        )
+        outputEX = EX_Output(
+            n: n_EX,
+            c: c_EX,
+            z: z_EX,
+            v: v_EX,
+            j: j_EX,
+            jabs: jabs_EX,
+            y: y_EX,
+            hlt: hlt_EX,
+            storeOp: storeOp_EX,
+            ctl: ctl_EX,
+            selC: selC_EX,
+            associatedPC: associatedPC_EX
+        )
+        outputMEM = MEM_Output(
+            y: y_MEM,
+            storeOp: storeOp_MEM,
+            selC: selC_MEM,
+            ctl: ctl_MEM,
+            associatedPC: associatedPC_MEM
+        )
+        outputWB = WB_Output(c: c_WB, wrl: wrl_WB, wrh: wrh_WB, wben: wben_WB)
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(outputIF.ins, forKey: "IF.ins")
+        coder.encode(outputIF.pc, forKey: "IF.pc")
+        coder.encode(outputIF.associatedPC, forKey: "IF.associatedPC")
+
+        coder.encode(outputID.stall, forKey: "ID.stall")
+        coder.encode(outputID.ctl_EX, forKey: "ID.ctl_EX")
+        coder.encode(outputID.a, forKey: "ID.a")
+        coder.encode(outputID.b, forKey: "ID.b")
+        coder.encode(outputID.ins, forKey: "ID.ins")
+        coder.encode(outputID.associatedPC, forKey: "ID.associatedPC")
+
+        coder.encode(outputEX.n, forKey: "EX.n")
+        coder.encode(outputEX.c, forKey: "EX.c")
+        coder.encode(outputEX.z, forKey: "EX.z")
+        coder.encode(outputEX.v, forKey: "EX.v")
+        coder.encode(outputEX.j, forKey: "EX.j")
+        coder.encode(outputEX.jabs, forKey: "EX.jabs")
+        coder.encode(outputEX.y, forKey: "EX.y")
+        coder.encode(outputEX.hlt, forKey: "EX.hlt")
+        coder.encode(outputEX.storeOp, forKey: "EX.storeOp")
+        coder.encode(outputEX.ctl, forKey: "EX.ctl")
+        coder.encode(outputEX.selC, forKey: "EX.selC")
+        coder.encode(outputEX.associatedPC, forKey: "EX.associatedPC")
+
+        coder.encode(outputMEM.y, forKey: "MEM.y")
+        coder.encode(outputMEM.storeOp, forKey: "MEM.storeOp")
+        coder.encode(outputMEM.selC, forKey: "MEM.selC")
+        coder.encode(outputMEM.ctl, forKey: "MEM.ctl")
+        coder.encode(outputMEM.associatedPC, forKey: "MEM.associatedPC")
+
+        coder.encode(outputWB.c, forKey: "WB.c")
+        coder.encode(outputWB.wrl, forKey: "WB.wrl")
+        coder.encode(outputWB.wrh, forKey: "WB.wrh")
+        coder.encode(outputWB.wben, forKey: "WB.wben")
+    }
+
+    public static func == (lhs: PipelineLatchSnapshot, rhs: PipelineLatchSnapshot) -> Bool {
+        lhs.isEqual(rhs)
+    }
+
+    public override func isEqual(_ rhs: Any?) -> Bool {
+        guard rhs != nil else {
+            return false
+        }
+        guard let rhs = rhs as? PipelineLatchSnapshot else {
+            return false
+        }
+        guard outputIF == rhs.outputIF,
+              outputID == rhs.outputID,
+              outputEX == rhs.outputEX,
+              outputMEM == rhs.outputMEM,
+              outputWB == rhs.outputWB
+        else {
+            return false
+        }
+        return true
+    }
+
+    public override var hash: Int {
+        var hasher = Hasher()
+        hasher.combine(outputIF)
+        hasher.combine(outputID)
+        hasher.combine(outputEX)
+        hasher.combine(outputMEM)
+        hasher.combine(outputWB)
+        return hasher.finalize()
+    }
+}
+
+// Before the latches were structs, each one was an NSObject subclass which
+// archived itself under the keys "outputIF" through "outputWB". These
+// classes read archives of that format, such as simulator sessions saved by
+// older versions, by standing in for the old classes by name.
+public extension PipelineLatchSnapshot {
+    /// The names under which the old latch classes were archived, and the
+    /// classes which now decode them
+    static let legacyClassNames: [(AnyClass, String)] = [
+        (LegacyIF_Output.self, "TurtleSimulatorCore.IF_Output"),
+        (LegacyID_Output.self, "TurtleSimulatorCore.ID_Output"),
+        (LegacyEX_Output.self, "TurtleSimulatorCore.EX_Output"),
+        (LegacyMEM_Output.self, "TurtleSimulatorCore.MEM_Output"),
+        (LegacyWB_Output.self, "TurtleSimulatorCore.WB_Output")
+    ]
+
+    private static let registerLegacyClassNames: Void = {
+        for (cls, name) in legacyClassNames {
+            NSKeyedUnarchiver.setClass(cls, forClassName: name)
+        }
+    }()
+
+    /// Decode the latches from a CPU archived with one object for each latch,
+    /// or return nil if the archive does not have them
+    static func decodeLegacyLatches(from coder: NSCoder) -> PipelineLatchSnapshot? {
+        _ = registerLegacyClassNames
+        guard let outputIF = coder.decodeObject(of: LegacyIF_Output.self, forKey: "outputIF"),
+              let outputID = coder.decodeObject(of: LegacyID_Output.self, forKey: "outputID"),
+              let outputEX = coder.decodeObject(of: LegacyEX_Output.self, forKey: "outputEX"),
+              let outputMEM = coder.decodeObject(of: LegacyMEM_Output.self, forKey: "outputMEM"),
+              let outputWB = coder.decodeObject(of: LegacyWB_Output.self, forKey: "outputWB")
+        else {
+            return nil
+        }
+        return PipelineLatchSnapshot(
+            outputIF: outputIF.value,
+            outputID: outputID.value,
+            outputEX: outputEX.value,
+            outputMEM: outputMEM.value,
+            outputWB: outputWB.value
+        )
+    }
+}
+
+public final class LegacyIF_Output: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let value: IF_Output
+
+    public init(_ value: IF_Output) {
+        self.value = value
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let ins = coder.decodeObject(forKey: "ins") as? UInt16,
+              let pc = coder.decodeObject(forKey: "pc") as? UInt16,
+              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
+        else {
+            return nil
+        }
+        value = IF_Output(ins: ins, pc: pc, associatedPC: associatedPC)
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(value.ins, forKey: "ins")
+        coder.encode(value.pc, forKey: "pc")
+        coder.encode(value.associatedPC, forKey: "associatedPC")
+    }
+}
+
+public final class LegacyID_Output: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let value: ID_Output
+
+    public init(_ value: ID_Output) {
+        self.value = value
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let stall = coder.decodeObject(forKey: "stall") as? UInt,
+              let ctl_EX = coder.decodeObject(forKey: "ctl_EX") as? UInt,
+              let a = coder.decodeObject(forKey: "a") as? UInt16,
+              let b = coder.decodeObject(forKey: "b") as? UInt16,
+              let ins = coder.decodeObject(forKey: "ins") as? UInt,
+              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
+        else {
+            return nil
+        }
+        value = ID_Output(
+            stall: stall,
+            ctl_EX: ctl_EX,
+            a: a,
+            b: b,
+            ins: ins,
+            associatedPC: associatedPC
+        )
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(value.stall, forKey: "stall")
+        coder.encode(value.ctl_EX, forKey: "ctl_EX")
+        coder.encode(value.a, forKey: "a")
+        coder.encode(value.b, forKey: "b")
+        coder.encode(value.ins, forKey: "ins")
+        coder.encode(value.associatedPC, forKey: "associatedPC")
+    }
+}
+
+public final class LegacyEX_Output: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let value: EX_Output
+
+    public init(_ value: EX_Output) {
+        self.value = value
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let n = coder.decodeObject(forKey: "n") as? UInt,
+              let c = coder.decodeObject(forKey: "c") as? UInt,
+              let z = coder.decodeObject(forKey: "z") as? UInt,
+              let v = coder.decodeObject(forKey: "v") as? UInt,
+              let j = coder.decodeObject(forKey: "j") as? UInt,
+              let jabs = coder.decodeObject(forKey: "jabs") as? UInt,
+              let y = coder.decodeObject(forKey: "y") as? UInt16,
+              let hlt = coder.decodeObject(forKey: "hlt") as? UInt,
+              let storeOp = coder.decodeObject(forKey: "storeOp") as? UInt16,
+              let ctl = coder.decodeObject(forKey: "ctl") as? UInt,
+              let selC = coder.decodeObject(forKey: "selC") as? UInt,
+              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
+        else {
+            return nil
+        }
+        value = EX_Output(
+            n: n,
+            c: c,
+            z: z,
+            v: v,
+            j: j,
+            jabs: jabs,
+            y: y,
+            hlt: hlt,
+            storeOp: storeOp,
+            ctl: ctl,
+            selC: selC,
+            associatedPC: associatedPC
+        )
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(value.n, forKey: "n")
+        coder.encode(value.c, forKey: "c")
+        coder.encode(value.z, forKey: "z")
+        coder.encode(value.v, forKey: "v")
+        coder.encode(value.j, forKey: "j")
+        coder.encode(value.jabs, forKey: "jabs")
+        coder.encode(value.y, forKey: "y")
+        coder.encode(value.hlt, forKey: "hlt")
+        coder.encode(value.storeOp, forKey: "storeOp")
+        coder.encode(value.ctl, forKey: "ctl")
+        coder.encode(value.selC, forKey: "selC")
+        coder.encode(value.associatedPC, forKey: "associatedPC")
+    }
+}
+
+public final class LegacyMEM_Output: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let value: MEM_Output
+
+    public init(_ value: MEM_Output) {
+        self.value = value
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let y = coder.decodeObject(forKey: "y") as? UInt16,
+              let storeOp = coder.decodeObject(forKey: "storeOp") as? UInt16,
+              let selC = coder.decodeObject(forKey: "selC") as? UInt,
+              let ctl = coder.decodeObject(forKey: "ctl") as? UInt,
+              let associatedPC = coder.decodeObject(forKey: "associatedPC") as? UInt16?
+        else {
+            return nil
+        }
+        value = MEM_Output(y: y, storeOp: storeOp, selC: selC, ctl: ctl, associatedPC: associatedPC)
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(value.y, forKey: "y")
+        coder.encode(value.storeOp, forKey: "storeOp")
+        coder.encode(value.selC, forKey: "selC")
+        coder.encode(value.ctl, forKey: "ctl")
+        coder.encode(value.associatedPC, forKey: "associatedPC")
+    }
+}
+
+public final class LegacyWB_Output: NSObject, NSSecureCoding {
+    public static var supportsSecureCoding = true
+
+    public let value: WB_Output
+
+    public init(_ value: WB_Output) {
+        self.value = value
+    }
+
+    public required init?(coder: NSCoder) {
+        guard let c = coder.decodeObject(forKey: "c") as? UInt16,
+              let wrl = coder.decodeObject(forKey: "wrl") as? UInt,
+              let wrh = coder.decodeObject(forKey: "wrh") as? UInt,
+              let wben = coder.decodeObject(forKey: "wben") as? UInt
+        else {
+            return nil
+        }
+        value = WB_Output(c: c, wrl: wrl, wrh: wrh, wben: wben)
+    }
+
+    public func encode(with coder: NSCoder) {
+        coder.encode(value.c, forKey: "c")
+        coder.encode(value.wrl, forKey: "wrl")
+        coder.encode(value.wrh, forKey: "wrh")
+        coder.encode(value.wben, forKey: "wben")
+    }
+}
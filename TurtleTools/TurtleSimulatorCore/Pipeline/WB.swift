@@ -8,15 +8,15 @@
 
 import Foundation
 
-public class WB_Output: NSObject, NSSecureCoding {
-    public static var supportsSecureCoding = true
-
+// The WB pipeline latch. This is a plain value so that stepping the CPU
+// does not allocate.
+public struct WB_Output: Hashable, CustomStringConvertible {
     public let c: UInt16
     public let wrl: UInt
     public let wrh: UInt
     public let wben: UInt
 
-    public override var description: String {
+    public var description: String {
         "c: \(String(format: "%04x", c)), wrl: \(wrl), wrh: \(wrh), wben: \(wben)"
     }
 
@@ -26,57 +26,6 @@ public class WB_Output: NSObject, NSSecureCoding {
         self.wrh = wrh
         self.wben = wben
     }
-
-    public required init?(coder: NSCoder) {
-        guard let c = coder.decodeObject(forKey: "c") as? UInt16,
-              let wrl = coder.decodeObject(forKey: "wrl") as? UInt,
-              let wrh = coder.decodeObject(forKey: "wrh") as? UInt,
-              let wben = coder.decodeObject(forKey: "wben") as? UInt
-        else {
-            return nil
-        }
-        self.c = c
-        self.wrl = wrl
-        self.wrh = wrh
-        self.wben = wben
-    }
-
-    public func encode(with coder: NSCoder) {
-        coder.encode(c, forKey: "c")
-        coder.encode(wrl, forKey: "wrl")
-        coder.encode(wrh, forKey: "wrh")
-        coder.encode(wben, forKey: "wben")
-    }
-
-    public static func == (lhs: WB_Output, rhs: WB_Output) -> Bool {
-        lhs.isEqual(rhs)
-    }
-
-    public override func isEqual(_ rhs: Any?) -> Bool {
-        guard rhs != nil else {
-            return false
-        }
-        guard let rhs = rhs as? WB_Output else {
-            return false
-        }
-        guard c == rhs.c,
-              wrl == rhs.wrl,
-              wrh == rhs.wrh,
-              wben == rhs.wben
-        else {
-            return false
-        }
-        return true
-    }
-
-    public override var hash: Int {
-        var hasher = Hasher()
-        hasher.combine(c)
-        hasher.combine(wrl)
-        hasher.combine(wrh)
-        hasher.combine(wben)
-        return hasher.finalize()
-    }
 }
 
 // Models the WB (write back) stage of the Turtle16 pipeline.
@@ -0,0 +1,177 @@
+//
+//  PipelineHazardModel.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+/// Describes the pipeline hazards of the Turtle16 CPU so that a compiler can
+/// order instructions to avoid them.
+///
+/// The properties of each opcode are read from the control words produced by
+/// DecoderGenerator. The hazards are the ones which HazardControl detects:
+///
+/// * A value written back through the store operand path, e.g., by LOAD or
+///   LI, cannot be forwarded. An instruction which reads the register stalls
+///   while the writer is in EX or in MEM.
+/// * An instruction which depends on the flags stalls while an instruction
+///   which sets the flags is in EX.
+/// * The CPU always predicts that a branch is not taken. When a jump is taken
+///   in EX, the instructions in IF and ID are flushed.
+public struct PipelineHazardModel: Sendable {
+    public struct Opcode: Equatable, Sendable {
+        /// The instruction writes the store operand back to the register file
+        public let writesBackStoreOperand: Bool
+
+        /// The instruction updates the ALU flags
+        public let setsFlags: Bool
+
+        /// The instruction depends on the ALU flags
+        public let readsFlags: Bool
+
+        /// The instruction reads the register selected by the A field
+        public let usesLeftOperand: Bool
+
+        /// The instruction reads the register selected by the B field
+        public let usesRightOperand: Bool
+
+        /// The instruction may transfer control
+        public let isJump: Bool
+    }
+
+    /// The number of instructions after one which writes back the store
+    /// operand that stall if they read the register. These are the
+    /// instructions which enter ID while the writer is in EX or in MEM.
+    public let storeOperandHazardDistance = 2
+
+    /// The number of instructions after one which sets the flags that stall if
+    /// they depend on the flags. This is the instruction which enters ID while
+    /// the writer is in EX.
+    public let flagsHazardDistance = 1
+
+    /// The number of cycles lost when a jump is taken
+    public let takenJumpPenalty = 2
+
+    /// Properties of each opcode, indexed by opcode
+    public let opcodes: [Opcode]
+
+    private let opcodeByMnemonic: [String: Int]
+
+    public static let turtle16 = PipelineHazardModel()
+
+    public init(controlWords: [UInt] = DecoderGenerator().generate()) {
+        let generator = DecoderGenerator()
+        opcodes = (0..<32).map { opcode in
+            // Conditional instructions have a different control word for each
+            // state of the flags. Consider every one of them.
+            let words = generator.indicesForAllConditions(opcode).map { controlWords[$0] }
+            func isAsserted(_ signal: Int) -> Bool {
+                words.contains { (($0 >> signal) & 1) == 0 }
+            }
+            let isWritingBackStoreOperand = words.contains {
+                (($0 >> DecoderGenerator.WBEN) & 1) == 0
+                    && (($0 >> DecoderGenerator.WriteBackSrcFlag) & 1) != 0
+            }
+            return Opcode(
+                writesBackStoreOperand: isWritingBackStoreOperand,
+                setsFlags: isAsserted(DecoderGenerator.FI),
+                readsFlags: (opcode >> 3) == 0b11,
+                usesLeftOperand: isAsserted(DecoderGenerator.LeftOperandIsUnused),
+                usesRightOperand: isAsserted(DecoderGenerator.RightOperandIsUnused),
+                isJump: isAsserted(DecoderGenerator.J)
+            )
+        }
+        opcodeByMnemonic = Dictionary(
+            uniqueKeysWithValues: Disassembler().mnemonics.map { ($1, $0) }
+        )
+    }
+
+    /// Properties of the instruction with the given mnemonic, or nil if the
+    /// mnemonic does not name a single hardware instruction
+    public func opcode(mnemonic: String) -> Opcode? {
+        guard let opcode = opcodeByMnemonic[mnemonic] else {
+            return nil
+        }
+        return opcodes[opcode]
+    }
+
+    /// Tracks the instructions in flight in order to count the cycles which
+    /// are lost to stalls
+    public struct Timeline: Sendable {
+        private let model: PipelineHazardModel
+
+        /// The cycle at which the next instruction enters ID, if it does not
+        /// stall
+        public private(set) var cycle = 0
+
+        /// The total number of cycles lost to stalls
+        public private(set) var totalStallCycles = 0
+
+        // The first cycle at which each register may be read without stalling
+        private var registerReadyCycle = [Int](repeating: 0, count: 8)
+
+        // The first cycle at which the flags may be read without stalling
+        private var flagsReadyCycle = 0
+
+        public init(model: PipelineHazardModel = .turtle16) {
+            self.model = model
+        }
+
+        /// The first cycle at which every register may be read without
+        /// stalling
+        public var settledCycle: Int {
+            max(cycle, registerReadyCycle.max() ?? 0)
+        }
+
+        /// The number of cycles for which an instruction would stall if it
+        /// were issued next
+        ///
+        /// - Parameters:
+        ///   - reads: The registers read through the A and B fields
+        ///   - readsFlags: Whether the instruction depends on the flags
+        public func stallCycles(reads: [Int], readsFlags: Bool) -> Int {
+            var issueCycle = cycle
+            for register in reads {
+                issueCycle = max(issueCycle, registerReadyCycle[register])
+            }
+            if readsFlags {
+                issueCycle = max(issueCycle, flagsReadyCycle)
+            }
+            return issueCycle - cycle
+        }
+
+        /// Issue the next instruction
+        ///
+        /// - Parameters:
+        ///   - reads: The registers read through the A and B fields
+        ///   - readsFlags: Whether the instruction depends on the flags
+        ///   - writesBackStoreOperand: The register written back through the
+        ///     store operand path, if any
+        ///   - setsFlags: Whether the instruction updates the flags
+        ///   - slots: The number of instructions which are emitted for this
+        ///     one, e.g., two for the LA macro instruction
+        public mutating func issue(
+            reads: [Int],
+            readsFlags: Bool,
+            writesBackStoreOperand: Int?,
+            setsFlags: Bool,
+            slots: Int = 1
+        ) {
+            let stall = stallCycles(reads: reads, readsFlags: readsFlags)
+            totalStallCycles += stall
+            cycle += stall + slots
+            if let register = writesBackStoreOperand {
+                registerReadyCycle[register] = max(
+                    registerReadyCycle[register],
+                    cycle + model.storeOperandHazardDistance
+                )
+            }
+            if setsFlags {
+                flagsReadyCycle = cycle + model.flagsHazardDistance
+            }
+        }
+    }
+}
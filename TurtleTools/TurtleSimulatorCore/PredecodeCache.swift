@@ -0,0 +1,176 @@
+//
+//  PredecodeCache.swift
+//  TurtleSimulatorCore
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import Foundation
+
+// Caches the decoded form of each word of instruction memory, keyed by PC.
+//
+// An entry is built the first time the instruction at that address is fetched
+// and is reused on every later fetch. Setting `instructions` or `decoder`
+// discards all entries. The cache is derived state and so it is not archived
+// with the CPU, nor is it considered when comparing two CPUs for equality.
+public final class PredecodeCache {
+    public struct Entry: Equatable {
+        // The raw instruction word
+        public let ins: UInt16
+
+        // The five-bit opcode in the upper bits of the instruction word
+        public let opcode: UInt8
+
+        // The register selects for the A, B, and C (destination) operands.
+        // Not every instruction uses these fields as register selects.
+        public let selA: UInt8
+        public let selB: UInt8
+        public let selC: UInt8
+
+        // The lower eleven bits of the instruction word, which are carried
+        // down the pipeline to build immediate operands.
+        public let imm: UInt16
+
+        // The control word produced by the opcode decoder. This is only
+        // meaningful when `isConditional` is false. Otherwise, the control
+        // word depends on the flags and must be looked up at decode time.
+        public let ctl: UInt
+
+        // True if the control word depends on the value of the flags
+        public let isConditional: Bool
+    }
+
+    public private(set) var hits: UInt = 0
+    public private(set) var misses: UInt = 0
+
+    // The predecoded form of the NOP which is fetched when the pipeline is
+    // flushed
+    public private(set) var nop = Entry(
+        ins: 0,
+        opcode: 0,
+        selA: 0,
+        selB: 0,
+        selC: 0,
+        imm: 0,
+        ctl: ID.nopControlWord,
+        isConditional: false
+    )
+
+    public var instructions: [UInt16] {
+        didSet {
+            invalidate()
+        }
+    }
+
+    public var decoder: InstructionDecoder {
+        didSet {
+            rebuildDecoderTables()
+            invalidate()
+        }
+    }
+
+    // A flat copy of the contents of the opcode decoder, addressed in the
+    // same way as the opcode decode ROM.
+    private var opcodeDecodeTable: [UInt] = []
+
+    // Indexed by opcode. True if the decoder produces a different control
+    // word for the opcode depending on the flags.
+    private var isConditionalOpcode: [Bool] = []
+
+    // Allocated lazily, on the first miss, so that creating a CPU is cheap.
+    private var entries: [Entry?] = []
+
+    public init(instructions: [UInt16] = [], decoder: InstructionDecoder) {
+        self.instructions = instructions
+        self.decoder = decoder
+        rebuildDecoderTables()
+    }
+
+    // Discard all entries. This does not reset the counters.
+    public func invalidate() {
+        entries = []
+    }
+
+    public func resetCounters() {
+        hits = 0
+        misses = 0
+    }
+
+    // Get the predecoded instruction at the specified address. Addresses
+    // outside of instruction memory read as a NOP.
+    @inline(__always)
+    public func entry(at pc: UInt16) -> Entry {
+        let index = Int(pc)
+        if index < entries.count, let entry = entries[index] {
+            hits = hits &+ 1
+            return entry
+        }
+        misses = misses &+ 1
+        guard index < instructions.count else {
+            return nop
+        }
+        if entries.isEmpty {
+            entries = [Entry?](repeating: nil, count: instructions.count)
+        }
+        let entry = predecode(instructions[index])
+        entries[index] = entry
+        return entry
+    }
+
+    // Get the entry for the specified address if it has already been built
+    // and if it still matches the given instruction word. This does not
+    // update the counters.
+    @inline(__always)
+    public func cachedEntry(at pc: UInt16, ins: UInt16) -> Entry? {
+        let index = Int(pc)
+        guard index < entries.count, let entry = entries[index], entry.ins == ins else {
+            return nil
+        }
+        return entry
+    }
+
+    // Get the control word for the instruction given the current flags.
+    @inline(__always)
+    public func controlWord(_ entry: Entry, n: UInt, c: UInt, z: UInt, v: UInt) -> UInt {
+        guard entry.isConditional else {
+            return entry.ctl
+        }
+        let address = (n << 8) | (v << 7) | (z << 6) | (c << 5) | UInt(entry.opcode)
+        return opcodeDecodeTable[Int(address)]
+    }
+
+    // Decode an instruction word without consulting or updating the cache
+    public func predecode(_ ins: UInt16) -> Entry {
+        let opcode = Int((ins >> 11) & 31)
+        return Entry(
+            ins: ins,
+            opcode: UInt8(opcode),
+            selA: UInt8((ins >> 5) & 0b111),
+            selB: UInt8((ins >> 2) & 0b111),
+            selC: UInt8((ins >> 8) & 0b111),
+            imm: ins & 0x07ff,
+            ctl: opcodeDecodeTable[opcode],
+            isConditional: isConditionalOpcode[opcode]
+        )
+    }
+
+    private func rebuildDecoderTables() {
+        if let rom = decoder as? OpcodeDecoderROM {
+            opcodeDecodeTable = rom.opcodeDecodeROM
+        }
+        else {
+            opcodeDecodeTable = (0..<decoder.count).map { decoder.decode($0) }
+        }
+
+        // The flags occupy the four address bits above the opcode.
+        isConditionalOpcode = (0..<32).map { opcode in
+            let ctl = opcodeDecodeTable[opcode]
+            return (1..<16).contains { flags in
+                opcodeDecodeTable[(flags << 5) | opcode] != ctl
+            }
+        }
+
+        nop = predecode(0)
+    }
+}
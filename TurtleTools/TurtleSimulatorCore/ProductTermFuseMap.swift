@@ -16,6 +16,12 @@ public struct ProductTermFuseMap {
     public static let numberOfTerms = 44
     private let fuseList: [UInt]
 
+    // The product term compiled to a pair of bitmasks over the packed pin
+    // word, where bit i holds the logic level of pin i. The term is asserted
+    // when every pin in `highMask' is high and every pin in `lowMask' is low.
+    public let highMask: UInt32
+    public let lowMask: UInt32
+
     public init(fuseListBitmap: UInt) {
         assert(fuseListBitmap <= 0b1111_11111111_11111111_11111111_11111111_11111111)
         var fuseList: [UInt] = []
@@ -30,6 +36,35 @@ public struct ProductTermFuseMap {
     public init(fuseList: [UInt]) {
         assert(fuseList.count == ProductTermFuseMap.numberOfTerms)
         self.fuseList = fuseList
+
+        // An intact fuse, represented by a zero, connects the corresponding
+        // literal to the product term.
+        var highMask: UInt32 = 0
+        var lowMask: UInt32 = 0
+        for i in 1...11 {
+            let base = (i - 1) * 4
+            if (fuseList[base + 0] & 1) == 0 {
+                highMask |= 1 << i
+            }
+            if (fuseList[base + 1] & 1) == 0 {
+                lowMask |= 1 << i
+            }
+            if (fuseList[base + 2] & 1) == 0 {
+                highMask |= 1 << (24 - i)
+            }
+            if (fuseList[base + 3] & 1) == 0 {
+                lowMask |= 1 << (24 - i)
+            }
+        }
+        self.highMask = highMask
+        self.lowMask = lowMask
+    }
+
+    // Evaluate the compiled product term against the packed pin word.
+    // This is equivalent to ANDing together the terms returned by evaluate().
+    @inline(__always)
+    public func evaluate(pins: UInt32) -> UInt {
+        ((pins & highMask) == highMask && (pins & lowMask) == 0) ? 1 : 0
     }
 
     public func evaluate(_ inputs: [UInt]) -> [UInt] {
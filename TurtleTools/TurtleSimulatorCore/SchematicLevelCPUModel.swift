@@ -33,11 +33,20 @@ public class SchematicLevelCPUModel: NSObject, CPU {
     public var pc: UInt16 = 0
     var prevPC: UInt16 = 0
 
-    public var instructions: [UInt16] = .init(repeating: 0, count: 65535)
+    public var instructions: [UInt16] = .init(repeating: 0, count: 65535) {
+        didSet {
+            predecodeCache.instructions = instructions
+        }
+    }
+
+    // IF fetches instructions through the predecode cache, and ID uses the
+    // cached control word when the instruction came from the cache.
+    public let predecodeCache: PredecodeCache
 
     public var decoder: InstructionDecoder {
         set(value) {
             stageID.decoder = value
+            predecodeCache.decoder = value
         }
         get {
             stageID.decoder
@@ -131,6 +140,9 @@ public class SchematicLevelCPUModel: NSObject, CPU {
     public var outputMEM: MEM_Output
     public var outputWB: WB_Output
 
+    // Reads the clock once per batch of cycles in run(until:)
+    let runLoop = BatchedRunLoop()
+
     public override init() {
         stageIF = IF()
         stageID = ID()
@@ -156,18 +168,22 @@ public class SchematicLevelCPUModel: NSObject, CPU {
         outputMEM = MEM_Output(y: 0, storeOp: 0, selC: 0, ctl: 0b11111_11111111_11111111)
         outputWB = WB_Output(c: 0, wrl: 1, wrh: 1, wben: 1)
 
-        super.init()
-        stageIF.load = { [weak self] (addr: UInt16) in
-            if addr < self!.instructions.count {
-                return self!.instructions[Int(addr)]
-            }
-            return 0
-        }
-
-        //        stageID.decoder = ProgrammableLogicDecoder()
         let rom = OpcodeDecoderROM()
         rom.opcodeDecodeROM = DecoderGenerator().generate()
+        predecodeCache = PredecodeCache(decoder: rom)
+
+        super.init()
+        //        stageID.decoder = ProgrammableLogicDecoder()
         stageID.decoder = rom
+        predecodeCache.instructions = instructions
+        connectPredecodeCache()
+    }
+
+    private func connectPredecodeCache() {
+        stageIF.load = { [weak self] (addr: UInt16) in
+            self!.predecodeCache.entry(at: addr).ins
+        }
+        stageID.predecodeCache = predecodeCache
     }
 
     public required init?(coder: NSCoder) {
@@ -175,7 +191,6 @@ public class SchematicLevelCPUModel: NSObject, CPU {
               let resetCounter = coder.decodeObject(forKey: "resetCounter") as? UInt,
               let pc = coder.decodeObject(forKey: "pc") as? UInt16,
               let prevPC = coder.decodeObject(forKey: "prevPC") as? UInt16,
-              let instructions = coder.decodeObject(forKey: "instructions") as? [UInt16],
               let n = coder.decodeObject(forKey: "n") as? UInt,
               let c = coder.decodeObject(forKey: "c") as? UInt,
               let v = coder.decodeObject(forKey: "v") as? UInt,
@@ -185,14 +200,15 @@ public class SchematicLevelCPUModel: NSObject, CPU {
               let stageEX = coder.decodeObject(of: EX.self, forKey: "stageEX"),
               let stageMEM = coder.decodeObject(of: MEM.self, forKey: "stageMEM"),
               let stageWB = coder.decodeObject(of: WB.self, forKey: "stageWB"),
-              let outputIF = coder.decodeObject(of: IF_Output.self, forKey: "outputIF"),
-              let outputID = coder.decodeObject(of: ID_Output.self, forKey: "outputID"),
-              let outputEX = coder.decodeObject(of: EX_Output.self, forKey: "outputEX"),
-              let outputMEM = coder.decodeObject(of: MEM_Output.self, forKey: "outputMEM"),
-              let outputWB = coder.decodeObject(of: WB_Output.self, forKey: "outputWB")
+              let latches = coder.decodeObject(
+                  of: PipelineLatchSnapshot.self,
+                  forKey: "latches"
+              ) ?? PipelineLatchSnapshot.decodeLegacyLatches(from: coder)
         else {
             return nil
         }
+        let instructions = coder.decodeObject(forKey: "instructions") as? [UInt16]
+            ?? [UInt16](repeating: 0, count: 65535)
         self.timeStamp = timeStamp
         self.resetCounter = resetCounter
         self.pc = pc
@@ -207,20 +223,15 @@ public class SchematicLevelCPUModel: NSObject, CPU {
         self.stageEX = stageEX
         self.stageMEM = stageMEM
         self.stageWB = stageWB
-        self.outputIF = outputIF
-        self.outputID = outputID
-        self.outputEX = outputEX
-        self.outputMEM = outputMEM
-        self.outputWB = outputWB
+        outputIF = latches.outputIF
+        outputID = latches.outputID
+        outputEX = latches.outputEX
+        outputMEM = latches.outputMEM
+        outputWB = latches.outputWB
+        predecodeCache = PredecodeCache(instructions: instructions, decoder: stageID.decoder)
 
         super.init()
-
-        self.stageIF.load = { [weak self] (addr: UInt16) in
-            if addr < self!.instructions.count {
-                return self!.instructions[Int(addr)]
-            }
-            return 0
-        }
+        connectPredecodeCache()
     }
 
     public func encode(with coder: NSCoder) {
@@ -228,7 +239,9 @@ public class SchematicLevelCPUModel: NSObject, CPU {
         coder.encode(resetCounter, forKey: "resetCounter")
         coder.encode(pc, forKey: "pc")
         coder.encode(prevPC, forKey: "prevPC")
-        coder.encode(instructions, forKey: "instructions")
+        if coder.encodesInstructionMemory {
+            coder.encode(instructions, forKey: "instructions")
+        }
         coder.encode(n, forKey: "n")
         coder.encode(z, forKey: "z")
         coder.encode(c, forKey: "c")
@@ -238,11 +251,14 @@ public class SchematicLevelCPUModel: NSObject, CPU {
         coder.encode(stageEX, forKey: "stageEX")
         coder.encode(stageMEM, forKey: "stageMEM")
         coder.encode(stageWB, forKey: "stageWB")
-        coder.encode(outputIF, forKey: "outputIF")
-        coder.encode(outputID, forKey: "outputID")
-        coder.encode(outputEX, forKey: "outputEX")
-        coder.encode(outputMEM, forKey: "outputMEM")
-        coder.encode(outputWB, forKey: "outputWB")
+        let latches = PipelineLatchSnapshot(
+            outputIF: outputIF,
+            outputID: outputID,
+            outputEX: outputEX,
+            outputMEM: outputMEM,
+            outputWB: outputWB
+        )
+        coder.encode(latches, forKey: "latches")
     }
 
     public static func decode(from data: Data) throws -> SchematicLevelCPUModel {
@@ -334,13 +350,7 @@ public class SchematicLevelCPUModel: NSObject, CPU {
     }
 
     public func run(until date: Date = Date.distantFuture) -> Bool {
-        repeat {
-            step()
-            if Date.now > date {
-                return false
-            }
-        } while !isHalted
-        return true
+        runLoop.run(self, until: date)
     }
 
     public func run() {
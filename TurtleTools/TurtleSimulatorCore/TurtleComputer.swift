@@ -24,6 +24,9 @@ public extension Notification.Name {
 public class TurtleComputer: NSObject, NSSecureCoding {
     public static var supportsSecureCoding = true
     public private(set) var cpu: CPU
+
+    // Calibrates the number of cycles run between reads of the clock
+    public let runLoop = BatchedRunLoop()
     public var ram: [UInt16]
     public var decoder: InstructionDecoder {
         set(value) {
@@ -125,6 +128,18 @@ public class TurtleComputer: NSObject, NSSecureCoding {
         isFreeRunningInternal = isFreeRunning
         isFreeRunningLock.name = "TurtleComputer.isFreeRunningLock"
         super.init()
+        connectMemoryAccessClosures()
+    }
+
+    public convenience init(_ snapshot: ComputerSnapshot) {
+        let cpu = snapshot.makeCPU()
+        cpu.instructions = snapshot.instructions.words
+        self.init(cpu: cpu, ram: snapshot.ram.words)
+        bank = snapshot.bank
+        lastSnapshot = snapshot
+    }
+
+    private func connectMemoryAccessClosures() {
         cpu.store = { [weak self] in
             self?.store(value: $0, address: $1)
         }
@@ -153,7 +168,8 @@ public class TurtleComputer: NSObject, NSSecureCoding {
     }
 
     public required convenience init?(coder: NSCoder) {
-        guard let cpu = coder.decodeObject(of: SchematicLevelCPUModel.self, forKey: "cpu"),
+        let cpuClasses = [SchematicLevelCPUModel.self, FastCPUModel.self, LockstepCPUModel.self]
+        guard let cpu = coder.decodeObject(of: cpuClasses, forKey: "cpu") as? CPU,
               let ram = coder.decodeObject(forKey: "ram") as? [UInt16]
         else {
             return nil
@@ -209,11 +225,21 @@ public class TurtleComputer: NSObject, NSSecureCoding {
     }
 
     public func run() {
-        _ = cpu.run(until: Date.distantFuture)
+        _ = runLoop.run(cpu)
     }
 
     public func run(until date: Date = Date.distantFuture) -> Bool {
-        cpu.run(until: date)
+        runLoop.run(cpu, until: date)
+    }
+
+    // Run until the CPU halts, until it has run the specified number of
+    // cycles, or until the deadline passes. The clock is only read between
+    // batches of cycles. The result reports the number of cycles run.
+    public func run(
+        cycles: UInt = UInt.max,
+        until deadline: DispatchTime = .distantFuture
+    ) -> BatchedRunLoop.Result {
+        runLoop.run(cpu, cycles: cycles, until: deadline)
     }
 
     public func step() {
@@ -291,7 +317,41 @@ public class TurtleComputer: NSObject, NSSecureCoding {
         }
         cpu = decodedComputer.cpu
         ram = decodedComputer.ram
+        connectMemoryAccessClosures()
         cachedDisassembly = nil
+        NotificationCenter.default.post(name: .computerStateDidChange, object: makeSnapshot())
+    }
+
+    // The snapshot most recently taken or restored. The next snapshot shares
+    // the pages of memory which are unchanged since then.
+    private var lastSnapshot: ComputerSnapshot?
+
+    // Take a snapshot of the computer. This is much cheaper than snapshot()
+    // in both time and space because only the pages of memory which changed
+    // since the previous snapshot are copied.
+    public func makeSnapshot() -> ComputerSnapshot {
+        let snapshot = ComputerSnapshot(self, previous: lastSnapshot)
+        lastSnapshot = snapshot
+        return snapshot
+    }
+
+    // Restore the computer to the state in the given snapshot. Only those
+    // pages of memory which differ from the snapshot are copied.
+    public func restore(from snapshot: ComputerSnapshot) {
+        let restoredCPU = snapshot.makeCPU()
+        var instructions = cpu.instructions
+        let copiedInstructionPageCount = snapshot.instructions.copy(into: &instructions)
+        restoredCPU.instructions = instructions
+        snapshot.ram.copy(into: &ram)
+        cpu = restoredCPU
+        connectMemoryAccessClosures()
+        if bank != snapshot.bank {
+            bank = snapshot.bank
+        }
+        if copiedInstructionPageCount > 0 {
+            cachedDisassembly = nil
+        }
+        lastSnapshot = snapshot
         NotificationCenter.default.post(name: .computerStateDidChange, object: snapshot)
     }
 }
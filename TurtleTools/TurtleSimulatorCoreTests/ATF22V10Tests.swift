@@ -137,6 +137,60 @@ final class ATF22V10Tests: XCTestCase {
         XCTAssertEqual(step3[0], 1)
     }
 
+    func testCompiledTwoInputAND_UsingIOPinsForInput() throws {
+        var fuseList = [UInt](repeating: 1, count: 5892)
+        fuseList[90] = 0
+        fuseList[94] = 0
+        for i in 132..<440 {
+            fuseList[i] = 0
+        }
+
+        let gal = ATF22V10(fuseList: fuseList)
+        let driven: UInt32 = 0b11000000_00111111_11111111
+        for a: UInt32 in 0...1 {
+            for b: UInt32 in 0...1 {
+                let output = gal.step(pins: (a << 23) | (b << 22), driven: driven)
+                XCTAssertEqual(output[0], UInt(a & b))
+            }
+        }
+    }
+
+    func testCompiledFlipFlopToggle() throws {
+        var fuseList = [UInt](repeating: 1, count: 5892)
+        fuseList[90] = 0
+        for i in 132..<440 {
+            fuseList[i] = 0
+        }
+        fuseList[5808] = 1
+        fuseList[5809] = 0
+
+        let gal = ATF22V10(fuseList: fuseList)
+        let driven: UInt32 = 0b00111111_11111111
+        XCTAssertEqual(gal.step(pins: 0b00, driven: driven)[0], 1)
+        XCTAssertEqual(gal.step(pins: 0b10, driven: driven)[0], 0)
+        XCTAssertEqual(gal.step(pins: 0b00, driven: driven)[0], 0)
+        XCTAssertEqual(gal.step(pins: 0b10, driven: driven)[0], 1)
+    }
+
+    func testCompiledEvaluationMatchesFuseMapForHazardControl() throws {
+        for name in ["HazardControl1", "HazardControl2"] {
+            let reference = HazardControlGAL.makeGAL(name)
+            let compiled = HazardControlGAL.makeGAL(name)
+            for word: UInt32 in 0..<(1 << 12) {
+                let pins = word << 2
+                var inputs = (0..<24).map { i -> UInt? in UInt((pins >> i) & 1) }
+                for i in 14..<24 {
+                    inputs[i] = nil
+                }
+                let expected = reference.step(inputs: inputs)
+                let actual = compiled.step(pins: pins, driven: 0b00111111_11111111)
+                for k in 0..<10 {
+                    XCTAssertEqual(actual[k], expected[k], "\(name): pins=\(pins), olmc=\(k)")
+                }
+            }
+        }
+    }
+
     func testSimpleJEDECFile_Inverter() throws {
         let maker = FuseListMaker()
         let parser = JEDECFuseFileParser(maker)
@@ -2572,4 +2572,22 @@ final class AssemblerCompilerTests: XCTestCase {
             """
         )
     }
+
+    func testSourceAnchorIndexMapsEachInstructionToItsNode() throws {
+        let lineMapper = SourceLineRangeMapper(text: "NOP\nENTER\nHLT")
+        let nop = lineMapper.anchor(0, 3)
+        let enter = lineMapper.anchor(4, 9)
+        let compiler = AssemblerCompiler()
+        compiler.compile(ast: [
+            InstructionNode(sourceAnchor: nop, instruction: kNOP),
+            InstructionNode(sourceAnchor: enter, instruction: kENTER),
+            InstructionNode(instruction: kHLT)
+        ])
+        XCTAssertFalse(compiler.hasError)
+        let index = compiler.sourceAnchorIndex
+        XCTAssertEqual(index[pc: 0], nop)
+        XCTAssertEqual(index[pc: 1], enter)
+        XCTAssertEqual(index[pc: compiler.instructions.count - 2], enter)
+        XCTAssertEqual(index.runCount, 2)
+    }
 }
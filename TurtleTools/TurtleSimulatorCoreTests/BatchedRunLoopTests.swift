@@ -0,0 +1,93 @@
+//
+//  BatchedRunLoopTests.swift
+//  TurtleSimulatorCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleSimulatorCore
+import XCTest
+
+final class BatchedRunLoopTests: XCTestCase {
+    fileprivate func makeCountdownCPU(_ count: UInt8) -> SchematicLevelCPUModel {
+        let cpu = SchematicLevelCPUModel()
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100111_00000000 | UInt16(count), // LI r7, count
+            0b01111111_11100001, // SUBI r7, r7, 1
+            0b11001111_11111101, // BNZ -3
+            0b00001000_00000000 // HLT
+        ]
+        cpu.reset()
+        return cpu
+    }
+
+    fileprivate func makeInfiniteLoopCPU() -> SchematicLevelCPUModel {
+        let cpu = SchematicLevelCPUModel()
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b10100111_11111110 // JMP -2, which branches to itself
+        ]
+        cpu.reset()
+        return cpu
+    }
+
+    func testRunUntilHalted() {
+        let cpu = makeCountdownCPU(5)
+        let runLoop = BatchedRunLoop()
+        let result = runLoop.run(cpu)
+        XCTAssertEqual(result.stopReason, .halted)
+        XCTAssertEqual(result.cyclesRun, cpu.timeStamp)
+        XCTAssertTrue(cpu.isHalted)
+        XCTAssertEqual(cpu.getRegister(7), 0)
+    }
+
+    func testRunStopsAtTheCycleLimit() {
+        let cpu = makeInfiniteLoopCPU()
+        let runLoop = BatchedRunLoop()
+        let result = runLoop.run(cpu, cycles: 1000)
+        XCTAssertEqual(result, BatchedRunLoop.Result(cyclesRun: 1000, stopReason: .cycleLimit))
+        XCTAssertEqual(cpu.timeStamp, 1000)
+    }
+
+    func testRunStopsAtTheDeadline() {
+        let cpu = makeInfiniteLoopCPU()
+        let runLoop = BatchedRunLoop(batchSize: 100)
+        let result = runLoop.run(cpu, until: .now())
+        XCTAssertEqual(result, BatchedRunLoop.Result(cyclesRun: 100, stopReason: .deadline))
+    }
+
+    func testRunUntilDateReturnsFalseWhenNotHalted() {
+        let cpu = makeInfiniteLoopCPU()
+        XCTAssertFalse(cpu.run(until: Date.now))
+        XCTAssertFalse(cpu.isHalted)
+    }
+
+    func testBatchSizeAdaptsToTheTargetLatency() {
+        let cpu = makeInfiniteLoopCPU()
+        let runLoop = BatchedRunLoop(targetLatency: 1_000_000, batchSize: 64)
+        for _ in 0..<20 {
+            _ = runLoop.run(cpu, until: .now())
+        }
+        XCTAssertGreaterThan(runLoop.batchSize, BatchedRunLoop.minimumBatchSize)
+        XCTAssertLessThanOrEqual(runLoop.batchSize, BatchedRunLoop.maximumBatchSize)
+    }
+
+    func testTurtleComputerReportsCyclesRun() {
+        let computer = TurtleComputer(SchematicLevelCPUModel())
+        computer.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100111_00000101, // LI r7, 5
+            0b01111111_11100001, // SUBI r7, r7, 1
+            0b11001111_11111101, // BNZ -3
+            0b00001000_00000000 // HLT
+        ]
+        computer.reset()
+        let result = computer.run(cycles: 10)
+        XCTAssertEqual(result, BatchedRunLoop.Result(cyclesRun: 10, stopReason: .cycleLimit))
+        let rest = computer.run(cycles: UInt.max)
+        XCTAssertEqual(rest.stopReason, .halted)
+        XCTAssertEqual(result.cyclesRun + rest.cyclesRun, computer.timeStamp)
+    }
+}
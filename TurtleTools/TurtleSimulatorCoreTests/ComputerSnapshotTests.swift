@@ -0,0 +1,96 @@
+//
+//  ComputerSnapshotTests.swift
+//  TurtleSimulatorCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleSimulatorCore
+import XCTest
+
+final class ComputerSnapshotTests: XCTestCase {
+    func makeComputer(_ cpu: CPU = SchematicLevelCPUModel()) -> TurtleComputer {
+        let assembler = Assembler()
+        assembler.compile(
+            """
+            LI r0, 42
+            LI r1, 100
+            STORE r0, r1, 0
+            HLT
+            """
+        )
+        XCTAssertFalse(assembler.hasError)
+        let computer = TurtleComputer(cpu)
+        computer.instructions = assembler.instructions
+        computer.reset()
+        return computer
+    }
+
+    func testRestoreUndoesTheChangesMadeSinceTheSnapshot() throws {
+        let computer = makeComputer()
+        let expected = try TurtleComputer.decode(from: computer.snapshot())
+        let snapshot = computer.makeSnapshot()
+        computer.run()
+        XCTAssertEqual(computer.ram[100], 42)
+        computer.restore(from: snapshot)
+        XCTAssertEqual(computer.ram[100], 0)
+        XCTAssertEqual(computer.pc, 0)
+        XCTAssertEqual(computer, expected)
+    }
+
+    func testRestoredComputerCanRunAgain() throws {
+        let computer = makeComputer(FastCPUModel())
+        let snapshot = computer.makeSnapshot()
+        computer.run()
+        let expected = try TurtleComputer.decode(from: computer.snapshot())
+        computer.restore(from: snapshot)
+        computer.run()
+        XCTAssertEqual(computer.ram[100], 42)
+        XCTAssertEqual(computer, expected)
+    }
+
+    func testSnapshotSharesPagesWhichHaveNotChanged() throws {
+        let computer = makeComputer()
+        let first = computer.makeSnapshot()
+        XCTAssertEqual(first.ram.newPageCount, first.ram.pageCount)
+
+        let second = computer.makeSnapshot()
+        XCTAssertEqual(second.ram.newPageCount, 0)
+        XCTAssertEqual(second.instructions.newPageCount, 0)
+
+        computer.run()
+        let third = computer.makeSnapshot()
+        XCTAssertEqual(third.ram.newPageCount, 1)
+        XCTAssertEqual(third.instructions.newPageCount, 0)
+        XCTAssertEqual(third.ram[100], 42)
+        XCTAssertLessThan(third.byteCount, first.byteCount)
+    }
+
+    func testRestoreCopiesOnlyThePagesWhichDiffer() throws {
+        var words = [UInt16](repeating: 0, count: 3 * PagedMemory.kPageSize)
+        let memory = PagedMemory(words)
+        words[PagedMemory.kPageSize + 1] = 1
+        XCTAssertEqual(memory.copy(into: &words), 1)
+        XCTAssertEqual(words, memory.words)
+        XCTAssertEqual(memory.copy(into: &words), 0)
+    }
+
+    func testMemoryNeedNotBeAMultipleOfThePageSize() throws {
+        let words = (0..<(PagedMemory.kPageSize + 3)).map { UInt16($0) }
+        let memory = PagedMemory(words)
+        XCTAssertEqual(memory.pageCount, 2)
+        XCTAssertEqual(memory.words, words)
+        XCTAssertEqual(memory[PagedMemory.kPageSize + 2], UInt16(PagedMemory.kPageSize + 2))
+
+        var other = [UInt16](repeating: 0, count: 1)
+        XCTAssertEqual(memory.copy(into: &other), 2)
+        XCTAssertEqual(other, words)
+    }
+
+    func testComputerBuiltFromSnapshotIsEqualToTheOriginal() throws {
+        let computer = makeComputer()
+        computer.run()
+        XCTAssertEqual(TurtleComputer(computer.makeSnapshot()), computer)
+    }
+}
@@ -486,6 +486,7 @@ final class DebugConsoleCommandLineInterpreterTests: XCTestCase {
         let interpreter = DebugConsoleCommandLineInterpreter(computer)
         interpreter.runOne(instruction: .run)
         XCTAssertTrue(computer.cpu.isHalted)
+        XCTAssertEqual(interpreter.lastRunCycleCount, computer.timeStamp)
     }
 
     func testInputFibonacciProgramAndRunIt() throws {
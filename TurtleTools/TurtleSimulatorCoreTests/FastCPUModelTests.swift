@@ -0,0 +1,258 @@
+//
+//  FastCPUModelTests.swift
+//  TurtleSimulatorCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleSimulatorCore
+import XCTest
+
+final class FastCPUModelTests: XCTestCase {
+    fileprivate func runInLockstep(
+        _ instructions: [UInt16],
+        stepLimit: UInt,
+        setup: (LockstepCPUModel) -> Void = { _ in }
+    ) -> LockstepCPUModel {
+        let cpu = LockstepCPUModel()
+        var ram = [UInt16](repeating: 0, count: Int(UInt16.max) + 1)
+        cpu.load = { (addr: MemoryAddress) in
+            ram[addr.value]
+        }
+        cpu.store = { (value: UInt16, addr: MemoryAddress) in
+            ram[addr.value] = value
+        }
+        cpu.instructions = instructions
+        cpu.reset()
+        setup(cpu)
+        var counter: UInt = 0
+        while !cpu.isHalted, cpu.firstDivergence == nil {
+            cpu.step()
+            counter = counter + 1
+            if counter > stepLimit {
+                XCTFail("program did not halt within \(stepLimit) steps")
+                break
+            }
+        }
+        XCTAssertNil(cpu.firstDivergence, cpu.firstDivergence?.description ?? "")
+        return cpu
+    }
+
+    func testStartsInResetState() {
+        let cpu = FastCPUModel()
+        XCTAssertTrue(cpu.isResetting)
+    }
+
+    func testExitsResetStateAfterSomeTime() {
+        let cpu = FastCPUModel()
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00001000_00000000 // HLT
+        ]
+        cpu.reset()
+        XCTAssertFalse(cpu.isResetting)
+        XCTAssertFalse(cpu.isHalted)
+    }
+
+    func testLoad() {
+        var observedLoadAddr: UInt16? = nil
+        let cpu = FastCPUModel()
+        cpu.load = { (addr: MemoryAddress) in
+            if observedLoadAddr != nil {
+                XCTFail()
+            }
+            observedLoadAddr = UInt16(addr.value)
+            return 0xabcd
+        }
+        cpu.store = { (_: UInt16, _: MemoryAddress) in
+            XCTFail()
+        }
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00010011_00100001 // LOAD r3, 1(r1)
+        ]
+        cpu.reset()
+        cpu.setRegister(1, 0xfffe)
+        cpu.step() // -
+        cpu.step() // IF
+        cpu.step() // ID
+        cpu.step() // EX
+        cpu.step() // MEM
+        cpu.step() // WB
+        XCTAssertEqual(0xabcd, cpu.getRegister(3))
+        XCTAssertEqual(0xffff, observedLoadAddr)
+    }
+
+    func testStore() {
+        var observedStoreAddr: MemoryAddress? = nil
+        var observedStoreVal: UInt16? = nil
+        let cpu = FastCPUModel()
+        cpu.store = { (value: UInt16, addr: MemoryAddress) in
+            XCTAssertNil(observedStoreVal)
+            XCTAssertNil(observedStoreAddr)
+            observedStoreVal = value
+            observedStoreAddr = addr
+        }
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00011111_00101111 // STORE r3, r1, -1
+        ]
+        cpu.reset()
+        cpu.setRegister(1, 0x0000)
+        cpu.setRegister(3, 0xabcd)
+        cpu.step() // -
+        cpu.step() // IF
+        cpu.step() // ID
+        cpu.step() // EX
+        cpu.step() // MEM
+        XCTAssertEqual(observedStoreAddr?.value, 0xffff)
+        XCTAssertEqual(observedStoreVal, 0xabcd)
+    }
+
+    func testLockstep_Countdown() {
+        let cpu = runInLockstep([
+            0b00000000_00000000, // NOP
+            0b00100111_00000101, // LI r7, 5
+            0b01111111_11100001, // SUBI r7, r7, 1
+            0b11001111_11111101, // BNZ -3
+            0b00001000_00000000 // HLT
+        ], stepLimit: 30)
+        XCTAssertEqual(cpu.fast.getRegister(7), 0)
+    }
+
+    func testLockstep_Fibonacci() {
+        let cpu = runInLockstep([
+            0b00000000_00000000, // NOP
+            0b00100000_00000000, // LI r0, 0
+            0b00100001_00000001, // LI r1, 1
+            0b00100111_00000000, // LI r7, 0
+            0b00111010_00000100, // ADD r2, r0, r1
+            0b01110000_00100000, // ADDI r0, r1, 0
+            0b01110111_11100001, // ADDI r7, r7, 1
+            0b01110001_01000000, // ADDI r1, r2, 0
+            0b01101000_11101001, // CMPI r7, 9
+            0b11010111_11111001, // BLT -7
+            0b00001000_00000000 // HLT
+        ], stepLimit: 89)
+        XCTAssertEqual(cpu.fast.getRegister(2), 55)
+    }
+
+    func testLockstep_JalrAndThenReturn() {
+        let cpu = runInLockstep([
+            0b00000000_00000000, // NOP
+            0b10110111_00100000, // JALR r7, r1, 0
+            0b00001000_00000000, // HLT
+            0b00000000_00000010, // NOP
+            0b00100110_00001101, // LI r6, 13
+            0b10101000_11111111, // JR r7, -1
+            0b00001000_00000000 // HLT
+        ], stepLimit: 20) {
+            $0.setRegister(1, 4)
+        }
+        XCTAssertEqual(cpu.fast.getRegister(6), 13)
+        XCTAssertEqual(cpu.fast.getRegister(7), 3)
+    }
+
+    func testLockstep_HazardMemoryLoad() {
+        let cpu = runInLockstep([
+            0b00000000_00000000, // NOP
+            0b00100111_00001010, // LI r7, 10
+            0b00100001_00000011, // LI r1, 3
+            0b00011000_11100100, // STORE r1, r7, 0
+            0b00010000_11100000, // LOAD r0, r7
+            0b00111010_00000100, // ADD r2, r0, r1
+            0b00001000_00000000 // HLT
+        ], stepLimit: 30)
+        XCTAssertEqual(cpu.fast.getRegister(2), 6)
+    }
+
+    func testLockstep_AddWithCarry() {
+        let cpu = runInLockstep([
+            0b00000000_00000000, // NOP
+            0b00111000_00101000, // ADD r0, r1, r2
+            0b11110011_00101000, // ADC r3, r1, r2
+            0b00001000_00000000 // HLT
+        ], stepLimit: 20) {
+            $0.setRegister(1, 0xffff)
+            $0.setRegister(2, 0x0001)
+        }
+        XCTAssertEqual(cpu.fast.getRegister(0), 0)
+        XCTAssertEqual(cpu.fast.getRegister(3), cpu.reference.getRegister(3))
+    }
+
+    func testLockstep_ConditionalBranches() {
+        let branches: [UInt16] = [
+            0b11000011_11111111, // BEQ 1023
+            0b11001011_11111111, // BNE 1023
+            0b11010011_11111111, // BLT 1023
+            0b11011011_11111111, // BGT 1023
+            0b11100011_11111111, // BLTU 1023
+            0b11101011_11111111 // BGTU 1023
+        ]
+        for branch in branches {
+            for (a, b) in [(1, 1), (1, 2), (2, 1), (0xffff, 1)] as [(UInt16, UInt16)] {
+                // Whether or not the branch is taken, it lands on a HLT.
+                var instructions: [UInt16] = [
+                    0b00000000_00000000, // NOP
+                    0b00110000_00101000, // CMP r1, r2
+                    branch
+                ]
+                instructions += [UInt16](repeating: 0b00001000_00000000, count: 1100)
+                _ = runInLockstep(instructions, stepLimit: 20) {
+                    $0.setRegister(1, a)
+                    $0.setRegister(2, b)
+                }
+            }
+        }
+    }
+
+    func testLockstep_DetectsDivergence() {
+        let cpu = LockstepCPUModel()
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100111_00000101, // LI r7, 5
+            0b00001000_00000000 // HLT
+        ]
+        cpu.reset()
+        cpu.fast.setRegister(3, 0xbeef)
+        cpu.step()
+        XCTAssertEqual(cpu.firstDivergence?.what, "r3")
+    }
+
+    func testEquality_Equal() throws {
+        let cpu1 = FastCPUModel()
+        cpu1.instructions = [0x000, 0x0800]
+        cpu1.reset()
+        cpu1.run()
+
+        let cpu2 = FastCPUModel()
+        cpu2.instructions = [0x000, 0x0800]
+        cpu2.reset()
+        cpu2.run()
+
+        XCTAssertEqual(cpu1, cpu2)
+        XCTAssertEqual(cpu1.hash, cpu2.hash)
+    }
+
+    func testEncodeDecodeRoundTrip() throws {
+        let cpu1 = FastCPUModel()
+        cpu1.instructions = [0x000, 0x0800]
+        cpu1.reset()
+        cpu1.run()
+        var data: Data! = nil
+        XCTAssertNoThrow(
+            data = try NSKeyedArchiver.archivedData(
+                withRootObject: cpu1,
+                requiringSecureCoding: true
+            )
+        )
+        if data == nil {
+            XCTFail()
+            return
+        }
+        var cpu2: FastCPUModel! = nil
+        XCTAssertNoThrow(cpu2 = try FastCPUModel.decode(from: data))
+        XCTAssertEqual(cpu1, cpu2)
+    }
+}
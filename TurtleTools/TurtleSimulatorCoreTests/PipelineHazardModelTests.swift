@@ -0,0 +1,134 @@
+//
+//  PipelineHazardModelTests.swift
+//  TurtleSimulatorCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleCore
+import TurtleSimulatorCore
+import XCTest
+
+final class PipelineHazardModelTests: XCTestCase {
+    let model = PipelineHazardModel.turtle16
+
+    fileprivate func countCycles(_ nodes: [InstructionNode]) throws -> UInt {
+        let compiler = AssemblerCompiler()
+        compiler.compile(ast: [InstructionNode(instruction: kNOP)] + nodes + [
+            InstructionNode(instruction: kHLT)
+        ])
+        if let error = compiler.errors.first {
+            throw error
+        }
+        let cpu = FastCPUModel()
+        cpu.load = { _ in 0 }
+        cpu.store = { _, _ in }
+        cpu.instructions = compiler.instructions
+        cpu.reset()
+        var counter: UInt = 0
+        while !cpu.isHalted {
+            cpu.step()
+            counter += 1
+            if counter > 1000 {
+                XCTFail("program did not halt")
+                break
+            }
+        }
+        return counter
+    }
+
+    fileprivate func ins(_ instruction: String, _ parameters: Parameter...) -> InstructionNode {
+        InstructionNode(instruction: instruction, parameters: parameters)
+    }
+
+    func testOpcodePropertiesFollowTheDecoder() throws {
+        let load = try XCTUnwrap(model.opcode(mnemonic: kLOAD))
+        XCTAssertTrue(load.writesBackStoreOperand)
+        XCTAssertFalse(load.setsFlags)
+
+        let li = try XCTUnwrap(model.opcode(mnemonic: kLI))
+        XCTAssertTrue(li.writesBackStoreOperand)
+        XCTAssertFalse(li.usesLeftOperand)
+        XCTAssertFalse(li.usesRightOperand)
+
+        let add = try XCTUnwrap(model.opcode(mnemonic: kADD))
+        XCTAssertFalse(add.writesBackStoreOperand)
+        XCTAssertTrue(add.setsFlags)
+        XCTAssertTrue(add.usesLeftOperand)
+        XCTAssertTrue(add.usesRightOperand)
+
+        let not = try XCTUnwrap(model.opcode(mnemonic: kNOT))
+        XCTAssertFalse(not.setsFlags)
+
+        let beq = try XCTUnwrap(model.opcode(mnemonic: kBEQ))
+        XCTAssertTrue(beq.readsFlags)
+        XCTAssertTrue(beq.isJump)
+
+        let jmp = try XCTUnwrap(model.opcode(mnemonic: kJMP))
+        XCTAssertFalse(jmp.readsFlags)
+        XCTAssertTrue(jmp.isJump)
+
+        let adc = try XCTUnwrap(model.opcode(mnemonic: kADC))
+        XCTAssertTrue(adc.readsFlags)
+        XCTAssertTrue(adc.setsFlags)
+
+        XCTAssertNil(model.opcode(mnemonic: kCALL))
+    }
+
+    func testTimelineStallsOnStoreOperand() {
+        var timeline = PipelineHazardModel.Timeline()
+        timeline.issue(reads: [], readsFlags: false, writesBackStoreOperand: 1, setsFlags: false)
+        XCTAssertEqual(timeline.stallCycles(reads: [1], readsFlags: false), 2)
+        XCTAssertEqual(timeline.stallCycles(reads: [2], readsFlags: false), 0)
+        timeline.issue(reads: [], readsFlags: false, writesBackStoreOperand: nil, setsFlags: false)
+        XCTAssertEqual(timeline.stallCycles(reads: [1], readsFlags: false), 1)
+        timeline.issue(reads: [], readsFlags: false, writesBackStoreOperand: nil, setsFlags: false)
+        XCTAssertEqual(timeline.stallCycles(reads: [1], readsFlags: false), 0)
+    }
+
+    func testTimelineStallsOnFlags() {
+        var timeline = PipelineHazardModel.Timeline()
+        timeline.issue(reads: [1], readsFlags: false, writesBackStoreOperand: nil, setsFlags: true)
+        XCTAssertEqual(timeline.stallCycles(reads: [], readsFlags: true), 1)
+        timeline.issue(reads: [], readsFlags: true, writesBackStoreOperand: nil, setsFlags: false)
+        XCTAssertEqual(timeline.totalStallCycles, 1)
+        XCTAssertEqual(timeline.cycle, 3)
+    }
+
+    func testTimelineAgreesWithTheCPUOnStoreOperandHazards() throws {
+        let stalled = try countCycles([
+            ins(kLI, ParameterIdentifier("r1"), ParameterNumber(1)),
+            ins(kADD, ParameterIdentifier("r2"), ParameterIdentifier("r1"), ParameterIdentifier("r1")),
+            ins(kLI, ParameterIdentifier("r3"), ParameterNumber(2)),
+            ins(kLI, ParameterIdentifier("r4"), ParameterNumber(3))
+        ])
+        let unstalled = try countCycles([
+            ins(kLI, ParameterIdentifier("r1"), ParameterNumber(1)),
+            ins(kLI, ParameterIdentifier("r3"), ParameterNumber(2)),
+            ins(kLI, ParameterIdentifier("r4"), ParameterNumber(3)),
+            ins(kADD, ParameterIdentifier("r2"), ParameterIdentifier("r1"), ParameterIdentifier("r1"))
+        ])
+        XCTAssertEqual(stalled - unstalled, UInt(model.storeOperandHazardDistance))
+    }
+
+    func testTimelineAgreesWithTheCPUOnFlagsHazards() throws {
+        let stalled = try countCycles([
+            ins(kLI, ParameterIdentifier("r1"), ParameterNumber(1)),
+            ins(kLI, ParameterIdentifier("r2"), ParameterNumber(2)),
+            ins(kLI, ParameterIdentifier("r3"), ParameterNumber(3)),
+            ins(kADD, ParameterIdentifier("r4"), ParameterIdentifier("r1"), ParameterIdentifier("r2")),
+            ins(kADC, ParameterIdentifier("r4"), ParameterIdentifier("r1"), ParameterIdentifier("r2")),
+            ins(kLI, ParameterIdentifier("r0"), ParameterNumber(4))
+        ])
+        let unstalled = try countCycles([
+            ins(kLI, ParameterIdentifier("r1"), ParameterNumber(1)),
+            ins(kLI, ParameterIdentifier("r2"), ParameterNumber(2)),
+            ins(kLI, ParameterIdentifier("r3"), ParameterNumber(3)),
+            ins(kADD, ParameterIdentifier("r4"), ParameterIdentifier("r1"), ParameterIdentifier("r2")),
+            ins(kLI, ParameterIdentifier("r0"), ParameterNumber(4)),
+            ins(kADC, ParameterIdentifier("r4"), ParameterIdentifier("r1"), ParameterIdentifier("r2"))
+        ])
+        XCTAssertEqual(stalled - unstalled, UInt(model.flagsHazardDistance))
+    }
+}
@@ -0,0 +1,137 @@
+//
+//  PredecodeCacheTests.swift
+//  TurtleSimulatorCoreTests
+//
+//  Created by Andrew Fox on 10/17/26.
+//  Copyright © 2026 Andrew Fox. All rights reserved.
+//
+
+import TurtleSimulatorCore
+import XCTest
+
+final class PredecodeCacheTests: XCTestCase {
+    fileprivate func makeDecoder() -> OpcodeDecoderROM {
+        let rom = OpcodeDecoderROM()
+        rom.opcodeDecodeROM = DecoderGenerator().generate()
+        return rom
+    }
+
+    func testFirstFetchIsAMissAndLaterFetchesAreHits() {
+        let cache = PredecodeCache(
+            instructions: [
+                0b00000000_00000000, // NOP
+                0b00001000_00000000 // HLT
+            ],
+            decoder: makeDecoder()
+        )
+        XCTAssertEqual(cache.entry(at: 1).ins, 0b00001000_00000000)
+        XCTAssertEqual(cache.misses, 1)
+        XCTAssertEqual(cache.hits, 0)
+        XCTAssertEqual(cache.entry(at: 1).ins, 0b00001000_00000000)
+        XCTAssertEqual(cache.entry(at: 1).ins, 0b00001000_00000000)
+        XCTAssertEqual(cache.misses, 1)
+        XCTAssertEqual(cache.hits, 2)
+    }
+
+    func testFetchOutsideInstructionMemoryIsNop() {
+        let cache = PredecodeCache(instructions: [0b00001000_00000000], decoder: makeDecoder())
+        XCTAssertEqual(cache.entry(at: 100), cache.nop)
+    }
+
+    func testSplitsOutFields() {
+        let cache = PredecodeCache(
+            instructions: [
+                0b00111010_00000100 // ADD r2, r0, r1
+            ],
+            decoder: makeDecoder()
+        )
+        let entry = cache.entry(at: 0)
+        XCTAssertEqual(entry.opcode, 0b00111)
+        XCTAssertEqual(entry.selC, 2)
+        XCTAssertEqual(entry.selA, 0)
+        XCTAssertEqual(entry.selB, 1)
+        XCTAssertEqual(entry.imm, 0b010_00000100)
+        XCTAssertFalse(entry.isConditional)
+    }
+
+    func testSettingInstructionsInvalidatesEntries() {
+        let cache = PredecodeCache(instructions: [0b00000000_00000000], decoder: makeDecoder())
+        XCTAssertEqual(cache.entry(at: 0).ins, 0b00000000_00000000)
+        cache.instructions = [0b00001000_00000000]
+        XCTAssertEqual(cache.entry(at: 0).ins, 0b00001000_00000000)
+        XCTAssertEqual(cache.misses, 2)
+        XCTAssertEqual(cache.hits, 0)
+    }
+
+    func testControlWordMatchesDecoderForAllFlags() {
+        let decoder = makeDecoder()
+        let cache = PredecodeCache(
+            instructions: (0..<32).map { UInt16($0) << 11 },
+            decoder: decoder
+        )
+        for opcode in 0..<32 {
+            let entry = cache.entry(at: UInt16(opcode))
+            for flags in 0..<16 {
+                let n = UInt(flags >> 3) & 1
+                let v = UInt(flags >> 2) & 1
+                let z = UInt(flags >> 1) & 1
+                let c = UInt(flags) & 1
+                XCTAssertEqual(
+                    cache.controlWord(entry, n: n, c: c, z: z, v: v),
+                    decoder.decode(n: n, c: c, z: z, v: v, opcode: UInt(opcode))
+                )
+            }
+        }
+    }
+
+    func testBranchesAreConditional() {
+        let cache = PredecodeCache(
+            instructions: [
+                0b11000011_11111111 // BEQ 1023
+            ],
+            decoder: makeDecoder()
+        )
+        XCTAssertTrue(cache.entry(at: 0).isConditional)
+    }
+
+    func testSettingInstructionsOnTurtleComputerInvalidatesEntries() {
+        let cpu = SchematicLevelCPUModel()
+        let computer = TurtleComputer(cpu)
+        computer.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100001_00000001, // LI r1, 1
+            0b00001000_00000000 // HLT
+        ]
+        computer.reset()
+        computer.run()
+        XCTAssertEqual(computer.getRegister(1), 1)
+        XCTAssertEqual(cpu.predecodeCache.entry(at: 1).ins, 0b00100001_00000001)
+
+        computer.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100001_00000010, // LI r1, 2
+            0b00001000_00000000 // HLT
+        ]
+        computer.reset()
+        computer.run()
+        XCTAssertEqual(computer.getRegister(1), 2)
+        XCTAssertEqual(cpu.predecodeCache.entry(at: 1).ins, 0b00100001_00000010)
+    }
+
+    func testTightLoopMostlyHits() {
+        let cpu = FastCPUModel()
+        cpu.instructions = [
+            0b00000000_00000000, // NOP
+            0b00100111_01100100, // LI r7, 100
+            0b01111111_11100001, // SUBI r7, r7, 1
+            0b11001111_11111101, // BNZ -3
+            0b00001000_00000000 // HLT
+        ]
+        cpu.reset()
+        cpu.predecodeCache.resetCounters()
+        cpu.run()
+        XCTAssertEqual(cpu.getRegister(7), 0)
+        XCTAssertLessThan(cpu.predecodeCache.misses, 10)
+        XCTAssertGreaterThan(cpu.predecodeCache.hits, 100)
+    }
+}
@@ -1729,6 +1729,21 @@ final class SchematicLevelCPUModelTests: XCTestCase {
         XCTAssertEqual(cpu1, cpu2)
     }
 
+    func testDecodeSessionWithLatchesInTheOldFormat() throws {
+        let cpu1 = SchematicLevelCPUModel()
+        cpu1.instructions = [0x000, 0x0800]
+        cpu1.reset()
+        cpu1.run()
+        let archiver = LegacyLatchArchiver(requiringSecureCoding: true)
+        for (cls, name) in PipelineLatchSnapshot.legacyClassNames {
+            archiver.setClassName(name, for: cls)
+        }
+        archiver.encode(cpu1, forKey: NSKeyedArchiveRootObjectKey)
+        archiver.finishEncoding()
+        let cpu2 = try SchematicLevelCPUModel.decode(from: archiver.encodedData)
+        XCTAssertEqual(cpu1, cpu2)
+    }
+
     func testCmp_SpotChecksForSignedLessThanComparison() {
         // BLT jumps on N!=V
         assertComparisonWorksAsExpectedForSpotChecks({ $0 < $1 }) {
@@ -1810,3 +1825,19 @@ final class SchematicLevelCPUModelTests: XCTestCase {
         return true
     }
 }
+
+// Archives the pipeline latches the way the CPU model did before they were
+// structs, with one object per latch under "outputIF" through "outputWB"
+private final class LegacyLatchArchiver: NSKeyedArchiver {
+    override func encode(_ object: Any?, forKey key: String) {
+        guard key == "latches", let latches = object as? PipelineLatchSnapshot else {
+            super.encode(object, forKey: key)
+            return
+        }
+        super.encode(LegacyIF_Output(latches.outputIF), forKey: "outputIF")
+        super.encode(LegacyID_Output(latches.outputID), forKey: "outputID")
+        super.encode(LegacyEX_Output(latches.outputEX), forKey: "outputEX")
+        super.encode(LegacyMEM_Output(latches.outputMEM), forKey: "outputMEM")
+        super.encode(LegacyWB_Output(latches.outputWB), forKey: "outputWB")
+    }
+}